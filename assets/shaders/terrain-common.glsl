@@ -0,0 +1,64 @@
+// Terrain resources shared by every terrain shader stage. Matches VulkanTerrain.
+//	heightmap: R32_SFLOAT normalized heights, texel centers on the corners of the terrain grid
+//	patch_bounds: per patch normalized min height, max height, and variance against its bilinear surface
+
+layout(push_constant) uniform TerrainConstants
+{
+    mat4 view_projection;
+    vec4 camera;   // xyz: position, w: projection scale (1 / tan(fov_y / 2))
+    vec4 viewport; // xy: render extent, z: target pixels per tessellated edge, w: max tessellation
+    vec4 terrain;  // x: world size, y: height scale, z: patches per side, w: variance weight
+    uvec4 detail;  // x: detail region, y: page size, z: page border, w: feedback extent (width | height << 16)
+} pc;
+
+layout(set = 0, binding = 0) uniform sampler2D heightmap;
+
+layout(std430, set = 0, binding = 1) readonly buffer TerrainPatches
+{
+    vec4 patch_bounds[];
+};
+
+// Heights are fetched and filtered by hand, since linear filtering of 32-bit float images is optional.
+//	Coarser levels exist only where the device could generate them; level 0 always does.
+float terrain_height_level(vec2 uv, int level)
+{
+    ivec2 size = max(textureSize(heightmap, level), ivec2(2));
+    vec2 texel = clamp(uv, 0.0, 1.0) * vec2(size - 1);
+    ivec2 base = min(ivec2(texel), size - 2);
+    vec2 f = texel - vec2(base);
+
+    ivec2 last = textureSize(heightmap, level) - 1;
+    float h00 = texelFetch(heightmap, min(base, last), level).r;
+    float h10 = texelFetch(heightmap, min(base + ivec2(1, 0), last), level).r;
+    float h01 = texelFetch(heightmap, min(base + ivec2(0, 1), last), level).r;
+    float h11 = texelFetch(heightmap, min(base + ivec2(1, 1), last), level).r;
+
+    return mix(mix(h00, h10, f.x), mix(h01, h11, f.x), f.y) * pc.terrain.y;
+}
+
+float terrain_height(vec2 uv)
+{
+    return terrain_height_level(uv, 0);
+}
+
+vec3 terrain_position(vec2 uv)
+{
+    return vec3(uv.x * pc.terrain.x, terrain_height(uv), uv.y * pc.terrain.x);
+}
+
+// Central differences one texel of the given level apart
+vec3 terrain_normal_level(vec2 uv, int level)
+{
+    float step_uv = 1.0 / float(max(textureSize(heightmap, level).x - 1, 1));
+    float spacing = pc.terrain.x * step_uv;
+
+    float dx = terrain_height_level(uv + vec2(step_uv, 0.0), level) - terrain_height_level(uv - vec2(step_uv, 0.0), level);
+    float dz = terrain_height_level(uv + vec2(0.0, step_uv), level) - terrain_height_level(uv - vec2(0.0, step_uv), level);
+
+    return normalize(vec3(-dx, 2.0 * spacing, -dz));
+}
+
+vec3 terrain_normal(vec2 uv)
+{
+    return terrain_normal_level(uv, 0);
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+// Shared by the hydraulic erosion passes. Matches VulkanTerrainErosion.
+//	Virtual pipes connect every cell to its four neighbors; water flows through them down the slope of the
+//	water surface, picks up sediment where it moves fast over steep ground, and drops it where it slows.
+//	state: terrain height (m), water depth (m), suspended sediment (m), unused. Passes alternate between A and B.
+//	flux: outflow through the left, right, top and bottom pipes (m^3/s), double buffered across iterations
+//	velocity: water velocity (m/s)
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(push_constant) uniform ErosionConstants
+{
+    float time_step;
+    float cell_size;
+    float gravity;
+    float pipe_area;
+    float rain_rate;
+    float sediment_capacity;
+    float dissolving;
+    float deposition;
+    float evaporation;
+    float min_tilt;
+    uint size;
+    uint iteration;
+} pc;
+
+layout(set = 0, binding = 0, rgba32f) uniform restrict image2D state_a;
+layout(set = 0, binding = 1, rgba32f) uniform restrict image2D state_b;
+layout(set = 0, binding = 2, rgba32f) uniform restrict readonly image2D flux_previous;
+layout(set = 0, binding = 3, rgba32f) uniform restrict image2D flux_current;
+layout(set = 0, binding = 4, rg32f) uniform restrict image2D velocity;
+
+bool erosion_outside(ivec2 cell)
+{
+    return any(greaterThanEqual(uvec2(cell), uvec2(pc.size)));
+}
+
+ivec2 erosion_clamp(ivec2 cell)
+{
+    return clamp(cell, ivec2(0), ivec2(pc.size - 1));
+}
\ No newline at end of file
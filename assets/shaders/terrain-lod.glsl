@@ -0,0 +1,7 @@
+// Nodes selected by assets/shaders/terrain-lod.comp, shared by the quadtree LOD draw stages. Matches VulkanTerrain.
+//	selected_nodes: two vec4s per node. Origin uv, size in uv and level; then the distances its morph starts and ends at.
+
+layout(std430, set = 0, binding = 2) readonly buffer TerrainSelectedNodes
+{
+    vec4 selected_nodes[];
+};
\ No newline at end of file
@@ -0,0 +1,19 @@
+#version 450
+
+#include "terrain-common.glsl"
+#include "terrain-lod.glsl"
+
+layout(location = 0) out vec2 out_uv;
+layout(location = 1) flat out uint out_node;
+
+void main()
+{
+    // One instance per selected node, its four corners from the vertex index
+    uint corner = uint(gl_VertexIndex);
+    vec4 node = selected_nodes[gl_InstanceIndex * 2];
+
+    out_uv = node.xy + vec2(corner & 1u, corner >> 1u) * node.z;
+    out_node = uint(gl_InstanceIndex);
+
+    gl_Position = vec4(terrain_position(out_uv), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+// Mesh shading resources, on top of terrain-common.glsl. Matches VulkanTerrain.
+//	meshlets: per level, row-major over the whole heightmap, bounds then normal cone
+//	hiz: max depth pyramid of the previous frame, level 0 at half its render extent
+
+#define TERRAIN_MESHLET_QUADS 8
+#define TERRAIN_MAX_PATCH_MESHLETS 16
+
+struct TerrainMeshlet
+{
+    vec4 bounds; // x: min height, y: max height, normalized
+    vec4 cone;   // xyz: axis, w: sine of the half angle holding every triangle normal
+};
+
+layout(std430, set = 0, binding = 2) readonly buffer TerrainMeshlets
+{
+    TerrainMeshlet meshlets[];
+};
+
+layout(set = 0, binding = 3) uniform sampler2D hiz;
+
+layout(std140, set = 0, binding = 4) uniform TerrainCulling
+{
+    mat4 previous_view_projection;
+    vec4 hiz_info; // xy: previous render extent, z: pyramid levels, w: 1 when the pyramid holds a previous frame
+} culling;
+
+// Written by the task shader, one workgroup per patch
+struct TerrainPayload
+{
+    uint patch_index;
+    uint level;            // Vertices lie 1 << level texels apart
+    uint neighbor_levels;  // 8 bits each: left, top, right, bottom
+    uint meshlets[TERRAIN_MAX_PATCH_MESHLETS]; // Meshlet x, y within the patch, 16 bits each
+};
+
+int terrain_texels_per_side()
+{
+    return textureSize(heightmap, 0).x - 1;
+}
+
+int terrain_patch_texels()
+{
+    return terrain_texels_per_side() / int(pc.terrain.z);
+}
+
+// Coarsest level a patch may use: a single meshlet
+uint terrain_max_level()
+{
+    return uint(findMSB(terrain_patch_texels() / TERRAIN_MESHLET_QUADS));
+}
+
+float terrain_texel(ivec2 texel)
+{
+    return texelFetch(heightmap, texel, 0).r * pc.terrain.y;
+}
+
+vec3 terrain_texel_position(ivec2 texel)
+{
+    float spacing = pc.terrain.x / float(terrain_texels_per_side());
+    return vec3(float(texel.x) * spacing, terrain_texel(texel), float(texel.y) * spacing);
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+// Fractal gradient noise over heightmap texel coordinates. A step for step port of TerrainNoise, so heights
+//	generated here match the CPU generator to within floating point rounding.
+
+struct TerrainNoiseConfig
+{
+    uint seed;
+    uint octaves;
+    float frequency;
+    float lacunarity;
+    float gain;
+    float exponent;
+};
+
+const vec2 c_noise_gradients[8] = vec2[8](
+    vec2(1.0, 0.0), vec2(-1.0, 0.0), vec2(0.0, 1.0), vec2(0.0, -1.0),
+    vec2(0.70710678, 0.70710678), vec2(-0.70710678, 0.70710678), vec2(0.70710678, -0.70710678), vec2(-0.70710678, -0.70710678)
+);
+
+const uint c_octave_seed_step = 0x9E3779B9u;
+
+uint terrain_noise_hash(ivec2 cell, uint seed)
+{
+    uint h = (uint(cell.x) * 0x8DA6B343u) ^ (uint(cell.y) * 0xD8163841u) ^ (seed * 0xCB1AB31Fu);
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+float terrain_noise_fade(float t)
+{
+    return t * t * t * (t * (t * 6.0 - 15.0) + 10.0);
+}
+
+float terrain_noise_corner(ivec2 cell, uint seed, vec2 offset)
+{
+    vec2 gradient = c_noise_gradients[terrain_noise_hash(cell, seed) & 7u];
+    return gradient.x * offset.x + gradient.y * offset.y;
+}
+
+float terrain_noise_gradient(vec2 p, uint seed)
+{
+    vec2 floor_p = floor(p);
+    ivec2 cell = ivec2(floor_p);
+    vec2 t = p - floor_p;
+
+    float n00 = terrain_noise_corner(cell, seed, t);
+    float n10 = terrain_noise_corner(cell + ivec2(1, 0), seed, t - vec2(1.0, 0.0));
+    float n01 = terrain_noise_corner(cell + ivec2(0, 1), seed, t - vec2(0.0, 1.0));
+    float n11 = terrain_noise_corner(cell + ivec2(1, 1), seed, t - vec2(1.0, 1.0));
+
+    float u = terrain_noise_fade(t.x);
+    float v = terrain_noise_fade(t.y);
+    float n0 = n00 + (n10 - n00) * u;
+    float n1 = n01 + (n11 - n01) * u;
+    return n0 + (n1 - n0) * v;
+}
+
+float terrain_noise_sample(TerrainNoiseConfig config, vec2 p)
+{
+    float sum = 0.0;
+    float total = 0.0;
+    float amplitude = 1.0;
+    float frequency = config.frequency;
+
+    for (uint octave = 0; octave < config.octaves; octave++)
+    {
+        sum += terrain_noise_gradient(p * frequency, config.seed + octave * c_octave_seed_step) * amplitude;
+        total += amplitude;
+        amplitude *= config.gain;
+        frequency *= config.lacunarity;
+    }
+
+    // Normalize the octave sum, then remap gradient noise's range onto [0, 1]
+    float noise = total > 0.0 ? sum / total : 0.0;
+    float height = clamp(noise * 0.70710678 + 0.5, 0.0, 1.0);
+
+    return pow(height, config.exponent);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#version 450
+
+#include "terrain-common.glsl"
+#include "virtual-texture.glsl"
+
+layout(location = 0) in vec2 in_uv;
+layout(location = 1) in vec3 in_position;
+
+layout(location = 0) out vec4 out_color;
+
+// Ground detail, streamed by VulkanTerrain's virtual texture
+layout(set = 1, binding = 0) uniform usampler2D detail_indirection;
+layout(set = 1, binding = 1) uniform sampler2D detail_cache;
+
+layout(std430, set = 1, binding = 2) writeonly buffer DetailFeedback
+{
+    uint detail_feedback[];
+};
+
+const vec3 c_sun_direction = vec3(0.4, 0.8, 0.3);
+const vec3 c_sky_color = vec3(0.62, 0.72, 0.85);
+
+void main()
+{
+    // Per pixel normals keep lighting detailed wherever tessellation is coarse. Where a pixel spans several
+    //	texels, they come from the mip level matching its footprint, so distant slopes don't shimmer.
+    vec2 footprint = max(abs(dFdx(in_uv)), abs(dFdy(in_uv))) * vec2(textureSize(heightmap, 0) - 1);
+    int level = clamp(int(floor(log2(max(max(footprint.x, footprint.y), 1.0)))), 0, textureQueryLevels(heightmap) - 1);
+    vec3 normal = terrain_normal_level(in_uv, level);
+    float height = in_position.y / pc.terrain.y;
+    float slope = 1.0 - normal.y;
+
+    vec3 grass = vec3(0.22, 0.36, 0.14);
+    vec3 rock = vec3(0.38, 0.34, 0.30);
+    vec3 snow = vec3(0.92, 0.93, 0.95);
+
+    vec3 albedo = mix(grass, rock, smoothstep(0.15, 0.35, slope));
+    albedo = mix(albedo, snow, smoothstep(0.7, 0.8, height) * (1.0 - smoothstep(0.3, 0.5, slope)));
+
+    // Detail is centered on 0.5, and left out until its coarsest page arrives
+    uint pages_per_side = uint(textureSize(detail_indirection, 0).x);
+    uint mip_levels = uint(textureQueryLevels(detail_indirection));
+    uint page_size = pc.detail.y;
+    uint page_border = pc.detail.z;
+    uint cache_pages = uint(textureSize(detail_cache, 0).x) / page_size;
+    float detail_lod = vt_lod(in_uv, pages_per_side, page_size - 2u * page_border, 0.0);
+
+    vec3 detail = vt_sample(detail_indirection, detail_cache, in_uv, detail_lod,
+        pages_per_side, mip_levels, page_size, page_border, cache_pages, vec4(0.5)).rgb;
+    albedo *= detail * 2.0;
+
+    // Every fragment asks for the page it wanted; the last write to a feedback texel wins
+    uvec2 feedback_extent = uvec2(pc.detail.w & 0xFFFFu, pc.detail.w >> 16);
+    detail_feedback[vt_feedback_index(gl_FragCoord.xy, uvec2(pc.viewport.xy), feedback_extent)] =
+        vt_feedback_id(pc.detail.x, in_uv, detail_lod, pages_per_side, mip_levels);
+
+    float diffuse = max(dot(normal, normalize(c_sun_direction)), 0.0);
+    vec3 color = albedo * (0.25 + 0.75 * diffuse);
+
+    // Distance haze
+    float haze = 1.0 - exp(-distance(in_position, pc.camera.xyz) * 0.00015);
+    out_color = vec4(mix(color, c_sky_color, haze), 1.0);
+}
\ No newline at end of file
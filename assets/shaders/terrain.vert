@@ -0,0 +1,18 @@
+#version 450
+
+#include "terrain-common.glsl"
+
+layout(location = 0) out vec2 out_uv;
+
+void main()
+{
+    // Corners come from the vertex index, four per patch, so the terrain needs no vertex or index buffers
+    uint patch_index = uint(gl_VertexIndex) / 4u;
+    uint corner = uint(gl_VertexIndex) % 4u;
+    uint per_side = uint(pc.terrain.z);
+
+    vec2 cell = vec2(patch_index % per_side, patch_index / per_side) + vec2(corner & 1u, corner >> 1u);
+    out_uv = cell / float(per_side);
+
+    gl_Position = vec4(terrain_position(out_uv), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+// Virtual texture sampling, shared with VulkanVirtualTexture.
+//	indirection: R8G8B8A8_UINT, one texel per page per level: cache page x, cache page y, mip, resident
+//	cache: the physical page cache, cache_pages pages of page_size texels per side, borders included
+
+#define VT_EMPTY 0xFFFFFFFFu
+
+// Region (8 bits), mip (4), x (10), y (10). Matches VulkanVirtualTexture::PackPage.
+uint vt_page_id(uint region, uint mip, uvec2 page)
+{
+    return (region << 24) | ((mip & 0xFu) << 20) | ((page.x & 0x3FFu) << 10) | (page.y & 0x3FFu);
+}
+
+// Level of detail from screen space derivatives, in virtual texels
+float vt_lod(vec2 uv, uint pages_per_side, uint content_size, float bias)
+{
+    vec2 texels = uv * float(pages_per_side * content_size);
+    vec2 dx = dFdx(texels);
+    vec2 dy = dFdy(texels);
+    float rho = max(dot(dx, dx), dot(dy, dy));
+    return max(0.5 * log2(max(rho, 1e-8)) + bias, 0.0);
+}
+
+// Page id the feedback pass writes for a sample. A negative bias requests finer pages than are drawn,
+//	so they are resident by the time they are needed.
+uint vt_feedback_id(uint region, vec2 uv, float lod, uint pages_per_side, uint mip_levels)
+{
+    uint mip = min(uint(lod), mip_levels - 1u);
+    uint level_pages = max(pages_per_side >> mip, 1u);
+    uvec2 page = min(uvec2(clamp(uv, 0.0, 1.0) * float(level_pages)), uvec2(level_pages - 1u));
+    return vt_page_id(region, mip, page);
+}
+
+// Index into the feedback buffer for a fragment, when the feedback pass runs at a lower resolution
+uint vt_feedback_index(vec2 frag_coord, uvec2 render_extent, uvec2 feedback_extent)
+{
+    uvec2 texel = min(uvec2(frag_coord * vec2(feedback_extent) / vec2(render_extent)), feedback_extent - 1u);
+    return texel.y * feedback_extent.x + texel.x;
+}
+
+// Samples the finest resident level at or above lod. The coarsest level stays resident once uploaded;
+//	until then, fallback is returned.
+vec4 vt_sample(usampler2D indirection, sampler2D cache, vec2 uv, float lod,
+    uint pages_per_side, uint mip_levels, uint page_size, uint page_border, uint cache_pages, vec4 fallback)
+{
+    uv = clamp(uv, 0.0, 1.0);
+    uint mip = min(uint(lod), mip_levels - 1u);
+
+    uvec4 entry = uvec4(0u);
+    uint level_pages = 1u;
+    for (; mip < mip_levels; mip++)
+    {
+        level_pages = max(pages_per_side >> mip, 1u);
+        ivec2 page = ivec2(min(uvec2(uv * float(level_pages)), uvec2(level_pages - 1u)));
+        entry = texelFetch(indirection, page, int(mip));
+        if (entry.a != 0u)
+            break;
+    }
+
+    if (entry.a == 0u)
+        return fallback;
+
+    // Position within the page's content, offset past its border
+    float content_size = float(page_size - 2u * page_border);
+    vec2 in_page = fract(uv * float(level_pages));
+    if (uv.x >= 1.0) in_page.x = 1.0;
+    if (uv.y >= 1.0) in_page.y = 1.0;
+
+    vec2 cache_texel = vec2(entry.xy) * float(page_size) + float(page_border) + in_page * content_size;
+    vec2 cache_uv = cache_texel / float(page_size * cache_pages);
+
+    // The cache has a single level; the page was picked from the virtual level matching lod, so it is filtered as is.
+    //	Pages coarser than requested are magnified until the finer page arrives.
+    return textureLod(cache, cache_uv, 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+module;
+
+#include <cstdint>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+export module Jobs:JobSystem;
+
+export
+{
+	class JobSystem
+	{
+	public:
+		// Process-wide job system, lazily initialized on first use
+		static JobSystem* Get();
+
+	public:
+		JobSystem();
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		// Spins up worker threads. A thread count of 0 uses every hardware thread except the caller's.
+		void Initialize(const uint32_t& thread_count = 0);
+
+		// Finishes all pending jobs, then joins every worker thread
+		void Shutdown();
+
+		// Enqueues a job for execution on a worker thread, returning a future to its result
+		template<typename Fn>
+		auto Submit(Fn&& job) -> std::future<std::invoke_result_t<Fn>>
+		{
+			using ReturnType = std::invoke_result_t<Fn>;
+
+			// std::function requires copyable targets, so the task is shared
+			auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<Fn>(job));
+			std::future<ReturnType> future = task->get_future();
+
+			this->Enqueue([task]() { (*task)(); });
+
+			return future;
+		}
+
+		// Waits on a future, executing pending jobs on the calling thread in the meantime.
+		//	Because waiting threads help out, jobs may safely wait on other jobs.
+		template<typename Future>
+		decltype(auto) Wait(Future& future)
+		{
+			while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				if (!this->RunPendingJob())
+					future.wait_for(std::chrono::microseconds(100));
+			}
+
+			return future.get();
+		}
+
+		// Runs job(i) for every i in [0, count), spread across all workers. The calling thread participates.
+		void ParallelFor(const size_t& count, const std::function<void(size_t)>& job);
+
+		// Pops and executes a single pending job on the calling thread. Returns false if none were pending.
+		bool RunPendingJob();
+
+		uint32_t GetThreadCount();
+
+	private:
+		void Enqueue(std::function<void()>&& job);
+
+		void WorkerLoop();
+
+	private:
+		std::vector<std::thread> m_workers;
+		std::deque<std::function<void()>> m_jobs;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_running;
+	};
+}
@@ -0,0 +1,3 @@
+export module Jobs;
+
+export import :JobSystem;
@@ -1,5 +1,8 @@
 module;
 
+#include <string>
+#include <vector>
+
 #include <vulkan/vulkan.h>
 
 export module Vulkan:Command;
@@ -8,9 +11,20 @@ import Aurion.Window;
 
 import :Image;
 import :Frame;
+import :TransientPool;
+import :RenderGraph;
 
 export
 {
+	// An image render commands share for the length of a frame, created by the frame's render graph and aliased
+	//	with its other transients. Contents never carry over between frames.
+	struct VulkanCommandImageInfo
+	{
+		std::string name;
+		VulkanTransientImageInfo image_info{}; // A zero width or height takes the frame image's extent
+		VulkanResourceUsage usage = VulkanResourceUsage::None; // Layout and stages the image is in when commands record
+	};
+
 	struct VulkanCommand
 	{
 		const Aurion::WindowHandle& window_handle;
@@ -18,6 +32,8 @@ export
 		const VkCommandBuffer& graphics_buffer;
 		const VkCommandBuffer& compute_buffer;
 
+		// In VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, and only written as a color attachment. Contents are undefined
+		//	until a command clears or draws over them.
 		const VkImage& render_image;
 		const VkImageView& render_view;
 		const VkSampler& render_sampler;
@@ -26,6 +42,17 @@ export
 
 		const VkExtent2D& swapchain_extent;
 
+		// Declared command images, in declaration order. Only valid while the frame records.
+		const std::vector<VulkanImage>& command_images;
+
 		const size_t& current_frame;
+
+		// Set by commands that record into compute_buffer. Frames with no compute work skip their compute submission.
+		bool& compute_recorded;
+
+		// Graphics stages that read what commands recorded into compute_buffer, added to by each such command. The
+		//	frame's graphics work waits on its compute submission from these stages on, so everything before them
+		//	overlaps with it. Left empty after compute was recorded, graphics waits from its first command.
+		VkPipelineStageFlags2& compute_consumer_stages;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+module;
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <limits>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+export module Vulkan:ComputeScheduler;
+
+import :Device;
+
+export
+{
+	// Identifies a submitted compute job by the compute timeline value it signals
+	struct VulkanComputeTicket
+	{
+		uint64_t value = 0; // 0 never waits
+	};
+
+	struct VulkanComputeJob
+	{
+		VkCommandPool cmd_pool = VK_NULL_HANDLE;
+		VkCommandBuffer cmd_buffer = VK_NULL_HANDLE;
+		uint64_t value = 0;
+		std::string name;
+	};
+
+	// Submits compute work that runs independently of frames, so long jobs can span several frames
+	//	while graphics keeps presenting. Graphics only waits on a job when a window consumes its ticket.
+	//	Submissions are made on the calling thread, and must come from the thread that renders.
+	//	CAUTION: Resources shared with graphics must use concurrent sharing if the queue families differ.
+	class VulkanComputeScheduler
+	{
+	public:
+		VulkanComputeScheduler();
+		~VulkanComputeScheduler();
+
+		void Initialize(VulkanDevice* logical_device);
+
+		// Waits for all jobs, then releases their command buffers
+		void Destroy();
+
+		// Records and immediately submits a job. The job starts once after has completed; every earlier
+		//	compute submission is complete by then as well.
+		VulkanComputeTicket Submit(const std::function<void(const VkCommandBuffer&)>& record, const std::string& name = "", const VulkanComputeTicket& after = {});
+
+		bool IsComplete(const VulkanComputeTicket& ticket);
+
+		bool Wait(const VulkanComputeTicket& ticket, const uint64_t& timeout = std::numeric_limits<uint64_t>::max());
+
+		// Recycles the command buffers of completed jobs. Called once per frame by the renderer.
+		void Collect();
+
+		size_t GetPendingCount();
+
+	private:
+		VulkanComputeJob AcquireJob();
+
+	private:
+		VulkanDevice* m_logical_device;
+		std::vector<VulkanComputeJob> m_pending_jobs; // In submission order
+		std::vector<VulkanComputeJob> m_free_jobs;
+	};
+}
\ No newline at end of file
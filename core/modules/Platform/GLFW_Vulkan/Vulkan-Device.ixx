@@ -9,14 +9,18 @@ module;
 
 export module Vulkan:Device;
 
+import :Timeline;
+
 export
 {
 	struct VulkanDeviceRequirements
 	{
 		VkPhysicalDeviceFeatures2 features{};
 		VkPhysicalDeviceType device_type;
+		bool allow_device_type_fallback = false; // Accept any other device type if none of device_type qualifies
 		VmaAllocatorCreateFlags allocator_flags = 0;
 		std::vector<const char*> extensions;
+		std::vector<const char*> optional_extensions; // Enabled only where the device supports them
 		std::vector<const char*> layers;
 	};
 
@@ -25,12 +29,28 @@ export
 		static VulkanDevice Create(const VkInstance& instance, const VulkanDeviceRequirements& reqs);
 		static bool MeetsRequirements(const VkPhysicalDevice& physical_device, const VulkanDeviceRequirements& reqs);
 
+		// Ranks a queue family for a role. Returns -1 if the family lacks a required capability.
+		//	Preferred capabilities raise the score and avoided ones lower it, so dedicated families win.
+		static int32_t ScoreQueueFamily(const VkQueueFamilyProperties& props, const VkQueueFlags& required, const VkQueueFlags& preferred, const VkQueueFlags& avoided);
+
+		bool HasExtension(const char* extension) const;
+
 		VkInstance vk_instance = VK_NULL_HANDLE;
 		VkDevice handle = VK_NULL_HANDLE;
 		VmaAllocator allocator = VK_NULL_HANDLE;
 		VkPhysicalDevice physical_device = VK_NULL_HANDLE;
 		VkPhysicalDeviceProperties2 properties{};
 		VkPhysicalDeviceFeatures2 features{};
+		std::vector<const char*> enabled_extensions;
+
+		// VK_KHR_present_wait, for pacing frames against the display
+		bool present_wait_supported = false;
+		PFN_vkWaitForPresentKHR wait_for_present = nullptr;
+
+		// VK_EXT_mesh_shader, with task shaders. Mesh shading paths fall back to other pipelines without it.
+		bool mesh_shader_supported = false;
+		PFN_vkCmdDrawMeshTasksEXT draw_mesh_tasks = nullptr;
+		VkPhysicalDeviceMeshShaderPropertiesEXT mesh_shader_properties{};
 
 		VkCommandPool immediate_cmd_pool;
 		VkCommandBuffer immediate_cmd_buffer;
@@ -41,6 +61,21 @@ export
 		std::optional<uint32_t> graphics_queue_index;
 		VkQueue compute_queue = VK_NULL_HANDLE;
 		std::optional<uint32_t> compute_queue_index;
+		VkQueue transfer_queue = VK_NULL_HANDLE;
+		std::optional<uint32_t> transfer_queue_index;
+
+		// Every queue created for a role, for spreading independent work. The first is always the primary queue above.
+		//	Only the primary queues are tracked by a timeline; work on the others must bring its own synchronization.
+		std::vector<VkQueue> compute_queues;
+		std::vector<VkQueue> transfer_queues;
+
+		// Unique families of the primary queues. Resources used by more than one of them are shared concurrently.
+		std::vector<uint32_t> queue_families;
+
+		// One timeline per queue. Frames, uploads and compute jobs wait on exact values of these.
+		VulkanTimeline graphics_timeline{};
+		VulkanTimeline compute_timeline{};
+		VulkanTimeline transfer_timeline{};
 
 	};
 }
\ No newline at end of file
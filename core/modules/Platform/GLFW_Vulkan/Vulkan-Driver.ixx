@@ -23,6 +23,7 @@ export
 		uint32_t max_frames_in_flight = 1;
 		bool enable_validation_layers = true;
 		bool enable_debug_messenger = true;
+		bool headless = false; // No windowing system: skips GLFW and swapchain extensions, and accepts CPU devices
 	};
 
 	class VulkanDriver : public IGraphicsDriver
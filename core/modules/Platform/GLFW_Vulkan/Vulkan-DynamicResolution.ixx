@@ -0,0 +1,50 @@
+module;
+
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+export module Vulkan:DynamicResolution;
+
+export
+{
+	struct VulkanDynamicResolutionConfig
+	{
+		bool enabled = false;
+		double target_ms = 16.6; // GPU time per frame to hold
+		double headroom = 0.9; // Fraction of the target aimed for, leaving room for spikes
+		float min_scale = 0.5f; // Per axis
+		float max_scale = 1.0f; // Per axis. Frame images are allocated at full size, so at most 1.
+		float scale_step = 1.0f / 32.0f; // Scales snap to multiples of this, to avoid resizing every frame
+	};
+
+	// Picks a per axis render scale from measured GPU frame times. Cost is treated as proportional to pixel count,
+	//	so each measurement is normalized by the scale its frame rendered at. Timings arrive frames late, and this
+	//	keeps the controller from reacting to the same spike several times over.
+	class VulkanDynamicResolution
+	{
+	public:
+		VulkanDynamicResolution();
+		~VulkanDynamicResolution();
+
+		void Configure(const VulkanDynamicResolutionConfig& config);
+		const VulkanDynamicResolutionConfig& GetConfig();
+
+		// Feeds a completed frame's GPU time in milliseconds, along with the scale it rendered at, and returns the
+		//	scale to render the next frame at. Times of 0 (nothing measured) hold the current scale.
+		float Update(const double& gpu_ms, const float& measured_scale);
+
+		// The sub-rectangle of a full size image to render into at the current scale. Never empty.
+		VkExtent3D GetRenderExtent(const VkExtent3D& full_extent) const;
+
+		float GetScale() const;
+
+		// Smoothed GPU time expected at the current scale
+		double GetEstimatedMilliseconds() const;
+
+	private:
+		VulkanDynamicResolutionConfig m_config;
+		float m_scale;
+		double m_full_scale_ms; // Smoothed GPU time, normalized to a scale of 1
+	};
+}
\ No newline at end of file
@@ -1,27 +1,56 @@
 module;
 
+#include <cstdint>
+#include <vector>
+
 #include <vulkan/vulkan.h>
 
 export module Vulkan:Frame;
 
 import :Image;
+import :TransientPool;
 
 export
 {
+	// Secondary command buffers for one chunk of a parallel recording. Each slot
+	//	owns its pools, so only a single job ever records into them at a time.
+	struct VulkanRecordSlot
+	{
+		VkCommandPool compute_cmd_pool = VK_NULL_HANDLE;
+		VkCommandPool graphics_cmd_pool = VK_NULL_HANDLE;
+		VkCommandBuffer compute_cmd_buffer = VK_NULL_HANDLE;
+		VkCommandBuffer graphics_cmd_buffer = VK_NULL_HANDLE;
+	};
+
 	struct VulkanFrame
 	{
 		VulkanImage image{};
 
+		// Region of image rendered this frame, at render_scale of its extent per axis
+		VkExtent3D render_extent{};
+		float render_scale = 1.0f;
+
 		VkCommandPool compute_cmd_pool = VK_NULL_HANDLE;
 		VkCommandPool graphics_cmd_pool = VK_NULL_HANDLE;
 		VkCommandBuffer compute_cmd_buffer = VK_NULL_HANDLE;
 		VkCommandBuffer graphics_cmd_buffer = VK_NULL_HANDLE;
 
-		VkFence compute_fence = VK_NULL_HANDLE;
-		VkFence graphics_fence = VK_NULL_HANDLE;
+		// Memory for this frame's render graph transients
+		VulkanTransientPool transient_pool{};
+
+		// Created on demand the first time this frame records in parallel
+		std::vector<VulkanRecordSlot> record_slots;
+
+		// Values this frame's last submissions signal on the device's queue timelines
+		uint64_t compute_timeline_value = 0;
+		uint64_t graphics_timeline_value = 0;
+
+		// The frame image registered as an ImGui texture, while the window renders as UI
+		VkDescriptorSet ui_texture = VK_NULL_HANDLE;
+		VkImageView ui_texture_view = VK_NULL_HANDLE; // The view ui_texture samples; re-registered when the image is replaced
 
-		VkSemaphore compute_semaphore = VK_NULL_HANDLE;
-		VkSemaphore graphics_semaphore = VK_NULL_HANDLE;
+		// Presentation only supports binary semaphores
 		VkSemaphore swapchain_semaphore = VK_NULL_HANDLE;
+		VkSemaphore present_semaphore = VK_NULL_HANDLE;
 	};
 }
\ No newline at end of file
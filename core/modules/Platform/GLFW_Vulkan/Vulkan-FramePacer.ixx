@@ -0,0 +1,71 @@
+module;
+
+#include <cstdint>
+#include <chrono>
+#include <deque>
+
+export module Vulkan:FramePacer;
+
+export
+{
+	enum class VulkanLatencyMode
+	{
+		Off, // Frames queue up to the swapchain's limit
+		JustInTime // Waits for the previous frame to reach the display before sampling input
+	};
+
+	struct VulkanFramePacerConfig
+	{
+		double target_fps = 0.0; // 0 leaves the frame rate unlimited
+		VulkanLatencyMode latency_mode = VulkanLatencyMode::Off;
+		uint32_t history_size = 240; // Frames kept for the timing statistics
+	};
+
+	// Frame to frame timings over the pacer's history
+	struct VulkanFrameTimingStats
+	{
+		double average_ms = 0.0;
+		double min_ms = 0.0;
+		double max_ms = 0.0;
+		double std_dev_ms = 0.0; // Lower is smoother
+		double percentile_99_ms = 0.0;
+		double average_wait_ms = 0.0; // Time spent in the limiter and latency waits
+		uint32_t frame_count = 0;
+	};
+
+	// Spaces frame starts evenly at a target rate, and measures how evenly they actually land.
+	//	The renderer calls Pace once per frame, before input is polled.
+	class VulkanFramePacer
+	{
+	public:
+		VulkanFramePacer();
+		~VulkanFramePacer();
+
+		void Configure(const VulkanFramePacerConfig& config);
+		const VulkanFramePacerConfig& GetConfig();
+
+		void SetTargetFPS(const double& target_fps);
+		void SetLatencyMode(const VulkanLatencyMode& mode);
+
+		// Sleeps until the next frame is due, then records the frame time. wait_start is when any latency wait began,
+		//	so it's counted as waiting rather than work.
+		void Pace(const std::chrono::steady_clock::time_point& wait_start);
+
+		VulkanFrameTimingStats GetStats();
+
+		// Draws the timing statistics into the current ImGui context
+		void DrawOverlay(const char* title = "Frame Pacing");
+
+	private:
+		void SleepUntil(const std::chrono::steady_clock::time_point& deadline);
+
+	private:
+		VulkanFramePacerConfig m_config;
+		std::chrono::steady_clock::time_point m_next_frame;
+		std::chrono::steady_clock::time_point m_last_frame;
+		bool m_started;
+
+		std::deque<double> m_frame_times; // Milliseconds
+		std::deque<double> m_wait_times; // Milliseconds
+	};
+}
\ No newline at end of file
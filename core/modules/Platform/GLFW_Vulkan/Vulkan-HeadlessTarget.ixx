@@ -0,0 +1,126 @@
+module;
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+export module Vulkan:HeadlessTarget;
+
+import Aurion.Window;
+
+import :Device;
+import :Frame;
+import :Image;
+import :RenderGraph;
+import :Profiler;
+import :ComputeScheduler;
+
+import :Command;
+
+export
+{
+	struct VulkanHeadlessTargetConfig
+	{
+		VkExtent2D extent{ 1280, 720 };
+		VkFormat format = VK_FORMAT_B8G8R8A8_UNORM; // Matches the window pipelines' color attachment format
+		bool readback_enabled = false;
+	};
+
+	// Host visible copy of a frame's render image
+	struct VulkanHeadlessReadback
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		void* mapped = nullptr;
+		VkDeviceSize size = 0;
+	};
+
+	// Renders commands into VulkanFrame images without a surface or swapchain. Frames are paced by the
+	//	device's timelines only, so this runs on devices without presentation support, such as lavapipe.
+	class VulkanHeadlessTarget
+	{
+	public:
+		VulkanHeadlessTarget();
+		~VulkanHeadlessTarget();
+
+		// Owns Vulkan handles, which the destructor releases
+		VulkanHeadlessTarget(const VulkanHeadlessTarget&) = delete;
+		VulkanHeadlessTarget& operator=(const VulkanHeadlessTarget&) = delete;
+
+		void Attach(VulkanDevice* logical_device, const VulkanHeadlessTargetConfig& config);
+
+		void SetMaxFramesInFlight(const uint32_t& max_in_flight_frames);
+
+		// Records and submits one frame. Returns false if the target isn't attached.
+		bool Render();
+
+		// Binds a render command for repeated calls. CAUTION: These will NOT be cleared each frame.
+		void BindRenderCommand(const std::function<void(const VulkanCommand&)>& command, const std::string& name = "");
+
+		// Submits a render command for execution during the next frame.
+		void SubmitRenderCommand(const std::function<void(const VulkanCommand&)>& command, const std::string& name = "");
+
+		// Declares an image every frame's render commands write, created as a render graph transient. Commands find it
+		//	at the returned index of VulkanCommand::command_images, already in the usage's layout. Returns that index.
+		uint32_t DeclareCommandImage(const VulkanCommandImageInfo& image_info);
+
+		// Copies each frame's render image into host memory after its commands
+		void SetReadbackEnabled(const bool& enabled);
+
+		// Waits for the most recently rendered frame, then copies its tightly packed texels into pixels.
+		//	Requires readback to have been enabled when that frame was rendered.
+		bool ReadPixels(std::vector<uint8_t>& pixels);
+
+		// Blocks until every submitted frame has completed
+		void WaitIdle();
+
+		const VulkanHeadlessTargetConfig& GetConfig();
+
+		VulkanProfiler* GetProfiler();
+
+		// Makes the next frame's graphics work wait on a compute job, from the given stages on
+		void ConsumeCompute(const VulkanComputeTicket& ticket, const VkPipelineStageFlags2& stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+	private:
+		void Reset(const VulkanFrame& frame);
+		void Record(VulkanFrame& frame);
+		void Submit(VulkanFrame& frame);
+
+		void CopyImageToReadback(const VkCommandBuffer& cmd_buffer, const VulkanFrame& frame, const VulkanHeadlessReadback& readback);
+
+		bool CreateFrame(VulkanFrame& frame, VulkanHeadlessReadback& readback);
+		bool CreateReadback(VulkanHeadlessReadback& readback);
+		void DestroyFrame(VulkanFrame& frame, VulkanHeadlessReadback& readback);
+
+	private:
+		Aurion::WindowHandle m_handle; // Always empty; commands only receive it for API parity with windows
+		VulkanDevice* m_logical_device;
+		VulkanHeadlessTargetConfig m_config;
+		std::vector<VulkanFrame> m_frames;
+		std::vector<VulkanHeadlessReadback> m_readbacks;
+		std::vector<bool> m_readback_written; // Whether each frame's last submission copied into its readback buffer
+		VulkanRenderGraph m_render_graph;
+		std::vector<VulkanCommandImageInfo> m_command_image_infos;
+		std::vector<uint32_t> m_command_image_resources; // This frame's command images in the render graph
+		std::vector<VulkanImage> m_command_images; // Realized once the graph compiles
+		VulkanProfiler m_profiler;
+
+		std::vector<std::function<void(const VulkanCommand&)>> m_bound_commands;
+		std::vector<std::function<void(const VulkanCommand&)>> m_submit_commands;
+		std::vector<std::string> m_bound_command_names;
+		std::vector<std::string> m_submit_command_names;
+
+		uint64_t m_compute_wait_value;
+		VkPipelineStageFlags2 m_compute_wait_stages;
+		bool m_compute_recorded;
+		VkPipelineStageFlags2 m_compute_consumer_stages;
+
+		size_t m_current_frame;
+		size_t m_last_frame; // Frame most recently submitted, for ReadPixels
+		bool m_rendered;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,8 @@
 module;
 
+#include <cstdint>
+#include <vector>
+
 #include <vulkan/vulkan.h>
 #include <vma/vk_mem_alloc.h>
 
@@ -15,12 +18,46 @@ export
 		VkImageUsageFlags usage_flags = 0;
 		VkImageAspectFlags aspect_flags = 0;
 		VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+
+		// 3D images take their depth from the extent. 2D images with more than one layer are viewed as arrays.
+		VkImageType image_type = VK_IMAGE_TYPE_2D;
+		uint32_t mip_levels = 1; // VulkanImage::c_full_mip_chain builds every level down to 1x1
+		uint32_t array_layers = 1;
+
+		// Queue families that access the image. More than one unique family creates it with concurrent sharing.
+		const uint32_t* queue_family_indices = nullptr;
+		uint32_t queue_family_count = 0;
 	};
 
 	struct VulkanImage
 	{
+		static constexpr uint32_t c_full_mip_chain = 0;
+
 		static VulkanImage Create(const VkDevice& logical_device, const VmaAllocator& allocator, const VulkanImageCreateInfo& create_info);
-		static void TransitionLayout(const VkCommandBuffer& cmd_buffer, const VkImage& image, const VkImageLayout& src, const VkImageLayout& dst);
+
+		// Number of levels in a full mip chain for the given extent
+		static uint32_t GetMipLevelCount(const VkExtent3D& extent);
+
+		// Bytes per texel of uncompressed color formats used for uploads and readback. Returns 0 for any other format.
+		static uint32_t GetTexelSize(const VkFormat& format);
+
+		// Whether mips of this format can be generated by linear blits
+		static bool SupportsMipGeneration(const VkPhysicalDevice& physical_device, const VkFormat& format);
+
+		// Records blits that build every mip level from level 0, for all layers of every image, in one command buffer.
+		//	Levels are processed together across images, so each level costs one barrier batch rather than one per image.
+		//	Images need transfer source and destination usage. Level 0 is expected in src_layout; all levels end in dst_layout.
+		static void GenerateMips(const VkCommandBuffer& cmd_buffer, const std::vector<const VulkanImage*>& images,
+			const VkImageLayout& src_layout, const VkImageLayout& dst_layout, const VkFilter& filter = VK_FILTER_LINEAR);
+		static void GenerateMips(const VkCommandBuffer& cmd_buffer, const VulkanImage& image,
+			const VkImageLayout& src_layout, const VkImageLayout& dst_layout, const VkFilter& filter = VK_FILTER_LINEAR);
+
+		// Records a single layout transition. Defaults synchronize against all commands; pass precise masks where known,
+		//	or let a VulkanRenderGraph infer them.
+		static void TransitionLayout(const VkCommandBuffer& cmd_buffer, const VkImage& image, const VkImageLayout& src, const VkImageLayout& dst,
+			const VkPipelineStageFlags2& src_stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, const VkAccessFlags2& src_access = VK_ACCESS_2_MEMORY_WRITE_BIT,
+			const VkPipelineStageFlags2& dst_stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, const VkAccessFlags2& dst_access = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+			const VkImageAspectFlags& aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT);
 
 		VmaAllocation allocation = VK_NULL_HANDLE;
 		VkSampler sampler = VK_NULL_HANDLE;
@@ -28,5 +65,9 @@ export
 		VkImageView view = VK_NULL_HANDLE;
 		VkExtent3D extent{};
 		VkFormat format{};
+		VkImageType type = VK_IMAGE_TYPE_2D;
+		VkImageAspectFlags aspect_flags = 0;
+		uint32_t mip_levels = 1;
+		uint32_t array_layers = 1;
 	};
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 module;
 
 #include <vector>
+#include <deque>
 #include <string>
+#include <future>
+#include <memory>
+#include <mutex>
 
 #include <shaderc/shaderc.hpp>
 #include <spirv_cross/spirv_cross.hpp>
@@ -9,7 +13,11 @@ module;
 
 export module Vulkan:Pipeline;
 
+import Jobs;
+
 import :Device;
+import :ShaderCache;
+import :ShaderWatcher;
 
 // TODO: Break up massive configuration structure through strategy pattern.
 /*		Design:
@@ -35,6 +43,25 @@ export
 		std::vector<VkPushConstantRange> push_constants;
 	};
 
+	struct VulkanShaderSource
+	{
+		std::string file_path;
+		VkShaderStageFlagBits stage;
+		VkPipelineShaderStageCreateFlags create_flags = 0;
+		bool is_hlsl = false;
+		std::string entry_point = "main";
+		uint64_t cache_key = 0; // Key of the binary the current shader module was built from
+	};
+
+	struct VulkanShaderTiming
+	{
+		std::string file_path;
+		VkShaderStageFlagBits stage;
+		double milliseconds = 0.0;
+		bool from_cache = false;
+		bool succeeded = false;
+	};
+
 	struct VulkanRenderPassConfiguration
 	{
 		struct Subpass
@@ -104,6 +131,7 @@ export
 
 		// Shader information for this pipeline
 		std::vector<VkPipelineShaderStageCreateInfo> shader_stages;
+		std::vector<VulkanShaderSource> shader_sources; // Parallel to shader_stages
 
 		// Information about the desired layout
 		VkPipelineLayoutCreateInfo layout_info{ .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
@@ -127,26 +155,33 @@ export
 			std::vector<VulkanPipeline*> compute_pipelines;
 			std::vector<VulkanPipeline*> graphics_pipelines;
 			std::vector<VulkanPipeline*> ray_tracing_pipelines;
+
+			// Per-shader compilation timings for the most recent Build()
+			std::vector<VulkanShaderTiming> shader_timings;
 		};
 
 	public:
 		VulkanPipelineBuilder();
 		~VulkanPipelineBuilder();
 
-		void Initialize(VulkanDevice* device, std::vector<VulkanPipeline>& pipeline_buffer);
+		// Pipelines stay at the same address once built, so several Build() calls may hand them out
+		void Initialize(VulkanDevice* device, std::deque<VulkanPipeline>& pipeline_buffer);
 
 		void Cleanup();
 
 		// Start the configuration chain
 		VulkanPipelineBuilder& Configure(const VkStructureType& pipeline_type, const VkPipelineCreateFlags& create_flags = 0);
 
-		// End the configuration chain
+		// End the configuration chain. Joins all outstanding shader compilations.
 		Result Build();
 
 		// Shader Configuration
 		// --------------------
 
-		// Generate a shader module
+		// Sets the location of the SPIR-V cache archive and loads it
+		void SetShaderCachePath(const std::string& archive_path);
+
+		// Queue a shader for compilation on the job system. The shader module is created in Build()
 		VulkanPipelineBuilder& BindShader(const VkShaderStageFlagBits& shader_stage, const VkPipelineShaderStageCreateFlags& create_flags, 
 			const std::string& file_path, bool is_hlsl = false, const char* entry_point = "main");
 
@@ -338,17 +373,105 @@ export
 		// Raytracing Configuration
 		// ------------------------
 
+		// Hot Reloading
+		// -------------
+
+		// Watches a shader directory and rebuilds affected pipelines on the watcher thread
+		void EnableHotReload(const std::string& watch_directory = "assets/shaders");
+
+		// Stops watching and destroys any handles still waiting to be swapped in or retired. The device must be idle.
+		void DisableHotReload();
+
+		// Swaps rebuilt pipeline handles in. Must be called at a frame boundary, with no recorded work left unsubmitted.
+		//	Replaced handles are destroyed once the graphics and compute timelines pass every value reserved before
+		//	the swap, which covers frames of any window or headless target as well as scheduled compute jobs.
+		//	Never blocks on a rebuild in progress.
+		void ApplyHotReloads();
+
 	private:
-		shaderc_shader_kind VkShaderToShaderc(const VkShaderStageFlags& flags);
+		struct ShaderCompileOutput
+		{
+			std::vector<uint32_t> spirv;
+			std::string error;
+			uint64_t cache_key = 0;
+			double milliseconds = 0.0;
+			bool from_cache = false;
+			bool succeeded = false;
+		};
+
+		struct PendingShader
+		{
+			size_t config_index = 0;
+			size_t stage_index = 0;
+			std::shared_future<ShaderCompileOutput> output;
+		};
+
+		struct RetainedPipeline
+		{
+			size_t pipeline_index = 0;
+			VulkanPipelineConfiguration config;
+		};
+
+		struct ReloadedPipeline
+		{
+			size_t pipeline_index = 0;
+			VkPipeline handle = VK_NULL_HANDLE;
+		};
+
+		struct RetiredPipeline
+		{
+			VkPipeline handle = VK_NULL_HANDLE;
+			uint64_t graphics_timeline_value = 0; // Last values reserved while the handle could still be recorded
+			uint64_t compute_timeline_value = 0;
+		};
+
+		// Shared with the watcher thread, which keeps the builder itself copyable
+		struct HotReloadState
+		{
+			std::mutex mutex;
+			VulkanDevice* device = nullptr;
+			std::shared_ptr<VulkanShaderCache> shader_cache;
+			std::vector<RetainedPipeline> retained; // Built configurations, kept for rebuilding
+			std::vector<ReloadedPipeline> reloaded; // Rebuilt handles waiting for a frame boundary
+			std::vector<RetiredPipeline> retired; // Replaced handles waiting for their work to complete (render thread only)
+
+			// Declared last, so the watcher thread is joined before anything it touches is destroyed
+			VulkanShaderWatcher watcher;
+		};
+
+	private:
+		static shaderc_shader_kind VkShaderToShaderc(const VkShaderStageFlags& flags);
+
+		// Points the graphics create info at the state structures owned by the configuration
+		static void AttachGraphicsState(VulkanPipelineConfiguration& config);
+
+		// Executed on the watcher thread
+		static void ReloadPipelines(HotReloadState* state, const std::vector<std::string>& changed_files);
+
+		// Executed on a worker thread. Preprocesses the source, then either pulls the binary from the cache or compiles it.
+		static ShaderCompileOutput CompileShader(const std::shared_ptr<VulkanShaderCache>& cache, const std::string& source_text, 
+			const std::string& source_name, const shaderc_shader_kind& kind, const bool& is_hlsl, const std::string& entry_point);
+
+		// Waits on every queued compilation and attaches the resulting shader modules
+		void ResolvePendingShaders();
 
 	private:
 		// Renderer References
 		VulkanDevice* m_logical_device;
-		std::vector<VulkanPipeline>* m_pipeline_buffer;
+		std::deque<VulkanPipeline>* m_pipeline_buffer;
 
 		// Configurations to build
 		std::vector<VulkanPipelineConfiguration> m_configurations;
 
+		// Shader compilations in flight on the job system
+		std::vector<PendingShader> m_pending_shaders;
+
+		// SPIR-V cache, shared with compilation jobs
+		std::shared_ptr<VulkanShaderCache> m_shader_cache;
+
+		// Hot reload state, shared with the watcher thread
+		std::shared_ptr<HotReloadState> m_hot_reload;
+
 		// Build Result
 		Result m_build_result;
 	};
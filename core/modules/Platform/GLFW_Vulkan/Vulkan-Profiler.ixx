@@ -0,0 +1,133 @@
+module;
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+export module Vulkan:Profiler;
+
+import :Device;
+
+export
+{
+	// Hardware independent work counters. Compute queue scopes only report compute invocations.
+	struct VulkanPipelineStatistics
+	{
+		uint64_t input_assembly_vertices = 0;
+		uint64_t input_assembly_primitives = 0;
+		uint64_t vertex_invocations = 0;
+		uint64_t fragment_invocations = 0;
+		uint64_t compute_invocations = 0;
+	};
+
+	struct VulkanProfilerScope
+	{
+		std::string name;
+		bool compute = false;
+		bool statistics = false;
+	};
+
+	struct VulkanProfilerResult
+	{
+		std::string name;
+		bool compute = false;
+		double milliseconds = 0.0;
+		double average_milliseconds = 0.0; // Exponential moving average, for a readable overlay
+
+		bool has_statistics = false;
+		VulkanPipelineStatistics statistics{};
+	};
+
+	// Timestamp queries for a single frame in flight
+	struct VulkanProfilerFrame
+	{
+		VkQueryPool graphics_pool = VK_NULL_HANDLE;
+		VkQueryPool compute_pool = VK_NULL_HANDLE;
+		VkQueryPool graphics_statistics_pool = VK_NULL_HANDLE;
+		VkQueryPool compute_statistics_pool = VK_NULL_HANDLE;
+		std::vector<VulkanProfilerScope> scopes;
+		bool submitted = false;
+	};
+
+	// GPU timestamp profiler. Each frame in flight owns its query pools, which are only read back once
+	//	that frame's previous submission has completed, so collecting results never stalls.
+	class VulkanProfiler
+	{
+	public:
+		static constexpr uint32_t c_invalid_scope = UINT32_MAX;
+
+	public:
+		VulkanProfiler();
+		~VulkanProfiler();
+
+		void Initialize(VulkanDevice* logical_device, const uint32_t& max_scopes = 128);
+
+		// Matches the number of frames in flight. Removed frames must no longer be in use.
+		void Resize(const uint32_t& frame_count);
+
+		void Destroy();
+
+		void SetEnabled(const bool& enabled);
+		bool Enabled();
+
+		// Collects results of this frame's previous use, then resets its queries. Call after the frame's work has completed.
+		void BeginFrame(const size_t& frame_index);
+
+		// Marks the current frame's queries as submitted
+		void EndFrame();
+
+		// Allocates a scope in the current frame. Returns c_invalid_scope if profiling is off or the frame is full.
+		//	Scopes with statistics also collect pipeline statistics, and must not be nested within one another.
+		uint32_t AddScope(const std::string& name, const bool& compute = false, const bool& statistics = false);
+
+		// Brackets a scope's work with timestamps, and statistics queries if requested.
+		//	Safe to call from multiple threads on different command buffers.
+		void WriteBegin(const VkCommandBuffer& cmd_buffer, const uint32_t& scope) const;
+		void WriteEnd(const VkCommandBuffer& cmd_buffer, const uint32_t& scope) const;
+
+		// Results of the most recently completed frame
+		const std::vector<VulkanProfilerResult>& GetResults();
+
+		// Sum of all statistics scopes in the most recently completed frame
+		const VulkanPipelineStatistics& GetFrameStatistics();
+
+		// Graphics queue time from the first to the last timestamp of the most recently completed frame. 0 if nothing was timed.
+		double GetFrameMilliseconds();
+
+		// Draws the latest results into the current ImGui context
+		void DrawOverlay(const char* title = "GPU Profiler");
+
+		// Writes every recorded frame's results as CSV
+		bool DumpCSV(const std::string& path);
+
+	private:
+		void Collect(VulkanProfilerFrame& frame);
+
+		void WriteTimestamp(const VkCommandBuffer& cmd_buffer, const uint32_t& scope, const uint32_t& query, const VkPipelineStageFlags2& stage) const;
+
+		VkQueryPool GetStatisticsPool(const uint32_t& scope) const;
+
+	private:
+		VulkanDevice* m_logical_device;
+		std::vector<VulkanProfilerFrame> m_frames;
+		size_t m_current_frame;
+		uint32_t m_max_scopes;
+		double m_timestamp_period; // Nanoseconds per tick
+		bool m_graphics_supported;
+		bool m_compute_supported;
+		bool m_statistics_supported;
+		bool m_enabled;
+
+		std::vector<VulkanProfilerResult> m_results;
+		VulkanPipelineStatistics m_frame_statistics;
+		double m_frame_milliseconds;
+		std::unordered_map<std::string, double> m_averages;
+
+		uint64_t m_collected_frames;
+		std::deque<std::pair<uint64_t, std::vector<VulkanProfilerResult>>> m_history;
+	};
+}
\ No newline at end of file
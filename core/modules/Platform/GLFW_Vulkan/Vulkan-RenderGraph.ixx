@@ -0,0 +1,194 @@
+module;
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+export module Vulkan:RenderGraph;
+
+import :TransientPool;
+import :Profiler;
+
+export
+{
+	// How a pass uses a resource. Each usage maps to exact pipeline stages, access masks, and image layout.
+	enum class VulkanResourceUsage : uint8_t
+	{
+		None = 0,
+
+		// Images
+		ColorAttachmentWrite,
+		ColorAttachmentReadWrite,
+		DepthAttachmentWrite,
+		DepthAttachmentRead,
+		FragmentSampled,
+		ComputeSampled,
+		ComputeStorageRead,
+		ComputeStorageWrite,
+		ComputeStorageReadWrite,
+		TransferSrc,
+		TransferDst,
+		Present,
+
+		// Buffers
+		VertexBuffer,
+		IndexBuffer,
+		IndirectBuffer,
+		UniformBuffer,
+		HostRead, // Final usage of buffers the host reads once the frame completes
+
+		// Unknown work in the GENERAL layout. Synchronizes against everything, so prefer a precise usage.
+		General,
+	};
+
+	struct VulkanUsageInfo
+	{
+		VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 access = VK_ACCESS_2_NONE;
+		VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		bool writes = false;
+	};
+
+	struct VulkanRenderGraphAccess
+	{
+		uint32_t resource = 0;
+		VulkanResourceUsage usage = VulkanResourceUsage::None;
+	};
+
+	// A single pass in the graph. Passes declare every resource they touch; barriers between them are inferred.
+	struct VulkanRenderGraphPass
+	{
+		VulkanRenderGraphPass& Read(const uint32_t& resource, const VulkanResourceUsage& usage);
+		VulkanRenderGraphPass& Write(const uint32_t& resource, const VulkanResourceUsage& usage);
+
+		// Forces the pass to execute, even if nothing consumes its results
+		VulkanRenderGraphPass& KeepAlive();
+
+		VulkanRenderGraphPass& Execute(const std::function<void(const VkCommandBuffer&)>& execute);
+
+		std::string name;
+		std::vector<VulkanRenderGraphAccess> reads;
+		std::vector<VulkanRenderGraphAccess> writes;
+		std::function<void(const VkCommandBuffer&)> execute_fun;
+		bool keep_alive = false;
+
+		// Populated during compilation
+		bool culled = false;
+		std::vector<VkImageMemoryBarrier2> image_barriers;
+		std::vector<VkBufferMemoryBarrier2> buffer_barriers;
+	};
+
+	struct VulkanRenderGraphResource
+	{
+		std::string name;
+
+		bool is_image = false;
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		VkImageAspectFlags aspect_flags = 0;
+
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = VK_WHOLE_SIZE;
+
+		// Resources marked as outputs anchor culling, and are left in their final usage
+		bool is_output = false;
+		VulkanResourceUsage final_usage = VulkanResourceUsage::None;
+
+		// Transient resources are created by the graph, and alias memory with other transients.
+		//	Their handles are only valid once the graph compiles.
+		int32_t transient_request = -1;
+		std::vector<uint32_t> alias_predecessors;
+
+		// Synchronization state, tracked during compilation
+		bool accessed = false;
+		VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkPipelineStageFlags2 write_stages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 write_access = VK_ACCESS_2_NONE;
+		VkPipelineStageFlags2 read_stages = VK_PIPELINE_STAGE_2_NONE;
+		VkPipelineStageFlags2 visible_stages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 visible_access = VK_ACCESS_2_NONE;
+	};
+
+	struct VulkanRenderGraphStats
+	{
+		uint32_t pass_count = 0;
+		uint32_t culled_pass_count = 0;
+		uint32_t barrier_batch_count = 0;
+		uint32_t image_barrier_count = 0;
+		uint32_t buffer_barrier_count = 0;
+	};
+
+	// Builds a frame's work as a list of passes, then records it with the minimal set of barriers.
+	//	The graph is rebuilt every frame, starting from Reset().
+	class VulkanRenderGraph
+	{
+	public:
+		static VulkanUsageInfo GetUsageInfo(const VulkanResourceUsage& usage);
+
+	public:
+		VulkanRenderGraph();
+		~VulkanRenderGraph();
+
+		// Clears all passes and resources
+		void Reset();
+
+		// Imports an externally owned image. Initial stages/access describe work the image must wait on (e.g. a semaphore wait stage).
+		uint32_t ImportImage(const std::string& name, const VkImage& image, const VkImageAspectFlags& aspect_flags, const VkImageLayout& initial_layout,
+			const VkPipelineStageFlags2& initial_stages = VK_PIPELINE_STAGE_2_NONE, const VkAccessFlags2& initial_access = VK_ACCESS_2_NONE);
+
+		// Imports an externally owned buffer range
+		uint32_t ImportBuffer(const std::string& name, const VkBuffer& buffer, const VkDeviceSize& offset = 0, const VkDeviceSize& size = VK_WHOLE_SIZE,
+			const VkPipelineStageFlags2& initial_stages = VK_PIPELINE_STAGE_2_NONE, const VkAccessFlags2& initial_access = VK_ACCESS_2_NONE);
+
+		// Creates an image that only lives for this frame, between its first and last use
+		uint32_t CreateImage(const std::string& name, const VulkanTransientImageInfo& image_info);
+
+		// Creates a buffer that only lives for this frame, between its first and last use
+		uint32_t CreateBuffer(const std::string& name, const VulkanTransientBufferInfo& buffer_info);
+
+		// Sets the pool transient resources are placed in. Required before compiling a graph with transient resources.
+		void SetTransientPool(VulkanTransientPool* transient_pool);
+
+		// Marks a resource as a result of the graph, transitioning it to final_usage after the last pass
+		void MarkOutput(const uint32_t& resource, const VulkanResourceUsage& final_usage = VulkanResourceUsage::None);
+
+		// CAUTION: The returned reference is valid until the graph is reset.
+		VulkanRenderGraphPass& AddPass(const std::string& name);
+
+		// Culls unused passes and computes the barriers between passes
+		void Compile();
+
+		// Records all live passes, with one merged barrier call before each pass that needs it.
+		//	If a profiler is provided, each pass is timed as its own scope.
+		void Execute(const VkCommandBuffer& cmd_buffer, VulkanProfiler* profiler = nullptr);
+
+		VulkanRenderGraphResource* GetResource(const uint32_t& resource);
+
+		const VulkanRenderGraphStats& GetStats();
+
+	private:
+		void Cull();
+		void RealizeTransients();
+		void BuildBarriers();
+
+		void AddAccess(VulkanRenderGraphResource& resource, const VulkanUsageInfo& usage,
+			std::vector<VkImageMemoryBarrier2>& image_barriers, std::vector<VkBufferMemoryBarrier2>& buffer_barriers);
+
+		void RecordBarriers(const VkCommandBuffer& cmd_buffer, const std::vector<VkImageMemoryBarrier2>& image_barriers, const std::vector<VkBufferMemoryBarrier2>& buffer_barriers);
+
+	private:
+		std::vector<VulkanRenderGraphResource> m_resources;
+		std::deque<VulkanRenderGraphPass> m_passes;
+		std::vector<VulkanTransientRequest> m_transient_requests;
+		VulkanTransientPool* m_transient_pool;
+		std::vector<VkImageMemoryBarrier2> m_final_image_barriers;
+		std::vector<VkBufferMemoryBarrier2> m_final_buffer_barriers;
+		VulkanRenderGraphStats m_stats;
+		bool m_compiled;
+	};
+}
\ No newline at end of file
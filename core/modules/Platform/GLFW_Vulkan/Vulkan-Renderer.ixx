@@ -2,7 +2,9 @@ module;
 
 #include <cstdint>
 #include <set>
+#include <string>
 #include <vector>
+#include <deque>
 #include <unordered_map>
 
 #include <vulkan/vulkan.h>
@@ -13,6 +15,9 @@ import Graphics;
 
 import :Device;
 import :Window;
+import :HeadlessTarget;
+import :ComputeScheduler;
+import :FramePacer;
 import :Pipeline;
 
 import :Command;
@@ -33,6 +38,10 @@ export
 
 		virtual void EndFrame() override;
 
+		// Paces the next frame: waits for the display in just-in-time latency mode, then for the frame limiter.
+		//	Call before polling input, so input is sampled as late as possible.
+		void PaceFrame();
+
 		virtual bool AddWindow(const Aurion::WindowHandle& handle) override;
 
 		virtual void SetWindowEnabled(const Aurion::WindowHandle& handle, bool enabled) override;
@@ -45,11 +54,29 @@ export
 
 		VulkanPipelineBuilder* GetPipelineBuilder();
 
-		// Binds a render command to the window for repeated calls. CAUTION: These will NOT be cleared each frame.
-		void BindCommand(const Aurion::WindowHandle& window_handle, const std::function<void(const VulkanCommand&)>& command);
+		// For resources created outside the renderer, such as terrain and virtual textures
+		VulkanDevice* GetLogicalDevice();
+
+		// Compute jobs that may span several frames. Windows wait on them through VulkanWindow::ConsumeCompute.
+		VulkanComputeScheduler* GetComputeScheduler();
+
+		// Records windows concurrently, each on its own worker. On by default.
+		//	CAUTION: Commands bound to different windows may then run at the same time.
+		void SetParallelWindowsEnabled(const bool& enabled);
+
+		// Frame rate limiting, latency mode and frame time statistics
+		VulkanFramePacer* GetFramePacer();
+
+		// Adds an offscreen target rendered every EndFrame, without a window or swapchain. Returns its id.
+		uint64_t AddHeadlessTarget(const VulkanHeadlessTargetConfig& config);
+		VulkanHeadlessTarget* GetHeadlessTarget(const uint64_t& target_id);
+		bool RemoveHeadlessTarget(const uint64_t& target_id);
+
+		// Binds a render command to the window for repeated calls. The name labels its GPU profiler scope. CAUTION: These will NOT be cleared each frame.
+		void BindCommand(const Aurion::WindowHandle& window_handle, const std::function<void(const VulkanCommand&)>& command, const std::string& name = "");
 
 		// Submits a render command for execution. Gets cleared every frame
-		void SubmitCommand(const Aurion::WindowHandle& window_handle, const std::function<void(const VulkanCommand&)>& command);
+		void SubmitCommand(const Aurion::WindowHandle& window_handle, const std::function<void(const VulkanCommand&)>& command, const std::string& name = "");
 
 		// Submits a render command for immediate execution outside of the primary render loop.
 		//void SubmitCommandImmediate();
@@ -57,9 +84,18 @@ export
 	private:
 		VulkanDevice m_logical_device;
 		VulkanPipelineBuilder m_pipeline_builder;
-		std::vector<VulkanPipeline> m_pipelines;
+		VulkanComputeScheduler m_compute_scheduler;
+		VulkanFramePacer m_frame_pacer;
+		std::deque<VulkanPipeline> m_pipelines;
 		std::unordered_map<uint64_t, VulkanWindow> m_windows;
 		std::set<uint64_t> m_windows_to_remove;
+		std::unordered_map<uint64_t, VulkanHeadlessTarget> m_headless_targets;
+		uint64_t m_next_headless_id;
 		uint32_t m_max_in_flight_frames;
+		bool m_parallel_windows;
+
+		// This frame's rendering windows, and their combined submissions
+		std::vector<VulkanWindow*> m_render_windows;
+		VulkanSubmitBatch m_submit_batch;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+module;
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+#include <shaderc/shaderc.hpp>
+
+export module Vulkan:ShaderCache;
+
+export
+{
+	// Resolves #include directives for shaderc. Relative includes resolve against the including file,
+	//	standard (<...>) includes resolve against the include root.
+	class VulkanShaderIncluder : public shaderc::CompileOptions::IncluderInterface
+	{
+	public:
+		VulkanShaderIncluder(const std::string& include_root);
+		virtual ~VulkanShaderIncluder() override;
+
+		virtual shaderc_include_result* GetInclude(const char* requested_source, shaderc_include_type type,
+			const char* requesting_source, size_t include_depth) override;
+
+		virtual void ReleaseInclude(shaderc_include_result* data) override;
+
+	private:
+		std::string m_include_root;
+	};
+
+	// Content-addressed SPIR-V cache, persisted as a single indexed archive.
+	//	Keys are hashes of the fully preprocessed source and every compile input that affects the binary.
+	class VulkanShaderCache
+	{
+	public:
+		static uint64_t Hash(const void* data, const size_t& size, const uint64_t& seed = 0xcbf29ce484222325ull);
+		static uint64_t Hash(const std::string& value, const uint64_t& seed = 0xcbf29ce484222325ull);
+
+	public:
+		VulkanShaderCache();
+		~VulkanShaderCache();
+
+		VulkanShaderCache(const VulkanShaderCache&) = delete;
+		VulkanShaderCache& operator=(const VulkanShaderCache&) = delete;
+
+		// Reads the whole archive in a single read and builds the in-memory index
+		void Load(const std::string& archive_path);
+
+		// Writes the archive back to disk, if anything changed since it was loaded.
+		//	When only usage changed, just the header and the touched generation stamps are rewritten.
+		void Save();
+
+		// Thread-safe lookup. Returns false on a cache miss.
+		bool Find(const uint64_t& key, std::vector<uint32_t>& out_spirv);
+
+		// Thread-safe insertion of a freshly compiled binary
+		void Store(const uint64_t& key, const std::vector<uint32_t>& spirv);
+
+		const std::string& GetArchivePath();
+
+	private:
+		// Patches the header and the generation stamps of entries used this session in place
+		void SaveStamps();
+
+	private:
+		struct Entry
+		{
+			std::vector<uint32_t> spirv;
+			uint32_t last_used_generation = 0;
+
+			// Position in the archive index on disk, or -1 if the entry hasn't been written yet
+			int64_t archive_slot = -1;
+		};
+
+	private:
+		std::mutex m_mutex;
+		std::string m_archive_path;
+		std::unordered_map<uint64_t, Entry> m_entries;
+		uint32_t m_generation;
+		bool m_dirty;
+		bool m_stamps_dirty;
+	};
+}
@@ -0,0 +1,55 @@
+module;
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <filesystem>
+#include <unordered_map>
+
+export module Vulkan:ShaderWatcher;
+
+export
+{
+	// Polls a shader directory on its own thread, and reports modified files through a callback.
+	//	The callback is invoked on the watcher thread.
+	class VulkanShaderWatcher
+	{
+	public:
+		using ChangeCallback = std::function<void(const std::vector<std::string>&)>;
+
+	public:
+		VulkanShaderWatcher();
+		~VulkanShaderWatcher();
+
+		VulkanShaderWatcher(const VulkanShaderWatcher&) = delete;
+		VulkanShaderWatcher& operator=(const VulkanShaderWatcher&) = delete;
+
+		void Start(const std::string& directory, const ChangeCallback& on_change, 
+			const std::chrono::milliseconds& poll_interval = std::chrono::milliseconds(250));
+
+		void Stop();
+
+		bool Running();
+
+	private:
+		void WatchLoop();
+
+		// Returns every file whose write time changed since the last scan
+		std::vector<std::string> Scan(const bool& report_new_files);
+
+	private:
+		std::string m_directory;
+		ChangeCallback m_on_change;
+		std::chrono::milliseconds m_poll_interval;
+		std::unordered_map<std::string, std::filesystem::file_time_type> m_write_times;
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_running;
+	};
+}
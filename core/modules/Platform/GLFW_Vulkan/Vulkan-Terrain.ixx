@@ -0,0 +1,263 @@
+module;
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+export module Vulkan:Terrain;
+
+import :Device;
+import :Image;
+import :Pipeline;
+import :TransientPool;
+import :Command;
+import :VirtualTexture;
+
+import Terrain;
+
+export
+{
+	struct VulkanTerrainConfig
+	{
+		uint32_t heightmap_size = 1025; // Texels per side. (heightmap_size - 1) must be a multiple of patch_texels.
+		uint32_t patch_texels = 32; // Heightmap texels spanned by a patch side
+		float world_size = 4096.0f; // Meters per side
+		float height_scale = 600.0f; // Meters at a normalized height of 1
+		float target_edge_pixels = 10.0f; // Projected length of a tessellated edge segment
+		float variance_weight = 1.0f; // Scales the height variance that earns a patch full tessellation
+		float max_tessellation = 64.0f; // Also capped at patch_texels, past which the heightmap holds no more detail
+		VkFormat color_format = VK_FORMAT_B8G8R8A8_UNORM;
+		VkFormat depth_format = VK_FORMAT_D32_SFLOAT;
+		bool mesh_shading = true; // Used when the device supports VK_EXT_mesh_shader and patch_texels is 8, 16 or 32
+		bool occlusion_culling = true; // Mesh shading only
+		bool lod_traversal = true; // Without mesh shading, selects quadtree nodes on the compute queue instead of drawing every patch
+		float lod_morph_start = 0.7f; // Fraction of a node's range it covers before morphing into its parent
+		uint32_t detail_pages_per_side = 256; // Ground detail virtual texture, a power of two of at most 1024
+		bool generate_heights = true; // Off, heights start flat until UpdateHeights fills them in
+		TerrainNoiseConfig noise{};
+	};
+
+	// Push constants shared by every terrain shader stage. Matches assets/shaders/terrain-common.glsl.
+	struct VulkanTerrainConstants
+	{
+		float view_projection[16];
+		float camera[4]; // Position, projection scale
+		float viewport[4]; // Render extent, target edge pixels, max tessellation
+		float terrain[4]; // World size, height scale, patches per side, variance weight
+		uint32_t detail[4]; // Detail region, page size, page border, feedback extent (width | height << 16)
+	};
+
+	// Uniforms for the task shader's occlusion test. Matches assets/shaders/terrain-mesh.glsl.
+	struct VulkanTerrainCulling
+	{
+		float previous_view_projection[16];
+		float hiz[4]; // Previous render extent, pyramid levels, 1 when the pyramid holds a previous frame
+	};
+
+	// Push constants of assets/shaders/terrain-lod.comp
+	struct VulkanTerrainLodConstants
+	{
+		float view_projection[16];
+		float camera[4]; // Position, range of a node in node sizes
+		float terrain[4]; // World size, height scale, leaf level, morph start
+		uint32_t traversal[4]; // Level, queue capacity
+	};
+
+	// Quadtree traversal state for a single frame in flight. Written on the compute queue, drawn on graphics.
+	struct VulkanTerrainLodFrame
+	{
+		VkBuffer queue_buffer = VK_NULL_HANDLE; // Nodes to visit, two levels' worth
+		VmaAllocation queue_allocation = VK_NULL_HANDLE;
+		VkBuffer counter_buffer = VK_NULL_HANDLE; // Per level indirect dispatch and node count
+		VmaAllocation counter_allocation = VK_NULL_HANDLE;
+		VkBuffer selected_buffer = VK_NULL_HANDLE; // Selected nodes, with their morph ranges
+		VmaAllocation selected_allocation = VK_NULL_HANDLE;
+		VkBuffer draw_buffer = VK_NULL_HANDLE; // VkDrawIndirectCommand
+		VmaAllocation draw_allocation = VK_NULL_HANDLE;
+		VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+		VkDescriptorSet traversal_set = VK_NULL_HANDLE;
+		VkDescriptorSet draw_set = VK_NULL_HANDLE;
+	};
+
+	// Upload source, released once the frame that copied from it completes
+	struct VulkanTerrainStaging
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		uint64_t graphics_timeline_value = 0; // 0 until the uploading frame's value is known
+	};
+
+	// Hi-Z pyramid, sized to the depth images it reduces. The pyramid is read by the next frame's occlusion test, so
+	//	unlike depth it outlives the frame. Replaced targets wait on the graphics timeline value that frees them.
+	struct VulkanTerrainTarget
+	{
+		VkExtent3D extent{}; // Depth extent the pyramid was sized for
+		VulkanImage hiz{}; // R32_SFLOAT max depth, half the depth extent, with a full mip chain
+		std::vector<VkImageView> hiz_views; // One per level, written by the reduction
+		VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+		std::vector<VkDescriptorSet> reduce_sets; // One per level after the first, reading the level before
+		VkDescriptorSet mesh_set = VK_NULL_HANDLE; // Mesh pipeline resources, sampling this target's pyramid
+		uint64_t graphics_timeline_value = 0;
+	};
+
+	// The reduction into Hi-Z level 0 for a single frame in flight, reading the depth image that frame was given
+	struct VulkanTerrainDepthFrame
+	{
+		VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+		VkDescriptorSet reduce_set = VK_NULL_HANDLE;
+		VkImageView depth_view = VK_NULL_HANDLE; // Views the set was last written with
+		VkImageView hiz_view = VK_NULL_HANDLE;
+	};
+
+	// Draws the terrain as a fixed grid of coarse patches, refined on the GPU. No vertex or index buffers exist;
+	//	CPU and vertex memory stay the same at any view distance.
+	//
+	//	With VK_EXT_mesh_shader, each patch is a task workgroup that picks a level from the patch's projected texel
+	//	spacing and height variance, then culls the patch's 8x8 quad meshlets at that level by frustum, normal cone,
+	//	and last frame's Hi-Z depth pyramid. Mesh workgroups emit the surviving meshlets straight from heightmap
+	//	texels, stitching edges shared with coarser patches. Occlusion is tested against the previous frame, so
+	//	geometry uncovered by a sudden camera move may appear a frame late.
+	//
+	//	Otherwise a compute pass on the frame's compute queue walks a quadtree over the patches, a level per dispatch,
+	//	culling nodes by their height bounds and splitting those within their children's range. Selected nodes go
+	//	into an indirect draw as equal tessellated grids, each vertex morphing into the parent's grid toward the end
+	//	of its node's range, so nodes of neighboring levels meet without cracks. Ranges double per level and are
+	//	sized to keep grid cells near the target edge length on screen; height variance isn't considered.
+	//
+	//	Failing that, patches are refined by hardware tessellation. Control shaders pick edge factors from each edge's
+	//	projected length and the height variance of the patches sharing it, and cull patches outside the frustum.
+	//	Evaluation shaders displace vertices from the heightmap.
+	//
+	//	Every path shades with terrain.frag, which scales the slope and height albedo by a ground detail layer streamed
+	//	through a VulkanVirtualTexture. Detail pages are fractal color variation over world position, produced and
+	//	block compressed on the job system, so they never go stale when heights change.
+	class VulkanTerrain
+	{
+	public:
+		VulkanTerrain();
+		~VulkanTerrain();
+
+		// Generates the heightmap unless config.generate_heights is off, then patch bounds and meshlets, on the job
+		//	system. Builds the terrain pipelines with the builder, and creates the GPU resources. Data is uploaded with
+		//	the first recorded frame.
+		//	Quadtree traversal needs a power of two patches per side, and patches of at most 64 texels.
+		bool Initialize(VulkanDevice* logical_device, VulkanPipelineBuilder& builder, const VulkanTerrainConfig& config = {});
+
+		// Waits for frames that may use the terrain, then releases every resource
+		void Destroy();
+
+		// Depth image Record draws with, for declaring as a command image written as VulkanResourceUsage::DepthAttachmentWrite.
+		//	Sized with the frame image. Without occlusion culling nothing reads it back, so it's lazily allocated.
+		VulkanTransientImageInfo GetDepthImageInfo();
+
+		// Draws into the command's render image, depth tested against depth, which must be at least the render extent and
+		//	match GetDepthImageInfo. Depth is cleared first. Commands recorded earlier in the frame are drawn over.
+		void Record(const VulkanCommand& command, const VulkanImage& depth, const TerrainCamera& camera);
+
+		// Overwrites a region of the heightmap with width by height normalized heights in row-major order. Only the
+		//	patches it touches are re-uploaded, with the next recorded frame. Meshlets are recomputed in full.
+		void UpdateHeights(const uint32_t& x, const uint32_t& y, const uint32_t& width, const uint32_t& height, const float* heights);
+
+		const TerrainHeightmap& GetHeightmap();
+		const std::vector<TerrainPatchBounds>& GetPatchBounds();
+		const VulkanTerrainConfig& GetConfig();
+		uint32_t GetPatchesPerSide();
+
+		// Whether the terrain is drawn by task and mesh shaders rather than tessellation
+		bool IsMeshShading();
+
+		// Whether patches are selected by the quadtree traversal
+		bool IsLodTraversal();
+
+	private:
+		static void ConfigureTessellationPipeline(VulkanPipelineBuilder& builder, const VulkanTerrainConfig& config);
+		static void ConfigureMeshPipeline(VulkanPipelineBuilder& builder, const VulkanTerrainConfig& config);
+		static void ConfigureHiZPipeline(VulkanPipelineBuilder& builder);
+		static void ConfigureLodPipeline(VulkanPipelineBuilder& builder, const VulkanTerrainConfig& config);
+		static void ConfigureTraversalPipeline(VulkanPipelineBuilder& builder);
+
+		bool InitializeMeshShading(VulkanPipelineBuilder& builder);
+		bool InitializeLodTraversal(VulkanPipelineBuilder& builder);
+		bool InitializeDetail();
+		void BuildMeshlets();
+		void BuildNodeBounds();
+		bool CreateBuffer(const VkDeviceSize& size, const VkBufferUsageFlags& usage, VkBuffer& buffer, VmaAllocation& allocation, const bool& shared = false);
+		VulkanTerrainStaging* CreateStaging(const VkDeviceSize& size, uint8_t*& mapped);
+
+		bool RecordUploads(const VulkanCommand& command);
+		void RecordTileUploads(const VulkanCommand& command);
+		void FinishHeightmapUpload(const VkCommandBuffer& cmd_buffer, const VkPipelineStageFlags2& sampling_stages);
+		void RecordCulling(const VkCommandBuffer& cmd_buffer, const float* view_projection);
+		void RecordTraversal(const VulkanCommand& command, const VulkanTerrainLodFrame& frame, const VulkanTerrainConstants& constants);
+		void RecordHiZ(const VkCommandBuffer& cmd_buffer, const VulkanImage& depth, const VkDescriptorSet& depth_set, const VkExtent2D& extent);
+
+		VulkanTerrainLodFrame* PrepareLodFrame(const size_t& frame_index);
+		bool CreateLodFrame(VulkanTerrainLodFrame& frame);
+		void DestroyLodFrame(VulkanTerrainLodFrame& frame);
+
+		bool PrepareTarget(const VkExtent3D& extent);
+		bool CreateHiZ(VulkanTerrainTarget& target);
+		VkDescriptorSet PrepareDepthFrame(const size_t& frame_index, const VulkanImage& depth);
+		void ReleaseRetired();
+		VkDescriptorSet PrepareDetailSet();
+
+		void DestroyTarget(VulkanTerrainTarget& target);
+		void DestroyImage(VulkanImage& image);
+
+	private:
+		VulkanDevice* m_logical_device;
+		VulkanPipeline* m_pipeline; // Tessellation
+		VulkanPipeline* m_mesh_pipeline; // Null when mesh shading is unavailable
+		VulkanPipeline* m_hiz_pipeline; // Null without occlusion culling
+		VulkanPipeline* m_lod_pipeline; // Null unless patches are selected by the quadtree traversal
+		VulkanPipeline* m_traversal_pipeline;
+		VulkanTerrainConfig m_config;
+		uint32_t m_patches_per_side;
+
+		TerrainHeightmap m_heightmap;
+		std::vector<TerrainPatchBounds> m_patch_bounds;
+		std::vector<TerrainMeshlet> m_meshlets; // Every level, finest first
+		std::vector<TerrainPatchBounds> m_node_bounds; // Every quadtree level, root first, each in row-major order
+		uint32_t m_leaf_level;
+
+		VulkanImage m_heightmap_image;
+		VkBuffer m_patch_buffer;
+		VmaAllocation m_patch_allocation;
+		VkBuffer m_meshlet_buffer;
+		VmaAllocation m_meshlet_allocation;
+		VkBuffer m_culling_buffer;
+		VmaAllocation m_culling_allocation;
+		VkBuffer m_node_buffer;
+		VmaAllocation m_node_allocation;
+		std::vector<VulkanTerrainLodFrame> m_lod_frames; // Indexed by the command's frame
+
+		VkDescriptorPool m_descriptor_pool;
+		VkDescriptorSet m_descriptor_set;
+
+		// Ground detail, bound as set 1 by every graphics pipeline
+		VulkanVirtualTexture m_detail;
+		uint32_t m_detail_region;
+		VkDescriptorPool m_detail_pool;
+		std::vector<VkDescriptorSet> m_detail_sets; // One per virtual texture frame, written on first use
+		std::vector<VkBuffer> m_detail_feedback; // Feedback buffer each set was written with
+
+		std::vector<VulkanTerrainStaging> m_staging;
+		bool m_uploaded;
+
+		// Patches whose heights changed since they were last uploaded
+		std::vector<uint32_t> m_dirty_patches;
+		std::vector<uint8_t> m_patch_dirty;
+
+		// Sized to the largest depth extent seen
+		VulkanTerrainTarget m_target;
+		std::vector<VulkanTerrainTarget> m_retired_targets;
+		std::vector<VulkanTerrainDepthFrame> m_depth_frames; // Indexed by the command's frame
+
+		// The last recorded frame, which the current one's occlusion test reprojects into
+		float m_previous_view_projection[16];
+		VkExtent2D m_previous_extent;
+		bool m_hiz_valid;
+	};
+}
\ No newline at end of file
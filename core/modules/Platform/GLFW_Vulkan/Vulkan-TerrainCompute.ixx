@@ -0,0 +1,134 @@
+module;
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+export module Vulkan:TerrainCompute;
+
+import :Device;
+import :Image;
+import :Pipeline;
+import :ComputeScheduler;
+
+import Terrain;
+
+export
+{
+	struct VulkanTerrainComputeConfig
+	{
+		uint32_t tile_texels = 257; // Texels per tile side. Neighboring tiles share their edge texels.
+		uint32_t ring_size = 8; // Tiles in flight at once, each with its own storage image and readback buffer
+		float tolerance = 1e-4f; // Largest normalized height difference from the CPU generator that still agrees
+		TerrainNoiseConfig noise{};
+	};
+
+	// Push constants of assets/shaders/terrain-noise.comp
+	struct VulkanTerrainNoiseConstants
+	{
+		int32_t origin[2];
+		uint32_t size;
+		uint32_t seed;
+		uint32_t octaves;
+		float frequency;
+		float lacunarity;
+		float gain;
+		float exponent;
+	};
+
+	// A tile of the terrain's noise domain. Tile (x, y) starts at texel (x, y) * (tile_texels - 1).
+	struct VulkanTerrainTile
+	{
+		int32_t x = 0;
+		int32_t y = 0;
+	};
+
+	// Receives a finished tile's tile_texels squared normalized heights, in row-major order. The heights are only
+	//	valid for the duration of the call.
+	using VulkanTerrainTileConsumer = std::function<void(const VulkanTerrainTile& tile, const float* heights, const uint32_t& tile_texels)>;
+
+	// A tile's storage image and the host buffer it is read back through
+	struct VulkanTerrainTileSlot
+	{
+		VulkanImage image{};
+		VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+		VkBuffer readback_buffer = VK_NULL_HANDLE;
+		VmaAllocation readback_allocation = VK_NULL_HANDLE;
+		const float* readback = nullptr;
+		VulkanTerrainTile tile{};
+		VulkanComputeTicket ticket{};
+	};
+
+	struct VulkanTerrainComputeBenchmark
+	{
+		uint32_t tiles = 0;
+		uint32_t tile_texels = 0;
+		double gpu_tiles_per_second = 0.0; // Including readback
+		double cpu_tiles_per_second = 0.0; // Across the job system
+		float max_error = 0.0f; // Largest difference between the GPU and CPU heights
+		bool agrees = false; // max_error is within the configured tolerance
+	};
+
+	// Generates heightmap tiles on the compute queue. Each tile evaluates the terrain noise into a storage image,
+	//	which is copied into a mapped host buffer in the same job. Tiles cycle through a fixed ring of slots, and
+	//	finished ones are handed out in request order without waiting on the GPU, so physics and caching can
+	//	consume them as they arrive. The shader is a direct port of TerrainNoise, which the CPU generator uses.
+	//	All calls must come from the thread that renders.
+	class VulkanTerrainCompute
+	{
+	public:
+		VulkanTerrainCompute();
+		~VulkanTerrainCompute();
+
+		// Builds the noise pipeline with the builder, and creates the ring
+		bool Initialize(VulkanDevice* logical_device, VulkanComputeScheduler* scheduler, VulkanPipelineBuilder& builder, const VulkanTerrainComputeConfig& config = {});
+
+		// Waits for tiles in flight, then releases every resource. Unclaimed tiles are dropped.
+		void Destroy();
+
+		// Submits a tile. Returns false when every slot of the ring is still in flight.
+		bool Request(const VulkanTerrainTile& tile);
+
+		// Hands every finished tile to the consumer, oldest first, and frees its slot. Never waits on the GPU.
+		//	Returns the number of tiles handed out.
+		uint32_t Collect(const VulkanTerrainTileConsumer& consumer);
+
+		// Blocks until every requested tile has finished. Collect still hands them out.
+		void WaitIdle();
+
+		// Generates a tile on the GPU and compares it with the CPU generator, blocking until both finish.
+		//	Returns the largest height difference, or a negative value if the tile couldn't be generated.
+		float Validate(const VulkanTerrainTile& tile);
+
+		// Generates tile_count tiles on each generator, and compares their throughput and heights.
+		//	Blocks, and expects no other requests in flight.
+		VulkanTerrainComputeBenchmark Benchmark(const uint32_t& tile_count = 64);
+
+		// Benchmarks, then logs the results
+		void RunBenchmark(const uint32_t& tile_count = 64);
+
+		size_t GetPendingCount();
+		const VulkanTerrainComputeConfig& GetConfig();
+
+	private:
+		void GenerateOnCPU(const VulkanTerrainTile& tile, TerrainHeightmap& heightmap);
+
+		bool CreateSlot(VulkanTerrainTileSlot& slot);
+		void DestroySlot(VulkanTerrainTileSlot& slot);
+
+	private:
+		VulkanDevice* m_logical_device;
+		VulkanComputeScheduler* m_scheduler;
+		VulkanPipeline* m_pipeline;
+		VulkanTerrainComputeConfig m_config;
+
+		VkDescriptorPool m_descriptor_pool;
+		std::vector<VulkanTerrainTileSlot> m_slots;
+		std::vector<uint32_t> m_free_slots;
+		std::deque<uint32_t> m_in_flight; // In request order
+	};
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+module;
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+export module Vulkan:TerrainErosion;
+
+import :Device;
+import :Image;
+import :Pipeline;
+import :ComputeScheduler;
+
+import Terrain;
+
+export
+{
+	// Every cell holds 72 bytes of simulation state, so a 2049 texel map needs about 300MB, and a 4097 texel map 1.2GB
+	struct VulkanTerrainErosionConfig
+	{
+		uint32_t iterations_per_frame = 8; // Recorded into a single compute job
+		uint32_t batches_in_flight = 2; // Jobs queued behind each other, so the compute queue never idles between frames
+		float time_step = 0.02f; // Seconds per iteration
+		float cell_size = 1.0f; // Meters between texels
+		float height_scale = 128.0f; // Meters per unit of normalized height
+		float gravity = 9.81f;
+		float pipe_area = 1.0f; // Cross section of the pipes between cells, in square meters
+		float rain_rate = 0.012f; // Meters of water per second, on every cell
+		float sediment_capacity = 1.0f; // Sediment carried per unit of water speed and tilt
+		float dissolving = 0.5f; // Rate at which water below its capacity erodes the terrain
+		float deposition = 1.0f; // Rate at which water above its capacity deposits sediment
+		float evaporation = 0.015f; // Fraction of the water lost per second
+		float min_tilt = 0.05f; // Lets water over flat ground still carry sediment
+	};
+
+	// Push constants shared by every pass, declared in assets/shaders/terrain-erosion.glsl
+	struct VulkanTerrainErosionConstants
+	{
+		float time_step;
+		float cell_size;
+		float gravity;
+		float pipe_area;
+		float rain_rate;
+		float sediment_capacity;
+		float dissolving;
+		float deposition;
+		float evaporation;
+		float min_tilt;
+		uint32_t size;
+		uint32_t iteration;
+	};
+
+	struct VulkanTerrainErosionBatch
+	{
+		VulkanComputeTicket ticket{};
+		uint32_t iterations = 0;
+		std::chrono::high_resolution_clock::time_point submitted{};
+	};
+
+	struct VulkanTerrainErosionStats
+	{
+		uint64_t iterations_submitted = 0;
+		uint64_t iterations_completed = 0;
+		double iterations_per_second = 0.0; // Completed over the last second
+		double cell_updates_per_second = 0.0; // Iterations per second times cells
+		double batch_milliseconds = 0.0; // From the last completed batch's submission until its completion was seen
+		uint32_t batches_in_flight = 0;
+	};
+
+	// Receives size squared normalized terrain heights in row-major order, only valid for the duration of the call
+	using VulkanTerrainErosionConsumer = std::function<void(const float* heights, const uint32_t& size)>;
+
+	// Erodes a heightmap on the compute queue with the virtual pipe model: rain falls on every cell, flows
+	//	through pipes to its neighbors, dissolves terrain where it runs fast over steep ground, carries the
+	//	sediment along and deposits it where it slows, then evaporates. Each iteration is five passes over
+	//	double-buffered storage images, and Update submits a batch of them each frame without waiting on the GPU,
+	//	so long simulations are amortized across frames while graphics keeps presenting.
+	//	All calls must come from the thread that renders.
+	class VulkanTerrainErosion
+	{
+	public:
+		static constexpr uint32_t c_pass_count = 5;
+
+	public:
+		VulkanTerrainErosion();
+		~VulkanTerrainErosion();
+
+		// Builds the pass pipelines with the builder, creates the simulation state and uploads the heightmap
+		bool Initialize(VulkanDevice* logical_device, VulkanComputeScheduler* scheduler, VulkanPipelineBuilder& builder, const TerrainHeightmap& heightmap,
+			const VulkanTerrainErosionConfig& config = {});
+
+		// Waits for batches in flight, then releases every resource
+		void Destroy();
+
+		// Restarts the simulation from the heightmap, which must match the initialized size. Waits for batches in flight.
+		bool Reset(const TerrainHeightmap& heightmap);
+
+		// Collects finished batches, updates the stats, and tops up the batches in flight while running.
+		//	Never waits on the GPU. Call once per frame.
+		void Update();
+
+		// Batches already submitted still complete after pausing
+		void SetRunning(const bool& running);
+		bool IsRunning();
+
+		// Changes take effect from the next batch
+		void SetConfig(const VulkanTerrainErosionConfig& config);
+		const VulkanTerrainErosionConfig& GetConfig();
+
+		// Blocks until every submitted batch has finished
+		void WaitIdle();
+
+		// Copies the terrain height out of the state once the last submitted batch finishes. Returns false while an
+		//	earlier readback is still unclaimed.
+		bool RequestReadback();
+
+		// Hands a finished readback's heights to the consumer, divided by the height scale. Never waits on the GPU.
+		//	Returns whether one was handed out.
+		bool CollectReadback(const VulkanTerrainErosionConsumer& consumer);
+
+		// Terrain height, water depth and suspended sediment in meters, in VK_IMAGE_LAYOUT_GENERAL. Every batch leaves
+		//	its results here, so graphics may only sample it while paused, after consuming GetTicket. RequestReadback
+		//	copies it out for the CPU in the meantime.
+		const VulkanImage& GetState();
+
+		// The last submitted work, which the state is complete after
+		const VulkanComputeTicket& GetTicket();
+
+		uint32_t GetSize();
+		const VulkanTerrainErosionStats& GetStats();
+
+	private:
+		void CollectBatches();
+		bool Upload(const TerrainHeightmap& heightmap);
+		bool SubmitBatch();
+		void ReleaseStaging();
+		bool CreateReadback();
+
+		bool CreateImage(VulkanImage& image, const VkFormat& format, const VkImageUsageFlags& usage);
+		void DestroyImage(VulkanImage& image);
+
+	private:
+		VulkanDevice* m_logical_device;
+		VulkanComputeScheduler* m_scheduler;
+		std::array<VulkanPipeline*, c_pass_count> m_pipelines; // In dispatch order
+		VulkanTerrainErosionConfig m_config;
+		uint32_t m_size;
+
+		std::array<VulkanImage, 2> m_states; // A holds every batch's results, B the passes in between
+		std::array<VulkanImage, 2> m_flux; // Swapped every iteration
+		VulkanImage m_velocity;
+
+		VkDescriptorPool m_descriptor_pool;
+		std::array<VkDescriptorSet, 2> m_descriptor_sets; // Reading flux A or B from the previous iteration
+
+		// Initial state, released once its upload completes
+		VkBuffer m_staging_buffer;
+		VmaAllocation m_staging_allocation;
+		VulkanComputeTicket m_upload_ticket;
+
+		// Terrain height for the CPU, created with the first request
+		VkBuffer m_readback_buffer;
+		VmaAllocation m_readback_allocation;
+		const float* m_readback; // Every channel of the state
+		std::vector<float> m_readback_heights; // Normalized, handed to the consumer
+		VulkanComputeTicket m_readback_ticket; // Unclaimed readback, 0 if there is none
+
+		std::deque<VulkanTerrainErosionBatch> m_batches; // In submission order
+		VulkanComputeTicket m_ticket;
+		bool m_running;
+
+		VulkanTerrainErosionStats m_stats;
+		std::chrono::high_resolution_clock::time_point m_window_start;
+		uint64_t m_window_iterations;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+module;
+
+#include <cstdint>
+#include <limits>
+
+#include <vulkan/vulkan.h>
+
+export module Vulkan:Timeline;
+
+export
+{
+	// A timeline semaphore, along with the last value reserved for signaling on it.
+	//	One exists per queue; submissions signal strictly increasing values.
+	struct VulkanTimeline
+	{
+		static VulkanTimeline Create(const VkDevice& logical_device, const uint64_t& initial_value = 0);
+		static void Destroy(const VkDevice& logical_device, VulkanTimeline& timeline);
+
+		// Reserves the next value to be signaled by a submission on this timeline
+		uint64_t Next();
+
+		// Blocks until the timeline reaches the given value
+		bool Wait(const VkDevice& logical_device, const uint64_t& value, const uint64_t& timeout = std::numeric_limits<uint64_t>::max()) const;
+
+		// Non-blocking check of whether the timeline reached the given value
+		bool Reached(const VkDevice& logical_device, const uint64_t& value) const;
+
+		// Builds a submit info that waits on, or signals, the given value
+		VkSemaphoreSubmitInfo SubmitInfo(const uint64_t& value, const VkPipelineStageFlags2& stage_mask) const;
+
+		VkSemaphore handle = VK_NULL_HANDLE;
+		uint64_t value = 0;
+	};
+}
@@ -0,0 +1,93 @@
+module;
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+export module Vulkan:TransientPool;
+
+export
+{
+	struct VulkanTransientImageInfo
+	{
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		VkExtent3D extent{};
+		VkImageUsageFlags usage_flags = 0;
+		VkImageAspectFlags aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+
+		// Attachments that never leave tile memory. Backed by lazily allocated memory where the device supports it.
+		bool lazily_allocated = false;
+	};
+
+	struct VulkanTransientBufferInfo
+	{
+		VkDeviceSize size = 0;
+		VkBufferUsageFlags usage_flags = 0;
+	};
+
+	// A transient resource, alive from its first to its last pass (inclusive)
+	struct VulkanTransientRequest
+	{
+		bool is_image = true;
+		VulkanTransientImageInfo image_info{};
+		VulkanTransientBufferInfo buffer_info{};
+		uint32_t first_pass = 0;
+		uint32_t last_pass = 0;
+	};
+
+	struct VulkanTransientResource
+	{
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		VkBuffer buffer = VK_NULL_HANDLE;
+
+		// Dedicated lazily allocated memory, if any. Aliased resources share the pool's allocations.
+		VmaAllocation lazy_allocation = VK_NULL_HANDLE;
+
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+
+		// Requests that previously occupied this resource's memory. Its first use must wait on their last.
+		std::vector<uint32_t> alias_predecessors;
+	};
+
+	struct VulkanTransientPoolStats
+	{
+		VkDeviceSize requested_bytes = 0; // Memory required without aliasing
+		VkDeviceSize aliased_bytes = 0; // Memory actually bound to aliased resources
+		VkDeviceSize lazy_bytes = 0; // Memory requested for lazily allocated attachments
+	};
+
+	// Owns the memory for one frame's transient resources. Resources whose lifetimes don't overlap
+	//	are placed at the same offsets of a shared allocation. Placements are cached, and only rebuilt
+	//	when the requests change. A pool must only be realized once its frame's previous work completed.
+	struct VulkanTransientPool
+	{
+		static VkImageCreateInfo MakeImageCreateInfo(const VulkanTransientImageInfo& info);
+		static VkBufferCreateInfo MakeBufferCreateInfo(const VulkanTransientBufferInfo& info);
+		static bool RequestsMatch(const VulkanTransientRequest& a, const VulkanTransientRequest& b);
+
+		void Initialize(const VkDevice& logical_device, const VmaAllocator& allocator);
+		void Destroy();
+
+		bool Realize(const std::vector<VulkanTransientRequest>& requests);
+
+		const VulkanTransientResource& GetResource(const size_t& request_index) const;
+
+		VkDevice logical_device = VK_NULL_HANDLE;
+		VmaAllocator allocator = VK_NULL_HANDLE;
+
+		std::vector<VulkanTransientRequest> requests;
+		std::vector<VulkanTransientResource> resources;
+
+		// Images and buffers are kept apart, to avoid buffer/image granularity conflicts
+		VmaAllocation image_memory = VK_NULL_HANDLE;
+		VkDeviceSize image_memory_size = 0;
+		VmaAllocation buffer_memory = VK_NULL_HANDLE;
+		VkDeviceSize buffer_memory_size = 0;
+
+		VulkanTransientPoolStats stats{};
+	};
+}
\ No newline at end of file
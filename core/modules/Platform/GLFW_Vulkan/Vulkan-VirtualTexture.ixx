@@ -0,0 +1,204 @@
+module;
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <future>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+export module Vulkan:VirtualTexture;
+
+import :Device;
+import :Image;
+
+import Texture;
+
+export
+{
+	struct VulkanVirtualTextureConfig
+	{
+		VkFormat format = VK_FORMAT_R8G8B8A8_UNORM; // BC1, BC4, BC5 and BC7 formats are block compressed on the producing worker
+		BCQuality compression_quality = BCQuality::Fast;
+		uint32_t page_size = 128; // Texels per page side, borders included
+		uint32_t page_border = 4; // Texels on each side duplicated from neighbouring pages, for filtering
+		uint32_t cache_pages_per_side = 32; // The physical cache holds this many pages squared
+		VkExtent2D feedback_extent = { 240, 135 }; // Resolution of the feedback pass
+		VkDeviceSize staging_size = 16 * 1024 * 1024; // Upload ring, shared by page texels and indirection updates
+		uint32_t max_uploads_per_frame = 32;
+		uint32_t max_pending_pages = 64; // Pages being produced on the job system at once
+		uint32_t frames_in_flight = 3;
+	};
+
+	// A page of a region's virtual texture. Level 0 is the finest.
+	struct VulkanVirtualPage
+	{
+		uint32_t region = 0;
+		uint32_t mip = 0;
+		uint32_t x = 0;
+		uint32_t y = 0;
+	};
+
+	// Fills a page's texels, page_size squared in the cache format (RGBA8 for block compressed caches), borders included.
+	//	Runs on job system workers.
+	using VulkanVirtualPageProducer = std::function<void(const VulkanVirtualPage& page, uint8_t* texels, const uint32_t& page_size)>;
+
+	struct VulkanVirtualTextureRegionInfo
+	{
+		uint32_t pages_per_side = 256; // Power of two, at most 1024
+		VulkanVirtualPageProducer producer;
+	};
+
+	struct VulkanVirtualTextureRegion
+	{
+		uint32_t pages_per_side = 0;
+		uint32_t mip_levels = 0;
+		VulkanVirtualPageProducer producer;
+		VulkanImage indirection{}; // One texel per page per level: cache page x, cache page y, mip, resident
+		bool initialized = false; // Indirection cleared on the GPU
+		bool active = false;
+	};
+
+	struct VulkanVirtualCacheSlot
+	{
+		uint32_t page_id = UINT32_MAX;
+		uint64_t last_used = 0;
+		bool pinned = false; // Coarsest level of a region, so every lookup finds a fallback
+	};
+
+	struct VulkanVirtualPageJob
+	{
+		uint32_t page_id = UINT32_MAX;
+		std::unique_ptr<uint8_t[]> texels;
+		std::future<void> done;
+	};
+
+	// Feedback buffers for a single frame in flight
+	struct VulkanVirtualTextureFrame
+	{
+		VkBuffer feedback_buffer = VK_NULL_HANDLE;
+		VmaAllocation feedback_allocation = VK_NULL_HANDLE;
+		VkBuffer readback_buffer = VK_NULL_HANDLE;
+		VmaAllocation readback_allocation = VK_NULL_HANDLE;
+		const uint32_t* readback = nullptr;
+		uint64_t graphics_timeline_value = 0; // Work recorded with this frame has completed once reached
+		bool feedback_recorded = false;
+	};
+
+	struct VulkanVirtualTextureStats
+	{
+		uint32_t resident_pages = 0;
+		uint32_t pending_pages = 0;
+		uint32_t ready_pages = 0; // Produced, waiting for upload
+		uint32_t requested_pages = 0; // Unique pages in the last feedback read
+		uint32_t uploads = 0; // Last frame
+		uint32_t evictions = 0; // Last frame
+	};
+
+	// Streams detail texturing for regions far too large to keep resident. A fixed physical page cache holds
+	//	the pages in use; each region's indirection texture maps its virtual pages into the cache. A low resolution
+	//	feedback pass writes the pages it needs into a buffer, which is read back once its frame completes, so
+	//	requests never stall the GPU. Pages are produced on the job system and uploaded through a staging ring.
+	//	Shaders sample through assets/shaders/virtual-texture.glsl, which falls back to coarser resident levels.
+	//	All calls must come from the thread that records the frame.
+	class VulkanVirtualTexture
+	{
+	public:
+		static constexpr uint32_t c_empty_feedback = UINT32_MAX;
+		static constexpr uint32_t c_max_regions = 255;
+
+		// Packing shared with virtual-texture.glsl: region (8 bits), mip (4), x (10), y (10)
+		static uint32_t PackPage(const VulkanVirtualPage& page);
+		static VulkanVirtualPage UnpackPage(const uint32_t& page_id);
+
+	public:
+		VulkanVirtualTexture();
+		~VulkanVirtualTexture();
+
+		bool Initialize(VulkanDevice* logical_device, const VulkanVirtualTextureConfig& config = {});
+
+		// Waits for outstanding page jobs and GPU work, then releases every resource
+		void Destroy();
+
+		// Adds a region with its own indirection texture. Returns its index, or c_max_regions on failure.
+		//	The region's coarsest page is requested immediately, and stays resident.
+		uint32_t AddRegion(const VulkanVirtualTextureRegionInfo& info);
+		void RemoveRegion(const uint32_t& region);
+
+		// Reads back completed feedback, schedules page production and collects finished pages.
+		//	Call once per frame, after the previous frame was submitted and before recording uploads.
+		void BeginFrame();
+
+		// Records this frame's page and indirection uploads, and clears this frame's feedback buffer.
+		//	Call on the graphics command buffer before any pass samples the texture or writes feedback.
+		void RecordUploads(const VkCommandBuffer& cmd_buffer);
+
+		// Copies this frame's feedback for reading back. Call once the feedback pass has been recorded.
+		void RecordFeedbackReadback(const VkCommandBuffer& cmd_buffer);
+
+		// This frame's feedback storage buffer: feedback_extent texels of packed page ids, c_empty_feedback where nothing was drawn
+		VkBuffer GetFeedbackBuffer();
+		const VkExtent2D& GetFeedbackExtent();
+
+		// Which of the frames_in_flight feedback buffers this frame writes. Advances with BeginFrame.
+		size_t GetFrameIndex();
+
+		const VulkanImage& GetCache();
+		const VulkanImage* GetIndirection(const uint32_t& region);
+
+		const VulkanVirtualTextureConfig& GetConfig();
+		const VulkanVirtualTextureStats& GetStats();
+
+	private:
+		void ReadFeedback(VulkanVirtualTextureFrame& frame);
+		void RequestPage(const uint32_t& page_id);
+		void CollectJobs();
+
+		uint32_t AcquireSlot();
+		bool AllocateStaging(const VkDeviceSize& size, VkDeviceSize& offset);
+		void ReleaseStaging();
+
+		bool CreateFrame(VulkanVirtualTextureFrame& frame);
+		void DestroyFrame(VulkanVirtualTextureFrame& frame);
+		void DestroyImage(VulkanImage& image);
+
+	private:
+		VulkanDevice* m_logical_device;
+		VulkanVirtualTextureConfig m_config;
+		uint32_t m_texel_size; // Of produced texels
+		uint32_t m_page_bytes; // Of uploaded pages
+		bool m_compressed;
+		BCFormat m_block_format;
+
+		VulkanImage m_cache;
+		bool m_cache_initialized;
+		std::vector<VulkanVirtualCacheSlot> m_slots;
+		std::unordered_map<uint32_t, uint32_t> m_resident; // Page id to cache slot
+
+		std::vector<VulkanVirtualTextureRegion> m_regions;
+
+		std::vector<VulkanVirtualTextureFrame> m_frames;
+		uint64_t m_frame;
+
+		// Pages requested by the latest feedback, with the number of texels that asked for each
+		std::unordered_map<uint32_t, uint32_t> m_requests;
+		std::unordered_set<uint32_t> m_in_production; // Pending jobs and ready pages
+		std::deque<VulkanVirtualPageJob> m_jobs;
+		std::deque<VulkanVirtualPageJob> m_ready;
+
+		// Staging ring. Allocations are released once the frame that copied from them completes.
+		VkBuffer m_staging_buffer;
+		VmaAllocation m_staging_allocation;
+		uint8_t* m_staging_mapped;
+		VkDeviceSize m_staging_head;
+		VkDeviceSize m_staging_used;
+		std::deque<std::pair<VkDeviceSize, uint64_t>> m_staging_in_flight; // Bytes, and the graphics timeline value that frees them (0 until stamped)
+
+		VulkanVirtualTextureStats m_stats;
+	};
+}
\ No newline at end of file
@@ -2,7 +2,10 @@ module;
 
 #include <optional>
 #include <cstdint>
+#include <string>
 #include <vector>
+#include <deque>
+#include <array>
 
 #include <functional>
 
@@ -18,6 +21,10 @@ import :Device;
 import :Swapchain;
 import :Frame;
 import :Image;
+import :RenderGraph;
+import :Profiler;
+import :ComputeScheduler;
+import :DynamicResolution;
 
 import :Command;
 
@@ -31,6 +38,42 @@ export
 		std::optional<uint32_t> present_queue_index;
 	};
 
+	// A replaced swapchain, along with any frame images replaced with it. Destroyed once the frames that used them retire.
+	struct VulkanRetiredSwapchain
+	{
+		VkSwapchainKHR handle = VK_NULL_HANDLE;
+		std::vector<VkImageView> image_views;
+		std::vector<VulkanImage> frame_images;
+		uint64_t graphics_timeline_value = 0; // Last value any frame using these could have signaled
+		uint64_t submitted_frames = 0; // This window's submission count at retirement
+	};
+
+	// Submissions and presents gathered from several windows, so each queue is submitted to once per frame.
+	//	Infos live in deques, which keep earlier entries in place as submits point into them.
+	struct VulkanSubmitBatch
+	{
+		void Clear();
+
+		// Submits compute, then graphics, then presents each swapchain on its present queue. A failed submit skips
+		//	everything after it, since graphics waits on compute and presents wait on graphics. Returns submitted.
+		bool Submit(const VulkanDevice& logical_device);
+
+		bool submitted = false; // Whether every submit reached its queue. Otherwise no window's frame was presented.
+
+		std::deque<VkCommandBufferSubmitInfo> cmd_buffer_infos;
+		std::deque<std::array<VkSemaphoreSubmitInfo, 2>> semaphore_infos; // The waits or signals of a single submit
+		std::vector<VkSubmitInfo2> compute_submits;
+		std::vector<VkSubmitInfo2> graphics_submits;
+
+		// One entry per presenting window
+		std::vector<VkQueue> present_queues;
+		std::vector<VkSwapchainKHR> swapchains;
+		std::vector<uint32_t> image_indices;
+		std::vector<VkSemaphore> present_semaphores;
+		std::vector<uint64_t> present_ids; // 0 where present ids aren't in use
+		std::vector<VkResult> present_results;
+	};
+
 	class VulkanWindow : public IGraphicsWindow
 	{
 	public:
@@ -44,8 +87,17 @@ export
 
 		virtual bool OnRender() override;
 
+		// Builds the UI, records, submits and presents this window's frame on its own
 		virtual bool OnUIRender() override;
 
+		// OnUIRender in steps, for rendering several windows together. BuildUI must run on the main thread, since ImGui's
+		//	current context is global. RecordFrame may run on any thread, concurrently with other windows. AppendSubmit
+		//	reserves timeline values, so windows append one at a time; OnPresented then reads the batch's present result.
+		bool BuildUI();
+		void RecordFrame();
+		bool AppendSubmit(VulkanSubmitBatch& batch);
+		void OnPresented(const VulkanSubmitBatch& batch);
+
 		virtual void Enable() override;
 
 		virtual void Disable() override;
@@ -56,22 +108,78 @@ export
 
 		virtual void SetMaxFramesInFlight(const uint32_t& max_in_flight_frames) override;
 
-		void RecreateSwapchain();
+		// Shows the frame image through the UI instead of copying it to the swapchain. Each frame's image is
+		//	registered as an ImGui texture, which DrawViewport samples directly, and the UI gets a dockspace.
+		void SetRenderAsUI(const bool& enabled);
+		bool RenderAsUI();
+
+		// Draws this frame's image into a dockable ImGui window, fit to its size. Call from the UI render callback.
+		void DrawViewport(const char* title = "Viewport");
+
+		// Size of the viewport window's content region, as of the last DrawViewport. When rendering as UI, frames render
+		//	at this size (clamped to the frame image, before dynamic resolution), so commands' render extent and any
+		//	camera aspect taken from it match the viewport.
+		const VkExtent2D& GetViewportExtent();
+
+		// Renders into a scaled region of each frame image, chosen from GPU timings to hold a target frame time.
+		//	Commands see the region as VulkanCommand::render_extent; it's scaled up when copied to the swapchain.
+		void SetDynamicResolution(const VulkanDynamicResolutionConfig& config);
+		VulkanDynamicResolution* GetDynamicResolution();
+
+		// Blocks until the last presented frame reaches the display, or its GPU work completes where
+		//	VK_KHR_present_wait is unavailable. Used by the frame pacer's just-in-time latency mode.
+		void WaitForPresent(const uint64_t& timeout = 100'000'000);
+
+		// Replaces the swapchain without waiting on the device. Returns false if the surface
+		//	currently can't have one (e.g. the window is minimized).
+		bool RecreateSwapchain();
 
 		// Binds a render command for repeated calls. CAUTION: These will NOT be cleared each frame.
-		void BindRenderCommand(const std::function<void(const VulkanCommand&)>& command);
+		void BindRenderCommand(const std::function<void(const VulkanCommand&)>& command, const std::string& name = "");
 
 		// Submits a render command for execution during the current frame.
-		void SubmitRenderCommand(const std::function<void(const VulkanCommand&)>& command);
+		void SubmitRenderCommand(const std::function<void(const VulkanCommand&)>& command, const std::string& name = "");
+
+		// Declares an image every frame's render commands write, created as a render graph transient. Commands find it
+		//	at the returned index of VulkanCommand::command_images, already in the usage's layout. Returns that index.
+		uint32_t DeclareCommandImage(const VulkanCommandImageInfo& image_info);
+
+		// Records commands across the job system into secondary command buffers, executed in submission order.
+		//	Frames with fewer than two commands are recorded serially, so a single command gains nothing.
+		//	CAUTION: Commands may run concurrently, and must not rely on state set by other commands.
+		void SetParallelRecordingEnabled(const bool& enabled);
+
+		// GPU timings for every render graph pass and render command in this window
+		VulkanProfiler* GetProfiler();
+
+		// Makes this frame's graphics work wait on a compute job, from the given stages on. Only call
+		//	for frames that read the job's results; other frames overlap with it freely.
+		void ConsumeCompute(const VulkanComputeTicket& ticket, const VkPipelineStageFlags2& stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
 
 	private:
 		void Reset(const VulkanFrame& frame);
 		void Begin(const VulkanFrame& frame);
-		void Record(const VulkanFrame& frame);
+		void Record(VulkanFrame& frame);
+		bool RecordParallel(VulkanFrame& frame);
 		void End(const VulkanFrame& frame);
 
+		// Undoes a frame whose submit failed: its timeline values are never signaled, its acquire semaphore is left
+		//	signaled, and its swapchain image is never presented
+		void DiscardFrame(VulkanFrame& frame);
+
 		bool SwapBuffers(const VulkanFrame& frame);
-		void SubmitAndPresent(const VulkanFrame& frame);
+		void ReleaseRetiredSwapchains(const bool& force = false);
+
+		void InitializeUI();
+		void ShutdownUI();
+		void RenderUI(const VkCommandBuffer& cmd_buffer, ImDrawData* draw_data);
+		void UpdateUITexture(VulkanFrame& frame);
+
+		// Extent dynamic resolution scales from: the frame image, or in the UI the viewport's size within it
+		VkExtent3D GetFullRenderExtent(const VulkanFrame& frame);
+
+		bool CreateRecordSlots(VulkanFrame& frame, const size_t& slot_count);
+		void DestroyRecordSlots(VulkanFrame& frame);
 
 		void CopyImageToSwapchain(const VkCommandBuffer& cmd_buffer, const VkImage& image, const VkExtent3D& extent);
 
@@ -80,16 +188,49 @@ export
 		VulkanDevice* m_logical_device; // Vulkan Device Information
 		VulkanWindowSurface m_surface; // Vulkan Surface Information
 		ImGuiContext* m_imgui_context; // ImGuiContext for this window
+		VkDescriptorPool m_imgui_descriptor_pool; // Descriptors for UI fonts and textures
 		std::function<void()> m_ui_render_fun;// UI Render Function
 		std::vector<VulkanFrame> m_frames;
+		VulkanRenderGraph m_render_graph; // This frame's passes, recorded in OnUIRender
+		uint32_t m_swapchain_resource; // This frame's swapchain image in the render graph
+		uint32_t m_frame_resource; // This frame's render image in the render graph
+		std::vector<VulkanCommandImageInfo> m_command_image_infos;
+		std::vector<uint32_t> m_command_image_resources; // This frame's command images in the render graph
+		std::vector<VulkanImage> m_command_images; // Realized once the graph compiles
+		VkExtent2D m_viewport_extent;
+		VulkanProfiler m_profiler;
+		VulkanDynamicResolution m_dynamic_resolution;
+		std::deque<VulkanRetiredSwapchain> m_retired_swapchains;
+
+		// Compute work graphics must wait on this frame
+		uint64_t m_compute_wait_value;
+		VkPipelineStageFlags2 m_compute_wait_stages;
+		bool m_compute_recorded; // Whether any command recorded into this frame's compute buffer
+		VkPipelineStageFlags2 m_compute_consumer_stages; // Graphics stages reading this frame's compute results
+		uint64_t m_submitted_frames;
+		uint64_t m_last_graphics_timeline_value;
+		uint64_t m_present_id; // Last id presented, when present wait is supported
+		uint64_t m_swapchain_first_present_id;
+		size_t m_present_slot; // This frame's entry in the submit batch
+		VulkanSubmitBatch m_submit_batch; // Used when rendering on its own
 
 		std::vector<std::function<void(const VulkanCommand&)>> m_bound_commands;
 		std::vector<std::function<void(const VulkanCommand&)>> m_submit_commands;
+		std::vector<std::string> m_bound_command_names;
+		std::vector<std::string> m_submit_command_names;
+
+		// This frame's commands in execution order, with their names and profiler scopes (graphics, compute)
+		std::vector<const std::function<void(const VulkanCommand&)>*> m_record_commands;
+		std::vector<const std::string*> m_record_names;
+		std::vector<std::pair<uint32_t, uint32_t>> m_record_scopes;
 
 		size_t m_current_frame;
 		bool m_render_as_ui;
 		bool m_attached;
 		bool m_enabled;
 		bool m_vsync_enabled;
+		bool m_swapchain_dirty; // Recreate before the next acquire
+		bool m_frame_skipped; // No swapchain image was acquired this frame
+		bool m_parallel_recording;
 	};
 }
\ No newline at end of file
@@ -6,10 +6,23 @@ export import :Debug;
 export import :Renderer;
 export import :Device;
 export import :Pipeline;
+export import :ShaderCache;
+export import :ShaderWatcher;
 
 export import :Window;
+export import :HeadlessTarget;
 export import :Swapchain;
 export import :Frame;
 export import :Image;
+export import :Timeline;
+export import :ComputeScheduler;
+export import :RenderGraph;
+export import :Profiler;
+export import :FramePacer;
+export import :DynamicResolution;
+export import :VirtualTexture;
+export import :Terrain;
+export import :TerrainCompute;
+export import :TerrainErosion;
 
 export import :Command;
\ No newline at end of file
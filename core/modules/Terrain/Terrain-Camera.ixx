@@ -0,0 +1,29 @@
+module;
+
+#include <cstdint>
+
+export module Terrain:Camera;
+
+export
+{
+	// Y-up perspective camera. Matrices are column major, for Vulkan clip space: y points down and depth runs from 0 to 1.
+	struct TerrainCamera
+	{
+		float position[3] = { 0.0f, 0.0f, 0.0f };
+		float yaw = 0.0f; // Radians about +y. 0 looks down +z.
+		float pitch = 0.0f; // Radians above the horizon
+		float fov_y = 1.0472f;
+		float near_plane = 0.5f;
+		float far_plane = 20000.0f;
+
+		// Points the camera at a world position
+		void LookAt(const float target[3]);
+
+		void GetForward(float out[3]) const;
+
+		void ComputeViewProjection(const float& aspect, float out[16]) const;
+
+		// 1 / tan(fov_y / 2). Multiplied by a distance ratio, gives a size as a fraction of half the viewport height.
+		float GetProjectionScale() const;
+	};
+}
\ No newline at end of file
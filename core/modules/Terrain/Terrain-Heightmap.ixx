@@ -0,0 +1,67 @@
+module;
+
+#include <cstdint>
+#include <vector>
+
+export module Terrain:Heightmap;
+
+import :Noise;
+
+export
+{
+	// Matches the vec4 per patch read by the terrain shaders
+	struct TerrainPatchBounds
+	{
+		float min_height = 0.0f;
+		float max_height = 0.0f;
+		float variance = 0.0f; // Mean squared distance from the bilinear surface through the patch's corners
+		float padding = 0.0f;
+	};
+
+	// Matches the two vec4s per meshlet read by the terrain task shader
+	struct TerrainMeshlet
+	{
+		float min_height = 0.0f;
+		float max_height = 0.0f;
+		float padding[2] = {};
+		float cone[4] = {}; // World space axis, and the sine of the half angle holding every triangle normal. 1 if it never faces away.
+	};
+
+	// Square grid of normalized heights. Patches share their edge texels, so a heightmap of size texels
+	//	holds (size - 1) / patch_texels patches per side.
+	class TerrainHeightmap
+	{
+	public:
+		TerrainHeightmap();
+		~TerrainHeightmap();
+
+		// Evaluates the noise for every texel, rows spread across the job system. The origin offsets the sampled
+		//	texels, so tiles of a larger terrain can be generated alone.
+		void Generate(const TerrainNoiseConfig& config, const uint32_t& size, const int32_t& origin_x = 0, const int32_t& origin_y = 0);
+
+		// Resizes to size by size texels, all at a height of 0
+		void Resize(const uint32_t& size);
+
+		// Overwrites a region with width by height heights in row-major order. Parts outside the heightmap are dropped.
+		void Write(const uint32_t& x, const uint32_t& y, const uint32_t& width, const uint32_t& height, const float* heights);
+
+		// Per-patch bounds in row-major order. Rough patches have a high variance, and need more tessellation
+		//	than their screen size alone suggests.
+		std::vector<TerrainPatchBounds> ComputePatchBounds(const uint32_t& patch_texels) const;
+		TerrainPatchBounds ComputePatchBounds(const uint32_t& patch_texels, const uint32_t& patch_x, const uint32_t& patch_y) const;
+
+		// Bounds and normal cones of square meshlets, meshlet_quads quads per side with vertices stride texels apart,
+		//	in row-major order. Each quad splits into triangles (00, 01, 10) and (10, 01, 11).
+		std::vector<TerrainMeshlet> ComputeMeshlets(const uint32_t& meshlet_quads, const uint32_t& stride, const float& texel_spacing, const float& height_scale) const;
+
+		// Bilinear height at texel coordinates, clamped to the edges
+		float Sample(const float& x, const float& y) const;
+
+		uint32_t GetSize() const;
+		const std::vector<float>& GetHeights() const;
+
+	private:
+		uint32_t m_size;
+		std::vector<float> m_heights;
+	};
+}
\ No newline at end of file
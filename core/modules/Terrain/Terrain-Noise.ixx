@@ -0,0 +1,31 @@
+module;
+
+#include <cstdint>
+
+export module Terrain:Noise;
+
+export
+{
+	struct TerrainNoiseConfig
+	{
+		uint32_t seed = 1337;
+		uint32_t octaves = 6;
+		float frequency = 1.0f / 256.0f; // Of the first octave, in cycles per heightmap texel
+		float lacunarity = 2.0f; // Frequency multiplier between octaves
+		float gain = 0.5f; // Amplitude multiplier between octaves
+		float exponent = 1.6f; // Raises normalized heights, flattening valleys and sharpening peaks
+	};
+
+	// Fractal gradient noise over heightmap texel coordinates, producing heights in [0, 1].
+	//	Hashing is integer only and every step maps directly onto GLSL, so GPU generators can reproduce it.
+	class TerrainNoise
+	{
+	public:
+		static uint32_t Hash(const int32_t& x, const int32_t& y, const uint32_t& seed);
+
+		// Single octave of gradient noise, roughly in [-0.7, 0.7]
+		static float Gradient(const float& x, const float& y, const uint32_t& seed);
+
+		static float Sample(const TerrainNoiseConfig& config, const float& x, const float& y);
+	};
+}
\ No newline at end of file
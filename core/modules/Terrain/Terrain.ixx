@@ -0,0 +1,5 @@
+export module Terrain;
+
+export import :Noise;
+export import :Heightmap;
+export import :Camera;
\ No newline at end of file
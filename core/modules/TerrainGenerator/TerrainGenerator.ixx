@@ -1,9 +1,15 @@
+module;
+
+#include <vector>
+#include <chrono>
+
 export module TerrainGenerator;
 
 import Aurion.Application;
 import Aurion.GLFW;
 
 import Vulkan;
+import Terrain;
 
 export
 {
@@ -15,19 +21,56 @@ export
 
 		void StartAndRun() override;
 
+		// Compares GPU and CPU heightmap tile generation on a headless renderer, logging the results
+		static void RunGenerationBenchmark();
+
+		// Renders a known pattern over several frames on a headless target, comparing each frame's readback with the
+		//	image it should produce. Logs the first mismatch. Returns whether every frame matched.
+		static bool RunHeadlessGoldenTest();
+
 	private:
 		void Load();
 		void Start();
 		void Run();
 		void Unload();
 
+		// Sets up tile generation on the compute queue if the GPU generator agrees with the CPU one. Otherwise the
+		//	terrain generates its own heights on the CPU.
+		bool InitializeTileGeneration(VulkanPipelineBuilder& builder, const VulkanTerrainConfig& terrain_config);
+
+		// Writes finished tiles into the terrain, then requests more while the ring has room. Never waits on the GPU.
+		//	Once the last tile arrives, erosion restarts from the finished heightmap.
+		void StreamTiles();
+
+		// Advances the erosion, and writes its heights into the terrain as readbacks arrive. Never waits on the GPU.
+		void UpdateErosion();
+
+		// Restarts erosion from the generated heights, and puts them back into the terrain
+		void ResetErosion();
+
+		// Erosion counters, with run and reset controls
+		void DrawErosionOverlay();
+
+		void RenderSky(const VulkanCommand& command);
 		void Render(const VulkanCommand& command);
 
+		// Slow orbit around the terrain, kept above the ground
+		TerrainCamera GetCamera();
+
 	private:
 		Aurion::GLFWDriver m_window_driver;
 		VulkanDriver m_vulkan_driver;
 		VulkanRenderer* m_renderer;
-		VulkanPipelineBuilder::Result m_render_pipelines;
+		VulkanTerrain m_terrain;
+		VulkanTerrainCompute m_tile_generator;
+		std::vector<VulkanTerrainTile> m_tile_requests; // Tiles not yet requested, taken from the back
+		bool m_heights_ready; // Every tile has arrived, or the CPU generated the heights
+		TerrainHeightmap m_generated_heightmap; // Heights before erosion, which resets return to
+		VulkanTerrainErosion m_erosion;
+		std::chrono::steady_clock::time_point m_erosion_readback_time; // When the last readback was requested
+		bool m_erosion_changed; // Batches ran since the last readback was requested
+		uint32_t m_depth_image; // The terrain's depth, among the window's command images
+		std::chrono::steady_clock::time_point m_start_time;
 		bool m_should_close;
 	};
 }
\ No newline at end of file
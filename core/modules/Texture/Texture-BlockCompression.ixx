@@ -0,0 +1,86 @@
+module;
+
+#include <cstdint>
+
+export module Texture:BlockCompression;
+
+export
+{
+	// BC7 is limited to mode 6 (one subset, RGBA endpoints with 4-bit indices), which suits smooth generated content
+	enum class BCFormat
+	{
+		BC1, // RGB, 8 bytes per block. Alpha is ignored.
+		BC4, // One channel, 8 bytes per block
+		BC5, // Two channels, 16 bytes per block
+		BC7, // RGBA, 16 bytes per block
+	};
+
+	enum class BCQuality
+	{
+		Fast, // Bounding box end points and projected indices
+		Balanced, // Principal axis end points
+		High, // Principal axis, least squares refinement and exhaustive index search
+	};
+
+	struct BCEncodeInfo
+	{
+		BCFormat format = BCFormat::BC1;
+		BCQuality quality = BCQuality::Balanced;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		const uint8_t* texels = nullptr; // 8 bits per component
+		uint32_t components = 4; // Components per source texel. BC1 and BC7 need 3 or 4.
+		uint32_t channel = 0; // First source component encoded by BC4 and BC5
+		uint32_t row_pitch = 0; // Bytes between source rows. 0 for tightly packed rows.
+	};
+
+	struct BCBenchmarkResult
+	{
+		BCFormat format = BCFormat::BC1;
+		BCQuality quality = BCQuality::Balanced;
+		double megapixels_per_second = 0.0;
+		double psnr = 0.0; // Decibels, over the channels the format stores
+		double compression_ratio = 0.0; // Against the equivalent uncompressed 8-bit format
+	};
+
+	// SSE2 block compression for textures generated on the CPU. Edge blocks repeat the last row and column.
+	//	Encoding is stateless, so it is safe to run on any number of threads at once.
+	class BlockCompressor
+	{
+	public:
+		static uint32_t GetBlockSize(const BCFormat& format);
+		static uint32_t GetChannelCount(const BCFormat& format);
+		static size_t GetEncodedSize(const BCFormat& format, const uint32_t& width, const uint32_t& height);
+
+		// Encodes on the calling thread. Output needs GetEncodedSize bytes, blocks in row-major order.
+		static bool Encode(const BCEncodeInfo& info, uint8_t* output);
+
+		// Encodes rows of blocks across the job system. The calling thread participates.
+		static bool EncodeParallel(const BCEncodeInfo& info, uint8_t* output);
+
+		// Decodes what this encoder writes into tightly packed RGBA8. Unused channels are 0, alpha 255.
+		static bool Decode(const BCFormat& format, const uint32_t& width, const uint32_t& height, const uint8_t* blocks, uint8_t* texels);
+
+		// Peak signal to noise ratio over the first channel_count channels of two RGBA8 images
+		static double ComputePSNR(const uint8_t* a, const uint8_t* b, const uint32_t& width, const uint32_t& height, const uint32_t& channel_count);
+
+		// Encodes a synthetic terrain texture, reporting throughput across the job system and decoded quality
+		static BCBenchmarkResult Benchmark(const BCFormat& format, const BCQuality& quality,
+			const uint32_t& width = 1024, const uint32_t& height = 1024, const uint32_t& iterations = 8);
+
+		// Benchmarks every format and quality, logging the results
+		static void RunBenchmarks(const uint32_t& width = 1024, const uint32_t& height = 1024, const uint32_t& iterations = 8);
+
+		// Round trips known patterns through every format and quality, checking each decoded texel against a per format
+		//	error bound, that BC1 blocks never fall into three colour mode, and that parallel and serial encodes match.
+		//	Logs every failure. Returns whether all cases passed.
+		static bool RunSelfTests();
+
+		static const char* GetFormatName(const BCFormat& format);
+		static const char* GetQualityName(const BCQuality& quality);
+
+	private:
+		static bool Validate(const BCEncodeInfo& info);
+		static void EncodeRow(const BCEncodeInfo& info, const uint32_t& block_row, uint8_t* output);
+	};
+}
\ No newline at end of file
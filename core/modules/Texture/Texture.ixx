@@ -0,0 +1,3 @@
+export module Texture;
+
+export import :BlockCompression;
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+import Jobs;
+
+JobSystem* JobSystem::Get()
+{
+	static JobSystem s_job_system;
+	static std::once_flag s_init_flag;
+
+	// Lazily spin up workers the first time the job system is requested
+	std::call_once(s_init_flag, []() { s_job_system.Initialize(); });
+
+	return &s_job_system;
+}
+
+JobSystem::JobSystem()
+	: m_running(false)
+{
+
+}
+
+JobSystem::~JobSystem()
+{
+	this->Shutdown();
+}
+
+void JobSystem::Initialize(const uint32_t& thread_count)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	// Don't initialize twice
+	if (m_running)
+		return;
+
+	m_running = true;
+
+	// Leave a hardware thread for the caller, but always create at least one worker
+	uint32_t worker_count = thread_count;
+	if (worker_count == 0)
+		worker_count = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+	m_workers.reserve(worker_count);
+	for (uint32_t i = 0; i < worker_count; i++)
+		m_workers.emplace_back(&JobSystem::WorkerLoop, this);
+}
+
+void JobSystem::Shutdown()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (!m_running)
+			return;
+
+		m_running = false;
+	}
+
+	// Wake every worker so they can drain the queue and exit
+	m_condition.notify_all();
+
+	for (auto& worker : m_workers)
+		if (worker.joinable())
+			worker.join();
+
+	m_workers.clear();
+}
+
+void JobSystem::ParallelFor(const size_t& count, const std::function<void(size_t)>& job)
+{
+	if (count == 0)
+		return;
+
+	// Nothing to spread out, run inline
+	if (count == 1)
+	{
+		job(0);
+		return;
+	}
+
+	// Queue all but the first iteration, which the calling thread runs directly
+	std::vector<std::future<void>> futures;
+	futures.reserve(count - 1);
+	for (size_t i = 1; i < count; i++)
+		futures.emplace_back(this->Submit([&job, i]() { job(i); }));
+
+	job(0);
+
+	for (auto& future : futures)
+		this->Wait(future);
+}
+
+bool JobSystem::RunPendingJob()
+{
+	std::function<void()> job;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (m_jobs.empty())
+			return false;
+
+		job = std::move(m_jobs.front());
+		m_jobs.pop_front();
+	}
+
+	job();
+
+	return true;
+}
+
+uint32_t JobSystem::GetThreadCount()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	return static_cast<uint32_t>(m_workers.size());
+}
+
+void JobSystem::Enqueue(std::function<void()>&& job)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_jobs.emplace_back(std::move(job));
+	}
+
+	m_condition.notify_one();
+}
+
+void JobSystem::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			// Sleep until there's work, or the system is shutting down
+			m_condition.wait(lock, [this]() { return !m_running || !m_jobs.empty(); });
+
+			// Only exit once every queued job has been executed
+			if (!m_running && m_jobs.empty())
+				return;
+
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		job();
+	}
+}
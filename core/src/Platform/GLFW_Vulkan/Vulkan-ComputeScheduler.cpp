@@ -0,0 +1,177 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+import Vulkan;
+
+VulkanComputeScheduler::VulkanComputeScheduler()
+	: m_logical_device(nullptr)
+{
+
+}
+
+VulkanComputeScheduler::~VulkanComputeScheduler()
+{
+
+}
+
+void VulkanComputeScheduler::Initialize(VulkanDevice* logical_device)
+{
+	m_logical_device = logical_device;
+}
+
+void VulkanComputeScheduler::Destroy()
+{
+	if (!m_logical_device)
+		return;
+
+	// Every job completes in submission order, so waiting on the last covers them all
+	if (!m_pending_jobs.empty())
+		m_logical_device->compute_timeline.Wait(m_logical_device->handle, m_pending_jobs.back().value);
+
+	// Destroying the pools frees their command buffers
+	for (const VulkanComputeJob& job : m_pending_jobs)
+		vkDestroyCommandPool(m_logical_device->handle, job.cmd_pool, nullptr);
+	for (const VulkanComputeJob& job : m_free_jobs)
+		vkDestroyCommandPool(m_logical_device->handle, job.cmd_pool, nullptr);
+
+	m_pending_jobs.clear();
+	m_free_jobs.clear();
+}
+
+VulkanComputeTicket VulkanComputeScheduler::Submit(const std::function<void(const VkCommandBuffer&)>& record, const std::string& name, const VulkanComputeTicket& after)
+{
+	if (!m_logical_device || !record)
+		return {};
+
+	VulkanComputeJob job = this->AcquireJob();
+	if (job.cmd_buffer == VK_NULL_HANDLE)
+	{
+		AURION_ERROR("[Vulkan Compute] Failed to submit job '%s': Could not allocate a command buffer.", name.c_str());
+		return {};
+	}
+
+	job.name = name;
+
+	VkCommandBufferBeginInfo begin_info{
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+	};
+
+	vkBeginCommandBuffer(job.cmd_buffer, &begin_info);
+	record(job.cmd_buffer);
+	vkEndCommandBuffer(job.cmd_buffer);
+
+	// Only reserved once the submit succeeds. A value signaled from the host instead could overtake signals still
+	//	pending on the queue, and move the timeline backwards.
+	VulkanTimeline& compute_timeline = m_logical_device->compute_timeline;
+	job.value = compute_timeline.value + 1;
+
+	VkCommandBufferSubmitInfo cmd_buffer_info{};
+	cmd_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+	cmd_buffer_info.commandBuffer = job.cmd_buffer;
+
+	VkSemaphoreSubmitInfo wait_info = compute_timeline.SubmitInfo(after.value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+	VkSemaphoreSubmitInfo signal_info = compute_timeline.SubmitInfo(job.value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+	VkSubmitInfo2 submit_info{};
+	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+	submit_info.waitSemaphoreInfoCount = after.value > 0 ? 1 : 0;
+	submit_info.pWaitSemaphoreInfos = &wait_info;
+	submit_info.commandBufferInfoCount = 1;
+	submit_info.pCommandBufferInfos = &cmd_buffer_info;
+	submit_info.signalSemaphoreInfoCount = 1;
+	submit_info.pSignalSemaphoreInfos = &signal_info;
+
+	if (vkQueueSubmit2(m_logical_device->compute_queue, 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Compute] Failed to submit job '%s'!", name.c_str());
+
+		m_free_jobs.emplace_back(job);
+		return {};
+	}
+
+	compute_timeline.Next();
+	m_pending_jobs.emplace_back(job);
+
+	return VulkanComputeTicket{ job.value };
+}
+
+bool VulkanComputeScheduler::IsComplete(const VulkanComputeTicket& ticket)
+{
+	if (!m_logical_device || ticket.value == 0)
+		return true;
+
+	return m_logical_device->compute_timeline.Reached(m_logical_device->handle, ticket.value);
+}
+
+bool VulkanComputeScheduler::Wait(const VulkanComputeTicket& ticket, const uint64_t& timeout)
+{
+	if (!m_logical_device || ticket.value == 0)
+		return true;
+
+	return m_logical_device->compute_timeline.Wait(m_logical_device->handle, ticket.value, timeout);
+}
+
+void VulkanComputeScheduler::Collect()
+{
+	if (!m_logical_device || m_pending_jobs.empty())
+		return;
+
+	uint64_t completed_value = 0;
+	vkGetSemaphoreCounterValue(m_logical_device->handle, m_logical_device->compute_timeline.handle, &completed_value);
+
+	// Jobs complete in submission order
+	size_t completed_count = 0;
+	while (completed_count < m_pending_jobs.size() && m_pending_jobs[completed_count].value <= completed_value)
+		m_free_jobs.emplace_back(m_pending_jobs[completed_count++]);
+
+	m_pending_jobs.erase(m_pending_jobs.begin(), m_pending_jobs.begin() + completed_count);
+}
+
+size_t VulkanComputeScheduler::GetPendingCount()
+{
+	return m_pending_jobs.size();
+}
+
+VulkanComputeJob VulkanComputeScheduler::AcquireJob()
+{
+	// Re-use a completed job's command buffer if possible
+	if (!m_free_jobs.empty())
+	{
+		VulkanComputeJob job = m_free_jobs.back();
+		m_free_jobs.pop_back();
+
+		vkResetCommandPool(m_logical_device->handle, job.cmd_pool, 0);
+		return job;
+	}
+
+	VulkanComputeJob job{};
+
+	VkCommandPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	pool_info.queueFamilyIndex = m_logical_device->compute_queue_index.value();
+
+	if (vkCreateCommandPool(m_logical_device->handle, &pool_info, nullptr, &job.cmd_pool) != VK_SUCCESS)
+		return {};
+
+	VkCommandBufferAllocateInfo buffer_info{};
+	buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	buffer_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	buffer_info.commandBufferCount = 1;
+	buffer_info.commandPool = job.cmd_pool;
+
+	if (vkAllocateCommandBuffers(m_logical_device->handle, &buffer_info, &job.cmd_buffer) != VK_SUCCESS)
+	{
+		vkDestroyCommandPool(m_logical_device->handle, job.cmd_pool, nullptr);
+		return {};
+	}
+
+	return job;
+}
\ No newline at end of file
@@ -1,14 +1,19 @@
 #include <macros/AurionLog.h>
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 #include <vector>
-#include <set>
 
 #include <vulkan/vulkan.h>
 #include <vma/vk_mem_alloc.h>
 
 import Vulkan;
 
+// Queues requested per role, when the family has them
+constexpr uint32_t c_max_compute_queues = 2;
+constexpr uint32_t c_max_transfer_queues = 2;
+
 VulkanDevice VulkanDevice::Create(const VkInstance& instance, const VulkanDeviceRequirements& reqs)
 {
 	VulkanDevice device;
@@ -49,6 +54,37 @@ VulkanDevice VulkanDevice::Create(const VkInstance& instance, const VulkanDevice
 				device.physical_device = physical_device;
 		}
 
+		// Fall back to other device types, from most to least capable. CPU devices (e.g. lavapipe) come last,
+		//	so machines without a GPU can still render.
+		if (device.physical_device == VK_NULL_HANDLE && reqs.allow_device_type_fallback)
+		{
+			VkPhysicalDeviceType fallback_types[] = {
+				VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU,
+				VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU,
+				VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU,
+				VK_PHYSICAL_DEVICE_TYPE_CPU,
+				VK_PHYSICAL_DEVICE_TYPE_OTHER
+			};
+
+			VulkanDeviceRequirements fallback_reqs = reqs;
+			for (const VkPhysicalDeviceType& type : fallback_types)
+			{
+				if (type == reqs.device_type || device.physical_device != VK_NULL_HANDLE)
+					continue;
+
+				fallback_reqs.device_type = type;
+				for (const auto& physical_device : physical_devices)
+				{
+					if (VulkanDevice::MeetsRequirements(physical_device, fallback_reqs))
+					{
+						device.physical_device = physical_device;
+						AURION_WARN("[VulkanDevice::Create] No device of the preferred type was found. Falling back to device type %d.", type);
+						break;
+					}
+				}
+			}
+		}
+
 		// Bail early if a valid device wasn't found
 		if (device.physical_device == VK_NULL_HANDLE)
 		{
@@ -63,7 +99,12 @@ VulkanDevice VulkanDevice::Create(const VkInstance& instance, const VulkanDevice
 	vkGetPhysicalDeviceProperties2(device.physical_device, &device.properties);
 	vkGetPhysicalDeviceFeatures2(device.physical_device, &device.features);
 
-	// Query for device queue indices (Graphics & Compute Only)
+	// Queue indices within each family, per role
+	std::vector<uint32_t> compute_queue_slots;
+	std::vector<uint32_t> transfer_queue_slots;
+	std::vector<uint32_t> family_queue_counts;
+
+	// Choose the best scoring queue family for each role
 	{
 		// Query for supported queue families
 		uint32_t family_count = 0;
@@ -73,43 +114,86 @@ VulkanDevice VulkanDevice::Create(const VkInstance& instance, const VulkanDevice
 		std::vector<VkQueueFamilyProperties> queueFamProps(family_count);
 		vkGetPhysicalDeviceQueueFamilyProperties(device.physical_device, &family_count, queueFamProps.data());
 
-		// Query queue family support for the chosen physical device
-		uint32_t i = 0;
-		for (const VkQueueFamilyProperties& props : queueFamProps)
+		int32_t graphics_score = -1;
+		int32_t compute_score = -1;
+		int32_t transfer_score = -1;
+		for (uint32_t i = 0; i < family_count; i++)
 		{
-			// Check for support for graphics operations
-			if (props.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+			// Graphics work prefers a family that can also run the frame's compute work
+			int32_t score = ScoreQueueFamily(queueFamProps[i], VK_QUEUE_GRAPHICS_BIT, VK_QUEUE_COMPUTE_BIT, 0);
+			if (score > graphics_score)
+			{
+				graphics_score = score;
 				device.graphics_queue_index = i;
+			}
 
-			// Check for support for compute operations
-			if (props.queueFlags & VK_QUEUE_COMPUTE_BIT)
+			// Async compute prefers a family without graphics
+			score = ScoreQueueFamily(queueFamProps[i], VK_QUEUE_COMPUTE_BIT, 0, VK_QUEUE_GRAPHICS_BIT);
+			if (score > compute_score)
+			{
+				compute_score = score;
 				device.compute_queue_index = i;
+			}
 
-			i++;
+			// Transfers prefer a copy-only family, then one without graphics
+			score = ScoreQueueFamily(queueFamProps[i], VK_QUEUE_TRANSFER_BIT, 0, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+			if (score > transfer_score)
+			{
+				transfer_score = score;
+				device.transfer_queue_index = i;
+			}
 		}
+
+		// Hand out distinct queues within each family while they last. Roles sharing an exhausted family share its first queue.
+		family_queue_counts.resize(family_count, 0);
+		auto allocate_queues = [&](const uint32_t& family, const uint32_t& wanted)
+		{
+			std::vector<uint32_t> slots;
+			uint32_t available = queueFamProps[family].queueCount - family_queue_counts[family];
+			for (uint32_t j = 0; j < std::min(wanted, available); j++)
+				slots.push_back(family_queue_counts[family]++);
+
+			if (slots.empty())
+				slots.push_back(0);
+
+			return slots;
+		};
+
+		if (device.graphics_queue_index.has_value())
+			allocate_queues(device.graphics_queue_index.value(), 1);
+
+		if (device.compute_queue_index.has_value())
+			compute_queue_slots = allocate_queues(device.compute_queue_index.value(), c_max_compute_queues);
+
+		if (device.transfer_queue_index.has_value())
+			transfer_queue_slots = allocate_queues(device.transfer_queue_index.value(), c_max_transfer_queues);
+
+		AURION_INFO("[VulkanDevice::Create] Queue families: graphics %d, compute %d (%d queues), transfer %d (%d queues)",
+			static_cast<int32_t>(device.graphics_queue_index.value_or(UINT32_MAX)),
+			static_cast<int32_t>(device.compute_queue_index.value_or(UINT32_MAX)), static_cast<int32_t>(compute_queue_slots.size()),
+			static_cast<int32_t>(device.transfer_queue_index.value_or(UINT32_MAX)), static_cast<int32_t>(transfer_queue_slots.size()));
 	}
 
 	// Create logical device handle
 	{
 		// Attach relevant queues
-		float queuePriority = 1.0f;
+		std::vector<float> queue_priorities;
 		std::vector<VkDeviceQueueCreateInfo> queue_infos;
-		std::set<uint32_t> queue_indices;
-
-		if (device.graphics_queue_index.has_value())
-			queue_indices.emplace(device.graphics_queue_index.value());
 
-		if (device.compute_queue_index.has_value())
-			queue_indices.emplace(device.compute_queue_index.value());
+		for (uint32_t count : family_queue_counts)
+			queue_priorities.resize(std::max(queue_priorities.size(), static_cast<size_t>(count)), 1.0f);
 
-		// Attach each unique queue create info
-		for (uint32_t index : queue_indices)
+		// Attach a queue create info for each family in use
+		for (uint32_t index = 0; index < static_cast<uint32_t>(family_queue_counts.size()); index++)
 		{
+			if (family_queue_counts[index] == 0)
+				continue;
+
 			VkDeviceQueueCreateInfo queue_info{};
 			queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 			queue_info.queueFamilyIndex = index;
-			queue_info.queueCount = 1;
-			queue_info.pQueuePriorities = &queuePriority;
+			queue_info.queueCount = family_queue_counts[index];
+			queue_info.pQueuePriorities = queue_priorities.data();
 
 			queue_infos.push_back(queue_info);
 		}
@@ -120,12 +204,81 @@ VulkanDevice VulkanDevice::Create(const VkInstance& instance, const VulkanDevice
 		device_info.queueCreateInfoCount = static_cast<uint32_t>(queue_infos.size());
 		device_info.pQueueCreateInfos = queue_infos.data();
 
-		// Enable required extensions
-		device_info.enabledExtensionCount = static_cast<uint32_t>(reqs.extensions.size());
-		device_info.ppEnabledExtensionNames = reqs.extensions.data();
+		// Enable required extensions, and any optional ones the device supports
+		{
+			uint32_t extension_count = 0;
+			vkEnumerateDeviceExtensionProperties(device.physical_device, nullptr, &extension_count, nullptr);
+
+			std::vector<VkExtensionProperties> available_extensions(extension_count);
+			vkEnumerateDeviceExtensionProperties(device.physical_device, nullptr, &extension_count, available_extensions.data());
+
+			device.enabled_extensions = reqs.extensions;
+			for (const char* extension : reqs.optional_extensions)
+			{
+				for (const VkExtensionProperties& props : available_extensions)
+				{
+					if (std::strcmp(props.extensionName, extension) == 0)
+					{
+						device.enabled_extensions.push_back(extension);
+						break;
+					}
+				}
+			}
+		}
+
+		device_info.enabledExtensionCount = static_cast<uint32_t>(device.enabled_extensions.size());
+		device_info.ppEnabledExtensionNames = device.enabled_extensions.data();
 
 		// Enable required features
-		device_info.pNext = &reqs.features; // Features for 1.1+
+		VkPhysicalDeviceFeatures2 features = reqs.features; // Features for 1.1+
+		device_info.pNext = &features;
+
+		// Present wait needs both present extensions and their features. Chained ahead of the required features when available.
+		VkPhysicalDevicePresentIdFeaturesKHR present_id_features{};
+		present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+
+		VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features{};
+		present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+		present_wait_features.pNext = &present_id_features;
+
+		if (device.HasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) && device.HasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+		{
+			VkPhysicalDeviceFeatures2 supported_features{};
+			supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			supported_features.pNext = &present_wait_features;
+			vkGetPhysicalDeviceFeatures2(device.physical_device, &supported_features);
+
+			if (present_id_features.presentId && present_wait_features.presentWait)
+			{
+				present_id_features.pNext = features.pNext;
+				features.pNext = &present_wait_features;
+				device.present_wait_supported = true;
+			}
+		}
+
+		// Mesh shading needs both task and mesh shader features. Chained ahead of the required features when available.
+		VkPhysicalDeviceMeshShaderFeaturesEXT mesh_shader_features{};
+		mesh_shader_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+
+		if (device.HasExtension(VK_EXT_MESH_SHADER_EXTENSION_NAME))
+		{
+			VkPhysicalDeviceFeatures2 supported_features{};
+			supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			supported_features.pNext = &mesh_shader_features;
+			vkGetPhysicalDeviceFeatures2(device.physical_device, &supported_features);
+
+			if (mesh_shader_features.taskShader && mesh_shader_features.meshShader)
+			{
+				// The rest depend on features that aren't enabled
+				mesh_shader_features.multiviewMeshShader = VK_FALSE;
+				mesh_shader_features.primitiveFragmentShadingRateMeshShader = VK_FALSE;
+				mesh_shader_features.meshShaderQueries = VK_FALSE;
+
+				mesh_shader_features.pNext = features.pNext;
+				features.pNext = &mesh_shader_features;
+				device.mesh_shader_supported = true;
+			}
+		}
 
 		// Create logical device
 		if (vkCreateDevice(device.physical_device, &device_info, nullptr, &device.handle) != VK_SUCCESS)
@@ -153,7 +306,7 @@ VulkanDevice VulkanDevice::Create(const VkInstance& instance, const VulkanDevice
 		}
 	}
 
-	// Get graphics/compute queues
+	// Get graphics/compute/transfer queues
 	{
 		VkDeviceQueueInfo2 queue_info{};
 		queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_INFO_2;
@@ -171,20 +324,132 @@ VulkanDevice VulkanDevice::Create(const VkInstance& instance, const VulkanDevice
 				AURION_ERROR("[VulkanDevice::Create] Failed to fetch graphics queue with index %d", queue_info.queueFamilyIndex);
 		}
 
-		// Retrieve Compute Queue
+		// Retrieve Compute Queues
 		if (device.compute_queue_index.has_value())
 		{
 			queue_info.queueFamilyIndex = device.compute_queue_index.value();
-			vkGetDeviceQueue2(device.handle, &queue_info, &device.compute_queue);
+			for (uint32_t slot : compute_queue_slots)
+			{
+				VkQueue queue = VK_NULL_HANDLE;
+				queue_info.queueIndex = slot;
+				vkGetDeviceQueue2(device.handle, &queue_info, &queue);
+
+				if (queue == VK_NULL_HANDLE)
+					AURION_ERROR("[VulkanDevice::Create] Failed to fetch compute queue %d with index %d", slot, queue_info.queueFamilyIndex);
+				else
+					device.compute_queues.push_back(queue);
+			}
 
-			if (device.compute_queue == VK_NULL_HANDLE)
-				AURION_ERROR("[VulkanDevice::Create] Failed to fetch graphics queue with index %d", queue_info.queueFamilyIndex);
+			if (!device.compute_queues.empty())
+				device.compute_queue = device.compute_queues.front();
+		}
+
+		// Retrieve Transfer Queues
+		if (device.transfer_queue_index.has_value())
+		{
+			queue_info.queueFamilyIndex = device.transfer_queue_index.value();
+			for (uint32_t slot : transfer_queue_slots)
+			{
+				VkQueue queue = VK_NULL_HANDLE;
+				queue_info.queueIndex = slot;
+				vkGetDeviceQueue2(device.handle, &queue_info, &queue);
+
+				if (queue == VK_NULL_HANDLE)
+					AURION_ERROR("[VulkanDevice::Create] Failed to fetch transfer queue %d with index %d", slot, queue_info.queueFamilyIndex);
+				else
+					device.transfer_queues.push_back(queue);
+			}
+
+			if (!device.transfer_queues.empty())
+				device.transfer_queue = device.transfer_queues.front();
+		}
+
+		// Unique families of the primary queues
+		for (const std::optional<uint32_t>& index : { device.graphics_queue_index, device.compute_queue_index, device.transfer_queue_index })
+		{
+			if (index.has_value() && std::find(device.queue_families.begin(), device.queue_families.end(), index.value()) == device.queue_families.end())
+				device.queue_families.push_back(index.value());
 		}
 	}
 
+	// Present wait is an extension entry point
+	if (device.present_wait_supported)
+	{
+		device.wait_for_present = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(device.handle, "vkWaitForPresentKHR");
+		device.present_wait_supported = device.wait_for_present != nullptr;
+	}
+
+	// Mesh task dispatch is an extension entry point, and its limits size task and mesh workgroups
+	if (device.mesh_shader_supported)
+	{
+		device.draw_mesh_tasks = (PFN_vkCmdDrawMeshTasksEXT)vkGetDeviceProcAddr(device.handle, "vkCmdDrawMeshTasksEXT");
+		device.mesh_shader_supported = device.draw_mesh_tasks != nullptr;
+
+		device.mesh_shader_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_PROPERTIES_EXT;
+
+		VkPhysicalDeviceProperties2 properties{};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties.pNext = &device.mesh_shader_properties;
+		vkGetPhysicalDeviceProperties2(device.physical_device, &properties);
+		device.mesh_shader_properties.pNext = nullptr;
+	}
+
+	// Per-queue timeline semaphores
+	device.graphics_timeline = VulkanTimeline::Create(device.handle);
+	device.compute_timeline = VulkanTimeline::Create(device.handle);
+	device.transfer_timeline = VulkanTimeline::Create(device.handle);
+
 	return std::move(device);
 }
 
+int32_t VulkanDevice::ScoreQueueFamily(const VkQueueFamilyProperties& props, const VkQueueFlags& required, const VkQueueFlags& preferred, const VkQueueFlags& avoided)
+{
+	// Graphics and compute families always support transfers, whether or not they report it
+	VkQueueFlags flags = props.queueFlags;
+	if (flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))
+		flags |= VK_QUEUE_TRANSFER_BIT;
+
+	if (props.queueCount == 0 || (flags & required) != required)
+		return -1;
+
+	// Heavier capabilities weigh more, so a compute-only family outranks a graphics one for copies
+	int32_t score = 8;
+	const std::pair<VkQueueFlags, int32_t> weights[] = {
+		{ VK_QUEUE_GRAPHICS_BIT, 4 },
+		{ VK_QUEUE_COMPUTE_BIT, 2 },
+		{ VK_QUEUE_TRANSFER_BIT, 1 }
+	};
+
+	for (const auto& [flag, weight] : weights)
+	{
+		if (!(flags & flag))
+			continue;
+
+		if (preferred & flag)
+			score += weight;
+
+		if (avoided & flag)
+			score -= weight;
+	}
+
+	// Break ties in favor of families the profiler can time
+	if (props.timestampValidBits > 0)
+		score += 1;
+
+	return score;
+}
+
+bool VulkanDevice::HasExtension(const char* extension) const
+{
+	for (const char* enabled : enabled_extensions)
+	{
+		if (std::strcmp(enabled, extension) == 0)
+			return true;
+	}
+
+	return false;
+}
+
 bool VulkanDevice::MeetsRequirements(const VkPhysicalDevice& physical_device, const VulkanDeviceRequirements& reqs)
 {
 	// Check physical device properties
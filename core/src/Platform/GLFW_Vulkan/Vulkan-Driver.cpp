@@ -91,6 +91,8 @@ IRenderer* VulkanDriver::CreateRenderer(const std::vector<Aurion::WindowHandle>&
 		VkPhysicalDeviceFeatures features{};
 		features.geometryShader = VK_TRUE;
 		features.tessellationShader = VK_TRUE;
+		features.pipelineStatisticsQuery = VK_TRUE;
+		features.fragmentStoresAndAtomics = VK_TRUE; // Virtual texture feedback is written by fragment shaders
 
 		// Vulkan 1.1 Features
 		VkPhysicalDeviceVulkan11Features features11{};
@@ -101,6 +103,8 @@ IRenderer* VulkanDriver::CreateRenderer(const std::vector<Aurion::WindowHandle>&
 		features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
 		features12.bufferDeviceAddress = VK_TRUE;
 		features12.descriptorIndexing = VK_TRUE;
+		features12.timelineSemaphore = VK_TRUE;
+		features12.hostQueryReset = VK_TRUE;
 		features12.pNext = &features11;
 
 		// Vulkan 1.3 Features
@@ -128,12 +132,27 @@ IRenderer* VulkanDriver::CreateRenderer(const std::vector<Aurion::WindowHandle>&
 		VulkanDeviceRequirements device_reqs{};
 		device_reqs.features = deviceFeatures2;
 		device_reqs.device_type = VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU; // Prefer dedicated GPU
+		device_reqs.allow_device_type_fallback = true;
 		device_reqs.allocator_flags = allocator_flags;
 		device_reqs.extensions = {
-			VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 			VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
 			VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME
 		};
+
+		// Mesh shading terrain, where supported. Other terrain paths cover devices without it.
+		device_reqs.optional_extensions = {
+			VK_EXT_MESH_SHADER_EXTENSION_NAME
+		};
+
+		// Headless renderers never present
+		if (!m_config.headless)
+		{
+			device_reqs.extensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
+			// Lets the frame pacer wait for the display instead of the GPU
+			device_reqs.optional_extensions.emplace_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+			device_reqs.optional_extensions.emplace_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+		}
 		device_reqs.layers = m_config.validation_layers;
 
 		// Initialize renderer with vulkan instance and default device requirements
@@ -233,17 +252,22 @@ void VulkanDriver::CreateVkInstance()
 		instance_info.pNext = nullptr;
 	}
 
-	// Required GLFW Extensions
-	uint32_t glfw_extension_count = 0;
-	const char** glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
+	std::vector<const char*> extensions;
 
-	if (glfw_extension_count == 0 || !glfw_extensions)
+	// Required GLFW Extensions. Headless instances have no surfaces, so GLFW is never needed.
+	if (!m_config.headless)
 	{
-		AURION_CRITICAL("Could not initialize Vulkan Driver: GLFW is either unavailable or hasn't been initialized.");
-		return;
-	}
+		uint32_t glfw_extension_count = 0;
+		const char** glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
+
+		if (glfw_extension_count == 0 || !glfw_extensions)
+		{
+			AURION_CRITICAL("Could not initialize Vulkan Driver: GLFW is either unavailable or hasn't been initialized.");
+			return;
+		}
 
-	std::vector<const char*> extensions(glfw_extensions, glfw_extensions + glfw_extension_count);
+		extensions.assign(glfw_extensions, glfw_extensions + glfw_extension_count);
+	}
 
 	if (m_config.enable_debug_messenger)
 		extensions.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME); // Enable vulkan debug utilities
@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+
+import Vulkan;
+
+// Weight of each new frame time in the running average
+constexpr double c_dynamic_resolution_average_weight = 0.2;
+
+// Relative error in frame time tolerated before the scale changes
+constexpr double c_dynamic_resolution_tolerance = 0.05;
+
+VulkanDynamicResolution::VulkanDynamicResolution()
+	: m_config({}), m_scale(1.0f), m_full_scale_ms(0.0)
+{
+
+}
+
+VulkanDynamicResolution::~VulkanDynamicResolution()
+{
+
+}
+
+void VulkanDynamicResolution::Configure(const VulkanDynamicResolutionConfig& config)
+{
+	m_config = config;
+	m_config.max_scale = std::clamp(m_config.max_scale, 0.0625f, 1.0f);
+	m_config.min_scale = std::clamp(m_config.min_scale, 0.0625f, m_config.max_scale);
+	m_config.scale_step = std::max(m_config.scale_step, 0.001f);
+
+	m_scale = m_config.enabled ? std::clamp(m_scale, m_config.min_scale, m_config.max_scale) : 1.0f;
+	m_full_scale_ms = 0.0;
+}
+
+const VulkanDynamicResolutionConfig& VulkanDynamicResolution::GetConfig()
+{
+	return m_config;
+}
+
+float VulkanDynamicResolution::Update(const double& gpu_ms, const float& measured_scale)
+{
+	if (!m_config.enabled)
+	{
+		m_scale = 1.0f;
+		return m_scale;
+	}
+
+	if (gpu_ms <= 0.0 || measured_scale <= 0.0f || m_config.target_ms <= 0.0)
+		return m_scale;
+
+	const double full_scale_ms = gpu_ms / (static_cast<double>(measured_scale) * measured_scale);
+	m_full_scale_ms = m_full_scale_ms <= 0.0 ? full_scale_ms : m_full_scale_ms + (full_scale_ms - m_full_scale_ms) * c_dynamic_resolution_average_weight;
+
+	// Within tolerance of the target, hold steady rather than chase noise
+	const double target = m_config.target_ms * m_config.headroom;
+	const double error = (this->GetEstimatedMilliseconds() - target) / target;
+	if (std::abs(error) < c_dynamic_resolution_tolerance)
+		return m_scale;
+
+	// Over budget frames drop straight to the scale that fits; recovery is gradual
+	double ideal = std::sqrt(target / m_full_scale_ms);
+	if (ideal > m_scale)
+		ideal = m_scale + (ideal - m_scale) * 0.25;
+
+	const float snapped = std::round(static_cast<float>(ideal) / m_config.scale_step) * m_config.scale_step;
+	m_scale = std::clamp(snapped, m_config.min_scale, m_config.max_scale);
+
+	return m_scale;
+}
+
+VkExtent3D VulkanDynamicResolution::GetRenderExtent(const VkExtent3D& full_extent) const
+{
+	return VkExtent3D{
+		std::max(1u, static_cast<uint32_t>(std::lround(full_extent.width * m_scale))),
+		std::max(1u, static_cast<uint32_t>(std::lround(full_extent.height * m_scale))),
+		full_extent.depth
+	};
+}
+
+float VulkanDynamicResolution::GetScale() const
+{
+	return m_scale;
+}
+
+double VulkanDynamicResolution::GetEstimatedMilliseconds() const
+{
+	return m_full_scale_ms * m_scale * m_scale;
+}
\ No newline at end of file
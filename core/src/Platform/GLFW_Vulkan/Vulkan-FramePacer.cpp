@@ -0,0 +1,185 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <imgui.h>
+
+import Vulkan;
+
+// OS sleeps overshoot by up to a scheduler tick, so the last stretch before a deadline is spent yielding instead
+constexpr std::chrono::microseconds c_spin_threshold(2000);
+
+VulkanFramePacer::VulkanFramePacer()
+	: m_started(false)
+{
+
+}
+
+VulkanFramePacer::~VulkanFramePacer()
+{
+
+}
+
+void VulkanFramePacer::Configure(const VulkanFramePacerConfig& config)
+{
+	m_config = config;
+	m_started = false;
+
+	while (m_frame_times.size() > m_config.history_size)
+	{
+		m_frame_times.pop_front();
+		m_wait_times.pop_front();
+	}
+}
+
+const VulkanFramePacerConfig& VulkanFramePacer::GetConfig()
+{
+	return m_config;
+}
+
+void VulkanFramePacer::SetTargetFPS(const double& target_fps)
+{
+	if (target_fps < 0.0)
+	{
+		AURION_WARN("[Vulkan Frame Pacer] Target FPS must not be negative. Leaving the frame rate unlimited.");
+		m_config.target_fps = 0.0;
+	}
+	else
+		m_config.target_fps = target_fps;
+
+	// Restart the cadence from the next frame
+	m_started = false;
+}
+
+void VulkanFramePacer::SetLatencyMode(const VulkanLatencyMode& mode)
+{
+	m_config.latency_mode = mode;
+}
+
+void VulkanFramePacer::Pace(const std::chrono::steady_clock::time_point& wait_start)
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	if (m_config.target_fps > 0.0)
+	{
+		std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(1.0 / m_config.target_fps)
+		);
+
+		// Frames that run over by less than a period keep the cadence. Anything later restarts it, rather than
+		//	rushing through several frames to catch up.
+		if (!m_started || now > m_next_frame + period)
+			m_next_frame = now;
+		else
+			this->SleepUntil(m_next_frame);
+
+		m_next_frame += period;
+		now = std::chrono::steady_clock::now();
+	}
+
+	if (m_started)
+	{
+		m_frame_times.push_back(std::chrono::duration<double, std::milli>(now - m_last_frame).count());
+		m_wait_times.push_back(std::chrono::duration<double, std::milli>(now - wait_start).count());
+
+		while (m_frame_times.size() > m_config.history_size)
+		{
+			m_frame_times.pop_front();
+			m_wait_times.pop_front();
+		}
+	}
+
+	m_last_frame = now;
+	m_started = true;
+}
+
+VulkanFrameTimingStats VulkanFramePacer::GetStats()
+{
+	VulkanFrameTimingStats stats{};
+	if (m_frame_times.empty())
+		return stats;
+
+	stats.frame_count = static_cast<uint32_t>(m_frame_times.size());
+	stats.min_ms = m_frame_times.front();
+	stats.max_ms = m_frame_times.front();
+
+	double wait_sum = 0.0;
+	for (size_t i = 0; i < m_frame_times.size(); i++)
+	{
+		stats.average_ms += m_frame_times[i];
+		stats.min_ms = std::min(stats.min_ms, m_frame_times[i]);
+		stats.max_ms = std::max(stats.max_ms, m_frame_times[i]);
+		wait_sum += m_wait_times[i];
+	}
+	stats.average_ms /= stats.frame_count;
+	stats.average_wait_ms = wait_sum / stats.frame_count;
+
+	double variance = 0.0;
+	for (const double& frame_time : m_frame_times)
+		variance += (frame_time - stats.average_ms) * (frame_time - stats.average_ms);
+	stats.std_dev_ms = std::sqrt(variance / stats.frame_count);
+
+	// Slowest 1% of frames, which is where stutter shows
+	std::vector<double> sorted(m_frame_times.begin(), m_frame_times.end());
+	size_t percentile_index = std::min(sorted.size() - 1, static_cast<size_t>(std::ceil(sorted.size() * 0.99)) - 1);
+	std::nth_element(sorted.begin(), sorted.begin() + percentile_index, sorted.end());
+	stats.percentile_99_ms = sorted[percentile_index];
+
+	return stats;
+}
+
+void VulkanFramePacer::DrawOverlay(const char* title)
+{
+	ImGui::SetNextWindowBgAlpha(0.8f);
+	if (!ImGui::Begin(title, nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+	{
+		ImGui::End();
+		return;
+	}
+
+	VulkanFrameTimingStats stats = this->GetStats();
+
+	if (m_config.target_fps > 0.0)
+		ImGui::Text("Target: %.1f fps (%.3f ms)", m_config.target_fps, 1000.0 / m_config.target_fps);
+	else
+		ImGui::TextUnformatted("Target: Unlimited");
+
+	ImGui::Text("Latency Mode: %s", m_config.latency_mode == VulkanLatencyMode::JustInTime ? "Just In Time" : "Off");
+	ImGui::Separator();
+
+	ImGui::Text("Average: %.3f ms (%.1f fps)", stats.average_ms, stats.average_ms > 0.0 ? 1000.0 / stats.average_ms : 0.0);
+	ImGui::Text("Min / Max: %.3f / %.3f ms", stats.min_ms, stats.max_ms);
+	ImGui::Text("Std Dev: %.3f ms", stats.std_dev_ms);
+	ImGui::Text("99th Percentile: %.3f ms", stats.percentile_99_ms);
+	ImGui::Text("Waiting: %.3f ms", stats.average_wait_ms);
+
+	// Frame times, oldest to newest
+	float plot_values[256];
+	int plot_count = static_cast<int>(std::min(m_frame_times.size(), static_cast<size_t>(256)));
+	for (int i = 0; i < plot_count; i++)
+		plot_values[i] = static_cast<float>(m_frame_times[m_frame_times.size() - plot_count + i]);
+
+	ImGui::PlotLines("##frame_times", plot_values, plot_count, 0, nullptr, 0.0f, static_cast<float>(stats.max_ms * 1.25), ImVec2(240.0f, 60.0f));
+
+	ImGui::End();
+}
+
+void VulkanFramePacer::SleepUntil(const std::chrono::steady_clock::time_point& deadline)
+{
+	while (true)
+	{
+		std::chrono::steady_clock::duration remaining = deadline - std::chrono::steady_clock::now();
+		if (remaining <= std::chrono::steady_clock::duration::zero())
+			return;
+
+		if (remaining > c_spin_threshold)
+			std::this_thread::sleep_for(remaining - c_spin_threshold);
+		else
+			std::this_thread::yield();
+	}
+}
\ No newline at end of file
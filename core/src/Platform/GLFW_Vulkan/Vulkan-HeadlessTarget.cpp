@@ -0,0 +1,585 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+import Vulkan;
+import Aurion.Window;
+
+VulkanHeadlessTarget::VulkanHeadlessTarget()
+	: m_handle({}), m_logical_device(nullptr), m_config({}),
+		m_compute_wait_value(0), m_compute_wait_stages(VK_PIPELINE_STAGE_2_NONE), m_compute_recorded(false),
+		m_compute_consumer_stages(VK_PIPELINE_STAGE_2_NONE), m_current_frame(0), m_last_frame(0), m_rendered(false)
+{
+
+}
+
+VulkanHeadlessTarget::~VulkanHeadlessTarget()
+{
+	// Never attached
+	if (!m_logical_device)
+		return;
+
+	this->WaitIdle();
+
+	m_profiler.Destroy();
+
+	for (size_t i = 0; i < m_frames.size(); i++)
+		this->DestroyFrame(m_frames[i], m_readbacks[i]);
+}
+
+void VulkanHeadlessTarget::Attach(VulkanDevice* logical_device, const VulkanHeadlessTargetConfig& config)
+{
+	if (m_logical_device)
+	{
+		AURION_ERROR("[Vulkan Headless] Failed to attach headless target: Already attached.");
+		return;
+	}
+
+	if (!logical_device || logical_device->handle == VK_NULL_HANDLE)
+	{
+		AURION_ERROR("[Vulkan Headless] Failed to attach headless target: Invalid logical device.");
+		return;
+	}
+
+	m_logical_device = logical_device;
+	m_config = config;
+
+	if (m_config.readback_enabled && VulkanImage::GetTexelSize(m_config.format) == 0)
+	{
+		AURION_WARN("[Vulkan Headless] Readback does not support format %d. Readback is disabled.", m_config.format);
+		m_config.readback_enabled = false;
+	}
+
+	// Query pools are created per frame in SetMaxFramesInFlight
+	m_profiler.Initialize(m_logical_device);
+}
+
+void VulkanHeadlessTarget::SetMaxFramesInFlight(const uint32_t& max_in_flight_frames)
+{
+	if (!m_logical_device)
+		return;
+
+	// Removed frames may still be in use
+	if (max_in_flight_frames < m_frames.size())
+	{
+		for (size_t i = max_in_flight_frames; i < m_frames.size(); i++)
+		{
+			m_logical_device->graphics_timeline.Wait(m_logical_device->handle, m_frames[i].graphics_timeline_value);
+			m_logical_device->compute_timeline.Wait(m_logical_device->handle, m_frames[i].compute_timeline_value);
+
+			this->DestroyFrame(m_frames[i], m_readbacks[i]);
+		}
+
+		m_frames.resize(max_in_flight_frames);
+		m_readbacks.resize(max_in_flight_frames);
+		m_readback_written.resize(max_in_flight_frames);
+		m_profiler.Resize(max_in_flight_frames);
+
+		// The last frame may have been removed
+		if (m_current_frame >= m_frames.size())
+			m_current_frame = 0;
+		if (m_last_frame >= m_frames.size())
+			m_rendered = false;
+
+		return;
+	}
+
+	size_t create_index = m_frames.size();
+
+	m_frames.resize(max_in_flight_frames);
+	m_readbacks.resize(max_in_flight_frames);
+	m_readback_written.resize(max_in_flight_frames, false);
+	m_profiler.Resize(max_in_flight_frames);
+
+	for (; create_index < m_frames.size(); create_index++)
+	{
+		if (!this->CreateFrame(m_frames[create_index], m_readbacks[create_index]))
+		{
+			AURION_ERROR("[Vulkan Headless] Frame %d: Failed to create frame resources!", create_index);
+
+			// Keep only the frames that are complete
+			this->DestroyFrame(m_frames[create_index], m_readbacks[create_index]);
+			m_frames.resize(create_index);
+			m_readbacks.resize(create_index);
+			m_readback_written.resize(create_index);
+			m_profiler.Resize((uint32_t)create_index);
+			return;
+		}
+	}
+}
+
+bool VulkanHeadlessTarget::Render()
+{
+	if (!m_logical_device || m_frames.empty())
+		return false;
+
+	VulkanFrame& frame = m_frames[m_current_frame];
+	const VulkanHeadlessReadback& readback = m_readbacks[m_current_frame];
+
+	this->Reset(frame);
+
+	m_profiler.BeginFrame(m_current_frame);
+
+	VkCommandBufferBeginInfo begin_info{
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+	};
+
+	vkBeginCommandBuffer(frame.graphics_cmd_buffer, &begin_info);
+	vkBeginCommandBuffer(frame.compute_cmd_buffer, &begin_info);
+
+	// Same passes as a window, minus presentation
+	m_render_graph.Reset();
+	m_render_graph.SetTransientPool(&frame.transient_pool);
+
+	uint32_t frame_image = m_render_graph.ImportImage("Frame Image", frame.image.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+
+	// Nothing is presented, so the frame image itself is the graph's result
+	m_render_graph.MarkOutput(frame_image);
+
+	VulkanRenderGraphPass& command_pass = m_render_graph.AddPass("Render Commands")
+		.Write(frame_image, VulkanResourceUsage::ColorAttachmentReadWrite)
+		.Execute([this, &frame](const VkCommandBuffer&) { this->Record(frame); });
+
+	m_command_image_resources.clear();
+	for (const VulkanCommandImageInfo& command_image : m_command_image_infos)
+	{
+		VulkanTransientImageInfo image_info = command_image.image_info;
+		if (image_info.extent.width == 0 || image_info.extent.height == 0)
+			image_info.extent = frame.image.extent;
+
+		const uint32_t resource = m_render_graph.CreateImage(command_image.name, image_info);
+		command_pass.Write(resource, command_image.usage);
+		m_command_image_resources.emplace_back(resource);
+	}
+
+	const bool copy_readback = m_config.readback_enabled && readback.buffer != VK_NULL_HANDLE;
+	if (copy_readback)
+	{
+		uint32_t readback_buffer = m_render_graph.ImportBuffer("Readback Buffer", readback.buffer);
+
+		// Leaves the buffer visible to the host once the frame's timeline value is reached
+		m_render_graph.MarkOutput(readback_buffer, VulkanResourceUsage::HostRead);
+
+		m_render_graph.AddPass("Readback")
+			.Read(frame_image, VulkanResourceUsage::TransferSrc)
+			.Write(readback_buffer, VulkanResourceUsage::TransferDst)
+			.Execute([this, &frame, &readback](const VkCommandBuffer& cmd_buffer) { this->CopyImageToReadback(cmd_buffer, frame, readback); });
+	}
+
+	m_render_graph.Execute(frame.graphics_cmd_buffer, &m_profiler);
+
+	vkEndCommandBuffer(frame.graphics_cmd_buffer);
+	vkEndCommandBuffer(frame.compute_cmd_buffer);
+
+	this->Submit(frame);
+
+	m_readback_written[m_current_frame] = copy_readback;
+	m_last_frame = m_current_frame;
+	m_rendered = true;
+
+	m_current_frame = (m_current_frame + 1) % m_frames.size();
+
+	return true;
+}
+
+void VulkanHeadlessTarget::BindRenderCommand(const std::function<void(const VulkanCommand&)>& command, const std::string& name)
+{
+	m_bound_commands.emplace_back(command);
+	m_bound_command_names.emplace_back(name);
+}
+
+void VulkanHeadlessTarget::SubmitRenderCommand(const std::function<void(const VulkanCommand&)>& command, const std::string& name)
+{
+	m_submit_commands.emplace_back(command);
+	m_submit_command_names.emplace_back(name);
+}
+
+uint32_t VulkanHeadlessTarget::DeclareCommandImage(const VulkanCommandImageInfo& image_info)
+{
+	m_command_image_infos.emplace_back(image_info);
+	return static_cast<uint32_t>(m_command_image_infos.size() - 1);
+}
+
+void VulkanHeadlessTarget::SetReadbackEnabled(const bool& enabled)
+{
+	if (enabled && VulkanImage::GetTexelSize(m_config.format) == 0)
+	{
+		AURION_WARN("[Vulkan Headless] Readback does not support format %d.", m_config.format);
+		return;
+	}
+
+	m_config.readback_enabled = enabled;
+
+	// Readback buffers are created lazily, once the first frame needs one
+	if (!enabled || !m_logical_device)
+		return;
+
+	// The frame may still be in flight, but its new readback buffer isn't used until its next submission
+	for (size_t i = 0; i < m_frames.size(); i++)
+	{
+		if (m_readbacks[i].buffer == VK_NULL_HANDLE && !this->CreateReadback(m_readbacks[i]))
+			AURION_ERROR("[Vulkan Headless] Frame %d: Failed to create readback buffer!", i);
+	}
+}
+
+bool VulkanHeadlessTarget::ReadPixels(std::vector<uint8_t>& pixels)
+{
+	if (!m_rendered || !m_readback_written[m_last_frame])
+	{
+		AURION_WARN("[Vulkan Headless] No frame with readback enabled has been rendered.");
+		return false;
+	}
+
+	const VulkanFrame& frame = m_frames[m_last_frame];
+	const VulkanHeadlessReadback& readback = m_readbacks[m_last_frame];
+
+	// The copy is recorded on the graphics queue
+	if (!m_logical_device->graphics_timeline.Wait(m_logical_device->handle, frame.graphics_timeline_value))
+		return false;
+
+	// Host cached memory may not be coherent
+	vmaInvalidateAllocation(m_logical_device->allocator, readback.allocation, 0, VK_WHOLE_SIZE);
+
+	pixels.resize((size_t)readback.size);
+	std::memcpy(pixels.data(), readback.mapped, (size_t)readback.size);
+
+	return true;
+}
+
+void VulkanHeadlessTarget::WaitIdle()
+{
+	if (!m_logical_device)
+		return;
+
+	for (const VulkanFrame& frame : m_frames)
+	{
+		m_logical_device->graphics_timeline.Wait(m_logical_device->handle, frame.graphics_timeline_value);
+		m_logical_device->compute_timeline.Wait(m_logical_device->handle, frame.compute_timeline_value);
+	}
+}
+
+const VulkanHeadlessTargetConfig& VulkanHeadlessTarget::GetConfig()
+{
+	return m_config;
+}
+
+VulkanProfiler* VulkanHeadlessTarget::GetProfiler()
+{
+	return &m_profiler;
+}
+
+void VulkanHeadlessTarget::ConsumeCompute(const VulkanComputeTicket& ticket, const VkPipelineStageFlags2& stages)
+{
+	if (ticket.value == 0)
+		return;
+
+	m_compute_wait_value = std::max(m_compute_wait_value, ticket.value);
+	m_compute_wait_stages |= stages;
+}
+
+void VulkanHeadlessTarget::Reset(const VulkanFrame& frame)
+{
+	// Wait for this frame's previous graphics and compute work in a single call
+	VkSemaphore timelines[] = { m_logical_device->graphics_timeline.handle, m_logical_device->compute_timeline.handle };
+	uint64_t values[] = { frame.graphics_timeline_value, frame.compute_timeline_value };
+
+	VkSemaphoreWaitInfo wait_info{};
+	wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	wait_info.semaphoreCount = 2;
+	wait_info.pSemaphores = timelines;
+	wait_info.pValues = values;
+
+	vkWaitSemaphores(m_logical_device->handle, &wait_info, UINT64_MAX);
+
+	vkResetCommandPool(m_logical_device->handle, frame.graphics_cmd_pool, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+	vkResetCommandPool(m_logical_device->handle, frame.compute_cmd_pool, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+}
+
+void VulkanHeadlessTarget::Record(VulkanFrame& frame)
+{
+	// No surface, so the render extent stands in for the swapchain extent
+	const VkExtent2D render_extent{ frame.image.extent.width, frame.image.extent.height };
+
+	m_command_images.resize(m_command_image_resources.size());
+	for (size_t i = 0; i < m_command_image_resources.size(); i++)
+	{
+		const VulkanRenderGraphResource* resource = m_render_graph.GetResource(m_command_image_resources[i]);
+		const VulkanTransientImageInfo& image_info = m_command_image_infos[i].image_info;
+
+		VulkanImage& image = m_command_images[i];
+		image = {};
+		image.image = resource->image;
+		image.view = resource->view;
+		image.format = image_info.format;
+		image.extent = image_info.extent.width == 0 || image_info.extent.height == 0 ? frame.image.extent : image_info.extent;
+		image.aspect_flags = image_info.aspect_flags;
+	}
+
+	VulkanCommand command_data{
+		.window_handle = m_handle,
+		.graphics_buffer = frame.graphics_cmd_buffer,
+		.compute_buffer = frame.compute_cmd_buffer,
+		.render_image = frame.image.image,
+		.render_view = frame.image.view,
+		.render_sampler = frame.image.sampler,
+		.render_extent = frame.image.extent,
+		.render_format = frame.image.format,
+		.swapchain_extent = render_extent,
+		.command_images = m_command_images,
+		.current_frame = m_current_frame,
+		.compute_recorded = m_compute_recorded,
+		.compute_consumer_stages = m_compute_consumer_stages
+	};
+
+	// Temporary commands first, then bound commands, matching windows
+	auto record = [&](const std::function<void(const VulkanCommand&)>& command, const std::string& name, const size_t& index) {
+		uint32_t graphics_scope = VulkanProfiler::c_invalid_scope;
+		uint32_t compute_scope = VulkanProfiler::c_invalid_scope;
+
+		if (m_profiler.Enabled())
+		{
+			std::string scope_name = name.empty() ? "Command " + std::to_string(index) : name;
+			graphics_scope = m_profiler.AddScope(scope_name, false, true);
+			compute_scope = m_profiler.AddScope(scope_name, true, true);
+		}
+
+		m_profiler.WriteBegin(frame.graphics_cmd_buffer, graphics_scope);
+		m_profiler.WriteBegin(frame.compute_cmd_buffer, compute_scope);
+
+		command(command_data);
+
+		m_profiler.WriteEnd(frame.graphics_cmd_buffer, graphics_scope);
+		m_profiler.WriteEnd(frame.compute_cmd_buffer, compute_scope);
+	};
+
+	size_t index = 0;
+	for (size_t i = 0; i < m_submit_commands.size(); i++)
+		record(m_submit_commands[i], m_submit_command_names[i], index++);
+	for (size_t i = 0; i < m_bound_commands.size(); i++)
+		record(m_bound_commands[i], m_bound_command_names[i], index++);
+
+	m_submit_commands.clear();
+	m_submit_command_names.clear();
+}
+
+void VulkanHeadlessTarget::Submit(VulkanFrame& frame)
+{
+	VulkanTimeline& graphics_timeline = m_logical_device->graphics_timeline;
+	VulkanTimeline& compute_timeline = m_logical_device->compute_timeline;
+
+	m_profiler.EndFrame();
+
+	// Skip compute entirely if no command recorded into it
+	const bool submit_compute = m_compute_recorded;
+
+	frame.compute_timeline_value = submit_compute ? compute_timeline.Next() : 0;
+	frame.graphics_timeline_value = graphics_timeline.Next();
+
+	uint64_t compute_wait_value = m_compute_wait_value;
+	VkPipelineStageFlags2 compute_wait_stages = m_compute_wait_stages;
+	if (submit_compute)
+	{
+		compute_wait_value = std::max(compute_wait_value, frame.compute_timeline_value);
+		compute_wait_stages |= m_compute_consumer_stages != VK_PIPELINE_STAGE_2_NONE ? m_compute_consumer_stages : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+	}
+
+	m_compute_wait_value = 0;
+	m_compute_wait_stages = VK_PIPELINE_STAGE_2_NONE;
+	m_compute_recorded = false;
+	m_compute_consumer_stages = VK_PIPELINE_STAGE_2_NONE;
+
+	VkCommandBufferSubmitInfo graphics_cmd_buffer_info{};
+	graphics_cmd_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+	graphics_cmd_buffer_info.commandBuffer = frame.graphics_cmd_buffer;
+
+	VkCommandBufferSubmitInfo compute_cmd_buffer_info{};
+	compute_cmd_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+	compute_cmd_buffer_info.commandBuffer = frame.compute_cmd_buffer;
+
+	VkSemaphoreSubmitInfo compute_signal_info = compute_timeline.SubmitInfo(frame.compute_timeline_value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+	// Without a swapchain image, graphics only waits on compute results it consumes
+	VkSemaphoreSubmitInfo graphics_wait_info = compute_timeline.SubmitInfo(compute_wait_value, compute_wait_stages);
+	VkSemaphoreSubmitInfo graphics_signal_info = graphics_timeline.SubmitInfo(frame.graphics_timeline_value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+	VkSubmitInfo2 compute_submit_info{};
+	compute_submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+	compute_submit_info.commandBufferInfoCount = 1;
+	compute_submit_info.pCommandBufferInfos = &compute_cmd_buffer_info;
+	compute_submit_info.signalSemaphoreInfoCount = 1;
+	compute_submit_info.pSignalSemaphoreInfos = &compute_signal_info;
+
+	VkSubmitInfo2 graphics_submit_info{};
+	graphics_submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+	graphics_submit_info.commandBufferInfoCount = 1;
+	graphics_submit_info.pCommandBufferInfos = &graphics_cmd_buffer_info;
+	graphics_submit_info.waitSemaphoreInfoCount = compute_wait_value > 0 ? 1 : 0;
+	graphics_submit_info.pWaitSemaphoreInfos = &graphics_wait_info;
+	graphics_submit_info.signalSemaphoreInfoCount = 1;
+	graphics_submit_info.pSignalSemaphoreInfos = &graphics_signal_info;
+
+	if (submit_compute)
+		vkQueueSubmit2(m_logical_device->compute_queue, 1, &compute_submit_info, VK_NULL_HANDLE);
+	vkQueueSubmit2(m_logical_device->graphics_queue, 1, &graphics_submit_info, VK_NULL_HANDLE);
+}
+
+void VulkanHeadlessTarget::CopyImageToReadback(const VkCommandBuffer& cmd_buffer, const VulkanFrame& frame, const VulkanHeadlessReadback& readback)
+{
+	// Tightly packed, row after row
+	VkBufferImageCopy2 region{
+		.sType = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2,
+		.bufferOffset = 0,
+		.bufferRowLength = 0,
+		.bufferImageHeight = 0,
+		.imageSubresource = {
+			.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+			.mipLevel = 0,
+			.baseArrayLayer = 0,
+			.layerCount = 1
+		},
+		.imageOffset = { 0, 0, 0 },
+		.imageExtent = {
+			.width = frame.image.extent.width,
+			.height = frame.image.extent.height,
+			.depth = 1
+		}
+	};
+
+	VkCopyImageToBufferInfo2 copy_info{
+		.sType = VK_STRUCTURE_TYPE_COPY_IMAGE_TO_BUFFER_INFO_2,
+		.srcImage = frame.image.image,
+		.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		.dstBuffer = readback.buffer,
+		.regionCount = 1,
+		.pRegions = &region
+	};
+
+	vkCmdCopyImageToBuffer2(cmd_buffer, &copy_info);
+}
+
+bool VulkanHeadlessTarget::CreateFrame(VulkanFrame& frame, VulkanHeadlessReadback& readback)
+{
+	// Render Image
+	{
+		VulkanImageCreateInfo create_info{};
+		create_info.extent = VkExtent3D{
+			.width = m_config.extent.width,
+			.height = m_config.extent.height,
+			.depth = 1
+		};
+		create_info.format = m_config.format;
+
+		create_info.usage_flags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		create_info.usage_flags |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		create_info.usage_flags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		create_info.usage_flags |= VK_IMAGE_USAGE_SAMPLED_BIT;
+
+		// Software implementations don't always support storage on 8-bit BGRA formats
+		VkFormatProperties format_properties{};
+		vkGetPhysicalDeviceFormatProperties(m_logical_device->physical_device, m_config.format, &format_properties);
+		if (format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)
+			create_info.usage_flags |= VK_IMAGE_USAGE_STORAGE_BIT;
+
+		create_info.aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+
+		// Frame images are written by both the graphics and compute queues
+		create_info.queue_family_indices = m_logical_device->queue_families.data();
+		create_info.queue_family_count = static_cast<uint32_t>(m_logical_device->queue_families.size());
+
+		frame.image = VulkanImage::Create(m_logical_device->handle, m_logical_device->allocator, create_info);
+		if (frame.image.image == VK_NULL_HANDLE)
+			return false;
+	}
+
+	frame.transient_pool.Initialize(m_logical_device->handle, m_logical_device->allocator);
+
+	// Command Pools
+	{
+		VkCommandPoolCreateInfo pool_info{};
+		pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+
+		pool_info.queueFamilyIndex = m_logical_device->graphics_queue_index.value();
+		if (vkCreateCommandPool(m_logical_device->handle, &pool_info, nullptr, &frame.graphics_cmd_pool) != VK_SUCCESS)
+			return false;
+
+		pool_info.queueFamilyIndex = m_logical_device->compute_queue_index.value();
+		if (vkCreateCommandPool(m_logical_device->handle, &pool_info, nullptr, &frame.compute_cmd_pool) != VK_SUCCESS)
+			return false;
+	}
+
+	// Command Buffers
+	{
+		VkCommandBufferAllocateInfo buffer_info{};
+		buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		buffer_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		buffer_info.commandBufferCount = 1;
+
+		buffer_info.commandPool = frame.graphics_cmd_pool;
+		if (vkAllocateCommandBuffers(m_logical_device->handle, &buffer_info, &frame.graphics_cmd_buffer) != VK_SUCCESS)
+			return false;
+
+		buffer_info.commandPool = frame.compute_cmd_pool;
+		if (vkAllocateCommandBuffers(m_logical_device->handle, &buffer_info, &frame.compute_cmd_buffer) != VK_SUCCESS)
+			return false;
+	}
+
+	// Readback buffers are only created when readback is enabled
+	if (m_config.readback_enabled && !this->CreateReadback(readback))
+		return false;
+
+	return true;
+}
+
+bool VulkanHeadlessTarget::CreateReadback(VulkanHeadlessReadback& readback)
+{
+	readback.size = (VkDeviceSize)m_config.extent.width * m_config.extent.height * VulkanImage::GetTexelSize(m_config.format);
+
+	VkBufferCreateInfo buffer_info{};
+	buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_info.size = readback.size;
+	buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	// Read back through cached host memory where available
+	VmaAllocationCreateInfo alloc_info{};
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+	alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VmaAllocationInfo allocation_info{};
+	if (vmaCreateBuffer(m_logical_device->allocator, &buffer_info, &alloc_info, &readback.buffer, &readback.allocation, &allocation_info) != VK_SUCCESS)
+	{
+		readback = {};
+		return false;
+	}
+
+	readback.mapped = allocation_info.pMappedData;
+	return true;
+}
+
+void VulkanHeadlessTarget::DestroyFrame(VulkanFrame& frame, VulkanHeadlessReadback& readback)
+{
+	vkDestroyCommandPool(m_logical_device->handle, frame.graphics_cmd_pool, nullptr);
+	vkDestroyCommandPool(m_logical_device->handle, frame.compute_cmd_pool, nullptr);
+	frame.graphics_cmd_pool = VK_NULL_HANDLE;
+	frame.compute_cmd_pool = VK_NULL_HANDLE;
+
+	frame.transient_pool.Destroy();
+
+	vkDestroySampler(m_logical_device->handle, frame.image.sampler, nullptr);
+	vkDestroyImageView(m_logical_device->handle, frame.image.view, nullptr);
+	vmaDestroyImage(m_logical_device->allocator, frame.image.image, frame.image.allocation);
+	frame.image = {};
+
+	if (readback.buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, readback.buffer, readback.allocation);
+	readback = {};
+}
\ No newline at end of file
@@ -1,3 +1,7 @@
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
 #include <vulkan/vulkan.h>
 #include <vma/vk_mem_alloc.h>
 
@@ -9,20 +13,28 @@ VulkanImage VulkanImage::Create(const VkDevice& logical_device, const VmaAllocat
 
 	out_image.extent = create_info.extent;
 	out_image.format = create_info.format;
+	out_image.type = create_info.image_type;
+	out_image.aspect_flags = create_info.aspect_flags;
+	out_image.mip_levels = create_info.mip_levels == c_full_mip_chain ? GetMipLevelCount(create_info.extent) : create_info.mip_levels;
+
+	// 3D images can't have layers, and 2D images are a single slice deep
+	out_image.array_layers = create_info.image_type == VK_IMAGE_TYPE_3D ? 1 : std::max(create_info.array_layers, 1u);
+	if (create_info.image_type != VK_IMAGE_TYPE_3D)
+		out_image.extent.depth = 1;
 
 	// Image Creation
 	VkImageCreateInfo imageCreateInfo{};
 	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 	imageCreateInfo.pNext = nullptr;
 
-	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageCreateInfo.imageType = out_image.type;
 	imageCreateInfo.initialLayout = create_info.initial_layout;
 
 	imageCreateInfo.format = create_info.format;
-	imageCreateInfo.extent = create_info.extent;
+	imageCreateInfo.extent = out_image.extent;
 
-	imageCreateInfo.mipLevels = 1;
-	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.mipLevels = out_image.mip_levels;
+	imageCreateInfo.arrayLayers = out_image.array_layers;
 
 	// For MSAA
 	imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -31,6 +43,16 @@ VulkanImage VulkanImage::Create(const VkDevice& logical_device, const VmaAllocat
 	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
 	imageCreateInfo.usage = create_info.usage_flags;
 
+	// Share across queue families instead of transferring ownership between them
+	if (create_info.queue_family_count > 1)
+	{
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+		imageCreateInfo.queueFamilyIndexCount = create_info.queue_family_count;
+		imageCreateInfo.pQueueFamilyIndices = create_info.queue_family_indices;
+	}
+	else
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
 	// Allocate image from gpu local memory
 	VmaAllocationCreateInfo imgAllocInfo{};
 	imgAllocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
@@ -43,13 +65,20 @@ VulkanImage VulkanImage::Create(const VkDevice& logical_device, const VmaAllocat
 	viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 	viewCreateInfo.pNext = nullptr;
 
-	viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	// The view covers every level and layer
+	if (out_image.type == VK_IMAGE_TYPE_3D)
+		viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
+	else if (out_image.array_layers > 1)
+		viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+	else
+		viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+
 	viewCreateInfo.image = out_image.image;
 	viewCreateInfo.format = out_image.format;
 	viewCreateInfo.subresourceRange.baseMipLevel = 0;
-	viewCreateInfo.subresourceRange.levelCount = 1;
+	viewCreateInfo.subresourceRange.levelCount = out_image.mip_levels;
 	viewCreateInfo.subresourceRange.baseArrayLayer = 0;
-	viewCreateInfo.subresourceRange.layerCount = 1;
+	viewCreateInfo.subresourceRange.layerCount = out_image.array_layers;
 	viewCreateInfo.subresourceRange.aspectMask = create_info.aspect_flags;
 
 	vkCreateImageView(logical_device, &viewCreateInfo, nullptr, &out_image.view);
@@ -72,17 +101,183 @@ VulkanImage VulkanImage::Create(const VkDevice& logical_device, const VmaAllocat
 	return out_image;
 }
 
-void VulkanImage::TransitionLayout(const VkCommandBuffer& cmd_buffer, const VkImage& image, const VkImageLayout& src, const VkImageLayout& dst)
+uint32_t VulkanImage::GetMipLevelCount(const VkExtent3D& extent)
+{
+	uint32_t largest = std::max({ extent.width, extent.height, extent.depth, 1u });
+
+	uint32_t levels = 1;
+	while (largest > 1)
+	{
+		largest >>= 1;
+		levels++;
+	}
+
+	return levels;
+}
+
+uint32_t VulkanImage::GetTexelSize(const VkFormat& format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_R8G8B8A8_UNORM:
+	case VK_FORMAT_R8G8B8A8_SRGB:
+	case VK_FORMAT_B8G8R8A8_UNORM:
+	case VK_FORMAT_B8G8R8A8_SRGB:
+	case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+	case VK_FORMAT_R32_SFLOAT:
+		return 4;
+	case VK_FORMAT_R16G16B16A16_SFLOAT:
+		return 8;
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+bool VulkanImage::SupportsMipGeneration(const VkPhysicalDevice& physical_device, const VkFormat& format)
+{
+	VkFormatProperties format_properties{};
+	vkGetPhysicalDeviceFormatProperties(physical_device, format, &format_properties);
+
+	const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+	return (format_properties.optimalTilingFeatures & required) == required;
+}
+
+void VulkanImage::GenerateMips(const VkCommandBuffer& cmd_buffer, const VulkanImage& image,
+	const VkImageLayout& src_layout, const VkImageLayout& dst_layout, const VkFilter& filter)
+{
+	GenerateMips(cmd_buffer, std::vector<const VulkanImage*>{ &image }, src_layout, dst_layout, filter);
+}
+
+void VulkanImage::GenerateMips(const VkCommandBuffer& cmd_buffer, const std::vector<const VulkanImage*>& images,
+	const VkImageLayout& src_layout, const VkImageLayout& dst_layout, const VkFilter& filter)
+{
+	std::vector<VkImageMemoryBarrier2> barriers;
+	barriers.reserve(images.size() * 2);
+
+	VkDependencyInfo dep_info{};
+	dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+
+	auto make_barrier = [](const VulkanImage& image, const uint32_t& base_level, const uint32_t& level_count,
+		const VkImageLayout& old_layout, const VkImageLayout& new_layout,
+		const VkPipelineStageFlags2& src_stages, const VkAccessFlags2& src_access,
+		const VkPipelineStageFlags2& dst_stages, const VkAccessFlags2& dst_access)
+	{
+		VkImageMemoryBarrier2 barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+		barrier.srcStageMask = src_stages;
+		barrier.srcAccessMask = src_access;
+		barrier.dstStageMask = dst_stages;
+		barrier.dstAccessMask = dst_access;
+		barrier.oldLayout = old_layout;
+		barrier.newLayout = new_layout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image.image;
+		barrier.subresourceRange.aspectMask = image.aspect_flags;
+		barrier.subresourceRange.baseMipLevel = base_level;
+		barrier.subresourceRange.levelCount = level_count;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = image.array_layers;
+		return barrier;
+	};
+
+	// Level 0 becomes the first blit source, and every other level a destination. Their previous contents are discarded.
+	uint32_t max_levels = 0;
+	for (const VulkanImage* image : images)
+	{
+		max_levels = std::max(max_levels, image->mip_levels);
+
+		barriers.push_back(make_barrier(*image, 0, 1, src_layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_BLIT_BIT, VK_ACCESS_2_TRANSFER_READ_BIT));
+
+		if (image->mip_levels > 1)
+		{
+			barriers.push_back(make_barrier(*image, 1, image->mip_levels - 1, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_NONE,
+				VK_PIPELINE_STAGE_2_BLIT_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT));
+		}
+	}
+
+	dep_info.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+	dep_info.pImageMemoryBarriers = barriers.data();
+	vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+
+	// Each level is blitted from the one above it, then made the source for the next
+	for (uint32_t level = 1; level < max_levels; level++)
+	{
+		barriers.clear();
+
+		for (const VulkanImage* image : images)
+		{
+			if (level >= image->mip_levels)
+				continue;
+
+			VkImageBlit2 blit{};
+			blit.sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2;
+			blit.srcSubresource = { image->aspect_flags, level - 1, 0, image->array_layers };
+			blit.srcOffsets[1] = {
+				static_cast<int32_t>(std::max(image->extent.width >> (level - 1), 1u)),
+				static_cast<int32_t>(std::max(image->extent.height >> (level - 1), 1u)),
+				static_cast<int32_t>(std::max(image->extent.depth >> (level - 1), 1u))
+			};
+			blit.dstSubresource = { image->aspect_flags, level, 0, image->array_layers };
+			blit.dstOffsets[1] = {
+				static_cast<int32_t>(std::max(image->extent.width >> level, 1u)),
+				static_cast<int32_t>(std::max(image->extent.height >> level, 1u)),
+				static_cast<int32_t>(std::max(image->extent.depth >> level, 1u))
+			};
+
+			VkBlitImageInfo2 blit_info{};
+			blit_info.sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2;
+			blit_info.srcImage = image->image;
+			blit_info.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			blit_info.dstImage = image->image;
+			blit_info.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			blit_info.regionCount = 1;
+			blit_info.pRegions = &blit;
+			blit_info.filter = filter;
+
+			vkCmdBlitImage2(cmd_buffer, &blit_info);
+
+			barriers.push_back(make_barrier(*image, level, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				VK_PIPELINE_STAGE_2_BLIT_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_BLIT_BIT, VK_ACCESS_2_TRANSFER_READ_BIT));
+		}
+
+		dep_info.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+		dep_info.pImageMemoryBarriers = barriers.data();
+		vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+	}
+
+	// Every level is now a transfer source; hand them all over in their final layout
+	barriers.clear();
+	for (const VulkanImage* image : images)
+	{
+		barriers.push_back(make_barrier(*image, 0, image->mip_levels, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst_layout,
+			VK_PIPELINE_STAGE_2_BLIT_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT));
+	}
+
+	dep_info.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+	dep_info.pImageMemoryBarriers = barriers.data();
+	vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+}
+
+void VulkanImage::TransitionLayout(const VkCommandBuffer& cmd_buffer, const VkImage& image, const VkImageLayout& src, const VkImageLayout& dst,
+	const VkPipelineStageFlags2& src_stages, const VkAccessFlags2& src_access, const VkPipelineStageFlags2& dst_stages, const VkAccessFlags2& dst_access,
+	const VkImageAspectFlags& aspect_flags)
 {
 	VkImageMemoryBarrier2 barrier{};
 	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
 	barrier.pNext = nullptr;
 
-	// This is a bit general, and not at all optimal. Future TODO: Allow custom masks
-	barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-	barrier.srcAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
-	barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-	barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+	barrier.srcStageMask = src_stages;
+	barrier.srcAccessMask = src_access;
+	barrier.dstStageMask = dst_stages;
+	barrier.dstAccessMask = dst_access;
 
 	// Transition from old to new layout
 	barrier.oldLayout = src;
@@ -90,7 +285,7 @@ void VulkanImage::TransitionLayout(const VkCommandBuffer& cmd_buffer, const VkIm
 
 	// Create Image Subresource Range with aspect mask
 	VkImageSubresourceRange sub_image{};
-	sub_image.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	sub_image.aspectMask = aspect_flags;
 	sub_image.baseMipLevel = 0;
 	sub_image.levelCount = VK_REMAINING_MIP_LEVELS;
 	sub_image.baseArrayLayer = 0;
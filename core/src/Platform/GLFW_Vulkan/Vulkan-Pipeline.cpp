@@ -2,16 +2,37 @@
 
 #include <string>
 #include <vector>
+#include <deque>
 #include <cstdint>
 #include <thread>
+#include <future>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
 
 #include <shaderc/shaderc.hpp>
 #include <spirv_cross/spirv_cross.hpp>
 #include <vulkan/vulkan.h>
 
 import Vulkan;
+import Jobs;
 import Aurion.FileSystem;
 
+// NOTE: Paths are relative to the working directory, like every other asset path
+constexpr const char* c_default_shader_cache_path = "assets/shaders/cached/shader-cache.bin";
+constexpr const char* c_shader_include_root = "assets/shaders";
+
+// Bump whenever compilation changes in a way the cache key can't see (e.g. a shaderc upgrade)
+constexpr uint32_t c_shader_compile_options_version = 1;
+constexpr shaderc_optimization_level c_shader_optimization_level = shaderc_optimization_level_performance;
+
+// Task and mesh shaders need SPIR-V 1.4 or newer
+constexpr shaderc_env_version c_shader_target_env_version = shaderc_env_version_vulkan_1_3;
+
 VulkanPipelineBuilder::VulkanPipelineBuilder()
 {
 
@@ -22,14 +43,38 @@ VulkanPipelineBuilder::~VulkanPipelineBuilder()
 	this->Cleanup();
 }
 
-void VulkanPipelineBuilder::Initialize(VulkanDevice* device, std::vector<VulkanPipeline>& pipeline_buffer)
+void VulkanPipelineBuilder::Initialize(VulkanDevice* device, std::deque<VulkanPipeline>& pipeline_buffer)
 {
 	m_logical_device = device;
 	m_pipeline_buffer = &pipeline_buffer;
+
+	// Load the SPIR-V cache up front, in a single read
+	m_shader_cache = std::make_shared<VulkanShaderCache>();
+	m_shader_cache->Load(c_default_shader_cache_path);
+
+	// Built configurations are retained here, so pipelines can be rebuilt later
+	m_hot_reload = std::make_shared<HotReloadState>();
+	m_hot_reload->device = m_logical_device;
+	m_hot_reload->shader_cache = m_shader_cache;
 }
 
 void VulkanPipelineBuilder::Cleanup()
 {
+	// Let any in-flight compilations finish; their results are no longer needed
+	for (auto& pending : m_pending_shaders)
+		if (pending.output.valid())
+			pending.output.wait();
+	m_pending_shaders.clear();
+
+	// Stop reloading. Retained layouts are owned by the built pipelines, so they're only forgotten here
+	if (m_hot_reload)
+	{
+		m_hot_reload->watcher.Stop();
+
+		std::unique_lock<std::mutex> lock(m_hot_reload->mutex);
+		m_hot_reload->retained.clear();
+	}
+
 	for (size_t i = 0; i < m_configurations.size(); i++)
 	{
 		VulkanPipelineConfiguration& config = m_configurations[i];
@@ -109,12 +154,16 @@ VulkanPipelineBuilder& VulkanPipelineBuilder::Configure(const VkStructureType& p
 
 VulkanPipelineBuilder::Result VulkanPipelineBuilder::Build()
 {
+	// Shader modules must exist before any pipeline can be created
+	this->ResolvePendingShaders();
+
 	std::vector<VkPipeline> compute_pipeline_refs;
 	std::vector<VkPipeline> graphics_pipeline_refs;
 	std::vector<VkPipeline> raytracing_pipeline_refs;
 	std::vector<VkComputePipelineCreateInfo> compute_creates;
 	std::vector<VkGraphicsPipelineCreateInfo> graphics_creates;
 	std::vector<VkRayTracingPipelineCreateInfoKHR> raytracing_creates;
+	std::vector<size_t> pipeline_indices;
 
 	// Setup pipeline buffers for each type
 	for (size_t i = 0; i < m_configurations.size(); i++)
@@ -122,6 +171,7 @@ VulkanPipelineBuilder::Result VulkanPipelineBuilder::Build()
 		// Create a pipeline in the buffer for each configuration
 		m_pipeline_buffer->emplace_back(VulkanPipeline{});
 		VulkanPipeline& pipeline = m_pipeline_buffer->back();
+		pipeline_indices.emplace_back(m_pipeline_buffer->size() - 1);
 
 		// Grab an easy ref to the current configuration
 		VulkanPipelineConfiguration& config = m_configurations[i];
@@ -149,28 +199,8 @@ VulkanPipelineBuilder::Result VulkanPipelineBuilder::Build()
 			}
 			case VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO:
 			{
-				// Attach all graphics configuration data
-				config.graphics_info.pVertexInputState = &config.vertex_input_state;
-				config.graphics_info.pInputAssemblyState = &config.input_assembly_state;
-				config.graphics_info.pTessellationState = &config.tessellation_state;
-				config.graphics_info.pViewportState = &config.viewport_state;
-				config.graphics_info.pRasterizationState = &config.rasterization_state;
-				config.graphics_info.pMultisampleState = &config.multisample_state;
-				config.graphics_info.pDepthStencilState = &config.depth_stencil_state;
-				config.graphics_info.pColorBlendState = &config.color_blend_state;
-				config.graphics_info.pDynamicState = &config.dynamic_state;
-
-				// For pipeline derivation (unused)
-				config.graphics_info.basePipelineHandle = VK_NULL_HANDLE;
-				config.graphics_info.basePipelineIndex = -1;
-
-				// Attach dynamic rendering information (if using)
-				if (config.use_dynamic_rendering)
-					config.graphics_info.pNext = &config.dynamic_render_info;
-
-				// Attach shader stages
-				config.graphics_info.stageCount = static_cast<uint32_t>(config.shader_stages.size());
-				config.graphics_info.pStages = config.shader_stages.data();
+				// Attach all graphics configuration data and shader stages
+				VulkanPipelineBuilder::AttachGraphicsState(config);
 
 				// Grab references
 				graphics_creates.emplace_back(config.graphics_info);
@@ -267,7 +297,29 @@ VulkanPipelineBuilder::Result VulkanPipelineBuilder::Build()
 		VulkanPipelineConfiguration& config = m_configurations[i];
 
 		for (size_t j = 0; j < config.shader_stages.size(); j++)
+		{
 			vkDestroyShaderModule(m_logical_device->handle, config.shader_stages[j].module, nullptr);
+			config.shader_stages[j].module = VK_NULL_HANDLE;
+		}
+	}
+
+	// Retain compute and graphics configurations for hot reloading. They're moved, not copied,
+	//	since their state structures point into their own vectors.
+	{
+		std::unique_lock<std::mutex> lock(m_hot_reload->mutex);
+
+		for (size_t i = 0; i < m_configurations.size(); i++)
+		{
+			VulkanPipelineConfiguration& config = m_configurations[i];
+
+			if (config.type != VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO && config.type != VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO)
+				continue;
+
+			m_hot_reload->retained.emplace_back(RetainedPipeline{
+				.pipeline_index = pipeline_indices[i],
+				.config = std::move(config)
+			});
+		}
 	}
 
 	// Reset configuration state
@@ -277,17 +329,26 @@ VulkanPipelineBuilder::Result VulkanPipelineBuilder::Build()
 	return m_build_result;
 }
 
+void VulkanPipelineBuilder::SetShaderCachePath(const std::string& archive_path)
+{
+	// Flush anything produced against the previous archive first
+	if (!m_shader_cache->GetArchivePath().empty())
+		m_shader_cache->Save();
+
+	m_shader_cache->Load(archive_path);
+}
+
 VulkanPipelineBuilder& VulkanPipelineBuilder::BindShader(const VkShaderStageFlagBits& shader_stage, const VkPipelineShaderStageCreateFlags& create_flags, const std::string& file_path, bool is_hlsl, const char* entry_point)
 {
 	// Grab the current configuration
 	VulkanPipelineConfiguration& config = m_configurations.back();
 
-	// Setup shader stage
+	// Setup shader stage. The module and entry point name are attached in Build()
 	VkPipelineShaderStageCreateInfo shader_stage_create_info{
 		.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
 		.flags = create_flags,
 		.stage = shader_stage,
-		.pName = entry_point,
+		.module = VK_NULL_HANDLE,
 	};
 
 	// NOTE: This is WINDOWS only!!!! 
@@ -303,127 +364,181 @@ VulkanPipelineBuilder& VulkanPipelineBuilder::BindShader(const VkShaderStageFlag
 	// Open the file (don't force create it)
 	Aurion::FSFileHandle raw_handle = fs.OpenFile(file_path.c_str(), false);
 
-	// Remove file extension and replace with .spv
-	size_t ext_start = file_path.find_last_of('.');
-	size_t base_start = file_path.find_last_of('/');
-
-	// Strip extension
-	std::string path_no_ext = file_path.substr(0, ext_start);
+	// Copy everything the worker needs, the file handle doesn't outlive this call.
+	//	The full path doubles as the source name, so relative includes can be resolved.
+	std::string source_text((const char*)raw_handle.Read());
+	std::string entry_point_name = entry_point;
+	shaderc_shader_kind shader_kind = VkShaderToShaderc(shader_stage);
+	std::shared_ptr<VulkanShaderCache> cache = m_shader_cache;
+
+	// Track the compilation so Build() can join it. Compilation takes a while (~300+ ms),
+	//	so it is spread across the job system.
+	PendingShader pending{};
+	pending.config_index = m_configurations.size() - 1;
+	pending.stage_index = config.shader_stages.size();
+	pending.output = JobSystem::Get()->Submit([cache, source_text, file_path, shader_kind, is_hlsl, entry_point_name]() {
+		return VulkanPipelineBuilder::CompileShader(cache, source_text, file_path, shader_kind, is_hlsl, entry_point_name);
+	}).share();
+
+	// Reserve the shader stage in the current configuration
+	config.shader_stages.emplace_back(shader_stage_create_info);
+	config.shader_sources.emplace_back(VulkanShaderSource{
+		.file_path = file_path,
+		.stage = shader_stage,
+		.create_flags = create_flags,
+		.is_hlsl = is_hlsl,
+		.entry_point = entry_point
+	});
 
-	// Strip path to get file name
-	std::string file_name = path_no_ext.substr(base_start);
+	m_pending_shaders.emplace_back(std::move(pending));
 
-	// Configure the local cache path for the SPIR-V binary of this shader
-	//	NOTE: CACHE PATH SHOULD BE DYNAMIC, NOT A MAGIC VALUE!
-	std::string local_cache_path = "assets/shaders/cached/" + file_name + ".spv";
+	return *this;
+}
 
-	// If the SPIR-V binary exists
-	if (fs.FileExists(local_cache_path.c_str()))
-	{
-		// Load the SPIR-V binary
-		Aurion::FSFileHandle spv_handle = fs.OpenFile(local_cache_path.c_str(), false);
-		uint32_t* binary_data = (uint32_t*)spv_handle.Read();
-		size_t binary_size = spv_handle.GetSize() - 1;
+VulkanPipelineBuilder::ShaderCompileOutput VulkanPipelineBuilder::CompileShader(const std::shared_ptr<VulkanShaderCache>& cache, const std::string& source_text, const std::string& source_name, const shaderc_shader_kind& kind, const bool& is_hlsl, const std::string& entry_point)
+{
+	ShaderCompileOutput output{};
 
-		// Generate Shader Module
-		{
-			VkShaderModuleCreateInfo shader_module_info{};
-			shader_module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-			shader_module_info.codeSize = binary_size;
-			shader_module_info.pCode = binary_data;
+	auto compile_start = std::chrono::steady_clock::now();
 
-			// Attempt to generate the shader module
-			if (vkCreateShaderModule(m_logical_device->handle, &shader_module_info, nullptr, &shader_stage_create_info.module) != VK_SUCCESS)
-			{
-				AURION_ERROR("[Vulkan Pipeline Builder] Faile d to bind shader: VkShaderModule creation failed.");
-				return *this;
-			}
+	shaderc::Compiler compiler;
+	shaderc::CompileOptions options;
 
-			// Copy the shader stage info into the current configuration
-			config.shader_stages.emplace_back(shader_stage_create_info);
-		}
+	options.SetOptimizationLevel(c_shader_optimization_level);
+	options.SetTargetEnvironment(shaderc_target_env_vulkan, c_shader_target_env_version);
+	options.SetSourceLanguage(is_hlsl ? shaderc_source_language_hlsl : shaderc_source_language_glsl);
+	options.SetIncluder(std::make_unique<VulkanShaderIncluder>(c_shader_include_root));
+
+	// Resolve all includes and macros first, so the cache key reflects exactly what gets compiled
+	shaderc::PreprocessedSourceCompilationResult preprocessed = compiler.PreprocessGlsl(
+		source_text.c_str(),
+		source_text.size(),
+		kind,
+		source_name.c_str(),
+		options
+	);
 
-		// Compile and replace the cached version
-		//	TODO: Compilation takes a while (~300+ ms), so spinning up another thread for this would be ideal
-		//	NOTE: This is dead code right now. Recompilation will be supported later. To force the recompilation
-		//			of a shader, the .spv file must be manually deleted
-		if (false)
-		{
-			shaderc::Compiler compiler;
-			shaderc::CompileOptions options;
-
-			options.SetOptimizationLevel(shaderc_optimization_level_performance);
-			options.SetSourceLanguage(is_hlsl ? shaderc_source_language_hlsl : shaderc_source_language_glsl);
-
-			shaderc::SpvCompilationResult spv_compiled = compiler.CompileGlslToSpv(
-				(const char*)raw_handle.Read(),
-				VkShaderToShaderc(shader_stage),
-				raw_handle.GetInfo().name,
-				options
-			);
-
-			if (spv_compiled.GetCompilationStatus() != shaderc_compilation_status_success) {
-				AURION_ERROR("Shaderc Compilation Error: %s", spv_compiled.GetErrorMessage().c_str());
-				return *this;
-			}
+	if (preprocessed.GetCompilationStatus() != shaderc_compilation_status_success)
+	{
+		output.error = preprocessed.GetErrorMessage();
+		output.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - compile_start).count();
+		return output;
+	}
 
-			// Once successfully compiled, write to the cached location
-			std::vector<uint32_t> compilation_result(spv_compiled.begin(), spv_compiled.end());
+	// Cache key: preprocessed source, stage, entry point and compile options
+	const uint32_t option_key[] = {
+		static_cast<uint32_t>(kind),
+		static_cast<uint32_t>(is_hlsl),
+		static_cast<uint32_t>(c_shader_optimization_level),
+		static_cast<uint32_t>(c_shader_target_env_version),
+		c_shader_compile_options_version
+	};
 
-			// Overwrite existing compiled binary
-			spv_handle.Write(compilation_result.data(), compilation_result.size() * sizeof(uint32_t), 0);
-		}
+	output.cache_key = VulkanShaderCache::Hash(preprocessed.cbegin(), static_cast<size_t>(preprocessed.cend() - preprocessed.cbegin()));
+	output.cache_key = VulkanShaderCache::Hash(option_key, sizeof(option_key), output.cache_key);
+	output.cache_key = VulkanShaderCache::Hash(entry_point, output.cache_key);
 
-		return *this;
+	// Skip compilation entirely on a cache hit
+	if (cache->Find(output.cache_key, output.spirv))
+	{
+		output.from_cache = true;
+		output.succeeded = true;
+		output.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - compile_start).count();
+		return output;
 	}
 
-	// If the SPIR-V binary doesn't exist:
-
-	// First, generate the file handle for the desired directory
-	Aurion::FSFileHandle spv_handle = fs.OpenFile(local_cache_path.c_str(), true);
-
 	// Compile the raw shader into SPIR-V
-	shaderc::Compiler compiler;
-	shaderc::CompileOptions options;
-
-	options.SetOptimizationLevel(shaderc_optimization_level_performance);
-	options.SetSourceLanguage(is_hlsl ? shaderc_source_language_hlsl : shaderc_source_language_glsl);
-
 	shaderc::SpvCompilationResult spv_compiled = compiler.CompileGlslToSpv(
-		(const char*)raw_handle.Read(),
-		VkShaderToShaderc(shader_stage),
-		raw_handle.GetInfo().name,
+		source_text.c_str(),
+		source_text.size(),
+		kind,
+		source_name.c_str(),
+		entry_point.c_str(),
 		options
 	);
 
-	if (spv_compiled.GetCompilationStatus() != shaderc_compilation_status_success) {
-		AURION_ERROR("Shaderc Compilation Error: %s", spv_compiled.GetErrorMessage().c_str());
-		return *this;
+	output.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - compile_start).count();
+
+	if (spv_compiled.GetCompilationStatus() != shaderc_compilation_status_success)
+	{
+		output.error = spv_compiled.GetErrorMessage();
+		return output;
 	}
 
-	// Convert to vector for ease of use
-	std::vector<uint32_t> compilation_result(spv_compiled.begin(), spv_compiled.end());
+	output.spirv.assign(spv_compiled.begin(), spv_compiled.end());
+	output.succeeded = true;
+
+	// Make the binary available to later builds and sessions
+	cache->Store(output.cache_key, output.spirv);
+
+	return output;
+}
 
-	// After compilation succeeds, generate the shader module
-	VkShaderModuleCreateInfo shader_module_info{};
-	shader_module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-	shader_module_info.codeSize = compilation_result.size() * sizeof(uint32_t);
-	shader_module_info.pCode = compilation_result.data();
+void VulkanPipelineBuilder::ResolvePendingShaders()
+{
+	m_build_result.shader_timings.clear();
 
-	// Attempt to generate the shader module
-	if (vkCreateShaderModule(m_logical_device->handle, &shader_module_info, nullptr, &shader_stage_create_info.module) != VK_SUCCESS)
+	// Join every compilation. They all run concurrently, so this costs roughly the slowest shader.
+	for (auto& pending : m_pending_shaders)
 	{
-		AURION_ERROR("[Vulkan Pipeline Builder] Faile d to bind shader: VkShaderModule creation failed.");
-		return *this;
+		const ShaderCompileOutput& output = JobSystem::Get()->Wait(pending.output);
+
+		VulkanPipelineConfiguration& config = m_configurations[pending.config_index];
+		VulkanShaderSource& source = config.shader_sources[pending.stage_index];
+
+		m_build_result.shader_timings.emplace_back(VulkanShaderTiming{
+			.file_path = source.file_path,
+			.stage = source.stage,
+			.milliseconds = output.milliseconds,
+			.from_cache = output.from_cache,
+			.succeeded = output.succeeded
+		});
+
+		if (!output.succeeded)
+		{
+			AURION_ERROR("Shaderc Compilation Error (%s): %s", source.file_path.c_str(), output.error.c_str());
+			continue;
+		}
+
+		// Generate the shader module
+		VkShaderModuleCreateInfo shader_module_info{};
+		shader_module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		shader_module_info.codeSize = output.spirv.size() * sizeof(uint32_t);
+		shader_module_info.pCode = output.spirv.data();
+
+		if (vkCreateShaderModule(m_logical_device->handle, &shader_module_info, nullptr, &config.shader_stages[pending.stage_index].module) != VK_SUCCESS)
+		{
+			AURION_ERROR("[Vulkan Pipeline Builder] Failed to bind shader: VkShaderModule creation failed.");
+			continue;
+		}
+
+		// Remember which binary this module came from, so hot reloads can skip unchanged shaders
+		source.cache_key = output.cache_key;
+
+		AURION_TRACE("[Vulkan Pipeline Builder] %s %s in %.2f ms", 
+			output.from_cache ? "Loaded" : "Compiled", source.file_path.c_str(), output.milliseconds);
 	}
+	m_pending_shaders.clear();
 
-	// Then, cache the shader binary on disk
-	spv_handle.Write(compilation_result.data(), compilation_result.size() * sizeof(uint32_t), 0);
+	// Persist newly compiled binaries in one write
+	m_shader_cache->Save();
 
-	// And copy the shader stage info into the current configuration
-	config.shader_stages.emplace_back(shader_stage_create_info);
+	for (auto& config : m_configurations)
+	{
+		// Drop any stage that failed to produce a shader module
+		for (size_t i = config.shader_stages.size(); i-- > 0;)
+		{
+			if (config.shader_stages[i].module != VK_NULL_HANDLE)
+				continue;
 
-	return *this;
+			config.shader_stages.erase(config.shader_stages.begin() + i);
+			config.shader_sources.erase(config.shader_sources.begin() + i);
+		}
+
+		// Entry point names live with the configuration, so only point at them once it stops moving
+		for (size_t i = 0; i < config.shader_stages.size(); i++)
+			config.shader_stages[i].pName = config.shader_sources[i].entry_point.c_str();
+	}
 }
 
 VulkanPipelineBuilder& VulkanPipelineBuilder::ConfigurePipelineLayout(const VkPipelineLayoutCreateFlags& create_flags)
@@ -1472,6 +1587,283 @@ VulkanPipelineBuilder& VulkanPipelineBuilder::BuildDynamicState()
 	return *this;
 }
 
+void VulkanPipelineBuilder::EnableHotReload(const std::string& watch_directory)
+{
+	if (!m_hot_reload || m_hot_reload->watcher.Running())
+		return;
+
+	// The state outlives the watcher thread, which is always joined first
+	HotReloadState* state = m_hot_reload.get();
+
+	m_hot_reload->watcher.Start(watch_directory, [state](const std::vector<std::string>& changed_files) {
+		VulkanPipelineBuilder::ReloadPipelines(state, changed_files);
+	});
+
+	AURION_INFO("[Vulkan Pipeline Builder] Hot reloading shaders in %s", watch_directory.c_str());
+}
+
+void VulkanPipelineBuilder::DisableHotReload()
+{
+	if (!m_hot_reload)
+		return;
+
+	m_hot_reload->watcher.Stop();
+
+	std::unique_lock<std::mutex> lock(m_hot_reload->mutex);
+
+	// Rebuilt pipelines that never got swapped in
+	for (const auto& reloaded : m_hot_reload->reloaded)
+		vkDestroyPipeline(m_logical_device->handle, reloaded.handle, nullptr);
+	m_hot_reload->reloaded.clear();
+
+	// Replaced pipelines still waiting on their frames
+	for (const auto& retired : m_hot_reload->retired)
+		vkDestroyPipeline(m_logical_device->handle, retired.handle, nullptr);
+	m_hot_reload->retired.clear();
+}
+
+void VulkanPipelineBuilder::ApplyHotReloads()
+{
+	if (!m_hot_reload)
+		return;
+
+	std::vector<ReloadedPipeline> reloaded;
+
+	// Never stall the render loop on a rebuild in progress, swaps are picked up next frame instead
+	{
+		std::unique_lock<std::mutex> lock(m_hot_reload->mutex, std::try_to_lock);
+		if (lock.owns_lock())
+			reloaded.swap(m_hot_reload->reloaded);
+	}
+
+	const VkDevice& device = m_logical_device->handle;
+	VulkanTimeline& graphics_timeline = m_logical_device->graphics_timeline;
+	VulkanTimeline& compute_timeline = m_logical_device->compute_timeline;
+
+	// Swap handles. Anything recorded from here on uses the new pipeline, and anything recorded before was
+	//	submitted with a value reserved by now, whether by a frame or a compute job.
+	for (const auto& swap : reloaded)
+	{
+		VulkanPipeline& pipeline = (*m_pipeline_buffer)[swap.pipeline_index];
+
+		m_hot_reload->retired.emplace_back(RetiredPipeline{
+			.handle = pipeline.handle,
+			.graphics_timeline_value = graphics_timeline.value,
+			.compute_timeline_value = compute_timeline.value
+		});
+
+		pipeline.handle = swap.handle;
+	}
+
+	// Destroy replaced handles once both queues are past any work that could have used them
+	std::vector<RetiredPipeline>& retired = m_hot_reload->retired;
+	for (size_t i = retired.size(); i-- > 0;)
+	{
+		if (!graphics_timeline.Reached(device, retired[i].graphics_timeline_value) || !compute_timeline.Reached(device, retired[i].compute_timeline_value))
+			continue;
+
+		vkDestroyPipeline(m_logical_device->handle, retired[i].handle, nullptr);
+		retired.erase(retired.begin() + i);
+	}
+}
+
+void VulkanPipelineBuilder::AttachGraphicsState(VulkanPipelineConfiguration& config)
+{
+	// Attach all graphics configuration data
+	config.graphics_info.pVertexInputState = &config.vertex_input_state;
+	config.graphics_info.pInputAssemblyState = &config.input_assembly_state;
+	config.graphics_info.pTessellationState = &config.tessellation_state;
+	config.graphics_info.pViewportState = &config.viewport_state;
+	config.graphics_info.pRasterizationState = &config.rasterization_state;
+	config.graphics_info.pMultisampleState = &config.multisample_state;
+	config.graphics_info.pDepthStencilState = &config.depth_stencil_state;
+	config.graphics_info.pColorBlendState = &config.color_blend_state;
+	config.graphics_info.pDynamicState = &config.dynamic_state;
+
+	// For pipeline derivation (unused)
+	config.graphics_info.basePipelineHandle = VK_NULL_HANDLE;
+	config.graphics_info.basePipelineIndex = -1;
+
+	// Attach dynamic rendering information (if using)
+	if (config.use_dynamic_rendering)
+		config.graphics_info.pNext = &config.dynamic_render_info;
+
+	// Attach shader stages
+	config.graphics_info.stageCount = static_cast<uint32_t>(config.shader_stages.size());
+	config.graphics_info.pStages = config.shader_stages.data();
+}
+
+void VulkanPipelineBuilder::ReloadPipelines(HotReloadState* state, const std::vector<std::string>& changed_files)
+{
+	// Compare paths the same way the watcher reports them
+	auto normalize = [](const std::string& path) {
+		return std::filesystem::path(path).lexically_normal().generic_string();
+	};
+
+	std::set<std::string> changed_set(changed_files.begin(), changed_files.end());
+
+	// Retained pipelines to rebuild, with their sources. Retained entries are only ever appended while the watcher runs,
+	//	so their slots stay valid once the lock is released.
+	struct ReloadCandidate
+	{
+		size_t retained_slot = 0;
+		std::vector<VulkanShaderSource> sources;
+		std::vector<std::shared_future<ShaderCompileOutput>> outputs;
+	};
+
+	std::vector<ReloadCandidate> candidates;
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+
+		// A changed file that no pipeline binds directly is most likely an include, which makes every
+		//	pipeline a candidate. Pipelines whose binaries didn't actually change are filtered out below.
+		bool include_changed = false;
+		for (const std::string& file : changed_set)
+		{
+			bool bound = false;
+			for (const auto& retained : state->retained)
+				for (const auto& source : retained.config.shader_sources)
+					bound |= normalize(source.file_path) == file;
+
+			include_changed |= !bound;
+		}
+
+		for (size_t slot = 0; slot < state->retained.size(); slot++)
+		{
+			const VulkanPipelineConfiguration& config = state->retained[slot].config;
+
+			bool candidate = include_changed;
+			for (const auto& source : config.shader_sources)
+				candidate |= changed_set.contains(normalize(source.file_path));
+
+			if (candidate && !config.shader_sources.empty())
+				candidates.emplace_back(ReloadCandidate{ .retained_slot = slot, .sources = config.shader_sources });
+		}
+	}
+
+	// Recompile every stage of every candidate across the job system, without holding the lock
+	for (auto& candidate : candidates)
+	{
+		for (const auto& source : candidate.sources)
+		{
+			std::ifstream file(source.file_path, std::ios::in | std::ios::binary);
+			std::stringstream stream;
+			stream << file.rdbuf();
+
+			std::string source_text = stream.str();
+			std::shared_ptr<VulkanShaderCache> cache = state->shader_cache;
+			shaderc_shader_kind shader_kind = VulkanPipelineBuilder::VkShaderToShaderc(source.stage);
+
+			candidate.outputs.emplace_back(JobSystem::Get()->Submit([cache, source_text, source, shader_kind]() {
+				return VulkanPipelineBuilder::CompileShader(cache, source_text, source.file_path, shader_kind, source.is_hlsl, source.entry_point);
+			}).share());
+		}
+	}
+
+	// Keep the current pipeline on any failure, and skip pipelines whose binaries are identical
+	for (auto& candidate : candidates)
+	{
+		bool failed = false;
+		bool unchanged = true;
+		for (size_t i = 0; i < candidate.outputs.size(); i++)
+		{
+			const ShaderCompileOutput& output = JobSystem::Get()->Wait(candidate.outputs[i]);
+
+			if (!output.succeeded)
+			{
+				AURION_ERROR("[Vulkan Pipeline Builder] Hot reload failed for %s: %s", candidate.sources[i].file_path.c_str(), output.error.c_str());
+				failed = true;
+			}
+
+			unchanged &= output.cache_key == candidate.sources[i].cache_key;
+		}
+
+		if (failed || unchanged)
+			candidate.outputs.clear();
+	}
+
+	// Only module and pipeline creation touch the retained configurations
+	std::unique_lock<std::mutex> lock(state->mutex);
+
+	for (auto& candidate : candidates)
+	{
+		if (candidate.outputs.empty())
+			continue;
+
+		RetainedPipeline& retained = state->retained[candidate.retained_slot];
+		VulkanPipelineConfiguration& config = retained.config;
+
+		// Generate the new shader modules
+		bool modules_created = true;
+		for (size_t i = 0; i < candidate.outputs.size(); i++)
+		{
+			const ShaderCompileOutput& output = candidate.outputs[i].get();
+
+			VkShaderModuleCreateInfo shader_module_info{};
+			shader_module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+			shader_module_info.codeSize = output.spirv.size() * sizeof(uint32_t);
+			shader_module_info.pCode = output.spirv.data();
+
+			if (vkCreateShaderModule(state->device->handle, &shader_module_info, nullptr, &config.shader_stages[i].module) != VK_SUCCESS)
+				modules_created = false;
+
+			config.shader_stages[i].pName = config.shader_sources[i].entry_point.c_str();
+		}
+
+		// Rebuild the pipeline against its original layout
+		VkPipeline handle = VK_NULL_HANDLE;
+		VkResult result = VK_ERROR_INITIALIZATION_FAILED;
+		if (modules_created)
+		{
+			switch (config.type)
+			{
+				case VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO:
+				{
+					config.compute_info.stage = config.shader_stages[0];
+					result = vkCreateComputePipelines(state->device->handle, VK_NULL_HANDLE, 1, &config.compute_info, nullptr, &handle);
+					break;
+				}
+				case VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO:
+				{
+					VulkanPipelineBuilder::AttachGraphicsState(config);
+					result = vkCreateGraphicsPipelines(state->device->handle, VK_NULL_HANDLE, 1, &config.graphics_info, nullptr, &handle);
+					break;
+				}
+				default: break;
+			}
+		}
+
+		// Shader modules are only needed during creation
+		for (auto& stage : config.shader_stages)
+		{
+			vkDestroyShaderModule(state->device->handle, stage.module, nullptr);
+			stage.module = VK_NULL_HANDLE;
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			AURION_ERROR("[Vulkan Pipeline Builder] Hot reload failed to rebuild pipeline %zu", retained.pipeline_index);
+			continue;
+		}
+
+		for (size_t i = 0; i < candidate.outputs.size(); i++)
+			config.shader_sources[i].cache_key = candidate.outputs[i].get().cache_key;
+
+		// Hand the new handle to the render thread, which swaps it in at a frame boundary
+		state->reloaded.emplace_back(ReloadedPipeline{
+			.pipeline_index = retained.pipeline_index,
+			.handle = handle
+		});
+
+		AURION_INFO("[Vulkan Pipeline Builder] Reloaded pipeline %zu", retained.pipeline_index);
+	}
+
+	lock.unlock();
+
+	// Persist any new binaries. The cache has its own lock.
+	state->shader_cache->Save();
+}
+
 shaderc_shader_kind VulkanPipelineBuilder::VkShaderToShaderc(const VkShaderStageFlags& flags)
 {
 	switch (flags)
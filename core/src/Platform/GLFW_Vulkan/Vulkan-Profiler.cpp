@@ -0,0 +1,511 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+#include <imgui.h>
+
+import Vulkan;
+
+// Number of completed frames kept around for CSV dumps
+constexpr size_t c_profiler_history_frames = 600;
+
+// Weight of the newest sample in the overlay's moving average
+constexpr double c_profiler_average_weight = 0.1;
+
+// Counters collected on the graphics queue, in the order results are written
+constexpr VkQueryPipelineStatisticFlags c_graphics_statistics =
+	VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+	VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+	VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+	VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+	VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+constexpr uint32_t c_graphics_statistics_count = 5;
+
+// Compute queues may not support graphics counters
+constexpr VkQueryPipelineStatisticFlags c_compute_statistics = VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+constexpr uint32_t c_compute_statistics_count = 1;
+
+VulkanProfiler::VulkanProfiler()
+	: m_logical_device(nullptr), m_current_frame(0), m_max_scopes(0), m_timestamp_period(1.0),
+		m_graphics_supported(false), m_compute_supported(false), m_statistics_supported(false), m_enabled(true),
+		m_frame_statistics({}), m_frame_milliseconds(0.0), m_collected_frames(0)
+{
+
+}
+
+VulkanProfiler::~VulkanProfiler()
+{
+
+}
+
+void VulkanProfiler::Initialize(VulkanDevice* logical_device, const uint32_t& max_scopes)
+{
+	m_logical_device = logical_device;
+	m_max_scopes = max_scopes;
+
+	const VkPhysicalDeviceLimits& limits = m_logical_device->properties.properties.limits;
+	m_timestamp_period = (double)limits.timestampPeriod;
+
+	// Timestamps are only supported on queues with valid timestamp bits
+	uint32_t family_count = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(m_logical_device->physical_device, &family_count, nullptr);
+
+	std::vector<VkQueueFamilyProperties> families(family_count);
+	vkGetPhysicalDeviceQueueFamilyProperties(m_logical_device->physical_device, &family_count, families.data());
+
+	uint32_t graphics_index = m_logical_device->graphics_queue_index.value_or(family_count);
+	uint32_t compute_index = m_logical_device->compute_queue_index.value_or(family_count);
+
+	m_graphics_supported = graphics_index < family_count && families[graphics_index].timestampValidBits > 0;
+	m_compute_supported = compute_index < family_count && families[compute_index].timestampValidBits > 0;
+
+	if (!m_graphics_supported)
+		AURION_WARN("[Vulkan Profiler] Graphics queue does not support timestamps. GPU profiling is disabled.");
+
+	m_statistics_supported = m_logical_device->features.features.pipelineStatisticsQuery == VK_TRUE;
+
+	if (!m_statistics_supported)
+		AURION_WARN("[Vulkan Profiler] Pipeline statistics queries are not supported. Only timings will be collected.");
+}
+
+void VulkanProfiler::Resize(const uint32_t& frame_count)
+{
+	if (!m_logical_device)
+		return;
+
+	// Destroy removed frames' query pools
+	for (size_t i = frame_count; i < m_frames.size(); i++)
+	{
+		vkDestroyQueryPool(m_logical_device->handle, m_frames[i].graphics_pool, nullptr);
+		vkDestroyQueryPool(m_logical_device->handle, m_frames[i].compute_pool, nullptr);
+		vkDestroyQueryPool(m_logical_device->handle, m_frames[i].graphics_statistics_pool, nullptr);
+		vkDestroyQueryPool(m_logical_device->handle, m_frames[i].compute_statistics_pool, nullptr);
+	}
+
+	size_t create_index = m_frames.size();
+	m_frames.resize(frame_count);
+
+	// Two timestamps per scope
+	VkQueryPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	pool_info.queryCount = m_max_scopes * 2;
+
+	// One statistics query per scope, sharing the scope's index
+	VkQueryPoolCreateInfo graphics_statistics_info{};
+	graphics_statistics_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	graphics_statistics_info.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+	graphics_statistics_info.queryCount = m_max_scopes;
+	graphics_statistics_info.pipelineStatistics = c_graphics_statistics;
+
+	VkQueryPoolCreateInfo compute_statistics_info = graphics_statistics_info;
+	compute_statistics_info.pipelineStatistics = c_compute_statistics;
+
+	for (; create_index < m_frames.size(); create_index++)
+	{
+		VulkanProfilerFrame& frame = m_frames[create_index];
+
+		if (m_graphics_supported && vkCreateQueryPool(m_logical_device->handle, &pool_info, nullptr, &frame.graphics_pool) != VK_SUCCESS)
+			AURION_ERROR("[Vulkan Profiler] Frame %d: Failed to create graphics query pool!", create_index);
+
+		if (m_compute_supported && vkCreateQueryPool(m_logical_device->handle, &pool_info, nullptr, &frame.compute_pool) != VK_SUCCESS)
+			AURION_ERROR("[Vulkan Profiler] Frame %d: Failed to create compute query pool!", create_index);
+
+		if (m_statistics_supported && m_graphics_supported && vkCreateQueryPool(m_logical_device->handle, &graphics_statistics_info, nullptr, &frame.graphics_statistics_pool) != VK_SUCCESS)
+			AURION_ERROR("[Vulkan Profiler] Frame %d: Failed to create graphics statistics query pool!", create_index);
+
+		if (m_statistics_supported && m_compute_supported && vkCreateQueryPool(m_logical_device->handle, &compute_statistics_info, nullptr, &frame.compute_statistics_pool) != VK_SUCCESS)
+			AURION_ERROR("[Vulkan Profiler] Frame %d: Failed to create compute statistics query pool!", create_index);
+
+		// Queries must be reset before their first use
+		if (frame.graphics_pool)
+			vkResetQueryPool(m_logical_device->handle, frame.graphics_pool, 0, pool_info.queryCount);
+		if (frame.compute_pool)
+			vkResetQueryPool(m_logical_device->handle, frame.compute_pool, 0, pool_info.queryCount);
+		if (frame.graphics_statistics_pool)
+			vkResetQueryPool(m_logical_device->handle, frame.graphics_statistics_pool, 0, m_max_scopes);
+		if (frame.compute_statistics_pool)
+			vkResetQueryPool(m_logical_device->handle, frame.compute_statistics_pool, 0, m_max_scopes);
+	}
+
+	if (m_current_frame >= m_frames.size())
+		m_current_frame = 0;
+}
+
+void VulkanProfiler::Destroy()
+{
+	this->Resize(0);
+	m_results.clear();
+	m_frame_statistics = {};
+	m_averages.clear();
+	m_history.clear();
+}
+
+void VulkanProfiler::SetEnabled(const bool& enabled)
+{
+	m_enabled = enabled;
+}
+
+bool VulkanProfiler::Enabled()
+{
+	return m_enabled && m_graphics_supported;
+}
+
+void VulkanProfiler::BeginFrame(const size_t& frame_index)
+{
+	if (frame_index >= m_frames.size())
+		return;
+
+	m_current_frame = frame_index;
+	VulkanProfilerFrame& frame = m_frames[m_current_frame];
+
+	if (frame.submitted)
+		this->Collect(frame);
+
+	// Host reset, so no commands are needed to re-use the queries
+	if (!frame.scopes.empty())
+	{
+		uint32_t query_count = (uint32_t)frame.scopes.size() * 2;
+
+		if (frame.graphics_pool)
+			vkResetQueryPool(m_logical_device->handle, frame.graphics_pool, 0, query_count);
+		if (frame.compute_pool)
+			vkResetQueryPool(m_logical_device->handle, frame.compute_pool, 0, query_count);
+		if (frame.graphics_statistics_pool)
+			vkResetQueryPool(m_logical_device->handle, frame.graphics_statistics_pool, 0, (uint32_t)frame.scopes.size());
+		if (frame.compute_statistics_pool)
+			vkResetQueryPool(m_logical_device->handle, frame.compute_statistics_pool, 0, (uint32_t)frame.scopes.size());
+	}
+
+	frame.scopes.clear();
+	frame.submitted = false;
+}
+
+void VulkanProfiler::EndFrame()
+{
+	if (m_current_frame < m_frames.size())
+		m_frames[m_current_frame].submitted = true;
+}
+
+uint32_t VulkanProfiler::AddScope(const std::string& name, const bool& compute, const bool& statistics)
+{
+	if (!this->Enabled() || m_current_frame >= m_frames.size() || (compute && !m_compute_supported))
+		return c_invalid_scope;
+
+	VulkanProfilerFrame& frame = m_frames[m_current_frame];
+	if (frame.scopes.size() >= m_max_scopes)
+		return c_invalid_scope;
+
+	frame.scopes.emplace_back(VulkanProfilerScope{ .name = name, .compute = compute, .statistics = statistics && m_statistics_supported });
+
+	return (uint32_t)frame.scopes.size() - 1;
+}
+
+void VulkanProfiler::WriteBegin(const VkCommandBuffer& cmd_buffer, const uint32_t& scope) const
+{
+	this->WriteTimestamp(cmd_buffer, scope, scope * 2, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT);
+
+	// Statistics queries sit inside the timestamps, so their begin/end cost isn't timed
+	if (VkQueryPool pool = this->GetStatisticsPool(scope))
+		vkCmdBeginQuery(cmd_buffer, pool, scope, 0);
+}
+
+void VulkanProfiler::WriteEnd(const VkCommandBuffer& cmd_buffer, const uint32_t& scope) const
+{
+	if (VkQueryPool pool = this->GetStatisticsPool(scope))
+		vkCmdEndQuery(cmd_buffer, pool, scope);
+
+	this->WriteTimestamp(cmd_buffer, scope, scope * 2 + 1, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT);
+}
+
+void VulkanProfiler::WriteTimestamp(const VkCommandBuffer& cmd_buffer, const uint32_t& scope, const uint32_t& query, const VkPipelineStageFlags2& stage) const
+{
+	if (scope == c_invalid_scope || m_current_frame >= m_frames.size())
+		return;
+
+	const VulkanProfilerFrame& frame = m_frames[m_current_frame];
+	if (scope >= frame.scopes.size())
+		return;
+
+	VkQueryPool pool = frame.scopes[scope].compute ? frame.compute_pool : frame.graphics_pool;
+	if (pool)
+		vkCmdWriteTimestamp2(cmd_buffer, stage, pool, query);
+}
+
+VkQueryPool VulkanProfiler::GetStatisticsPool(const uint32_t& scope) const
+{
+	if (scope == c_invalid_scope || m_current_frame >= m_frames.size())
+		return VK_NULL_HANDLE;
+
+	const VulkanProfilerFrame& frame = m_frames[m_current_frame];
+	if (scope >= frame.scopes.size() || !frame.scopes[scope].statistics)
+		return VK_NULL_HANDLE;
+
+	return frame.scopes[scope].compute ? frame.compute_statistics_pool : frame.graphics_statistics_pool;
+}
+
+const std::vector<VulkanProfilerResult>& VulkanProfiler::GetResults()
+{
+	return m_results;
+}
+
+double VulkanProfiler::GetFrameMilliseconds()
+{
+	return m_frame_milliseconds;
+}
+
+const VulkanPipelineStatistics& VulkanProfiler::GetFrameStatistics()
+{
+	return m_frame_statistics;
+}
+
+void VulkanProfiler::DrawOverlay(const char* title)
+{
+	ImGui::SetNextWindowBgAlpha(0.8f);
+	if (!ImGui::Begin(title, nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+	{
+		ImGui::End();
+		return;
+	}
+
+	if (!this->Enabled())
+	{
+		ImGui::TextUnformatted("GPU profiling is unavailable");
+		ImGui::End();
+		return;
+	}
+
+	if (ImGui::BeginTable("##gpu_scopes", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+	{
+		ImGui::TableSetupColumn("Scope");
+		ImGui::TableSetupColumn("Queue");
+		ImGui::TableSetupColumn("ms");
+		ImGui::TableSetupColumn("avg ms");
+		ImGui::TableHeadersRow();
+
+		double graphics_total = 0.0;
+		double compute_total = 0.0;
+
+		for (const VulkanProfilerResult& result : m_results)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(result.name.c_str());
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(result.compute ? "Compute" : "Graphics");
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", result.milliseconds);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", result.average_milliseconds);
+
+			(result.compute ? compute_total : graphics_total) += result.milliseconds;
+		}
+
+		ImGui::EndTable();
+
+		ImGui::Separator();
+		ImGui::Text("Graphics: %.3f ms  Compute: %.3f ms", graphics_total, compute_total);
+	}
+
+	if (m_statistics_supported && ImGui::CollapsingHeader("Pipeline Statistics", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::BeginTable("##gpu_statistics", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+		{
+			ImGui::TableSetupColumn("Scope");
+			ImGui::TableSetupColumn("IA Vertices");
+			ImGui::TableSetupColumn("IA Primitives");
+			ImGui::TableSetupColumn("VS Invocations");
+			ImGui::TableSetupColumn("FS Invocations");
+			ImGui::TableSetupColumn("CS Invocations");
+			ImGui::TableHeadersRow();
+
+			for (const VulkanProfilerResult& result : m_results)
+			{
+				if (!result.has_statistics)
+					continue;
+
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::Text("%s (%s)", result.name.c_str(), result.compute ? "Compute" : "Graphics");
+				ImGui::TableNextColumn();
+				ImGui::Text("%llu", (unsigned long long)result.statistics.input_assembly_vertices);
+				ImGui::TableNextColumn();
+				ImGui::Text("%llu", (unsigned long long)result.statistics.input_assembly_primitives);
+				ImGui::TableNextColumn();
+				ImGui::Text("%llu", (unsigned long long)result.statistics.vertex_invocations);
+				ImGui::TableNextColumn();
+				ImGui::Text("%llu", (unsigned long long)result.statistics.fragment_invocations);
+				ImGui::TableNextColumn();
+				ImGui::Text("%llu", (unsigned long long)result.statistics.compute_invocations);
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::Separator();
+		ImGui::Text("Frame: %llu primitives, %llu fragments, %llu compute invocations",
+			(unsigned long long)m_frame_statistics.input_assembly_primitives,
+			(unsigned long long)m_frame_statistics.fragment_invocations,
+			(unsigned long long)m_frame_statistics.compute_invocations
+		);
+	}
+
+	if (ImGui::Button("Dump CSV"))
+		this->DumpCSV("gpu-profile.csv");
+
+	ImGui::End();
+}
+
+bool VulkanProfiler::DumpCSV(const std::string& path)
+{
+	std::ofstream file(path, std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+	{
+		AURION_ERROR("[Vulkan Profiler] Failed to open '%s' for writing", path.c_str());
+		return false;
+	}
+
+	file << "frame,scope,queue,milliseconds,ia_vertices,ia_primitives,vs_invocations,fs_invocations,cs_invocations\n";
+	for (const auto& [frame_number, results] : m_history)
+	{
+		for (const VulkanProfilerResult& result : results)
+		{
+			file << frame_number << ",\"" << result.name << "\"," << (result.compute ? "compute" : "graphics") << "," << result.milliseconds;
+
+			// Statistics columns stay empty for timing-only scopes
+			if (result.has_statistics)
+			{
+				file << "," << result.statistics.input_assembly_vertices << "," << result.statistics.input_assembly_primitives
+					<< "," << result.statistics.vertex_invocations << "," << result.statistics.fragment_invocations
+					<< "," << result.statistics.compute_invocations << "\n";
+			}
+			else
+				file << ",,,,,\n";
+		}
+	}
+
+	AURION_INFO("[Vulkan Profiler] Wrote %d frames of GPU timings to '%s'", (int)m_history.size(), path.c_str());
+	return true;
+}
+
+void VulkanProfiler::Collect(VulkanProfilerFrame& frame)
+{
+	if (frame.scopes.empty())
+		return;
+
+	const uint32_t query_count = (uint32_t)frame.scopes.size() * 2;
+
+	// Each query is followed by its availability. The frame's work already completed, so this never waits.
+	std::vector<uint64_t> graphics_data(query_count * 2, 0);
+	std::vector<uint64_t> compute_data(query_count * 2, 0);
+
+	const VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+
+	if (frame.graphics_pool)
+		vkGetQueryPoolResults(m_logical_device->handle, frame.graphics_pool, 0, query_count,
+			graphics_data.size() * sizeof(uint64_t), graphics_data.data(), sizeof(uint64_t) * 2, flags);
+
+	if (frame.compute_pool)
+		vkGetQueryPoolResults(m_logical_device->handle, frame.compute_pool, 0, query_count,
+			compute_data.size() * sizeof(uint64_t), compute_data.data(), sizeof(uint64_t) * 2, flags);
+
+	// Statistics results are followed by their availability as well
+	const uint32_t scope_count = (uint32_t)frame.scopes.size();
+	const uint32_t graphics_stride = c_graphics_statistics_count + 1;
+	const uint32_t compute_stride = c_compute_statistics_count + 1;
+
+	std::vector<uint64_t> graphics_statistics(scope_count * graphics_stride, 0);
+	std::vector<uint64_t> compute_statistics(scope_count * compute_stride, 0);
+
+	if (frame.graphics_statistics_pool)
+		vkGetQueryPoolResults(m_logical_device->handle, frame.graphics_statistics_pool, 0, scope_count,
+			graphics_statistics.size() * sizeof(uint64_t), graphics_statistics.data(), sizeof(uint64_t) * graphics_stride, flags);
+
+	if (frame.compute_statistics_pool)
+		vkGetQueryPoolResults(m_logical_device->handle, frame.compute_statistics_pool, 0, scope_count,
+			compute_statistics.size() * sizeof(uint64_t), compute_statistics.data(), sizeof(uint64_t) * compute_stride, flags);
+
+	m_results.clear();
+	m_frame_statistics = {};
+
+	uint64_t frame_begin = UINT64_MAX;
+	uint64_t frame_end = 0;
+
+	for (size_t i = 0; i < frame.scopes.size(); i++)
+	{
+		const VulkanProfilerScope& scope = frame.scopes[i];
+		const std::vector<uint64_t>& data = scope.compute ? compute_data : graphics_data;
+
+		const uint64_t begin = data[i * 4 + 0];
+		const bool begin_available = data[i * 4 + 1] != 0;
+		const uint64_t end = data[i * 4 + 2];
+		const bool end_available = data[i * 4 + 3] != 0;
+
+		if (!begin_available || !end_available || end < begin)
+			continue;
+
+		if (!scope.compute)
+		{
+			frame_begin = std::min(frame_begin, begin);
+			frame_end = std::max(frame_end, end);
+		}
+
+		VulkanProfilerResult& result = m_results.emplace_back();
+		result.name = scope.name;
+		result.compute = scope.compute;
+		result.milliseconds = (double)(end - begin) * m_timestamp_period / 1000000.0;
+
+		// Smooth per scope, keyed by queue as well as name
+		std::string average_key = scope.compute ? scope.name + "#compute" : scope.name;
+		auto it = m_averages.find(average_key);
+		if (it == m_averages.end())
+			it = m_averages.emplace(average_key, result.milliseconds).first;
+		else
+			it->second += (result.milliseconds - it->second) * c_profiler_average_weight;
+
+		result.average_milliseconds = it->second;
+
+		if (!scope.statistics)
+			continue;
+
+		if (scope.compute)
+		{
+			const uint64_t* values = &compute_statistics[i * compute_stride];
+			if (values[c_compute_statistics_count] == 0)
+				continue;
+
+			result.statistics.compute_invocations = values[0];
+		}
+		else
+		{
+			const uint64_t* values = &graphics_statistics[i * graphics_stride];
+			if (values[c_graphics_statistics_count] == 0)
+				continue;
+
+			result.statistics.input_assembly_vertices = values[0];
+			result.statistics.input_assembly_primitives = values[1];
+			result.statistics.vertex_invocations = values[2];
+			result.statistics.fragment_invocations = values[3];
+			result.statistics.compute_invocations = values[4];
+		}
+
+		result.has_statistics = true;
+
+		m_frame_statistics.input_assembly_vertices += result.statistics.input_assembly_vertices;
+		m_frame_statistics.input_assembly_primitives += result.statistics.input_assembly_primitives;
+		m_frame_statistics.vertex_invocations += result.statistics.vertex_invocations;
+		m_frame_statistics.fragment_invocations += result.statistics.fragment_invocations;
+		m_frame_statistics.compute_invocations += result.statistics.compute_invocations;
+	}
+
+	m_frame_milliseconds = frame_end > frame_begin ? (double)(frame_end - frame_begin) * m_timestamp_period / 1000000.0 : 0.0;
+
+	m_history.emplace_back(m_collected_frames++, m_results);
+	if (m_history.size() > c_profiler_history_frames)
+		m_history.pop_front();
+}
\ No newline at end of file
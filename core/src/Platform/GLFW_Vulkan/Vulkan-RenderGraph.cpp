@@ -0,0 +1,584 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+
+import Vulkan;
+
+// Access bits that read memory. Accesses containing these depend on a resource's previous contents.
+constexpr VkAccessFlags2 c_read_access_mask =
+	VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT | VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT |
+	VK_ACCESS_2_UNIFORM_READ_BIT | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+	VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+	VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_MEMORY_READ_BIT;
+
+VulkanRenderGraphPass& VulkanRenderGraphPass::Read(const uint32_t& resource, const VulkanResourceUsage& usage)
+{
+	reads.emplace_back(VulkanRenderGraphAccess{ .resource = resource, .usage = usage });
+	return *this;
+}
+
+VulkanRenderGraphPass& VulkanRenderGraphPass::Write(const uint32_t& resource, const VulkanResourceUsage& usage)
+{
+	writes.emplace_back(VulkanRenderGraphAccess{ .resource = resource, .usage = usage });
+	return *this;
+}
+
+VulkanRenderGraphPass& VulkanRenderGraphPass::KeepAlive()
+{
+	keep_alive = true;
+	return *this;
+}
+
+VulkanRenderGraphPass& VulkanRenderGraphPass::Execute(const std::function<void(const VkCommandBuffer&)>& execute)
+{
+	execute_fun = execute;
+	return *this;
+}
+
+VulkanUsageInfo VulkanRenderGraph::GetUsageInfo(const VulkanResourceUsage& usage)
+{
+	switch (usage)
+	{
+	case VulkanResourceUsage::ColorAttachmentWrite:
+		return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true };
+	case VulkanResourceUsage::ColorAttachmentReadWrite:
+		return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true };
+	case VulkanResourceUsage::DepthAttachmentWrite:
+		return { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+			VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true };
+	case VulkanResourceUsage::DepthAttachmentRead:
+		return { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+			VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, false };
+	case VulkanResourceUsage::FragmentSampled:
+		return { VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+	case VulkanResourceUsage::ComputeSampled:
+		return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false };
+	case VulkanResourceUsage::ComputeStorageRead:
+		return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, false };
+	case VulkanResourceUsage::ComputeStorageWrite:
+		return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, true };
+	case VulkanResourceUsage::ComputeStorageReadWrite:
+		return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, true };
+	case VulkanResourceUsage::TransferSrc:
+		return { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, false };
+	case VulkanResourceUsage::TransferDst:
+		return { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true };
+	case VulkanResourceUsage::Present:
+		return { VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, false };
+	case VulkanResourceUsage::VertexBuffer:
+		return { VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false };
+	case VulkanResourceUsage::IndexBuffer:
+		return { VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false };
+	case VulkanResourceUsage::IndirectBuffer:
+		return { VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false };
+	case VulkanResourceUsage::UniformBuffer:
+		return { VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_UNIFORM_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false };
+	case VulkanResourceUsage::HostRead:
+		return { VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false };
+	case VulkanResourceUsage::General:
+		return { VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, true };
+	default:
+		return {};
+	}
+}
+
+VulkanRenderGraph::VulkanRenderGraph()
+	: m_transient_pool(nullptr), m_stats({}), m_compiled(false)
+{
+
+}
+
+VulkanRenderGraph::~VulkanRenderGraph()
+{
+
+}
+
+void VulkanRenderGraph::Reset()
+{
+	m_resources.clear();
+	m_passes.clear();
+	m_transient_requests.clear();
+	m_transient_pool = nullptr;
+	m_final_image_barriers.clear();
+	m_final_buffer_barriers.clear();
+	m_stats = {};
+	m_compiled = false;
+}
+
+uint32_t VulkanRenderGraph::ImportImage(const std::string& name, const VkImage& image, const VkImageAspectFlags& aspect_flags, const VkImageLayout& initial_layout,
+	const VkPipelineStageFlags2& initial_stages, const VkAccessFlags2& initial_access)
+{
+	VulkanRenderGraphResource& resource = m_resources.emplace_back();
+	resource.name = name;
+	resource.is_image = true;
+	resource.image = image;
+	resource.aspect_flags = aspect_flags;
+	resource.layout = initial_layout;
+	resource.write_stages = initial_stages;
+	resource.write_access = initial_access;
+
+	return (uint32_t)m_resources.size() - 1;
+}
+
+uint32_t VulkanRenderGraph::ImportBuffer(const std::string& name, const VkBuffer& buffer, const VkDeviceSize& offset, const VkDeviceSize& size,
+	const VkPipelineStageFlags2& initial_stages, const VkAccessFlags2& initial_access)
+{
+	VulkanRenderGraphResource& resource = m_resources.emplace_back();
+	resource.name = name;
+	resource.buffer = buffer;
+	resource.offset = offset;
+	resource.size = size;
+	resource.write_stages = initial_stages;
+	resource.write_access = initial_access;
+
+	return (uint32_t)m_resources.size() - 1;
+}
+
+uint32_t VulkanRenderGraph::CreateImage(const std::string& name, const VulkanTransientImageInfo& image_info)
+{
+	VulkanRenderGraphResource& resource = m_resources.emplace_back();
+	resource.name = name;
+	resource.is_image = true;
+	resource.aspect_flags = image_info.aspect_flags;
+	resource.transient_request = (int32_t)m_transient_requests.size();
+
+	VulkanTransientRequest& request = m_transient_requests.emplace_back();
+	request.is_image = true;
+	request.image_info = image_info;
+
+	return (uint32_t)m_resources.size() - 1;
+}
+
+uint32_t VulkanRenderGraph::CreateBuffer(const std::string& name, const VulkanTransientBufferInfo& buffer_info)
+{
+	VulkanRenderGraphResource& resource = m_resources.emplace_back();
+	resource.name = name;
+	resource.size = buffer_info.size;
+	resource.transient_request = (int32_t)m_transient_requests.size();
+
+	VulkanTransientRequest& request = m_transient_requests.emplace_back();
+	request.is_image = false;
+	request.buffer_info = buffer_info;
+
+	return (uint32_t)m_resources.size() - 1;
+}
+
+void VulkanRenderGraph::SetTransientPool(VulkanTransientPool* transient_pool)
+{
+	m_transient_pool = transient_pool;
+}
+
+void VulkanRenderGraph::MarkOutput(const uint32_t& resource, const VulkanResourceUsage& final_usage)
+{
+	if (resource >= m_resources.size())
+	{
+		AURION_ERROR("[Vulkan Render Graph] Cannot mark resource %d as an output: Resource does not exist", resource);
+		return;
+	}
+
+	m_resources[resource].is_output = true;
+	m_resources[resource].final_usage = final_usage;
+}
+
+VulkanRenderGraphPass& VulkanRenderGraph::AddPass(const std::string& name)
+{
+	VulkanRenderGraphPass& pass = m_passes.emplace_back();
+	pass.name = name;
+
+	return pass;
+}
+
+void VulkanRenderGraph::Compile()
+{
+	if (m_compiled)
+		return;
+
+	this->Cull();
+	this->RealizeTransients();
+	this->BuildBarriers();
+
+	m_compiled = true;
+}
+
+void VulkanRenderGraph::Execute(const VkCommandBuffer& cmd_buffer, VulkanProfiler* profiler)
+{
+	this->Compile();
+
+	for (const VulkanRenderGraphPass& pass : m_passes)
+	{
+		if (pass.culled)
+			continue;
+
+		this->RecordBarriers(cmd_buffer, pass.image_barriers, pass.buffer_barriers);
+
+		uint32_t scope = profiler ? profiler->AddScope(pass.name) : VulkanProfiler::c_invalid_scope;
+		if (profiler)
+			profiler->WriteBegin(cmd_buffer, scope);
+
+		if (pass.execute_fun)
+			pass.execute_fun(cmd_buffer);
+
+		if (profiler)
+			profiler->WriteEnd(cmd_buffer, scope);
+	}
+
+	// Leave outputs in their final usage
+	this->RecordBarriers(cmd_buffer, m_final_image_barriers, m_final_buffer_barriers);
+}
+
+VulkanRenderGraphResource* VulkanRenderGraph::GetResource(const uint32_t& resource)
+{
+	if (resource >= m_resources.size())
+		return nullptr;
+
+	return &m_resources[resource];
+}
+
+const VulkanRenderGraphStats& VulkanRenderGraph::GetStats()
+{
+	return m_stats;
+}
+
+void VulkanRenderGraph::Cull()
+{
+	// Walk passes back to front, tracking which resources a later live pass (or the graph's outputs) still needs
+	std::vector<bool> needed(m_resources.size(), false);
+	for (size_t i = 0; i < m_resources.size(); i++)
+		needed[i] = m_resources[i].is_output;
+
+	for (auto it = m_passes.rbegin(); it != m_passes.rend(); it++)
+	{
+		VulkanRenderGraphPass& pass = *it;
+
+		bool alive = pass.keep_alive;
+		for (const VulkanRenderGraphAccess& access : pass.writes)
+			alive |= access.resource < needed.size() && needed[access.resource];
+
+		pass.culled = !alive;
+		if (pass.culled)
+		{
+			m_stats.culled_pass_count++;
+			continue;
+		}
+
+		// Writes that don't read overwrite the resource, so earlier writers are no longer needed
+		for (const VulkanRenderGraphAccess& access : pass.writes)
+		{
+			if (access.resource >= needed.size())
+				continue;
+
+			needed[access.resource] = (GetUsageInfo(access.usage).access & c_read_access_mask) != 0;
+		}
+
+		for (const VulkanRenderGraphAccess& access : pass.reads)
+		{
+			if (access.resource < needed.size())
+				needed[access.resource] = true;
+		}
+	}
+
+	m_stats.pass_count = (uint32_t)m_passes.size();
+}
+
+void VulkanRenderGraph::RealizeTransients()
+{
+	if (m_transient_requests.empty())
+		return;
+
+	// Find each transient's lifetime across live passes
+	constexpr uint32_t unused = UINT32_MAX;
+	for (VulkanTransientRequest& request : m_transient_requests)
+	{
+		request.first_pass = unused;
+		request.last_pass = 0;
+	}
+
+	uint32_t pass_index = 0;
+	for (const VulkanRenderGraphPass& pass : m_passes)
+	{
+		if (pass.culled)
+			continue;
+
+		auto extend = [&](const VulkanRenderGraphAccess& access) {
+			if (access.resource >= m_resources.size() || m_resources[access.resource].transient_request < 0)
+				return;
+
+			VulkanTransientRequest& request = m_transient_requests[m_resources[access.resource].transient_request];
+			request.first_pass = std::min(request.first_pass, pass_index);
+			request.last_pass = std::max(request.last_pass, pass_index);
+		};
+
+		for (const VulkanRenderGraphAccess& access : pass.reads)
+			extend(access);
+		for (const VulkanRenderGraphAccess& access : pass.writes)
+			extend(access);
+
+		pass_index++;
+	}
+
+	// Only live transients get memory
+	std::vector<VulkanTransientRequest> live_requests;
+	std::vector<uint32_t> live_resources;
+	for (uint32_t i = 0; i < m_resources.size(); i++)
+	{
+		const int32_t request_index = m_resources[i].transient_request;
+		if (request_index < 0 || m_transient_requests[request_index].first_pass == unused)
+			continue;
+
+		live_requests.emplace_back(m_transient_requests[request_index]);
+		live_resources.emplace_back(i);
+	}
+
+	bool realized = !live_requests.empty() && m_transient_pool && m_transient_pool->Realize(live_requests);
+	if (!live_requests.empty() && !m_transient_pool)
+		AURION_ERROR("[Vulkan Render Graph] Cannot create transient resources: No transient pool was set!");
+
+	if (!realized)
+	{
+		// Passes can't run without their resources
+		for (VulkanRenderGraphPass& pass : m_passes)
+		{
+			auto uses_transient = [&](const VulkanRenderGraphAccess& access) {
+				return access.resource < m_resources.size() && m_resources[access.resource].transient_request >= 0;
+			};
+
+			for (const VulkanRenderGraphAccess& access : pass.reads)
+				pass.culled |= uses_transient(access);
+			for (const VulkanRenderGraphAccess& access : pass.writes)
+				pass.culled |= uses_transient(access);
+		}
+
+		return;
+	}
+
+	for (size_t i = 0; i < live_resources.size(); i++)
+	{
+		const VulkanTransientResource& transient = m_transient_pool->GetResource(i);
+		VulkanRenderGraphResource& resource = m_resources[live_resources[i]];
+
+		resource.image = transient.image;
+		resource.view = transient.view;
+		resource.buffer = transient.buffer;
+
+		// Map aliased requests back to graph resources
+		resource.alias_predecessors.clear();
+		for (const uint32_t& predecessor : transient.alias_predecessors)
+			resource.alias_predecessors.emplace_back(live_resources[predecessor]);
+	}
+}
+
+void VulkanRenderGraph::BuildBarriers()
+{
+	struct MergedAccess
+	{
+		uint32_t resource;
+		VulkanUsageInfo usage;
+	};
+
+	std::vector<MergedAccess> merged;
+
+	for (VulkanRenderGraphPass& pass : m_passes)
+	{
+		if (pass.culled)
+			continue;
+
+		// A pass may touch the same resource several times; synchronize against the union of its accesses
+		merged.clear();
+		auto merge = [&](const VulkanRenderGraphAccess& access) {
+			if (access.resource >= m_resources.size())
+			{
+				AURION_ERROR("[Vulkan Render Graph] Pass '%s' uses resource %d, which does not exist", pass.name.c_str(), access.resource);
+				return;
+			}
+
+			VulkanUsageInfo info = GetUsageInfo(access.usage);
+
+			for (MergedAccess& existing : merged)
+			{
+				if (existing.resource != access.resource)
+					continue;
+
+				if (existing.usage.layout != info.layout)
+				{
+					AURION_WARN("[Vulkan Render Graph] Pass '%s' uses '%s' in conflicting layouts", pass.name.c_str(), m_resources[access.resource].name.c_str());
+					if (info.writes)
+						existing.usage.layout = info.layout;
+				}
+
+				existing.usage.stages |= info.stages;
+				existing.usage.access |= info.access;
+				existing.usage.writes |= info.writes;
+				return;
+			}
+
+			merged.emplace_back(MergedAccess{ access.resource, info });
+		};
+
+		for (const VulkanRenderGraphAccess& access : pass.reads)
+			merge(access);
+		for (const VulkanRenderGraphAccess& access : pass.writes)
+			merge(access);
+
+		for (const MergedAccess& access : merged)
+			this->AddAccess(m_resources[access.resource], access.usage, pass.image_barriers, pass.buffer_barriers);
+
+		if (!pass.image_barriers.empty() || !pass.buffer_barriers.empty())
+			m_stats.barrier_batch_count++;
+
+		m_stats.image_barrier_count += (uint32_t)pass.image_barriers.size();
+		m_stats.buffer_barrier_count += (uint32_t)pass.buffer_barriers.size();
+	}
+
+	// Final transitions for outputs
+	for (VulkanRenderGraphResource& resource : m_resources)
+	{
+		if (!resource.is_output || resource.final_usage == VulkanResourceUsage::None)
+			continue;
+
+		this->AddAccess(resource, GetUsageInfo(resource.final_usage), m_final_image_barriers, m_final_buffer_barriers);
+	}
+
+	if (!m_final_image_barriers.empty() || !m_final_buffer_barriers.empty())
+		m_stats.barrier_batch_count++;
+
+	m_stats.image_barrier_count += (uint32_t)m_final_image_barriers.size();
+	m_stats.buffer_barrier_count += (uint32_t)m_final_buffer_barriers.size();
+}
+
+void VulkanRenderGraph::AddAccess(VulkanRenderGraphResource& resource, const VulkanUsageInfo& usage,
+	std::vector<VkImageMemoryBarrier2>& image_barriers, std::vector<VkBufferMemoryBarrier2>& buffer_barriers)
+{
+	// Memory handed down from aliased resources must wait on their last use before it's re-used
+	if (!resource.accessed)
+	{
+		resource.accessed = true;
+
+		for (const uint32_t& predecessor : resource.alias_predecessors)
+		{
+			resource.write_stages |= m_resources[predecessor].write_stages | m_resources[predecessor].read_stages;
+			resource.write_access |= m_resources[predecessor].write_access;
+		}
+	}
+
+	const bool is_image = resource.is_image;
+	const bool needs_transition = is_image && usage.layout != VK_IMAGE_LAYOUT_UNDEFINED && usage.layout != resource.layout;
+
+	VkPipelineStageFlags2 src_stages = VK_PIPELINE_STAGE_2_NONE;
+	VkAccessFlags2 src_access = VK_ACCESS_2_NONE;
+
+	if (needs_transition || usage.writes)
+	{
+		// Layout transitions and writes wait on the last write (RAW/WAW) and every read since (WAR)
+		src_stages = resource.write_stages | resource.read_stages;
+		src_access = resource.write_access;
+
+		// Nothing to wait on and no layout to change: no barrier needed
+		if (!needs_transition && src_stages == VK_PIPELINE_STAGE_2_NONE)
+		{
+			resource.write_stages = usage.stages;
+			resource.write_access = usage.access & ~c_read_access_mask;
+			resource.read_stages = VK_PIPELINE_STAGE_2_NONE;
+			resource.visible_stages = VK_PIPELINE_STAGE_2_NONE;
+			resource.visible_access = VK_ACCESS_2_NONE;
+			return;
+		}
+	}
+	else
+	{
+		// Reads only need the last write made visible to stages/accesses that haven't seen it yet
+		const bool already_visible = (usage.stages & ~resource.visible_stages) == 0 && (usage.access & ~resource.visible_access) == 0;
+		if (resource.write_stages == VK_PIPELINE_STAGE_2_NONE || already_visible)
+		{
+			resource.read_stages |= usage.stages;
+			return;
+		}
+
+		src_stages = resource.write_stages;
+		src_access = resource.write_access;
+	}
+
+	if (is_image)
+	{
+		VkImageMemoryBarrier2& barrier = image_barriers.emplace_back();
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+		barrier.srcStageMask = src_stages;
+		barrier.srcAccessMask = src_access;
+		barrier.dstStageMask = usage.stages;
+		barrier.dstAccessMask = usage.access;
+		barrier.oldLayout = resource.layout;
+		barrier.newLayout = needs_transition ? usage.layout : resource.layout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = resource.image;
+		barrier.subresourceRange = VkImageSubresourceRange{
+			.aspectMask = resource.aspect_flags,
+			.baseMipLevel = 0,
+			.levelCount = VK_REMAINING_MIP_LEVELS,
+			.baseArrayLayer = 0,
+			.layerCount = VK_REMAINING_ARRAY_LAYERS
+		};
+	}
+	else
+	{
+		VkBufferMemoryBarrier2& barrier = buffer_barriers.emplace_back();
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+		barrier.srcStageMask = src_stages;
+		barrier.srcAccessMask = src_access;
+		barrier.dstStageMask = usage.stages;
+		barrier.dstAccessMask = usage.access;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = resource.buffer;
+		barrier.offset = resource.offset;
+		barrier.size = resource.size;
+	}
+
+	if (needs_transition)
+		resource.layout = usage.layout;
+
+	if (usage.writes)
+	{
+		resource.write_stages = usage.stages;
+		resource.write_access = usage.access & ~c_read_access_mask;
+		resource.read_stages = VK_PIPELINE_STAGE_2_NONE;
+		resource.visible_stages = VK_PIPELINE_STAGE_2_NONE;
+		resource.visible_access = VK_ACCESS_2_NONE;
+	}
+	else if (needs_transition)
+	{
+		// The transition itself is a write; later readers in other stages must wait on it
+		resource.write_stages = usage.stages;
+		resource.write_access = VK_ACCESS_2_NONE;
+		resource.read_stages = usage.stages;
+		resource.visible_stages = usage.stages;
+		resource.visible_access = usage.access;
+	}
+	else
+	{
+		resource.read_stages |= usage.stages;
+		resource.visible_stages |= usage.stages;
+		resource.visible_access |= usage.access;
+	}
+}
+
+void VulkanRenderGraph::RecordBarriers(const VkCommandBuffer& cmd_buffer, const std::vector<VkImageMemoryBarrier2>& image_barriers, const std::vector<VkBufferMemoryBarrier2>& buffer_barriers)
+{
+	if (image_barriers.empty() && buffer_barriers.empty())
+		return;
+
+	VkDependencyInfo dep_info{};
+	dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dep_info.imageMemoryBarrierCount = (uint32_t)image_barriers.size();
+	dep_info.pImageMemoryBarriers = image_barriers.data();
+	dep_info.bufferMemoryBarrierCount = (uint32_t)buffer_barriers.size();
+	dep_info.pBufferMemoryBarriers = buffer_barriers.data();
+
+	vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+}
\ No newline at end of file
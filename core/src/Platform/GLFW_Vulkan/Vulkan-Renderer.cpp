@@ -2,15 +2,18 @@
 
 #include <cstdint>
 #include <utility>
+#include <string>
 #include <unordered_map>
+#include <chrono>
 
 #include <vulkan/vulkan.h>
 #include <vma/vk_mem_alloc.h>
 
 import Vulkan;
+import Jobs;
 
 VulkanRenderer::VulkanRenderer()
-	: m_max_in_flight_frames(3)
+	: m_next_headless_id(0), m_max_in_flight_frames(3), m_parallel_windows(true)
 {
 	
 }
@@ -34,6 +37,8 @@ void VulkanRenderer::Init(const VkInstance& vk_instance, const VulkanDeviceRequi
 
 	// Initialize pipeline builder
 	m_pipeline_builder.Initialize(&m_logical_device, m_pipelines);
+
+	m_compute_scheduler.Initialize(&m_logical_device);
 }
 
 void VulkanRenderer::Shutdown()
@@ -45,6 +50,11 @@ void VulkanRenderer::Shutdown()
 	// Wait for GPU to finish work
 	vkDeviceWaitIdle(m_logical_device.handle);
 
+	// Stop hot reloading, and release any pipelines it still owns
+	m_pipeline_builder.DisableHotReload();
+
+	m_compute_scheduler.Destroy();
+
 	// Cleanup any pipeline resources
 	for (size_t i = 0; i < m_pipelines.size(); i++)
 	{
@@ -68,6 +78,12 @@ void VulkanRenderer::Shutdown()
 	// Ensure all window resources have been cleaned up BEFORE the logical
 	//	device is destroyed
 	m_windows.clear();
+	m_headless_targets.clear();
+
+	// Destroy queue timelines
+	VulkanTimeline::Destroy(m_logical_device.handle, m_logical_device.graphics_timeline);
+	VulkanTimeline::Destroy(m_logical_device.handle, m_logical_device.compute_timeline);
+	VulkanTimeline::Destroy(m_logical_device.handle, m_logical_device.transfer_timeline);
 
 	// Destroy VMA allocator
 	vmaDestroyAllocator(m_logical_device.allocator);
@@ -78,6 +94,12 @@ void VulkanRenderer::Shutdown()
 
 void VulkanRenderer::BeginFrame()
 {
+	// Swap in any hot reloaded pipelines before recording starts
+	m_pipeline_builder.ApplyHotReloads();
+
+	// Recycle finished compute jobs
+	m_compute_scheduler.Collect();
+
 	// If rendering fails for whatever reason, remove the
 	//	graphics window.
 	for (auto& [id, window] : m_windows)
@@ -87,11 +109,39 @@ void VulkanRenderer::BeginFrame()
 
 void VulkanRenderer::EndFrame()
 {
-	// If rendering fails for whatever reason, remove the
-	//	graphics window.
+	// Build every window's UI. ImGui's current context is global, so this stays on the calling thread.
+	//	If rendering fails for whatever reason, remove the graphics window.
+	m_render_windows.clear();
 	for (auto& [id, window] : m_windows)
-		if (!window.OnUIRender())
+	{
+		if (!window.BuildUI())
 			m_windows_to_remove.emplace(id);
+		else
+			m_render_windows.emplace_back(&window);
+	}
+
+	// Each window records on its own worker, so several views cost about as much as the slowest one
+	if (m_parallel_windows && m_render_windows.size() > 1)
+		JobSystem::Get()->ParallelFor(m_render_windows.size(), [this](size_t i) { m_render_windows[i]->RecordFrame(); });
+	else
+	{
+		for (VulkanWindow* window : m_render_windows)
+			window->RecordFrame();
+	}
+
+	// Submit and present every window with a single call per queue
+	m_submit_batch.Clear();
+	for (VulkanWindow* window : m_render_windows)
+		window->AppendSubmit(m_submit_batch);
+
+	m_submit_batch.Submit(m_logical_device);
+
+	for (VulkanWindow* window : m_render_windows)
+		window->OnPresented(m_submit_batch);
+
+	// Headless targets have no UI, so they're recorded and submitted in one step
+	for (auto& [id, target] : m_headless_targets)
+		target.Render();
 
 	// At the end of the frame, remove any windows that
 	//	have become invalidated
@@ -99,6 +149,21 @@ void VulkanRenderer::EndFrame()
 		this->RemoveGraphicsWindow(id);
 }
 
+void VulkanRenderer::PaceFrame()
+{
+	std::chrono::steady_clock::time_point wait_start = std::chrono::steady_clock::now();
+
+	// Keep at most one frame queued ahead of the display
+	if (m_frame_pacer.GetConfig().latency_mode == VulkanLatencyMode::JustInTime)
+	{
+		for (auto& [id, window] : m_windows)
+			if (window.Enabled())
+				window.WaitForPresent();
+	}
+
+	m_frame_pacer.Pace(wait_start);
+}
+
 bool VulkanRenderer::AddWindow(const Aurion::WindowHandle& handle)
 {
 	if (m_windows.contains(handle.id))
@@ -163,7 +228,56 @@ VulkanPipelineBuilder* VulkanRenderer::GetPipelineBuilder()
 	return &m_pipeline_builder;
 }
 
-void VulkanRenderer::BindCommand(const Aurion::WindowHandle& window_handle, const std::function<void(const VulkanCommand&)>& command)
+VulkanDevice* VulkanRenderer::GetLogicalDevice()
+{
+	return &m_logical_device;
+}
+
+VulkanComputeScheduler* VulkanRenderer::GetComputeScheduler()
+{
+	return &m_compute_scheduler;
+}
+
+void VulkanRenderer::SetParallelWindowsEnabled(const bool& enabled)
+{
+	m_parallel_windows = enabled;
+}
+
+VulkanFramePacer* VulkanRenderer::GetFramePacer()
+{
+	return &m_frame_pacer;
+}
+
+uint64_t VulkanRenderer::AddHeadlessTarget(const VulkanHeadlessTargetConfig& config)
+{
+	uint64_t id = m_next_headless_id++;
+
+	// Constructed in place, since targets can't be copied
+	auto it = m_headless_targets.try_emplace(id);
+	it.first->second.Attach(&m_logical_device, config);
+	it.first->second.SetMaxFramesInFlight(m_max_in_flight_frames);
+
+	return id;
+}
+
+VulkanHeadlessTarget* VulkanRenderer::GetHeadlessTarget(const uint64_t& target_id)
+{
+	if (!m_headless_targets.contains(target_id))
+		return nullptr;
+
+	return &m_headless_targets.at(target_id);
+}
+
+bool VulkanRenderer::RemoveHeadlessTarget(const uint64_t& target_id)
+{
+	if (!m_headless_targets.contains(target_id))
+		return false;
+
+	m_headless_targets.erase(target_id);
+	return true;
+}
+
+void VulkanRenderer::BindCommand(const Aurion::WindowHandle& window_handle, const std::function<void(const VulkanCommand&)>& command, const std::string& name)
 {
 	// Get the graphics window
 	VulkanWindow* window = this->GetGraphicsWindow(window_handle);
@@ -176,10 +290,10 @@ void VulkanRenderer::BindCommand(const Aurion::WindowHandle& window_handle, cons
 	}
 
 	// Submit the command to the window's command buffer
-	window->BindRenderCommand(command);
+	window->BindRenderCommand(command, name);
 }
 
-void VulkanRenderer::SubmitCommand(const Aurion::WindowHandle& window_handle, const std::function<void(const VulkanCommand&)>& command)
+void VulkanRenderer::SubmitCommand(const Aurion::WindowHandle& window_handle, const std::function<void(const VulkanCommand&)>& command, const std::string& name)
 {
 	// Get the graphics window
 	VulkanWindow* window = this->GetGraphicsWindow(window_handle);
@@ -192,5 +306,5 @@ void VulkanRenderer::SubmitCommand(const Aurion::WindowHandle& window_handle, co
 	}
 
 	// Submit the command to the window's command buffer
-	window->SubmitRenderCommand(command);
+	window->SubmitRenderCommand(command, name);
 }
\ No newline at end of file
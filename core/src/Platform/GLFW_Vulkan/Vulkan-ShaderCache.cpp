@@ -0,0 +1,363 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include <shaderc/shaderc.hpp>
+
+import Vulkan;
+import Aurion.FileSystem;
+
+// Archive layout: [Header][Entry * entry_count][SPIR-V blobs...]
+constexpr uint32_t c_shader_archive_magic = 0x43534754; // "TGSC"
+constexpr uint32_t c_shader_archive_version = 1;
+
+// Entries that go unused for this many sessions are evicted on save
+constexpr uint32_t c_shader_archive_max_unused_generations = 8;
+
+struct ShaderArchiveHeader
+{
+	uint32_t magic = c_shader_archive_magic;
+	uint32_t version = c_shader_archive_version;
+	uint32_t generation = 0;
+	uint32_t entry_count = 0;
+};
+
+struct ShaderArchiveEntry
+{
+	uint64_t key = 0;
+	uint64_t offset = 0;
+	uint64_t size = 0;
+	uint32_t last_used_generation = 0;
+	uint32_t reserved = 0;
+};
+
+// Owns the strings handed back to shaderc for a single include
+struct ShaderIncludeData
+{
+	shaderc_include_result result{};
+	std::string source_name;
+	std::string content;
+};
+
+VulkanShaderIncluder::VulkanShaderIncluder(const std::string& include_root)
+	: m_include_root(include_root)
+{
+
+}
+
+VulkanShaderIncluder::~VulkanShaderIncluder()
+{
+
+}
+
+shaderc_include_result* VulkanShaderIncluder::GetInclude(const char* requested_source, shaderc_include_type type, const char* requesting_source, size_t include_depth)
+{
+	ShaderIncludeData* data = new ShaderIncludeData();
+
+	// Relative includes resolve next to the including file, standard includes against the root
+	std::filesystem::path resolved_path = type == shaderc_include_type_relative ?
+		std::filesystem::path(requesting_source).parent_path() / requested_source :
+		std::filesystem::path(m_include_root) / requested_source;
+
+	std::ifstream file(resolved_path, std::ios::in | std::ios::binary);
+	if (file.is_open())
+	{
+		std::stringstream stream;
+		stream << file.rdbuf();
+
+		data->source_name = resolved_path.generic_string();
+		data->content = stream.str();
+	}
+	else
+	{
+		// An empty source name signals a failed include, content holds the error message
+		data->content = "Failed to resolve include: " + resolved_path.generic_string();
+	}
+
+	data->result.source_name = data->source_name.c_str();
+	data->result.source_name_length = data->source_name.size();
+	data->result.content = data->content.c_str();
+	data->result.content_length = data->content.size();
+	data->result.user_data = data;
+
+	return &data->result;
+}
+
+void VulkanShaderIncluder::ReleaseInclude(shaderc_include_result* data)
+{
+	delete static_cast<ShaderIncludeData*>(data->user_data);
+}
+
+uint64_t VulkanShaderCache::Hash(const void* data, const size_t& size, const uint64_t& seed)
+{
+	// 64-bit FNV-1a
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+
+	return hash;
+}
+
+uint64_t VulkanShaderCache::Hash(const std::string& value, const uint64_t& seed)
+{
+	return VulkanShaderCache::Hash(value.data(), value.size(), seed);
+}
+
+VulkanShaderCache::VulkanShaderCache()
+	: m_generation(0), m_dirty(false), m_stamps_dirty(false)
+{
+
+}
+
+VulkanShaderCache::~VulkanShaderCache()
+{
+
+}
+
+void VulkanShaderCache::Load(const std::string& archive_path)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	m_archive_path = archive_path;
+	m_entries.clear();
+	m_generation = 0;
+	m_dirty = false;
+	m_stamps_dirty = false;
+
+	// NOTE: This is WINDOWS only!!!! 
+	Aurion::WindowsFileSystem fs;
+
+	// A missing archive is just an empty cache
+	if (!fs.FileExists(m_archive_path.c_str()))
+	{
+		m_generation = 1;
+		return;
+	}
+
+	// One read for the whole archive
+	Aurion::FSFileHandle archive_handle = fs.OpenFile(m_archive_path.c_str(), false);
+	const unsigned char* archive_data = (const unsigned char*)archive_handle.Read();
+
+	// Same convention as the other file handle readers, excluding the terminator the handle appends
+	size_t archive_size = archive_handle.GetSize() > 0 ? archive_handle.GetSize() - 1 : 0;
+
+	ShaderArchiveHeader header{};
+	if (!archive_data || archive_size < sizeof(ShaderArchiveHeader))
+	{
+		m_generation = 1;
+		return;
+	}
+
+	std::memcpy(&header, archive_data, sizeof(ShaderArchiveHeader));
+
+	// Discard archives written by a different version of this format
+	if (header.magic != c_shader_archive_magic || header.version != c_shader_archive_version)
+	{
+		AURION_WARN("[Vulkan Shader Cache] Ignoring incompatible shader archive (%s)", m_archive_path.c_str());
+		m_generation = 1;
+		m_dirty = true;
+		return;
+	}
+
+	// Every load counts as a new session. Only the stamps need to reach disk for that.
+	m_generation = header.generation + 1;
+	m_stamps_dirty = true;
+
+	size_t index_end = sizeof(ShaderArchiveHeader) + (size_t)header.entry_count * sizeof(ShaderArchiveEntry);
+	if (index_end > archive_size)
+	{
+		AURION_WARN("[Vulkan Shader Cache] Shader archive index is truncated (%s)", m_archive_path.c_str());
+		m_dirty = true;
+		return;
+	}
+
+	// Unpack each blob referenced by the index
+	for (uint32_t i = 0; i < header.entry_count; i++)
+	{
+		ShaderArchiveEntry archive_entry{};
+		std::memcpy(&archive_entry, archive_data + sizeof(ShaderArchiveHeader) + i * sizeof(ShaderArchiveEntry), sizeof(ShaderArchiveEntry));
+
+		if (archive_entry.offset + archive_entry.size > archive_size || archive_entry.size % sizeof(uint32_t) != 0)
+		{
+			m_dirty = true;
+			continue;
+		}
+
+		Entry& entry = m_entries[archive_entry.key];
+		entry.last_used_generation = archive_entry.last_used_generation;
+		entry.archive_slot = static_cast<int64_t>(i);
+		entry.spirv.resize(archive_entry.size / sizeof(uint32_t));
+		std::memcpy(entry.spirv.data(), archive_data + archive_entry.offset, archive_entry.size);
+	}
+}
+
+void VulkanShaderCache::Save()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if ((!m_dirty && !m_stamps_dirty) || m_archive_path.empty())
+		return;
+
+	// Evict entries that haven't been used in a while, so edited shaders don't pile up forever
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if (m_generation - it->second.last_used_generation > c_shader_archive_max_unused_generations)
+		{
+			it = m_entries.erase(it);
+			m_dirty = true;
+		}
+		else
+			it++;
+	}
+
+	// Nothing was added or removed, so patch the generation stamps in place rather than rewriting every blob
+	if (!m_dirty)
+	{
+		this->SaveStamps();
+		return;
+	}
+
+	ShaderArchiveHeader header{};
+	header.generation = m_generation;
+	header.entry_count = static_cast<uint32_t>(m_entries.size());
+
+	// Lay out the index, then every blob behind it
+	std::vector<ShaderArchiveEntry> index;
+	index.reserve(m_entries.size());
+
+	uint64_t offset = sizeof(ShaderArchiveHeader) + m_entries.size() * sizeof(ShaderArchiveEntry);
+	for (const auto& [key, entry] : m_entries)
+	{
+		index.emplace_back(ShaderArchiveEntry{
+			.key = key,
+			.offset = offset,
+			.size = entry.spirv.size() * sizeof(uint32_t),
+			.last_used_generation = entry.last_used_generation
+		});
+
+		offset += index.back().size;
+	}
+
+	std::vector<unsigned char> archive(offset);
+	std::memcpy(archive.data(), &header, sizeof(ShaderArchiveHeader));
+	std::memcpy(archive.data() + sizeof(ShaderArchiveHeader), index.data(), index.size() * sizeof(ShaderArchiveEntry));
+
+	size_t i = 0;
+	for (const auto& [key, entry] : m_entries)
+	{
+		std::memcpy(archive.data() + index[i].offset, entry.spirv.data(), index[i].size);
+		i++;
+	}
+
+	// The cache directory isn't tracked, so a fresh checkout has none
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(m_archive_path).parent_path(), error);
+
+	// Single write over a truncated file, so nothing from a larger, older archive survives behind it
+	std::ofstream file(m_archive_path, std::ios::out | std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(archive.data()), static_cast<std::streamsize>(archive.size()));
+	if (!file.good())
+	{
+		AURION_ERROR("[Vulkan Shader Cache] Failed to write shader archive (%s)", m_archive_path.c_str());
+		return;
+	}
+
+	// The index was rewritten in iteration order
+	int64_t slot = 0;
+	for (auto& [key, entry] : m_entries)
+		entry.archive_slot = slot++;
+
+	m_dirty = false;
+	m_stamps_dirty = false;
+}
+
+void VulkanShaderCache::SaveStamps()
+{
+	std::fstream file(m_archive_path, std::ios::in | std::ios::out | std::ios::binary);
+	if (!file.is_open())
+	{
+		AURION_ERROR("[Vulkan Shader Cache] Failed to open shader archive (%s)", m_archive_path.c_str());
+		return;
+	}
+
+	ShaderArchiveHeader header{};
+	header.generation = m_generation;
+	header.entry_count = static_cast<uint32_t>(m_entries.size());
+
+	file.seekp(0);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(ShaderArchiveHeader));
+
+	// Only entries used this session carry a new stamp
+	for (const auto& [key, entry] : m_entries)
+	{
+		if (entry.archive_slot < 0 || entry.last_used_generation != m_generation)
+			continue;
+
+		std::streamoff stamp_offset = sizeof(ShaderArchiveHeader) + entry.archive_slot * sizeof(ShaderArchiveEntry) +
+			offsetof(ShaderArchiveEntry, last_used_generation);
+
+		file.seekp(stamp_offset);
+		file.write(reinterpret_cast<const char*>(&entry.last_used_generation), sizeof(uint32_t));
+	}
+
+	if (!file.good())
+	{
+		AURION_ERROR("[Vulkan Shader Cache] Failed to update shader archive (%s)", m_archive_path.c_str());
+		return;
+	}
+
+	m_stamps_dirty = false;
+}
+
+bool VulkanShaderCache::Find(const uint64_t& key, std::vector<uint32_t>& out_spirv)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto it = m_entries.find(key);
+	if (it == m_entries.end())
+		return false;
+
+	// Keep the entry alive across sessions. Archived entries only need their stamp patched.
+	if (it->second.last_used_generation != m_generation)
+	{
+		it->second.last_used_generation = m_generation;
+
+		if (it->second.archive_slot >= 0)
+			m_stamps_dirty = true;
+		else
+			m_dirty = true;
+	}
+
+	out_spirv = it->second.spirv;
+	return true;
+}
+
+void VulkanShaderCache::Store(const uint64_t& key, const std::vector<uint32_t>& spirv)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	Entry& entry = m_entries[key];
+	entry.spirv = spirv;
+	entry.last_used_generation = m_generation;
+	entry.archive_slot = -1;
+
+	m_dirty = true;
+}
+
+const std::string& VulkanShaderCache::GetArchivePath()
+{
+	return m_archive_path;
+}
@@ -0,0 +1,137 @@
+#include <macros/AurionLog.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <filesystem>
+#include <system_error>
+
+import Vulkan;
+
+// Compiled output lives alongside the sources, and must not trigger reloads
+constexpr const char* c_shader_watcher_ignored_directory = "cached";
+
+VulkanShaderWatcher::VulkanShaderWatcher()
+	: m_poll_interval(250), m_running(false)
+{
+
+}
+
+VulkanShaderWatcher::~VulkanShaderWatcher()
+{
+	this->Stop();
+}
+
+void VulkanShaderWatcher::Start(const std::string& directory, const ChangeCallback& on_change, const std::chrono::milliseconds& poll_interval)
+{
+	if (m_running)
+	{
+		AURION_WARN("[Vulkan Shader Watcher] Already watching %s", m_directory.c_str());
+		return;
+	}
+
+	m_directory = directory;
+	m_on_change = on_change;
+	m_poll_interval = poll_interval;
+
+	// Take the initial snapshot, so only edits made from here on are reported
+	m_write_times.clear();
+	this->Scan(false);
+
+	m_running = true;
+	m_thread = std::thread(&VulkanShaderWatcher::WatchLoop, this);
+}
+
+void VulkanShaderWatcher::Stop()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (!m_running)
+			return;
+
+		m_running = false;
+	}
+
+	m_condition.notify_all();
+
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+bool VulkanShaderWatcher::Running()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_running;
+}
+
+void VulkanShaderWatcher::WatchLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (m_running)
+	{
+		// Sleep for the poll interval, waking early on shutdown
+		m_condition.wait_for(lock, m_poll_interval, [this]() { return !m_running; });
+
+		if (!m_running)
+			break;
+
+		// Don't hold the lock while scanning or reloading
+		lock.unlock();
+
+		std::vector<std::string> changed_files = this->Scan(true);
+		if (!changed_files.empty() && m_on_change)
+			m_on_change(changed_files);
+
+		lock.lock();
+	}
+}
+
+std::vector<std::string> VulkanShaderWatcher::Scan(const bool& report_new_files)
+{
+	std::vector<std::string> changed_files;
+
+	std::error_code error;
+	std::filesystem::recursive_directory_iterator it(m_directory, error);
+	if (error)
+		return changed_files;
+
+	for (; it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+	{
+		if (error)
+			break;
+
+		// Skip the compiled shader cache
+		if (it->is_directory(error) && it->path().filename() == c_shader_watcher_ignored_directory)
+		{
+			it.disable_recursion_pending();
+			continue;
+		}
+
+		if (!it->is_regular_file(error))
+			continue;
+
+		std::filesystem::file_time_type write_time = it->last_write_time(error);
+		if (error)
+			continue;
+
+		std::string path = it->path().lexically_normal().generic_string();
+
+		// New files are reported too, they may be included by an existing shader
+		auto found = m_write_times.find(path);
+		if (found != m_write_times.end() && found->second == write_time)
+			continue;
+
+		bool is_new = found == m_write_times.end();
+		m_write_times[path] = write_time;
+
+		// Files seen during the initial snapshot aren't changes
+		if (!is_new || report_new_files)
+			changed_files.emplace_back(path);
+	}
+
+	return changed_files;
+}
@@ -0,0 +1,2030 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <cstring>
+#include <cfloat>
+#include <vector>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+import Vulkan;
+import Terrain;
+
+// Patches are quads, one control point per corner
+constexpr uint32_t c_patch_control_points = 4;
+
+// Every stage reads the heightmap. Control shaders read the patch bounds.
+constexpr VkShaderStageFlags c_terrain_stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT |
+	VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+constexpr VkPipelineStageFlags2 c_terrain_pipeline_stages = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT |
+	VK_PIPELINE_STAGE_2_TESSELLATION_EVALUATION_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+
+// Task shaders read every buffer and the Hi-Z pyramid. Mesh and fragment shaders read the heightmap.
+constexpr VkShaderStageFlags c_mesh_stages = VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+constexpr VkPipelineStageFlags2 c_mesh_pipeline_stages = VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT |
+	VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+
+// Graphics stages that read what the quadtree traversal writes on the compute queue: the indirect draw, selected
+//	nodes and node bounds
+constexpr VkPipelineStageFlags2 c_lod_consumer_stages = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | c_terrain_pipeline_stages;
+
+constexpr VkPipelineStageFlags2 c_depth_stages = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+
+// Meshlets are squares of 8x8 quads. Task workgroups hold one invocation per meshlet of a patch at its finest level.
+constexpr uint32_t c_meshlet_quads = 8;
+constexpr uint32_t c_max_patch_meshlets = 16;
+
+constexpr uint32_t c_hiz_group_size = 8;
+
+// Quadtree traversal visits a node per invocation. Nodes are packed into 16 bits per coordinate.
+constexpr uint32_t c_lod_group_size = 64;
+constexpr uint32_t c_max_lod_level = 15;
+
+// Quadtree draws sample the heightmap in every stage, and read the selected nodes in vertex and evaluation shaders
+constexpr VkShaderStageFlags c_lod_node_stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+
+// Ground detail spans features of c_detail_wavelength meters down to a couple of texels of the finest level
+constexpr float c_detail_wavelength = 64.0f;
+constexpr uint32_t c_detail_octaves = 8;
+constexpr float c_detail_gain = 0.6f;
+constexpr uint32_t c_detail_seed = 0x9E3779B9u; // Mixed into the height seed, so detail doesn't follow the terrain's shapes
+
+// Fills a ground detail page with RGBA8 color variation centered on 0.5, which terrain.frag doubles into an albedo scale.
+//	Texels are placed by world position, borders included, so neighbouring pages match. Octaves finer than two of the
+//	page's texels are left out, which stands in for filtering finer levels down.
+static void ProduceDetailPage(const VulkanTerrainConfig& config, const uint32_t& page_border, const VulkanVirtualPage& page, uint8_t* texels, const uint32_t& page_size)
+{
+	const uint32_t content_size = page_size - 2 * page_border;
+	const float texel_meters = config.world_size * static_cast<float>(1u << page.mip) / static_cast<float>(config.detail_pages_per_side * content_size);
+
+	// Normalized by every octave's amplitude, so coarse levels keep the contrast of the fine ones
+	uint32_t octaves = 0;
+	float total_amplitude = 0.0f;
+	float amplitude = 1.0f;
+	for (uint32_t octave = 0; octave < c_detail_octaves; octave++)
+	{
+		if (c_detail_wavelength / static_cast<float>(1u << octave) >= 2.0f * texel_meters)
+			octaves = octave + 1;
+
+		total_amplitude += amplitude;
+		amplitude *= c_detail_gain;
+	}
+
+	const uint32_t seed = config.noise.seed ^ c_detail_seed;
+	for (uint32_t y = 0; y < page_size; y++)
+	{
+		for (uint32_t x = 0; x < page_size; x++)
+		{
+			const float world_x = (static_cast<float>(page.x * content_size + x) - static_cast<float>(page_border) + 0.5f) * texel_meters;
+			const float world_y = (static_cast<float>(page.y * content_size + y) - static_cast<float>(page_border) + 0.5f) * texel_meters;
+
+			float variation = 0.0f;
+			float octave_amplitude = 1.0f;
+			float frequency = 1.0f / c_detail_wavelength;
+			for (uint32_t octave = 0; octave < octaves; octave++)
+			{
+				variation += TerrainNoise::Gradient(world_x * frequency, world_y * frequency, seed + octave) * octave_amplitude;
+				octave_amplitude *= c_detail_gain;
+				frequency *= 2.0f;
+			}
+
+			variation /= total_amplitude;
+
+			// Warmer and drier above the mean, cooler and greener below
+			uint8_t* texel = texels + (static_cast<size_t>(y) * page_size + x) * 4;
+			texel[0] = static_cast<uint8_t>(std::clamp(0.5f + variation * 0.35f, 0.0f, 1.0f) * 255.0f + 0.5f);
+			texel[1] = static_cast<uint8_t>(std::clamp(0.5f + variation * 0.28f, 0.0f, 1.0f) * 255.0f + 0.5f);
+			texel[2] = static_cast<uint8_t>(std::clamp(0.5f + variation * 0.20f, 0.0f, 1.0f) * 255.0f + 0.5f);
+			texel[3] = 255;
+		}
+	}
+}
+
+static void ConfigureRasterization(VulkanPipelineBuilder& builder)
+{
+	builder.ConfigureViewportState()
+		.AddViewport(VkViewport{})
+		.AddScissor(VkRect2D{})
+	.BuildViewportState()
+	.ConfigureRasterizationState()
+		.SetDepthClampEnabled(VK_FALSE)
+		.SetRasterizerDiscardEnabled(VK_FALSE)
+		.SetPolygonMode(VK_POLYGON_MODE_FILL)
+		.SetLineWidth(1.0f)
+		.SetCullMode(VK_CULL_MODE_NONE) // Culling happens per patch or meshlet, before rasterization
+		.SetFrontFace(VK_FRONT_FACE_COUNTER_CLOCKWISE)
+		.SetDepthBiasEnabled(VK_FALSE)
+		.SetDepthBiasConstantFactor(0.0f)
+		.SetDepthBiasClamp(0.0f)
+		.SetDepthBiasSlopeFactor(0.0f)
+	.ConfigureMultisampleState()
+		.SetSampleShadingEnabled(VK_FALSE)
+		.SetRasterizationSamples(VK_SAMPLE_COUNT_1_BIT)
+		.SetMinSampleShading(1.0f)
+		.SetAlphaToCoverageEnabled(VK_FALSE)
+		.SetAlphaToOneEnabled(VK_FALSE)
+	.BuildMultisampleState()
+	.ConfigureDepthStencilState()
+		.SetDepthTestEnabled(VK_TRUE)
+		.SetDepthWriteEnabled(VK_TRUE)
+		.SetDepthCompareOp(VK_COMPARE_OP_LESS)
+		.SetDepthBoundsTestEnabled(VK_FALSE)
+		.SetStencilTestEnabled(VK_FALSE)
+	.ConfigureColorBlendState()
+		.AddColorAttachment()
+			.SetColorWriteMask(VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT)
+			.SetBlendEnabled(VK_FALSE)
+			.SetSrcColorBlendFactor(VK_BLEND_FACTOR_ONE)
+			.SetDstColorBlendFactor(VK_BLEND_FACTOR_ZERO)
+			.SetColorBlendOp(VK_BLEND_OP_ADD)
+			.SetSrcAlphaBlendFactor(VK_BLEND_FACTOR_ONE)
+			.SetDstAlphaBlendFactor(VK_BLEND_FACTOR_ZERO)
+			.SetAlphaBlendOp(VK_BLEND_OP_ADD)
+		.SetLogicOpEnabled(VK_FALSE)
+		.SetLogicOp(VK_LOGIC_OP_COPY)
+		.SetBlendConstants(0.0f, 0.0f, 0.0f, 0.0f)
+	.BuildColorBlendState()
+	.ConfigureDynamicState()
+		.AddDynamicState(VK_DYNAMIC_STATE_VIEWPORT)
+		.AddDynamicState(VK_DYNAMIC_STATE_SCISSOR)
+	.BuildDynamicState();
+}
+
+static void SetViewport(const VkCommandBuffer& cmd_buffer, const VkExtent2D& extent)
+{
+	VkViewport viewport{};
+	viewport.width = static_cast<float>(extent.width);
+	viewport.height = static_cast<float>(extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(cmd_buffer, 0, 1, &viewport);
+
+	VkRect2D scissor{ .extent = extent };
+	vkCmdSetScissor(cmd_buffer, 0, 1, &scissor);
+}
+
+static void BufferBarrier(const VkCommandBuffer& cmd_buffer, const VkBuffer& buffer,
+	const VkPipelineStageFlags2& src_stages, const VkAccessFlags2& src_access, const VkPipelineStageFlags2& dst_stages, const VkAccessFlags2& dst_access)
+{
+	VkBufferMemoryBarrier2 buffer_barrier{};
+	buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+	buffer_barrier.srcStageMask = src_stages;
+	buffer_barrier.srcAccessMask = src_access;
+	buffer_barrier.dstStageMask = dst_stages;
+	buffer_barrier.dstAccessMask = dst_access;
+	buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	buffer_barrier.buffer = buffer;
+	buffer_barrier.offset = 0;
+	buffer_barrier.size = VK_WHOLE_SIZE;
+
+	VkDependencyInfo dep_info{};
+	dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dep_info.bufferMemoryBarrierCount = 1;
+	dep_info.pBufferMemoryBarriers = &buffer_barrier;
+
+	vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+}
+
+static void GlobalBarrier(const VkCommandBuffer& cmd_buffer,
+	const VkPipelineStageFlags2& src_stages, const VkAccessFlags2& src_access, const VkPipelineStageFlags2& dst_stages, const VkAccessFlags2& dst_access)
+{
+	VkMemoryBarrier2 barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+	barrier.srcStageMask = src_stages;
+	barrier.srcAccessMask = src_access;
+	barrier.dstStageMask = dst_stages;
+	barrier.dstAccessMask = dst_access;
+
+	VkDependencyInfo dep_info{};
+	dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dep_info.memoryBarrierCount = 1;
+	dep_info.pMemoryBarriers = &barrier;
+
+	vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+}
+
+// Index of a quadtree level's first node, with every coarser level before it
+static size_t NodeLevelOffset(const uint32_t& level)
+{
+	return ((static_cast<size_t>(1) << (2 * level)) - 1) / 3;
+}
+
+// A node's bounds hold its four children's
+static void MergeChildBounds(std::vector<TerrainPatchBounds>& nodes, const uint32_t& level, const uint32_t& x, const uint32_t& y)
+{
+	const uint32_t child_side = 1u << (level + 1);
+	const TerrainPatchBounds* children = nodes.data() + NodeLevelOffset(level + 1);
+
+	TerrainPatchBounds& node = nodes[NodeLevelOffset(level) + static_cast<size_t>(y) * (1u << level) + x];
+	node.min_height = FLT_MAX;
+	node.max_height = -FLT_MAX;
+	node.variance = 0.0f;
+
+	for (uint32_t child = 0; child < 4; child++)
+	{
+		const TerrainPatchBounds& bounds = children[static_cast<size_t>(y * 2 + (child >> 1)) * child_side + x * 2 + (child & 1)];
+		node.min_height = std::min(node.min_height, bounds.min_height);
+		node.max_height = std::max(node.max_height, bounds.max_height);
+		node.variance = std::max(node.variance, bounds.variance);
+	}
+}
+
+void VulkanTerrain::ConfigureTessellationPipeline(VulkanPipelineBuilder& builder, const VulkanTerrainConfig& config)
+{
+	builder.Configure(VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO)
+	.UseDynamicRendering()
+		.AddDynamicColorAttachmentFormat(config.color_format)
+		.SetDynamicDepthAttachmentFormat(config.depth_format)
+		.SetDynamicStencilAttachmentFormat(VK_FORMAT_UNDEFINED)
+	.BindShader(VK_SHADER_STAGE_VERTEX_BIT, 0, "assets/shaders/terrain.vert", false)
+	.BindShader(VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT, 0, "assets/shaders/terrain.tesc", false)
+	.BindShader(VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT, 0, "assets/shaders/terrain.tese", false)
+	.BindShader(VK_SHADER_STAGE_FRAGMENT_BIT, 0, "assets/shaders/terrain.frag", false)
+	.ConfigurePipelineLayout() // Pipeline Layout
+		.ConfigureDescSetLayout()
+			.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, c_terrain_stages) // Heightmap
+			.AddDescSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT) // Patch bounds
+		.BuildDescSetLayout()
+		.ConfigureDescSetLayout() // Ground detail
+			.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT) // Indirection
+			.AddDescSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT) // Page cache
+			.AddDescSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT) // Feedback
+		.BuildDescSetLayout()
+		.AddPushConstantRange(c_terrain_stages, 0, sizeof(VulkanTerrainConstants))
+	.BuildPipelineLayout()
+	.ConfigureVertexInputState() // Corners are generated from the vertex index
+	.BuildVertexInputState()
+	.ConfigureInputAssemblyState()
+		.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_PATCH_LIST)
+		.SetPrimitiveRestartEnable(VK_FALSE)
+	.ConfigureTessellationState()
+		.SetPatchControlPointCount(c_patch_control_points);
+
+	ConfigureRasterization(builder);
+}
+
+void VulkanTerrain::ConfigureMeshPipeline(VulkanPipelineBuilder& builder, const VulkanTerrainConfig& config)
+{
+	// Vertex input and input assembly are ignored by mesh pipelines
+	builder.Configure(VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO)
+	.UseDynamicRendering()
+		.AddDynamicColorAttachmentFormat(config.color_format)
+		.SetDynamicDepthAttachmentFormat(config.depth_format)
+		.SetDynamicStencilAttachmentFormat(VK_FORMAT_UNDEFINED)
+	.BindShader(VK_SHADER_STAGE_TASK_BIT_EXT, 0, "assets/shaders/terrain.task", false)
+	.BindShader(VK_SHADER_STAGE_MESH_BIT_EXT, 0, "assets/shaders/terrain.mesh", false)
+	.BindShader(VK_SHADER_STAGE_FRAGMENT_BIT, 0, "assets/shaders/terrain.frag", false)
+	.ConfigurePipelineLayout() // Pipeline Layout
+		.ConfigureDescSetLayout()
+			.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, c_mesh_stages) // Heightmap
+			.AddDescSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_TASK_BIT_EXT) // Patch bounds
+			.AddDescSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_TASK_BIT_EXT) // Meshlets
+			.AddDescSetLayoutBinding(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_TASK_BIT_EXT) // Hi-Z pyramid
+			.AddDescSetLayoutBinding(4, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_TASK_BIT_EXT) // Culling
+		.BuildDescSetLayout()
+		.ConfigureDescSetLayout() // Ground detail
+			.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT) // Indirection
+			.AddDescSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT) // Page cache
+			.AddDescSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT) // Feedback
+		.BuildDescSetLayout()
+		.AddPushConstantRange(c_mesh_stages, 0, sizeof(VulkanTerrainConstants))
+	.BuildPipelineLayout();
+
+	ConfigureRasterization(builder);
+}
+
+void VulkanTerrain::ConfigureHiZPipeline(VulkanPipelineBuilder& builder)
+{
+	builder.Configure(VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO)
+	.BindShader(VK_SHADER_STAGE_COMPUTE_BIT, 0, "assets/shaders/terrain-hiz.comp", false)
+	.ConfigurePipelineLayout() // Pipeline Layout
+		.ConfigureDescSetLayout()
+			.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Depth, or the level before
+			.AddDescSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Level being reduced
+		.BuildDescSetLayout()
+		.AddPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(int32_t) * 4) // Source and destination sizes
+	.BuildPipelineLayout();
+}
+
+void VulkanTerrain::ConfigureLodPipeline(VulkanPipelineBuilder& builder, const VulkanTerrainConfig& config)
+{
+	builder.Configure(VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO)
+	.UseDynamicRendering()
+		.AddDynamicColorAttachmentFormat(config.color_format)
+		.SetDynamicDepthAttachmentFormat(config.depth_format)
+		.SetDynamicStencilAttachmentFormat(VK_FORMAT_UNDEFINED)
+	.BindShader(VK_SHADER_STAGE_VERTEX_BIT, 0, "assets/shaders/terrain-lod.vert", false)
+	.BindShader(VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT, 0, "assets/shaders/terrain-lod.tesc", false)
+	.BindShader(VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT, 0, "assets/shaders/terrain-lod.tese", false)
+	.BindShader(VK_SHADER_STAGE_FRAGMENT_BIT, 0, "assets/shaders/terrain.frag", false)
+	.ConfigurePipelineLayout() // Pipeline Layout
+		.ConfigureDescSetLayout()
+			.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, c_terrain_stages) // Heightmap
+			.AddDescSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, c_terrain_stages) // Node bounds, declared by terrain-common.glsl
+			.AddDescSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, c_lod_node_stages) // Selected nodes
+		.BuildDescSetLayout()
+		.ConfigureDescSetLayout() // Ground detail
+			.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT) // Indirection
+			.AddDescSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT) // Page cache
+			.AddDescSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT) // Feedback
+		.BuildDescSetLayout()
+		.AddPushConstantRange(c_terrain_stages, 0, sizeof(VulkanTerrainConstants))
+	.BuildPipelineLayout()
+	.ConfigureVertexInputState() // Corners are generated from the vertex index, nodes from the instance
+	.BuildVertexInputState()
+	.ConfigureInputAssemblyState()
+		.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_PATCH_LIST)
+		.SetPrimitiveRestartEnable(VK_FALSE)
+	.ConfigureTessellationState()
+		.SetPatchControlPointCount(c_patch_control_points);
+
+	ConfigureRasterization(builder);
+}
+
+void VulkanTerrain::ConfigureTraversalPipeline(VulkanPipelineBuilder& builder)
+{
+	builder.Configure(VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO)
+	.BindShader(VK_SHADER_STAGE_COMPUTE_BIT, 0, "assets/shaders/terrain-lod.comp", false)
+	.ConfigurePipelineLayout() // Pipeline Layout
+		.ConfigureDescSetLayout()
+			.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Node bounds
+			.AddDescSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Node queue
+			.AddDescSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Level counters
+			.AddDescSetLayoutBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Selected nodes
+			.AddDescSetLayoutBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Draw command
+		.BuildDescSetLayout()
+		.AddPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VulkanTerrainLodConstants))
+	.BuildPipelineLayout();
+}
+
+VulkanTerrain::VulkanTerrain()
+	: m_logical_device(nullptr), m_pipeline(nullptr), m_mesh_pipeline(nullptr), m_hiz_pipeline(nullptr), m_lod_pipeline(nullptr), m_traversal_pipeline(nullptr),
+		m_config({}), m_patches_per_side(0), m_leaf_level(0), m_heightmap_image({}), m_patch_buffer(VK_NULL_HANDLE), m_patch_allocation(VK_NULL_HANDLE),
+		m_meshlet_buffer(VK_NULL_HANDLE), m_meshlet_allocation(VK_NULL_HANDLE), m_culling_buffer(VK_NULL_HANDLE), m_culling_allocation(VK_NULL_HANDLE),
+		m_node_buffer(VK_NULL_HANDLE), m_node_allocation(VK_NULL_HANDLE), m_descriptor_pool(VK_NULL_HANDLE), m_descriptor_set(VK_NULL_HANDLE),
+		m_detail_region(VulkanVirtualTexture::c_max_regions), m_detail_pool(VK_NULL_HANDLE), m_uploaded(false), m_target({}), m_previous_view_projection{}, m_previous_extent({}), m_hiz_valid(false)
+{
+
+}
+
+VulkanTerrain::~VulkanTerrain()
+{
+	this->Destroy();
+}
+
+bool VulkanTerrain::Initialize(VulkanDevice* logical_device, VulkanPipelineBuilder& builder, const VulkanTerrainConfig& config)
+{
+	if (m_logical_device)
+	{
+		AURION_WARN("[Vulkan Terrain] Attempt to initialize after initialization!");
+		return false;
+	}
+
+	if (config.patch_texels == 0 || config.heightmap_size <= config.patch_texels || (config.heightmap_size - 1) % config.patch_texels != 0)
+	{
+		AURION_ERROR("[Vulkan Terrain] A heightmap of %d texels can't be split into patches of %d texels.", config.heightmap_size, config.patch_texels);
+		return false;
+	}
+
+	m_logical_device = logical_device;
+	m_config = config;
+	m_patches_per_side = (m_config.heightmap_size - 1) / m_config.patch_texels;
+
+	// The tessellation pipeline is built on its own, so a failed mesh shading build can't take it down
+	VulkanTerrain::ConfigureTessellationPipeline(builder, m_config);
+	VulkanPipelineBuilder::Result result = builder.Build();
+
+	m_pipeline = result.graphics_pipelines.empty() ? nullptr : result.graphics_pipelines.back();
+	if (!m_pipeline || m_pipeline->handle == VK_NULL_HANDLE || m_pipeline->ds_layouts.size() < 2)
+	{
+		AURION_ERROR("[Vulkan Terrain] Failed to build the tessellation pipeline!");
+		this->Destroy();
+		return false;
+	}
+
+	// CPU heights stay resident for queries and physics
+	if (m_config.generate_heights)
+		m_heightmap.Generate(m_config.noise, m_config.heightmap_size);
+	else
+		m_heightmap.Resize(m_config.heightmap_size);
+	m_patch_bounds = m_heightmap.ComputePatchBounds(m_config.patch_texels);
+
+	if (m_config.mesh_shading && !this->InitializeMeshShading(builder))
+	{
+		m_mesh_pipeline = nullptr;
+		m_hiz_pipeline = nullptr;
+		m_meshlets.clear();
+	}
+
+	if (!m_mesh_pipeline && m_config.lod_traversal && !this->InitializeLodTraversal(builder))
+	{
+		m_lod_pipeline = nullptr;
+		m_traversal_pipeline = nullptr;
+		m_node_bounds.clear();
+	}
+
+	m_patch_dirty.assign(m_patch_bounds.size(), 0);
+
+	const VkDeviceSize bounds_bytes = m_patch_bounds.size() * sizeof(TerrainPatchBounds);
+	const VkDeviceSize meshlet_bytes = m_meshlets.size() * sizeof(TerrainMeshlet);
+
+	// Heightmap. Heights are filtered in the shaders, since linear filtering of 32-bit floats is optional. Where the
+	//	device can blit it linearly, it gets a full mip chain for shading distant terrain.
+	{
+		const bool generate_mips = VulkanImage::SupportsMipGeneration(m_logical_device->physical_device, VK_FORMAT_R32_SFLOAT);
+
+		VulkanImageCreateInfo create_info{};
+		create_info.format = VK_FORMAT_R32_SFLOAT;
+		create_info.extent = VkExtent3D{ m_config.heightmap_size, m_config.heightmap_size, 1 };
+		create_info.usage_flags = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | (generate_mips ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+		create_info.mip_levels = generate_mips ? VulkanImage::c_full_mip_chain : 1;
+		create_info.aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+		create_info.queue_family_indices = m_logical_device->queue_families.data();
+		create_info.queue_family_count = static_cast<uint32_t>(m_logical_device->queue_families.size());
+
+		m_heightmap_image = VulkanImage::Create(m_logical_device->handle, m_logical_device->allocator, create_info);
+		if (m_heightmap_image.image == VK_NULL_HANDLE)
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to create the heightmap image!");
+			this->Destroy();
+			return false;
+		}
+	}
+
+	if (!this->CreateBuffer(bounds_bytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, m_patch_buffer, m_patch_allocation))
+	{
+		AURION_ERROR("[Vulkan Terrain] Failed to create the patch bounds buffer!");
+		this->Destroy();
+		return false;
+	}
+
+	if (m_mesh_pipeline)
+	{
+		if (!this->CreateBuffer(meshlet_bytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, m_meshlet_buffer, m_meshlet_allocation) ||
+			!this->CreateBuffer(sizeof(VulkanTerrainCulling), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, m_culling_buffer, m_culling_allocation))
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to create the mesh shading buffers!");
+			this->Destroy();
+			return false;
+		}
+	}
+
+	// Copied and read on the compute queue. Quadtree draws bind it too, as terrain-common.glsl declares it.
+	if (m_lod_pipeline)
+	{
+		if (!this->CreateBuffer(m_node_bounds.size() * sizeof(TerrainPatchBounds), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			m_node_buffer, m_node_allocation, true))
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to create the quadtree node buffer!");
+			this->Destroy();
+			return false;
+		}
+	}
+
+	// Tessellation descriptors. Mesh shading sets sample a render target's pyramid, so they're made with each target.
+	{
+		VkDescriptorPoolSize pool_sizes[2] = {
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 }
+		};
+
+		VkDescriptorPoolCreateInfo pool_info{};
+		pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		pool_info.maxSets = 1;
+		pool_info.poolSizeCount = 2;
+		pool_info.pPoolSizes = pool_sizes;
+
+		if (vkCreateDescriptorPool(m_logical_device->handle, &pool_info, nullptr, &m_descriptor_pool) != VK_SUCCESS)
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to create the descriptor pool!");
+			this->Destroy();
+			return false;
+		}
+
+		VkDescriptorSetAllocateInfo set_info{};
+		set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		set_info.descriptorPool = m_descriptor_pool;
+		set_info.descriptorSetCount = 1;
+		set_info.pSetLayouts = &m_pipeline->ds_layouts[0];
+
+		if (vkAllocateDescriptorSets(m_logical_device->handle, &set_info, &m_descriptor_set) != VK_SUCCESS)
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to allocate the descriptor set!");
+			this->Destroy();
+			return false;
+		}
+
+		VkDescriptorImageInfo image_info{};
+		image_info.sampler = m_heightmap_image.sampler;
+		image_info.imageView = m_heightmap_image.view;
+		image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkDescriptorBufferInfo buffer_info{};
+		buffer_info.buffer = m_patch_buffer;
+		buffer_info.offset = 0;
+		buffer_info.range = VK_WHOLE_SIZE;
+
+		VkWriteDescriptorSet writes[2]{};
+		writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[0].dstSet = m_descriptor_set;
+		writes[0].dstBinding = 0;
+		writes[0].descriptorCount = 1;
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[0].pImageInfo = &image_info;
+
+		writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[1].dstSet = m_descriptor_set;
+		writes[1].dstBinding = 1;
+		writes[1].descriptorCount = 1;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[1].pBufferInfo = &buffer_info;
+
+		vkUpdateDescriptorSets(m_logical_device->handle, 2, writes, 0, nullptr);
+	}
+
+	if (!this->InitializeDetail())
+	{
+		AURION_ERROR("[Vulkan Terrain] Failed to create the ground detail texture!");
+		this->Destroy();
+		return false;
+	}
+
+	AURION_INFO("[Vulkan Terrain] %d patches of %d texels, over a %d texel heightmap, drawn with %s.", m_patches_per_side * m_patches_per_side,
+		m_config.patch_texels, m_config.heightmap_size, m_mesh_pipeline ? "mesh shaders" : m_lod_pipeline ? "quadtree traversal" : "tessellation");
+
+	return true;
+}
+
+void VulkanTerrain::Destroy()
+{
+	if (!m_logical_device)
+		return;
+
+	// Frames in flight may still read any of it
+	m_logical_device->graphics_timeline.Wait(m_logical_device->handle, m_logical_device->graphics_timeline.value);
+
+	for (auto& target : m_retired_targets)
+		this->DestroyTarget(target);
+	m_retired_targets.clear();
+
+	this->DestroyTarget(m_target);
+	this->DestroyImage(m_heightmap_image);
+
+	m_detail.Destroy();
+	if (m_detail_pool != VK_NULL_HANDLE)
+		vkDestroyDescriptorPool(m_logical_device->handle, m_detail_pool, nullptr);
+	m_detail_pool = VK_NULL_HANDLE;
+	m_detail_region = VulkanVirtualTexture::c_max_regions;
+	m_detail_sets.clear();
+	m_detail_feedback.clear();
+
+	for (VulkanTerrainDepthFrame& frame : m_depth_frames)
+	{
+		if (frame.descriptor_pool != VK_NULL_HANDLE)
+			vkDestroyDescriptorPool(m_logical_device->handle, frame.descriptor_pool, nullptr);
+	}
+	m_depth_frames.clear();
+
+	for (VulkanTerrainLodFrame& frame : m_lod_frames)
+		this->DestroyLodFrame(frame);
+	m_lod_frames.clear();
+
+	for (VulkanTerrainStaging& staging : m_staging)
+		vmaDestroyBuffer(m_logical_device->allocator, staging.buffer, staging.allocation);
+	m_staging.clear();
+
+	if (m_descriptor_pool != VK_NULL_HANDLE)
+		vkDestroyDescriptorPool(m_logical_device->handle, m_descriptor_pool, nullptr);
+
+	if (m_patch_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, m_patch_buffer, m_patch_allocation);
+
+	if (m_meshlet_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, m_meshlet_buffer, m_meshlet_allocation);
+
+	if (m_culling_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, m_culling_buffer, m_culling_allocation);
+
+	if (m_node_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, m_node_buffer, m_node_allocation);
+
+	m_descriptor_pool = VK_NULL_HANDLE;
+	m_descriptor_set = VK_NULL_HANDLE;
+	m_patch_buffer = VK_NULL_HANDLE;
+	m_patch_allocation = VK_NULL_HANDLE;
+	m_meshlet_buffer = VK_NULL_HANDLE;
+	m_meshlet_allocation = VK_NULL_HANDLE;
+	m_culling_buffer = VK_NULL_HANDLE;
+	m_culling_allocation = VK_NULL_HANDLE;
+	m_node_buffer = VK_NULL_HANDLE;
+	m_node_allocation = VK_NULL_HANDLE;
+	m_uploaded = false;
+	m_hiz_valid = false;
+	m_patch_bounds.clear();
+	m_meshlets.clear();
+	m_node_bounds.clear();
+	m_dirty_patches.clear();
+	m_patch_dirty.clear();
+	m_patches_per_side = 0;
+	m_leaf_level = 0;
+	m_pipeline = nullptr;
+	m_mesh_pipeline = nullptr;
+	m_hiz_pipeline = nullptr;
+	m_lod_pipeline = nullptr;
+	m_traversal_pipeline = nullptr;
+	m_logical_device = nullptr;
+}
+
+VulkanTransientImageInfo VulkanTerrain::GetDepthImageInfo()
+{
+	VulkanTransientImageInfo image_info{};
+	image_info.format = m_config.depth_format;
+	image_info.usage_flags = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | (m_hiz_pipeline ? VK_IMAGE_USAGE_SAMPLED_BIT : 0);
+	image_info.aspect_flags = VK_IMAGE_ASPECT_DEPTH_BIT;
+	image_info.lazily_allocated = m_hiz_pipeline == nullptr;
+	return image_info;
+}
+
+void VulkanTerrain::Record(const VulkanCommand& command, const VulkanImage& depth, const TerrainCamera& camera)
+{
+	if (!m_logical_device || command.render_extent.width == 0 || command.render_extent.height == 0)
+		return;
+
+	if (depth.view == VK_NULL_HANDLE || depth.extent.width < command.render_extent.width || depth.extent.height < command.render_extent.height)
+	{
+		AURION_ERROR("[Vulkan Terrain] The depth image doesn't cover the render extent!");
+		return;
+	}
+
+	const VkCommandBuffer& cmd_buffer = command.graphics_buffer;
+	const VkExtent2D extent{ command.render_extent.width, command.render_extent.height };
+
+	this->ReleaseRetired();
+
+	if (!m_uploaded)
+	{
+		if (!this->RecordUploads(command))
+			return;
+	}
+	else if (!m_dirty_patches.empty())
+		this->RecordTileUploads(command);
+
+	if (!this->PrepareTarget(depth.extent))
+		return;
+
+	const VkDescriptorSet depth_set = m_hiz_pipeline ? this->PrepareDepthFrame(command.current_frame, depth) : VK_NULL_HANDLE;
+	if (m_hiz_pipeline && depth_set == VK_NULL_HANDLE)
+		return;
+
+	VulkanTerrainLodFrame* lod_frame = m_lod_pipeline ? this->PrepareLodFrame(command.current_frame) : nullptr;
+	if (m_lod_pipeline && !lod_frame)
+		return;
+
+	// Detail pages requested by earlier frames go in before anything samples the cache
+	m_detail.BeginFrame();
+	m_detail.RecordUploads(cmd_buffer);
+
+	const VkDescriptorSet detail_set = this->PrepareDetailSet();
+	if (detail_set == VK_NULL_HANDLE)
+		return;
+
+	VulkanTerrainConstants constants{};
+	camera.ComputeViewProjection(static_cast<float>(extent.width) / static_cast<float>(extent.height), constants.view_projection);
+	constants.camera[0] = camera.position[0];
+	constants.camera[1] = camera.position[1];
+	constants.camera[2] = camera.position[2];
+	constants.camera[3] = camera.GetProjectionScale();
+	constants.viewport[0] = static_cast<float>(extent.width);
+	constants.viewport[1] = static_cast<float>(extent.height);
+	constants.viewport[2] = std::max(m_config.target_edge_pixels, 1.0f);
+	constants.viewport[3] = std::clamp(m_config.max_tessellation, 1.0f, static_cast<float>(m_config.patch_texels));
+	if (m_lod_pipeline)
+		constants.viewport[3] = static_cast<float>(m_config.patch_texels); // Every node is a grid of this many cells per side
+	constants.terrain[0] = m_config.world_size;
+	constants.terrain[1] = m_config.height_scale;
+	constants.terrain[2] = static_cast<float>(m_patches_per_side);
+	constants.terrain[3] = m_config.variance_weight;
+
+	const VulkanVirtualTextureConfig& detail_config = m_detail.GetConfig();
+	constants.detail[0] = m_detail_region;
+	constants.detail[1] = detail_config.page_size;
+	constants.detail[2] = detail_config.page_border;
+	constants.detail[3] = detail_config.feedback_extent.width | (detail_config.feedback_extent.height << 16);
+
+	// Occlusion tests reproject into last frame's pyramid, so this frame's uniforms go in before drawing
+	if (m_mesh_pipeline)
+		this->RecordCulling(cmd_buffer, constants.view_projection);
+
+	// Graphics waits on the frame's compute work, so the draw list is ready before drawing
+	if (lod_frame)
+		this->RecordTraversal(command, *lod_frame, constants);
+
+	VkRenderingAttachmentInfo color_attachment{
+		.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+		.imageView = command.render_view,
+		.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+		.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD,
+		.storeOp = VK_ATTACHMENT_STORE_OP_STORE
+	};
+
+	// The render graph creates depth for the frame in the attachment layout. It's cleared, never carried between frames.
+	VkRenderingAttachmentInfo depth_attachment{
+		.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+		.imageView = depth.view,
+		.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+		.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+		.storeOp = m_hiz_pipeline ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE,
+		.clearValue = VkClearValue{ .depthStencil = { 1.0f, 0 } }
+	};
+
+	VkRenderingInfo render_info{
+		.sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+		.renderArea = VkRect2D{ .extent = extent },
+		.layerCount = 1,
+		.viewMask = 0,
+		.colorAttachmentCount = 1,
+		.pColorAttachments = &color_attachment,
+		.pDepthAttachment = &depth_attachment
+	};
+
+	vkCmdBeginRendering(cmd_buffer, &render_info);
+
+	SetViewport(cmd_buffer, extent);
+
+	if (m_mesh_pipeline)
+	{
+		vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_mesh_pipeline->handle);
+		VkDescriptorSet sets[2] = { m_target.mesh_set, detail_set };
+		vkCmdBindDescriptorSets(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_mesh_pipeline->layout, 0, 2, sets, 0, nullptr);
+		vkCmdPushConstants(cmd_buffer, m_mesh_pipeline->layout, c_mesh_stages, 0, sizeof(VulkanTerrainConstants), &constants);
+
+		// One task workgroup per patch, each launching a mesh workgroup per visible meshlet
+		m_logical_device->draw_mesh_tasks(cmd_buffer, m_patches_per_side * m_patches_per_side, 1, 1);
+	}
+	else if (lod_frame)
+	{
+		vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_lod_pipeline->handle);
+		VkDescriptorSet sets[2] = { lod_frame->draw_set, detail_set };
+		vkCmdBindDescriptorSets(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_lod_pipeline->layout, 0, 2, sets, 0, nullptr);
+		vkCmdPushConstants(cmd_buffer, m_lod_pipeline->layout, c_terrain_stages, 0, sizeof(VulkanTerrainConstants), &constants);
+
+		// One instance per selected node, counted by the traversal
+		vkCmdDrawIndirect(cmd_buffer, lod_frame->draw_buffer, 0, 1, sizeof(VkDrawIndirectCommand));
+	}
+	else
+	{
+		vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline->handle);
+		VkDescriptorSet sets[2] = { m_descriptor_set, detail_set };
+		vkCmdBindDescriptorSets(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline->layout, 0, 2, sets, 0, nullptr);
+		vkCmdPushConstants(cmd_buffer, m_pipeline->layout, c_terrain_stages, 0, sizeof(VulkanTerrainConstants), &constants);
+
+		// One patch per grid cell. The control shader discards the ones outside the frustum.
+		vkCmdDraw(cmd_buffer, m_patches_per_side * m_patches_per_side * c_patch_control_points, 1, 0, 0);
+	}
+
+	vkCmdEndRendering(cmd_buffer);
+
+	m_detail.RecordFeedbackReadback(cmd_buffer);
+
+	if (m_hiz_pipeline)
+	{
+		this->RecordHiZ(cmd_buffer, depth, depth_set, extent);
+
+		std::memcpy(m_previous_view_projection, constants.view_projection, sizeof(m_previous_view_projection));
+		m_previous_extent = extent;
+		m_hiz_valid = true;
+	}
+}
+
+void VulkanTerrain::UpdateHeights(const uint32_t& x, const uint32_t& y, const uint32_t& width, const uint32_t& height, const float* heights)
+{
+	if (!m_logical_device || !heights || width == 0 || height == 0 || x >= m_config.heightmap_size || y >= m_config.heightmap_size)
+		return;
+
+	m_heightmap.Write(x, y, width, height, heights);
+
+	// Patches share their edge texels, so a texel on a patch border dirties the patches on both sides
+	const uint32_t last_x = std::min(x + width, m_config.heightmap_size) - 1;
+	const uint32_t last_y = std::min(y + height, m_config.heightmap_size) - 1;
+	const uint32_t first_patch_x = x == 0 ? 0 : (x - 1) / m_config.patch_texels;
+	const uint32_t first_patch_y = y == 0 ? 0 : (y - 1) / m_config.patch_texels;
+	const uint32_t last_patch_x = std::min(last_x / m_config.patch_texels, m_patches_per_side - 1);
+	const uint32_t last_patch_y = std::min(last_y / m_config.patch_texels, m_patches_per_side - 1);
+
+	for (uint32_t patch_y = first_patch_y; patch_y <= last_patch_y; patch_y++)
+	{
+		for (uint32_t patch_x = first_patch_x; patch_x <= last_patch_x; patch_x++)
+		{
+			const uint32_t index = patch_y * m_patches_per_side + patch_x;
+			if (m_patch_dirty[index])
+				continue;
+
+			m_patch_dirty[index] = 1;
+			m_dirty_patches.push_back(index);
+		}
+	}
+}
+
+const TerrainHeightmap& VulkanTerrain::GetHeightmap()
+{
+	return m_heightmap;
+}
+
+const std::vector<TerrainPatchBounds>& VulkanTerrain::GetPatchBounds()
+{
+	return m_patch_bounds;
+}
+
+const VulkanTerrainConfig& VulkanTerrain::GetConfig()
+{
+	return m_config;
+}
+
+uint32_t VulkanTerrain::GetPatchesPerSide()
+{
+	return m_patches_per_side;
+}
+
+bool VulkanTerrain::IsMeshShading()
+{
+	return m_mesh_pipeline != nullptr;
+}
+
+bool VulkanTerrain::IsLodTraversal()
+{
+	return m_lod_pipeline != nullptr;
+}
+
+bool VulkanTerrain::InitializeMeshShading(VulkanPipelineBuilder& builder)
+{
+	if (!m_logical_device->mesh_shader_supported)
+	{
+		AURION_INFO("[Vulkan Terrain] VK_EXT_mesh_shader is unavailable. Falling back to tessellation.");
+		return false;
+	}
+
+	// A patch's finest level has to fit one task workgroup, and its coarsest level is a single meshlet
+	const uint32_t patch_meshlets = m_config.patch_texels / c_meshlet_quads;
+	if (m_config.patch_texels % c_meshlet_quads != 0 || (patch_meshlets & (patch_meshlets - 1)) != 0 || patch_meshlets * patch_meshlets > c_max_patch_meshlets)
+	{
+		AURION_WARN("[Vulkan Terrain] Mesh shading needs patches of 8, 16 or 32 texels, not %d. Falling back to tessellation.", m_config.patch_texels);
+		return false;
+	}
+
+	const uint32_t patch_count = m_patches_per_side * m_patches_per_side;
+	const VkPhysicalDeviceMeshShaderPropertiesEXT& properties = m_logical_device->mesh_shader_properties;
+	if (patch_count > properties.maxTaskWorkGroupCount[0] || patch_count > properties.maxTaskWorkGroupTotalCount)
+	{
+		AURION_WARN("[Vulkan Terrain] %d patches exceed the device's task workgroup limits. Falling back to tessellation.", patch_count);
+		return false;
+	}
+
+	VulkanTerrain::ConfigureMeshPipeline(builder, m_config);
+	if (m_config.occlusion_culling)
+		VulkanTerrain::ConfigureHiZPipeline(builder);
+
+	VulkanPipelineBuilder::Result result = builder.Build();
+
+	m_mesh_pipeline = result.graphics_pipelines.empty() ? nullptr : result.graphics_pipelines.back();
+	if (!m_mesh_pipeline || m_mesh_pipeline == m_pipeline || m_mesh_pipeline->handle == VK_NULL_HANDLE)
+	{
+		AURION_WARN("[Vulkan Terrain] Failed to build the mesh shading pipeline. Falling back to tessellation.");
+		return false;
+	}
+
+	if (m_config.occlusion_culling)
+	{
+		m_hiz_pipeline = result.compute_pipelines.empty() ? nullptr : result.compute_pipelines.back();
+		if (!m_hiz_pipeline || m_hiz_pipeline->handle == VK_NULL_HANDLE)
+		{
+			AURION_WARN("[Vulkan Terrain] Failed to build the Hi-Z pipeline. Meshlets won't be occlusion culled.");
+			m_hiz_pipeline = nullptr;
+		}
+	}
+
+	this->BuildMeshlets();
+
+	return true;
+}
+
+bool VulkanTerrain::InitializeLodTraversal(VulkanPipelineBuilder& builder)
+{
+	// Leaves are the patches, so the quadtree needs a power of two of them per side
+	if ((m_patches_per_side & (m_patches_per_side - 1)) != 0 || m_patches_per_side > (1u << c_max_lod_level))
+	{
+		AURION_WARN("[Vulkan Terrain] Quadtree traversal needs a power of two patches per side, not %d. Drawing every patch.", m_patches_per_side);
+		return false;
+	}
+
+	// Nodes are drawn as grids of patch_texels cells, whose odd vertices morph onto even ones
+	if (m_config.patch_texels % 2 != 0 || m_config.patch_texels > 64)
+	{
+		AURION_WARN("[Vulkan Terrain] Quadtree traversal needs patches of an even number of texels, at most 64, not %d. Drawing every patch.", m_config.patch_texels);
+		return false;
+	}
+
+	VulkanTerrain::ConfigureLodPipeline(builder, m_config);
+	VulkanTerrain::ConfigureTraversalPipeline(builder);
+
+	VulkanPipelineBuilder::Result result = builder.Build();
+
+	m_lod_pipeline = result.graphics_pipelines.empty() ? nullptr : result.graphics_pipelines.back();
+	m_traversal_pipeline = result.compute_pipelines.empty() ? nullptr : result.compute_pipelines.back();
+	if (!m_lod_pipeline || m_lod_pipeline == m_pipeline || m_lod_pipeline->handle == VK_NULL_HANDLE ||
+		!m_traversal_pipeline || m_traversal_pipeline->handle == VK_NULL_HANDLE || m_traversal_pipeline->ds_layouts.empty())
+	{
+		AURION_WARN("[Vulkan Terrain] Failed to build the quadtree traversal pipelines. Drawing every patch.");
+		return false;
+	}
+
+	m_leaf_level = 0;
+	while ((1u << m_leaf_level) < m_patches_per_side)
+		m_leaf_level++;
+
+	this->BuildNodeBounds();
+
+	return true;
+}
+
+bool VulkanTerrain::InitializeDetail()
+{
+	// Pages are block compressed where the device samples BC1, an eighth of the cache's RGBA8 size
+	VkFormatProperties format_properties{};
+	vkGetPhysicalDeviceFormatProperties(m_logical_device->physical_device, VK_FORMAT_BC1_RGB_UNORM_BLOCK, &format_properties);
+
+	const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+
+	VulkanVirtualTextureConfig detail_config{};
+	detail_config.format = (format_properties.optimalTilingFeatures & required) == required ? VK_FORMAT_BC1_RGB_UNORM_BLOCK : VK_FORMAT_R8G8B8A8_UNORM;
+
+	if (!m_detail.Initialize(m_logical_device, detail_config))
+		return false;
+
+	// Producers run on workers, so they get their own copy of the configuration
+	const VulkanTerrainConfig config = m_config;
+	const uint32_t page_border = detail_config.page_border;
+
+	VulkanVirtualTextureRegionInfo region_info{};
+	region_info.pages_per_side = m_config.detail_pages_per_side;
+	region_info.producer = [config, page_border](const VulkanVirtualPage& page, uint8_t* texels, const uint32_t& page_size) {
+		ProduceDetailPage(config, page_border, page, texels, page_size);
+	};
+
+	m_detail_region = m_detail.AddRegion(region_info);
+	if (m_detail_region == VulkanVirtualTexture::c_max_regions)
+		return false;
+
+	// A set per feedback buffer. Every graphics pipeline declares the same set 1 layout, so any of them can allocate it.
+	const uint32_t set_count = m_detail.GetConfig().frames_in_flight;
+
+	VkDescriptorPoolSize pool_sizes[2] = {
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 * set_count },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, set_count }
+	};
+
+	VkDescriptorPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	pool_info.maxSets = set_count;
+	pool_info.poolSizeCount = 2;
+	pool_info.pPoolSizes = pool_sizes;
+
+	if (vkCreateDescriptorPool(m_logical_device->handle, &pool_info, nullptr, &m_detail_pool) != VK_SUCCESS)
+		return false;
+
+	std::vector<VkDescriptorSetLayout> layouts(set_count, m_pipeline->ds_layouts[1]);
+	m_detail_sets.resize(set_count);
+
+	VkDescriptorSetAllocateInfo set_info{};
+	set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	set_info.descriptorPool = m_detail_pool;
+	set_info.descriptorSetCount = set_count;
+	set_info.pSetLayouts = layouts.data();
+
+	if (vkAllocateDescriptorSets(m_logical_device->handle, &set_info, m_detail_sets.data()) != VK_SUCCESS)
+	{
+		m_detail_sets.clear();
+		return false;
+	}
+
+	m_detail_feedback.assign(set_count, VK_NULL_HANDLE);
+
+	AURION_INFO("[Vulkan Terrain] Ground detail streams %d pages per side, cached as %s.", m_config.detail_pages_per_side,
+		detail_config.format == VK_FORMAT_BC1_RGB_UNORM_BLOCK ? "BC1" : "RGBA8");
+
+	return true;
+}
+
+void VulkanTerrain::BuildMeshlets()
+{
+	m_meshlets.clear();
+
+	// Every level covers the whole heightmap, finest first, as the task shader indexes them
+	const uint32_t patch_meshlets = m_config.patch_texels / c_meshlet_quads;
+	const float texel_spacing = m_config.world_size / static_cast<float>(m_config.heightmap_size - 1);
+	for (uint32_t stride = 1; stride <= patch_meshlets; stride <<= 1)
+	{
+		std::vector<TerrainMeshlet> level = m_heightmap.ComputeMeshlets(c_meshlet_quads, stride, texel_spacing, m_config.height_scale);
+		m_meshlets.insert(m_meshlets.end(), level.begin(), level.end());
+	}
+}
+
+void VulkanTerrain::BuildNodeBounds()
+{
+	m_node_bounds.assign(NodeLevelOffset(m_leaf_level + 1), TerrainPatchBounds{});
+
+	// Leaves are the patches, in the same order
+	std::copy(m_patch_bounds.begin(), m_patch_bounds.end(), m_node_bounds.begin() + NodeLevelOffset(m_leaf_level));
+
+	for (uint32_t level = m_leaf_level; level-- > 0;)
+	{
+		for (uint32_t y = 0; y < (1u << level); y++)
+			for (uint32_t x = 0; x < (1u << level); x++)
+				MergeChildBounds(m_node_bounds, level, x, y);
+	}
+}
+
+bool VulkanTerrain::CreateBuffer(const VkDeviceSize& size, const VkBufferUsageFlags& usage, VkBuffer& buffer, VmaAllocation& allocation, const bool& shared)
+{
+	VkBufferCreateInfo buffer_info{};
+	buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_info.size = size;
+	buffer_info.usage = usage;
+	buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	// Shared buffers are used on the compute and graphics queues
+	if (shared && m_logical_device->queue_families.size() > 1)
+	{
+		buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+		buffer_info.queueFamilyIndexCount = static_cast<uint32_t>(m_logical_device->queue_families.size());
+		buffer_info.pQueueFamilyIndices = m_logical_device->queue_families.data();
+	}
+
+	VmaAllocationCreateInfo alloc_info{};
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+	return vmaCreateBuffer(m_logical_device->allocator, &buffer_info, &alloc_info, &buffer, &allocation, nullptr) == VK_SUCCESS;
+}
+
+VulkanTerrainStaging* VulkanTerrain::CreateStaging(const VkDeviceSize& size, uint8_t*& mapped)
+{
+	VkBufferCreateInfo buffer_info{};
+	buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_info.size = size;
+	buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	// Quadtree node bounds are copied on the compute queue
+	if (m_lod_pipeline && m_logical_device->queue_families.size() > 1)
+	{
+		buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+		buffer_info.queueFamilyIndexCount = static_cast<uint32_t>(m_logical_device->queue_families.size());
+		buffer_info.pQueueFamilyIndices = m_logical_device->queue_families.data();
+	}
+
+	VmaAllocationCreateInfo alloc_info{};
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+	alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VulkanTerrainStaging staging{};
+	VmaAllocationInfo allocation_info{};
+	if (vmaCreateBuffer(m_logical_device->allocator, &buffer_info, &alloc_info, &staging.buffer, &staging.allocation, &allocation_info) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Terrain] Failed to create a %llu byte staging buffer!", static_cast<unsigned long long>(size));
+		return nullptr;
+	}
+
+	mapped = static_cast<uint8_t*>(allocation_info.pMappedData);
+	m_staging.push_back(staging);
+
+	return &m_staging.back();
+}
+
+bool VulkanTerrain::RecordUploads(const VulkanCommand& command)
+{
+	const VkCommandBuffer& cmd_buffer = command.graphics_buffer;
+
+	// Heights written before the first upload go up with it, once what's derived from them is current
+	if (!m_dirty_patches.empty())
+	{
+		for (const uint32_t& patch : m_dirty_patches)
+			m_patch_bounds[patch] = m_heightmap.ComputePatchBounds(m_config.patch_texels, patch % m_patches_per_side, patch / m_patches_per_side);
+
+		if (m_lod_pipeline)
+			this->BuildNodeBounds();
+
+		if (m_mesh_pipeline)
+			this->BuildMeshlets();
+	}
+
+	const VkDeviceSize height_bytes = m_heightmap.GetHeights().size() * sizeof(float);
+	const VkDeviceSize bounds_bytes = m_patch_bounds.size() * sizeof(TerrainPatchBounds);
+	const VkDeviceSize meshlet_bytes = m_meshlets.size() * sizeof(TerrainMeshlet);
+	const VkDeviceSize node_bytes = m_node_bounds.size() * sizeof(TerrainPatchBounds);
+
+	// Heights, patch bounds, meshlets and quadtree nodes, in that order
+	uint8_t* mapped = nullptr;
+	VulkanTerrainStaging* staging = this->CreateStaging(height_bytes + bounds_bytes + meshlet_bytes + node_bytes, mapped);
+	if (!staging)
+		return false;
+
+	std::memcpy(mapped, m_heightmap.GetHeights().data(), height_bytes);
+	std::memcpy(mapped + height_bytes, m_patch_bounds.data(), bounds_bytes);
+	if (meshlet_bytes > 0)
+		std::memcpy(mapped + height_bytes + bounds_bytes, m_meshlets.data(), meshlet_bytes);
+	if (node_bytes > 0)
+		std::memcpy(mapped + height_bytes + bounds_bytes + meshlet_bytes, m_node_bounds.data(), node_bytes);
+	vmaFlushAllocation(m_logical_device->allocator, staging->allocation, 0, VK_WHOLE_SIZE);
+
+	VulkanImage::TransitionLayout(cmd_buffer, m_heightmap_image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+	VkBufferImageCopy image_copy{};
+	image_copy.bufferOffset = 0;
+	image_copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_copy.imageSubresource.mipLevel = 0;
+	image_copy.imageSubresource.baseArrayLayer = 0;
+	image_copy.imageSubresource.layerCount = 1;
+	image_copy.imageExtent = m_heightmap_image.extent;
+
+	vkCmdCopyBufferToImage(cmd_buffer, staging->buffer, m_heightmap_image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &image_copy);
+
+	VkBufferCopy buffer_copy{};
+	buffer_copy.srcOffset = height_bytes;
+	buffer_copy.dstOffset = 0;
+	buffer_copy.size = bounds_bytes;
+
+	vkCmdCopyBuffer(cmd_buffer, staging->buffer, m_patch_buffer, 1, &buffer_copy);
+
+	if (m_mesh_pipeline)
+	{
+		buffer_copy.srcOffset = height_bytes + bounds_bytes;
+		buffer_copy.size = meshlet_bytes;
+
+		vkCmdCopyBuffer(cmd_buffer, staging->buffer, m_meshlet_buffer, 1, &buffer_copy);
+	}
+
+	// Only the active path's stages read the data
+	const VkPipelineStageFlags2 sampling_stages = m_mesh_pipeline ? c_mesh_pipeline_stages : c_terrain_pipeline_stages;
+	const VkPipelineStageFlags2 buffer_stages = m_mesh_pipeline ? VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT : VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT;
+
+	this->FinishHeightmapUpload(cmd_buffer, sampling_stages);
+
+	BufferBarrier(cmd_buffer, m_patch_buffer, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, buffer_stages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+	if (m_mesh_pipeline)
+		BufferBarrier(cmd_buffer, m_meshlet_buffer, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, buffer_stages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+	// Node bounds go in with the frame's compute work, ahead of the traversal
+	if (m_lod_pipeline)
+	{
+		buffer_copy.srcOffset = height_bytes + bounds_bytes + meshlet_bytes;
+		buffer_copy.size = node_bytes;
+
+		vkCmdCopyBuffer(command.compute_buffer, staging->buffer, m_node_buffer, 1, &buffer_copy);
+
+		BufferBarrier(command.compute_buffer, m_node_buffer, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+		command.compute_recorded = true;
+		command.compute_consumer_stages |= c_lod_consumer_stages;
+	}
+
+	for (const uint32_t& patch : m_dirty_patches)
+		m_patch_dirty[patch] = 0;
+	m_dirty_patches.clear();
+
+	m_uploaded = true;
+
+	return true;
+}
+
+void VulkanTerrain::RecordTileUploads(const VulkanCommand& command)
+{
+	const VkCommandBuffer& cmd_buffer = command.graphics_buffer;
+
+	// Each patch copies the texels it starts, so regions never overlap. Patches along the far edges also take the
+	//	last column or row, which no patch starts. Shared edges are always covered, since changing one dirties the
+	//	patches on both sides.
+	std::vector<VkExtent3D> tile_extents(m_dirty_patches.size());
+	std::vector<VkDeviceSize> tile_offsets(m_dirty_patches.size());
+	VkDeviceSize height_bytes = 0;
+	for (size_t i = 0; i < m_dirty_patches.size(); i++)
+	{
+		const bool last_column = m_dirty_patches[i] % m_patches_per_side == m_patches_per_side - 1;
+		const bool last_row = m_dirty_patches[i] / m_patches_per_side == m_patches_per_side - 1;
+
+		tile_extents[i] = VkExtent3D{ m_config.patch_texels + (last_column ? 1 : 0), m_config.patch_texels + (last_row ? 1 : 0), 1 };
+		tile_offsets[i] = height_bytes;
+		height_bytes += static_cast<VkDeviceSize>(tile_extents[i].width) * tile_extents[i].height * sizeof(float);
+	}
+
+	for (const uint32_t& patch : m_dirty_patches)
+		m_patch_bounds[patch] = m_heightmap.ComputePatchBounds(m_config.patch_texels, patch % m_patches_per_side, patch / m_patches_per_side);
+
+	// Changed leaves, then every ancestor above them, coarser levels last
+	std::vector<size_t> changed_nodes;
+	if (m_lod_pipeline)
+	{
+		std::vector<uint32_t> cells(m_dirty_patches.begin(), m_dirty_patches.end());
+		for (uint32_t level = m_leaf_level;; level--)
+		{
+			const uint32_t side = 1u << level;
+			for (const uint32_t& cell : cells)
+			{
+				if (level == m_leaf_level)
+					m_node_bounds[NodeLevelOffset(level) + cell] = m_patch_bounds[cell];
+				else
+					MergeChildBounds(m_node_bounds, level, cell % side, cell / side);
+
+				changed_nodes.push_back(NodeLevelOffset(level) + cell);
+			}
+
+			if (level == 0)
+				break;
+
+			// Parents, each once
+			for (uint32_t& cell : cells)
+				cell = (cell / side / 2) * (side / 2) + (cell % side) / 2;
+			std::sort(cells.begin(), cells.end());
+			cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+		}
+	}
+
+	if (m_mesh_pipeline)
+		this->BuildMeshlets();
+
+	const VkDeviceSize bounds_bytes = m_dirty_patches.size() * sizeof(TerrainPatchBounds);
+	const VkDeviceSize meshlet_bytes = m_mesh_pipeline ? m_meshlets.size() * sizeof(TerrainMeshlet) : 0;
+	const VkDeviceSize node_bytes = changed_nodes.size() * sizeof(TerrainPatchBounds);
+
+	// Dirty tiles' heights and bounds, meshlets and changed nodes, in that order
+	uint8_t* mapped = nullptr;
+	VulkanTerrainStaging* staging = this->CreateStaging(height_bytes + bounds_bytes + meshlet_bytes + node_bytes, mapped);
+	if (!staging)
+		return; // Stays dirty, and is retried with the next frame
+
+	std::vector<VkBufferImageCopy> image_copies(m_dirty_patches.size());
+	std::vector<VkBufferCopy> bounds_copies(m_dirty_patches.size());
+
+	const float* heights = m_heightmap.GetHeights().data();
+	for (size_t i = 0; i < m_dirty_patches.size(); i++)
+	{
+		const uint32_t origin_x = (m_dirty_patches[i] % m_patches_per_side) * m_config.patch_texels;
+		const uint32_t origin_y = (m_dirty_patches[i] / m_patches_per_side) * m_config.patch_texels;
+
+		const VkExtent3D& extent = tile_extents[i];
+		float* tile = reinterpret_cast<float*>(mapped + tile_offsets[i]);
+		for (uint32_t row = 0; row < extent.height; row++)
+			std::memcpy(tile + static_cast<size_t>(row) * extent.width, heights + static_cast<size_t>(origin_y + row) * m_config.heightmap_size + origin_x, extent.width * sizeof(float));
+
+		std::memcpy(mapped + height_bytes + i * sizeof(TerrainPatchBounds), &m_patch_bounds[m_dirty_patches[i]], sizeof(TerrainPatchBounds));
+
+		VkBufferImageCopy& image_copy = image_copies[i];
+		image_copy.bufferOffset = tile_offsets[i];
+		image_copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		image_copy.imageSubresource.layerCount = 1;
+		image_copy.imageOffset = VkOffset3D{ static_cast<int32_t>(origin_x), static_cast<int32_t>(origin_y), 0 };
+		image_copy.imageExtent = extent;
+
+		bounds_copies[i] = VkBufferCopy{ height_bytes + i * sizeof(TerrainPatchBounds), m_dirty_patches[i] * sizeof(TerrainPatchBounds), sizeof(TerrainPatchBounds) };
+	}
+
+	if (meshlet_bytes > 0)
+		std::memcpy(mapped + height_bytes + bounds_bytes, m_meshlets.data(), meshlet_bytes);
+
+	std::vector<VkBufferCopy> node_copies(changed_nodes.size());
+	for (size_t i = 0; i < changed_nodes.size(); i++)
+	{
+		const VkDeviceSize offset = height_bytes + bounds_bytes + meshlet_bytes + i * sizeof(TerrainPatchBounds);
+		std::memcpy(mapped + offset, &m_node_bounds[changed_nodes[i]], sizeof(TerrainPatchBounds));
+		node_copies[i] = VkBufferCopy{ offset, changed_nodes[i] * sizeof(TerrainPatchBounds), sizeof(TerrainPatchBounds) };
+	}
+
+	vmaFlushAllocation(m_logical_device->allocator, staging->allocation, 0, VK_WHOLE_SIZE);
+
+	const VkPipelineStageFlags2 sampling_stages = m_mesh_pipeline ? c_mesh_pipeline_stages : c_terrain_pipeline_stages;
+	const VkPipelineStageFlags2 buffer_stages = m_mesh_pipeline ? VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT : VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT;
+
+	// Earlier frames' draws may still be reading what these copies replace
+	VulkanImage::TransitionLayout(cmd_buffer, m_heightmap_image.image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		sampling_stages, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+	vkCmdCopyBufferToImage(cmd_buffer, staging->buffer, m_heightmap_image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		static_cast<uint32_t>(image_copies.size()), image_copies.data());
+
+	this->FinishHeightmapUpload(cmd_buffer, sampling_stages);
+
+	BufferBarrier(cmd_buffer, m_patch_buffer, buffer_stages, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+	vkCmdCopyBuffer(cmd_buffer, staging->buffer, m_patch_buffer, static_cast<uint32_t>(bounds_copies.size()), bounds_copies.data());
+	BufferBarrier(cmd_buffer, m_patch_buffer, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, buffer_stages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+	if (meshlet_bytes > 0)
+	{
+		VkBufferCopy meshlet_copy{ height_bytes + bounds_bytes, 0, meshlet_bytes };
+
+		BufferBarrier(cmd_buffer, m_meshlet_buffer, buffer_stages, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+		vkCmdCopyBuffer(cmd_buffer, staging->buffer, m_meshlet_buffer, 1, &meshlet_copy);
+		BufferBarrier(cmd_buffer, m_meshlet_buffer, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, buffer_stages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+	}
+
+	// The traversal reads node bounds on the compute queue, so they're copied there
+	if (!node_copies.empty())
+	{
+		BufferBarrier(command.compute_buffer, m_node_buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_NONE,
+			VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+		vkCmdCopyBuffer(command.compute_buffer, staging->buffer, m_node_buffer, static_cast<uint32_t>(node_copies.size()), node_copies.data());
+		BufferBarrier(command.compute_buffer, m_node_buffer, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+		command.compute_recorded = true;
+		command.compute_consumer_stages |= c_lod_consumer_stages;
+	}
+
+	for (const uint32_t& patch : m_dirty_patches)
+		m_patch_dirty[patch] = 0;
+	m_dirty_patches.clear();
+}
+
+void VulkanTerrain::FinishHeightmapUpload(const VkCommandBuffer& cmd_buffer, const VkPipelineStageFlags2& sampling_stages)
+{
+	if (m_heightmap_image.mip_levels == 1)
+	{
+		VulkanImage::TransitionLayout(cmd_buffer, m_heightmap_image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, sampling_stages, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+		return;
+	}
+
+	// Every coarser level is rebuilt from level 0, even after a tile upload. The whole chain is a few blits,
+	//	cheaper than tracking changed regions per level. All levels end ready to sample.
+	VulkanImage::GenerateMips(cmd_buffer, m_heightmap_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+void VulkanTerrain::RecordCulling(const VkCommandBuffer& cmd_buffer, const float* view_projection)
+{
+	VulkanTerrainCulling culling{};
+
+	// A fresh target holds no pyramid yet. Render extent changes are fine, since the previous extent travels with it.
+	const bool hiz_valid = m_hiz_pipeline && m_hiz_valid;
+	std::memcpy(culling.previous_view_projection, hiz_valid ? m_previous_view_projection : view_projection, sizeof(culling.previous_view_projection));
+	culling.hiz[0] = static_cast<float>(m_previous_extent.width);
+	culling.hiz[1] = static_cast<float>(m_previous_extent.height);
+	culling.hiz[2] = static_cast<float>(m_target.hiz.mip_levels);
+	culling.hiz[3] = hiz_valid ? 1.0f : 0.0f;
+
+	// The previous frame's task shaders may still read the last values
+	BufferBarrier(cmd_buffer, m_culling_buffer, VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT, VK_ACCESS_2_UNIFORM_READ_BIT,
+		VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+	vkCmdUpdateBuffer(cmd_buffer, m_culling_buffer, 0, sizeof(VulkanTerrainCulling), &culling);
+
+	BufferBarrier(cmd_buffer, m_culling_buffer, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT, VK_ACCESS_2_UNIFORM_READ_BIT);
+}
+
+void VulkanTerrain::RecordTraversal(const VulkanCommand& command, const VulkanTerrainLodFrame& frame, const VulkanTerrainConstants& constants)
+{
+	const VkCommandBuffer& cmd_buffer = command.compute_buffer;
+
+	VulkanTerrainLodConstants lod{};
+	std::memcpy(lod.view_projection, constants.view_projection, sizeof(lod.view_projection));
+	lod.camera[0] = constants.camera[0];
+	lod.camera[1] = constants.camera[1];
+	lod.camera[2] = constants.camera[2];
+
+	// Ranges keep a node's grid cells near the target edge length wherever it's drawn. Below twice a node's
+	//	size, nodes two levels apart could meet.
+	lod.camera[3] = std::max(constants.camera[3] * constants.viewport[1] / (constants.viewport[3] * constants.viewport[2]), 2.0f);
+
+	lod.terrain[0] = m_config.world_size;
+	lod.terrain[1] = m_config.height_scale;
+	lod.terrain[2] = static_cast<float>(m_leaf_level);
+	lod.terrain[3] = std::clamp(m_config.lod_morph_start, 0.0f, 0.95f);
+	lod.traversal[1] = m_patches_per_side * m_patches_per_side;
+
+	// Last frame's traversal may still be running on the queue
+	GlobalBarrier(cmd_buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+	// The root is the only node queued. Every other level starts empty, as does the draw.
+	std::vector<uint32_t> counters((m_leaf_level + 2) * 4, 0);
+	for (size_t level = 0; level < m_leaf_level + 2; level++)
+	{
+		counters[level * 4 + 1] = 1;
+		counters[level * 4 + 2] = 1;
+	}
+	counters[0] = 1;
+	counters[3] = 1;
+
+	const uint32_t root_node = 0;
+	const VkDrawIndirectCommand draw{ c_patch_control_points, 0, 0, 0 };
+
+	vkCmdUpdateBuffer(cmd_buffer, frame.counter_buffer, 0, counters.size() * sizeof(uint32_t), counters.data());
+	vkCmdUpdateBuffer(cmd_buffer, frame.queue_buffer, 0, sizeof(root_node), &root_node);
+	vkCmdUpdateBuffer(cmd_buffer, frame.draw_buffer, 0, sizeof(draw), &draw);
+
+	GlobalBarrier(cmd_buffer, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+		VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+
+	vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_traversal_pipeline->handle);
+	vkCmdBindDescriptorSets(cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_traversal_pipeline->layout, 0, 1, &frame.traversal_set, 0, nullptr);
+
+	// Each level is dispatched with as many workgroups as the level before queued nodes for
+	for (uint32_t level = 0; level <= m_leaf_level; level++)
+	{
+		lod.traversal[0] = level;
+		vkCmdPushConstants(cmd_buffer, m_traversal_pipeline->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VulkanTerrainLodConstants), &lod);
+		vkCmdDispatchIndirect(cmd_buffer, frame.counter_buffer, level * 4 * sizeof(uint32_t));
+
+		GlobalBarrier(cmd_buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+			VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+	}
+
+	command.compute_recorded = true;
+	command.compute_consumer_stages |= c_lod_consumer_stages;
+}
+
+void VulkanTerrain::RecordHiZ(const VkCommandBuffer& cmd_buffer, const VulkanImage& depth, const VkDescriptorSet& depth_set, const VkExtent2D& extent)
+{
+	// Depth becomes readable, and every level is rebuilt, so the pyramid's old contents are discarded once this
+	//	frame's task shaders are done with them. Depth isn't used after this, so the graph never sees it leave the attachment layout.
+	VulkanImage::TransitionLayout(cmd_buffer, depth.image, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL,
+		c_depth_stages, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+		VK_IMAGE_ASPECT_DEPTH_BIT);
+
+	VulkanImage::TransitionLayout(cmd_buffer, m_target.hiz.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+		VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+	vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_hiz_pipeline->handle);
+
+	int32_t sizes[4] = { static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), 0, 0 };
+	for (uint32_t level = 0; level < m_target.hiz.mip_levels; level++)
+	{
+		// Each level halves the one before, rounding up
+		sizes[2] = (sizes[0] + 1) / 2;
+		sizes[3] = (sizes[1] + 1) / 2;
+
+		const VkDescriptorSet& reduce_set = level == 0 ? depth_set : m_target.reduce_sets[level - 1];
+		vkCmdBindDescriptorSets(cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_hiz_pipeline->layout, 0, 1, &reduce_set, 0, nullptr);
+		vkCmdPushConstants(cmd_buffer, m_hiz_pipeline->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(sizes), sizes);
+		vkCmdDispatch(cmd_buffer, (sizes[2] + c_hiz_group_size - 1) / c_hiz_group_size, (sizes[3] + c_hiz_group_size - 1) / c_hiz_group_size, 1);
+
+		// The next level reads this one. After the last, next frame's task shaders do.
+		VkMemoryBarrier2 barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+		barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+		barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+		barrier.dstStageMask = level + 1 < m_target.hiz.mip_levels ? VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT;
+		barrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+
+		VkDependencyInfo dep_info{};
+		dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		dep_info.memoryBarrierCount = 1;
+		dep_info.pMemoryBarriers = &barrier;
+
+		vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+
+		sizes[0] = sizes[2];
+		sizes[1] = sizes[3];
+	}
+}
+
+bool VulkanTerrain::PrepareTarget(const VkExtent3D& extent)
+{
+	// Only mesh shading samples a pyramid
+	if (!m_mesh_pipeline)
+		return true;
+
+	if (m_target.descriptor_pool != VK_NULL_HANDLE && m_target.extent.width >= extent.width && m_target.extent.height >= extent.height)
+		return true;
+
+	// Every frame that could use the current target has reserved its value by now
+	if (m_target.descriptor_pool != VK_NULL_HANDLE)
+	{
+		m_target.graphics_timeline_value = m_logical_device->graphics_timeline.value;
+		m_retired_targets.emplace_back(m_target);
+	}
+
+	const VkExtent3D previous_extent = m_target.extent;
+	m_target = {};
+	m_target.extent = VkExtent3D{
+		.width = std::max(extent.width, previous_extent.width),
+		.height = std::max(extent.height, previous_extent.height),
+		.depth = 1
+	};
+	m_hiz_valid = false;
+
+	if (!this->CreateHiZ(m_target))
+	{
+		this->DestroyTarget(m_target);
+		return false;
+	}
+
+	return true;
+}
+
+bool VulkanTerrain::CreateHiZ(VulkanTerrainTarget& target)
+{
+	const VkDevice& device = m_logical_device->handle;
+
+	if (m_hiz_pipeline)
+	{
+		VulkanImageCreateInfo create_info{};
+		create_info.format = VK_FORMAT_R32_SFLOAT;
+		create_info.extent = VkExtent3D{ (target.extent.width + 1) / 2, (target.extent.height + 1) / 2, 1 };
+		create_info.usage_flags = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+		create_info.aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+		create_info.mip_levels = VulkanImage::c_full_mip_chain;
+
+		target.hiz = VulkanImage::Create(device, m_logical_device->allocator, create_info);
+		if (target.hiz.image == VK_NULL_HANDLE)
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to create a %dx%d Hi-Z pyramid!", create_info.extent.width, create_info.extent.height);
+			return false;
+		}
+
+		for (uint32_t level = 0; level < target.hiz.mip_levels; level++)
+		{
+			VkImageViewCreateInfo view_info{};
+			view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			view_info.image = target.hiz.image;
+			view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			view_info.format = VK_FORMAT_R32_SFLOAT;
+			view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			view_info.subresourceRange.baseMipLevel = level;
+			view_info.subresourceRange.levelCount = 1;
+			view_info.subresourceRange.baseArrayLayer = 0;
+			view_info.subresourceRange.layerCount = 1;
+
+			VkImageView view = VK_NULL_HANDLE;
+			if (vkCreateImageView(device, &view_info, nullptr, &view) != VK_SUCCESS)
+			{
+				AURION_ERROR("[Vulkan Terrain] Failed to create a view of Hi-Z level %d!", level);
+				return false;
+			}
+
+			target.hiz_views.push_back(view);
+		}
+	}
+
+	const uint32_t levels = static_cast<uint32_t>(target.hiz_views.size());
+
+	// Level 0 reads each frame's own depth image, so its sets are made per frame. One reduction set for each
+	//	level after it, and the mesh pipeline's set.
+	const uint32_t reduce_levels = levels > 0 ? levels - 1 : 0;
+	{
+		VkDescriptorPoolSize pool_sizes[4] = {
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, reduce_levels + 2 },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, std::max(reduce_levels, 1u) },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 },
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 }
+		};
+
+		VkDescriptorPoolCreateInfo pool_info{};
+		pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		pool_info.maxSets = reduce_levels + 1;
+		pool_info.poolSizeCount = 4;
+		pool_info.pPoolSizes = pool_sizes;
+
+		if (vkCreateDescriptorPool(device, &pool_info, nullptr, &target.descriptor_pool) != VK_SUCCESS)
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to create the render target's descriptor pool!");
+			return false;
+		}
+
+		std::vector<VkDescriptorSetLayout> layouts(reduce_levels, m_hiz_pipeline ? m_hiz_pipeline->ds_layouts[0] : VK_NULL_HANDLE);
+		layouts.push_back(m_mesh_pipeline->ds_layouts[0]);
+
+		std::vector<VkDescriptorSet> sets(layouts.size());
+
+		VkDescriptorSetAllocateInfo set_info{};
+		set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		set_info.descriptorPool = target.descriptor_pool;
+		set_info.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+		set_info.pSetLayouts = layouts.data();
+
+		if (vkAllocateDescriptorSets(device, &set_info, sets.data()) != VK_SUCCESS)
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to allocate the render target's descriptor sets!");
+			return false;
+		}
+
+		target.mesh_set = sets.back();
+		sets.pop_back();
+		target.reduce_sets = std::move(sets);
+	}
+
+	// Each level reads the one before
+	for (uint32_t level = 1; level < levels; level++)
+	{
+		VkDescriptorImageInfo source_info{};
+		source_info.sampler = target.hiz.sampler;
+		source_info.imageView = target.hiz_views[level - 1];
+		source_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+		VkDescriptorImageInfo destination_info{};
+		destination_info.imageView = target.hiz_views[level];
+		destination_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+		VkWriteDescriptorSet writes[2]{};
+		writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[0].dstSet = target.reduce_sets[level - 1];
+		writes[0].dstBinding = 0;
+		writes[0].descriptorCount = 1;
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[0].pImageInfo = &source_info;
+
+		writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[1].dstSet = target.reduce_sets[level - 1];
+		writes[1].dstBinding = 1;
+		writes[1].descriptorCount = 1;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		writes[1].pImageInfo = &destination_info;
+
+		vkUpdateDescriptorSets(device, 2, writes, 0, nullptr);
+	}
+
+	// Mesh shading. Without occlusion culling the heightmap stands in for the pyramid, which is never read.
+	{
+		VkDescriptorImageInfo heightmap_info{};
+		heightmap_info.sampler = m_heightmap_image.sampler;
+		heightmap_info.imageView = m_heightmap_image.view;
+		heightmap_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkDescriptorImageInfo hiz_info = heightmap_info;
+		if (m_hiz_pipeline)
+		{
+			hiz_info.sampler = target.hiz.sampler;
+			hiz_info.imageView = target.hiz.view;
+			hiz_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+		}
+
+		VkDescriptorBufferInfo buffer_infos[3]{};
+		buffer_infos[0] = { m_patch_buffer, 0, VK_WHOLE_SIZE };
+		buffer_infos[1] = { m_meshlet_buffer, 0, VK_WHOLE_SIZE };
+		buffer_infos[2] = { m_culling_buffer, 0, VK_WHOLE_SIZE };
+
+		VkWriteDescriptorSet writes[5]{};
+		for (uint32_t binding = 0; binding < 5; binding++)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = target.mesh_set;
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+		}
+
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[0].pImageInfo = &heightmap_info;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[1].pBufferInfo = &buffer_infos[0];
+		writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[2].pBufferInfo = &buffer_infos[1];
+		writes[3].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[3].pImageInfo = &hiz_info;
+		writes[4].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		writes[4].pBufferInfo = &buffer_infos[2];
+
+		vkUpdateDescriptorSets(device, 5, writes, 0, nullptr);
+	}
+
+	return true;
+}
+
+VkDescriptorSet VulkanTerrain::PrepareDepthFrame(const size_t& frame_index, const VulkanImage& depth)
+{
+	const VkDevice& device = m_logical_device->handle;
+
+	// The frame's previous work has completed, so its set can be rewritten
+	if (frame_index >= m_depth_frames.size())
+		m_depth_frames.resize(frame_index + 1);
+
+	VulkanTerrainDepthFrame& frame = m_depth_frames[frame_index];
+	if (frame.descriptor_pool == VK_NULL_HANDLE)
+	{
+		VkDescriptorPoolSize pool_sizes[2] = {
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 }
+		};
+
+		VkDescriptorPoolCreateInfo pool_info{};
+		pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		pool_info.maxSets = 1;
+		pool_info.poolSizeCount = 2;
+		pool_info.pPoolSizes = pool_sizes;
+
+		if (vkCreateDescriptorPool(device, &pool_info, nullptr, &frame.descriptor_pool) != VK_SUCCESS)
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to create a depth reduction descriptor pool!");
+			return VK_NULL_HANDLE;
+		}
+
+		VkDescriptorSetAllocateInfo set_info{};
+		set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		set_info.descriptorPool = frame.descriptor_pool;
+		set_info.descriptorSetCount = 1;
+		set_info.pSetLayouts = &m_hiz_pipeline->ds_layouts[0];
+
+		if (vkAllocateDescriptorSets(device, &set_info, &frame.reduce_set) != VK_SUCCESS)
+		{
+			AURION_ERROR("[Vulkan Terrain] Failed to allocate a depth reduction descriptor set!");
+			vkDestroyDescriptorPool(device, frame.descriptor_pool, nullptr);
+			frame = {};
+			return VK_NULL_HANDLE;
+		}
+	}
+
+	// The graph hands each frame the same depth image until its size changes, so this rarely writes
+	if (frame.depth_view == depth.view && frame.hiz_view == m_target.hiz_views[0])
+		return frame.reduce_set;
+
+	VkDescriptorImageInfo source_info{};
+	source_info.sampler = m_target.hiz.sampler;
+	source_info.imageView = depth.view;
+	source_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL;
+
+	VkDescriptorImageInfo destination_info{};
+	destination_info.imageView = m_target.hiz_views[0];
+	destination_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+	VkWriteDescriptorSet writes[2]{};
+	writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writes[0].dstSet = frame.reduce_set;
+	writes[0].dstBinding = 0;
+	writes[0].descriptorCount = 1;
+	writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	writes[0].pImageInfo = &source_info;
+
+	writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writes[1].dstSet = frame.reduce_set;
+	writes[1].dstBinding = 1;
+	writes[1].descriptorCount = 1;
+	writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	writes[1].pImageInfo = &destination_info;
+
+	vkUpdateDescriptorSets(device, 2, writes, 0, nullptr);
+
+	frame.depth_view = depth.view;
+	frame.hiz_view = m_target.hiz_views[0];
+
+	return frame.reduce_set;
+}
+
+VulkanTerrainLodFrame* VulkanTerrain::PrepareLodFrame(const size_t& frame_index)
+{
+	// Each frame in flight traverses into its own buffers, so the next frame never overwrites a draw list in use
+	if (frame_index >= m_lod_frames.size())
+		m_lod_frames.resize(frame_index + 1);
+
+	VulkanTerrainLodFrame& frame = m_lod_frames[frame_index];
+	if (frame.draw_set == VK_NULL_HANDLE && !this->CreateLodFrame(frame))
+	{
+		this->DestroyLodFrame(frame);
+		return nullptr;
+	}
+
+	return &frame;
+}
+
+bool VulkanTerrain::CreateLodFrame(VulkanTerrainLodFrame& frame)
+{
+	const VkDevice& device = m_logical_device->handle;
+
+	// Neither the queue of a level nor the selection can hold more nodes than there are leaves
+	const VkDeviceSize capacity = static_cast<VkDeviceSize>(m_patches_per_side) * m_patches_per_side;
+
+	if (!this->CreateBuffer(2 * capacity * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			frame.queue_buffer, frame.queue_allocation) ||
+		!this->CreateBuffer((m_leaf_level + 2) * 4 * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			frame.counter_buffer, frame.counter_allocation) ||
+		!this->CreateBuffer(capacity * 2 * 4 * sizeof(float), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			frame.selected_buffer, frame.selected_allocation, true) ||
+		!this->CreateBuffer(sizeof(VkDrawIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			frame.draw_buffer, frame.draw_allocation, true))
+	{
+		AURION_ERROR("[Vulkan Terrain] Failed to create the quadtree traversal buffers!");
+		return false;
+	}
+
+	VkDescriptorPoolSize pool_sizes[2] = {
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 7 },
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 }
+	};
+
+	VkDescriptorPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	pool_info.maxSets = 2;
+	pool_info.poolSizeCount = 2;
+	pool_info.pPoolSizes = pool_sizes;
+
+	if (vkCreateDescriptorPool(device, &pool_info, nullptr, &frame.descriptor_pool) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Terrain] Failed to create the quadtree traversal descriptor pool!");
+		return false;
+	}
+
+	const VkDescriptorSetLayout layouts[2] = { m_traversal_pipeline->ds_layouts[0], m_lod_pipeline->ds_layouts[0] };
+	VkDescriptorSet sets[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+
+	VkDescriptorSetAllocateInfo set_info{};
+	set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	set_info.descriptorPool = frame.descriptor_pool;
+	set_info.descriptorSetCount = 2;
+	set_info.pSetLayouts = layouts;
+
+	if (vkAllocateDescriptorSets(device, &set_info, sets) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Terrain] Failed to allocate the quadtree traversal descriptor sets!");
+		return false;
+	}
+
+	// Node bounds, the level queues, counters, the selection and the draw
+	{
+		VkDescriptorBufferInfo buffer_infos[5]{};
+		buffer_infos[0] = { m_node_buffer, 0, VK_WHOLE_SIZE };
+		buffer_infos[1] = { frame.queue_buffer, 0, VK_WHOLE_SIZE };
+		buffer_infos[2] = { frame.counter_buffer, 0, VK_WHOLE_SIZE };
+		buffer_infos[3] = { frame.selected_buffer, 0, VK_WHOLE_SIZE };
+		buffer_infos[4] = { frame.draw_buffer, 0, VK_WHOLE_SIZE };
+
+		VkWriteDescriptorSet writes[5]{};
+		for (uint32_t binding = 0; binding < 5; binding++)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = sets[0];
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+			writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[binding].pBufferInfo = &buffer_infos[binding];
+		}
+
+		vkUpdateDescriptorSets(device, 5, writes, 0, nullptr);
+	}
+
+	// Drawing samples the heightmap, and reads node bounds and the selection
+	{
+		VkDescriptorImageInfo heightmap_info{};
+		heightmap_info.sampler = m_heightmap_image.sampler;
+		heightmap_info.imageView = m_heightmap_image.view;
+		heightmap_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkDescriptorBufferInfo buffer_infos[2]{};
+		buffer_infos[0] = { m_node_buffer, 0, VK_WHOLE_SIZE };
+		buffer_infos[1] = { frame.selected_buffer, 0, VK_WHOLE_SIZE };
+
+		VkWriteDescriptorSet writes[3]{};
+		for (uint32_t binding = 0; binding < 3; binding++)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = sets[1];
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+		}
+
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[0].pImageInfo = &heightmap_info;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[1].pBufferInfo = &buffer_infos[0];
+		writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[2].pBufferInfo = &buffer_infos[1];
+
+		vkUpdateDescriptorSets(device, 3, writes, 0, nullptr);
+	}
+
+	frame.traversal_set = sets[0];
+	frame.draw_set = sets[1];
+
+	return true;
+}
+
+void VulkanTerrain::ReleaseRetired()
+{
+	const VkDevice& device = m_logical_device->handle;
+	VulkanTimeline& graphics_timeline = m_logical_device->graphics_timeline;
+
+	// An uploading frame has reserved its value once the next one records
+	for (size_t i = m_staging.size(); i-- > 0;)
+	{
+		VulkanTerrainStaging& staging = m_staging[i];
+		if (staging.graphics_timeline_value == 0)
+		{
+			staging.graphics_timeline_value = graphics_timeline.value;
+			continue;
+		}
+
+		if (!graphics_timeline.Reached(device, staging.graphics_timeline_value))
+			continue;
+
+		vmaDestroyBuffer(m_logical_device->allocator, staging.buffer, staging.allocation);
+		m_staging.erase(m_staging.begin() + i);
+	}
+
+	for (size_t i = m_retired_targets.size(); i-- > 0;)
+	{
+		if (!graphics_timeline.Reached(device, m_retired_targets[i].graphics_timeline_value))
+			continue;
+
+		this->DestroyTarget(m_retired_targets[i]);
+		m_retired_targets.erase(m_retired_targets.begin() + i);
+	}
+}
+
+VkDescriptorSet VulkanTerrain::PrepareDetailSet()
+{
+	const size_t index = m_detail.GetFrameIndex();
+	const VkBuffer feedback = m_detail.GetFeedbackBuffer();
+	const VulkanImage* indirection = m_detail.GetIndirection(m_detail_region);
+	if (index >= m_detail_sets.size() || feedback == VK_NULL_HANDLE || !indirection)
+		return VK_NULL_HANDLE;
+
+	// The cache and indirection never change, so each set is written the first time its frame comes around
+	if (m_detail_feedback[index] == feedback)
+		return m_detail_sets[index];
+
+	const VulkanImage& cache = m_detail.GetCache();
+
+	VkDescriptorImageInfo image_infos[2]{};
+	image_infos[0].sampler = indirection->sampler;
+	image_infos[0].imageView = indirection->view;
+	image_infos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	image_infos[1].sampler = cache.sampler;
+	image_infos[1].imageView = cache.view;
+	image_infos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkDescriptorBufferInfo buffer_info{};
+	buffer_info.buffer = feedback;
+	buffer_info.offset = 0;
+	buffer_info.range = VK_WHOLE_SIZE;
+
+	VkWriteDescriptorSet writes[3]{};
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[i].dstSet = m_detail_sets[index];
+		writes[i].dstBinding = i;
+		writes[i].descriptorCount = 1;
+	}
+
+	writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	writes[0].pImageInfo = &image_infos[0];
+	writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	writes[1].pImageInfo = &image_infos[1];
+	writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	writes[2].pBufferInfo = &buffer_info;
+
+	vkUpdateDescriptorSets(m_logical_device->handle, 3, writes, 0, nullptr);
+
+	m_detail_feedback[index] = feedback;
+
+	return m_detail_sets[index];
+}
+
+void VulkanTerrain::DestroyTarget(VulkanTerrainTarget& target)
+{
+	// Destroying the pool frees its sets
+	if (target.descriptor_pool != VK_NULL_HANDLE)
+		vkDestroyDescriptorPool(m_logical_device->handle, target.descriptor_pool, nullptr);
+
+	for (VkImageView& view : target.hiz_views)
+		vkDestroyImageView(m_logical_device->handle, view, nullptr);
+
+	this->DestroyImage(target.hiz);
+	target = {};
+}
+
+void VulkanTerrain::DestroyLodFrame(VulkanTerrainLodFrame& frame)
+{
+	// Destroying the pool frees its sets
+	if (frame.descriptor_pool != VK_NULL_HANDLE)
+		vkDestroyDescriptorPool(m_logical_device->handle, frame.descriptor_pool, nullptr);
+
+	if (frame.queue_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, frame.queue_buffer, frame.queue_allocation);
+
+	if (frame.counter_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, frame.counter_buffer, frame.counter_allocation);
+
+	if (frame.selected_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, frame.selected_buffer, frame.selected_allocation);
+
+	if (frame.draw_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, frame.draw_buffer, frame.draw_allocation);
+
+	frame = {};
+}
+
+void VulkanTerrain::DestroyImage(VulkanImage& image)
+{
+	if (image.image == VK_NULL_HANDLE)
+		return;
+
+	vkDestroySampler(m_logical_device->handle, image.sampler, nullptr);
+	vkDestroyImageView(m_logical_device->handle, image.view, nullptr);
+	vmaDestroyImage(m_logical_device->allocator, image.image, image.allocation);
+	image = {};
+}
\ No newline at end of file
@@ -0,0 +1,434 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+import Vulkan;
+import Terrain;
+import Jobs;
+
+constexpr uint32_t c_tile_group_size = 8;
+
+VulkanTerrainCompute::VulkanTerrainCompute()
+	: m_logical_device(nullptr), m_scheduler(nullptr), m_pipeline(nullptr), m_config({}), m_descriptor_pool(VK_NULL_HANDLE)
+{
+
+}
+
+VulkanTerrainCompute::~VulkanTerrainCompute()
+{
+	this->Destroy();
+}
+
+bool VulkanTerrainCompute::Initialize(VulkanDevice* logical_device, VulkanComputeScheduler* scheduler, VulkanPipelineBuilder& builder, const VulkanTerrainComputeConfig& config)
+{
+	if (m_logical_device)
+	{
+		AURION_WARN("[Vulkan Terrain Compute] Attempt to initialize after initialization!");
+		return false;
+	}
+
+	if (!logical_device || !scheduler || config.tile_texels < 2 || config.ring_size == 0)
+	{
+		AURION_ERROR("[Vulkan Terrain Compute] Initialization requires a device, a compute scheduler, tiles of at least 2 texels and a ring slot.");
+		return false;
+	}
+
+	m_logical_device = logical_device;
+	m_scheduler = scheduler;
+	m_config = config;
+
+	builder.Configure(VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO)
+	.BindShader(VK_SHADER_STAGE_COMPUTE_BIT, 0, "assets/shaders/terrain-noise.comp", false)
+	.ConfigurePipelineLayout() // Pipeline Layout
+		.ConfigureDescSetLayout()
+			.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Tile heights
+		.BuildDescSetLayout()
+		.AddPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VulkanTerrainNoiseConstants))
+	.BuildPipelineLayout();
+
+	VulkanPipelineBuilder::Result result = builder.Build();
+
+	m_pipeline = result.compute_pipelines.empty() ? nullptr : result.compute_pipelines.back();
+	if (!m_pipeline || m_pipeline->handle == VK_NULL_HANDLE || m_pipeline->ds_layouts.empty())
+	{
+		AURION_ERROR("[Vulkan Terrain Compute] Failed to build the noise pipeline!");
+		this->Destroy();
+		return false;
+	}
+
+	VkDescriptorPoolSize pool_size{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_config.ring_size };
+
+	VkDescriptorPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	pool_info.maxSets = m_config.ring_size;
+	pool_info.poolSizeCount = 1;
+	pool_info.pPoolSizes = &pool_size;
+
+	if (vkCreateDescriptorPool(m_logical_device->handle, &pool_info, nullptr, &m_descriptor_pool) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Terrain Compute] Failed to create the descriptor pool!");
+		this->Destroy();
+		return false;
+	}
+
+	m_slots.resize(m_config.ring_size);
+	for (uint32_t i = 0; i < m_config.ring_size; i++)
+	{
+		if (!this->CreateSlot(m_slots[i]))
+		{
+			AURION_ERROR("[Vulkan Terrain Compute] Failed to create ring slot %d!", i);
+			this->Destroy();
+			return false;
+		}
+
+		m_free_slots.push_back(m_config.ring_size - 1 - i);
+	}
+
+	return true;
+}
+
+void VulkanTerrainCompute::Destroy()
+{
+	if (!m_logical_device)
+		return;
+
+	this->WaitIdle();
+
+	for (VulkanTerrainTileSlot& slot : m_slots)
+		this->DestroySlot(slot);
+
+	if (m_descriptor_pool != VK_NULL_HANDLE)
+		vkDestroyDescriptorPool(m_logical_device->handle, m_descriptor_pool, nullptr);
+
+	m_slots.clear();
+	m_free_slots.clear();
+	m_in_flight.clear();
+	m_descriptor_pool = VK_NULL_HANDLE;
+	m_pipeline = nullptr;
+	m_scheduler = nullptr;
+	m_logical_device = nullptr;
+}
+
+bool VulkanTerrainCompute::Request(const VulkanTerrainTile& tile)
+{
+	if (!m_logical_device || m_free_slots.empty())
+		return false;
+
+	const uint32_t slot_index = m_free_slots.back();
+	VulkanTerrainTileSlot& slot = m_slots[slot_index];
+
+	const int32_t tile_span = static_cast<int32_t>(m_config.tile_texels - 1);
+
+	VulkanTerrainNoiseConstants constants{};
+	constants.origin[0] = tile.x * tile_span;
+	constants.origin[1] = tile.y * tile_span;
+	constants.size = m_config.tile_texels;
+	constants.seed = m_config.noise.seed;
+	constants.octaves = m_config.noise.octaves;
+	constants.frequency = m_config.noise.frequency;
+	constants.lacunarity = m_config.noise.lacunarity;
+	constants.gain = m_config.noise.gain;
+	constants.exponent = m_config.noise.exponent;
+
+	VulkanPipeline* pipeline = m_pipeline;
+	VulkanComputeTicket ticket = m_scheduler->Submit([&slot, &constants, pipeline](const VkCommandBuffer& cmd_buffer)
+	{
+		// Every texel is rewritten, so the last tile's heights are discarded. Its readback copy finished with its job.
+		VulkanImage::TransitionLayout(cmd_buffer, slot.image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+		vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->handle);
+		vkCmdBindDescriptorSets(cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->layout, 0, 1, &slot.descriptor_set, 0, nullptr);
+		vkCmdPushConstants(cmd_buffer, pipeline->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VulkanTerrainNoiseConstants), &constants);
+
+		const uint32_t groups = (constants.size + c_tile_group_size - 1) / c_tile_group_size;
+		vkCmdDispatch(cmd_buffer, groups, groups, 1);
+
+		VulkanImage::TransitionLayout(cmd_buffer, slot.image.image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
+
+		VkBufferImageCopy copy{};
+		copy.bufferOffset = 0;
+		copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy.imageSubresource.mipLevel = 0;
+		copy.imageSubresource.baseArrayLayer = 0;
+		copy.imageSubresource.layerCount = 1;
+		copy.imageExtent = slot.image.extent;
+
+		vkCmdCopyImageToBuffer(cmd_buffer, slot.image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.readback_buffer, 1, &copy);
+
+		// Make the copy visible to the host once the job's timeline value is reached
+		VkBufferMemoryBarrier2 buffer_barrier{};
+		buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+		buffer_barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		buffer_barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		buffer_barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+		buffer_barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+		buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_barrier.buffer = slot.readback_buffer;
+		buffer_barrier.offset = 0;
+		buffer_barrier.size = VK_WHOLE_SIZE;
+
+		VkDependencyInfo dep_info{};
+		dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		dep_info.bufferMemoryBarrierCount = 1;
+		dep_info.pBufferMemoryBarriers = &buffer_barrier;
+
+		vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+	}, "Terrain Tile");
+
+	if (ticket.value == 0)
+		return false;
+
+	slot.tile = tile;
+	slot.ticket = ticket;
+
+	m_free_slots.pop_back();
+	m_in_flight.push_back(slot_index);
+
+	return true;
+}
+
+uint32_t VulkanTerrainCompute::Collect(const VulkanTerrainTileConsumer& consumer)
+{
+	uint32_t collected = 0;
+
+	// The compute queue finishes jobs in submission order, so the oldest tile is always the first to finish
+	while (!m_in_flight.empty() && m_scheduler->IsComplete(m_slots[m_in_flight.front()].ticket))
+	{
+		const uint32_t slot_index = m_in_flight.front();
+		VulkanTerrainTileSlot& slot = m_slots[slot_index];
+
+		vmaInvalidateAllocation(m_logical_device->allocator, slot.readback_allocation, 0, VK_WHOLE_SIZE);
+
+		if (consumer)
+			consumer(slot.tile, slot.readback, m_config.tile_texels);
+
+		m_in_flight.pop_front();
+		m_free_slots.push_back(slot_index);
+		collected++;
+	}
+
+	return collected;
+}
+
+void VulkanTerrainCompute::WaitIdle()
+{
+	if (!m_in_flight.empty())
+		m_scheduler->Wait(m_slots[m_in_flight.back()].ticket);
+}
+
+float VulkanTerrainCompute::Validate(const VulkanTerrainTile& tile)
+{
+	this->WaitIdle();
+	this->Collect({});
+
+	if (!this->Request(tile))
+		return -1.0f;
+
+	TerrainHeightmap reference;
+	this->GenerateOnCPU(tile, reference);
+
+	float max_error = 0.0f;
+	this->WaitIdle();
+	this->Collect([&reference, &max_error](const VulkanTerrainTile&, const float* heights, const uint32_t& tile_texels)
+	{
+		const std::vector<float>& expected = reference.GetHeights();
+		for (size_t i = 0; i < static_cast<size_t>(tile_texels) * tile_texels; i++)
+			max_error = std::max(max_error, std::abs(heights[i] - expected[i]));
+	});
+
+	return max_error;
+}
+
+VulkanTerrainComputeBenchmark VulkanTerrainCompute::Benchmark(const uint32_t& tile_count)
+{
+	VulkanTerrainComputeBenchmark result{};
+	result.tiles = std::max(tile_count, 1u);
+	result.tile_texels = m_config.tile_texels;
+
+	if (!m_logical_device)
+		return result;
+
+	// Tiles run along a row, so every one samples different texels
+	auto tile_at = [](const uint32_t& index) {
+		return VulkanTerrainTile{ static_cast<int32_t>(index), 0 };
+	};
+
+	// CPU first, keeping each tile to check the GPU against
+	std::vector<TerrainHeightmap> reference(result.tiles);
+	{
+		TerrainHeightmap warm_up;
+		this->GenerateOnCPU(tile_at(0), warm_up);
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		for (uint32_t i = 0; i < result.tiles; i++)
+			this->GenerateOnCPU(tile_at(i), reference[i]);
+
+		const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		result.cpu_tiles_per_second = result.tiles / std::max(seconds, 1e-9);
+	}
+
+	// GPU, keeping the ring full. Collected heights are compared as they arrive, as a cache would copy them.
+	{
+		this->WaitIdle();
+		this->Collect({});
+
+		// Warm up the pipeline and the ring's memory
+		if (!this->Request(tile_at(0)))
+			return result;
+		this->WaitIdle();
+		this->Collect({});
+
+		auto compare = [&result, &reference](const VulkanTerrainTile& tile, const float* heights, const uint32_t& tile_texels)
+		{
+			const std::vector<float>& expected = reference[tile.x].GetHeights();
+			for (size_t i = 0; i < static_cast<size_t>(tile_texels) * tile_texels; i++)
+				result.max_error = std::max(result.max_error, std::abs(heights[i] - expected[i]));
+		};
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		uint32_t requested = 0;
+		uint32_t collected = 0;
+		while (collected < result.tiles)
+		{
+			while (requested < result.tiles && this->Request(tile_at(requested)))
+				requested++;
+
+			// Blocking is fine here; frames never do
+			if (!m_in_flight.empty())
+				m_scheduler->Wait(m_slots[m_in_flight.front()].ticket);
+
+			const uint32_t newly_collected = this->Collect(compare);
+			if (newly_collected == 0 && m_in_flight.empty())
+				break;
+
+			collected += newly_collected;
+			m_scheduler->Collect();
+		}
+
+		const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		result.gpu_tiles_per_second = collected / std::max(seconds, 1e-9);
+
+		if (collected < result.tiles)
+			AURION_WARN("[Vulkan Terrain Compute] Only %d of %d benchmark tiles were generated.", collected, result.tiles);
+	}
+
+	result.agrees = result.max_error <= m_config.tolerance;
+
+	return result;
+}
+
+void VulkanTerrainCompute::RunBenchmark(const uint32_t& tile_count)
+{
+	AURION_INFO("[Vulkan Terrain Compute] Benchmarking %d tiles of %dx%d, %d octaves, CPU on %d threads", tile_count, m_config.tile_texels,
+		m_config.tile_texels, m_config.noise.octaves, JobSystem::Get()->GetThreadCount() + 1);
+
+	const VulkanTerrainComputeBenchmark result = this->Benchmark(tile_count);
+
+	AURION_INFO("[Vulkan Terrain Compute] GPU %8.1f tiles/s (with readback)", result.gpu_tiles_per_second);
+	AURION_INFO("[Vulkan Terrain Compute] CPU %8.1f tiles/s", result.cpu_tiles_per_second);
+
+	if (result.agrees)
+		AURION_INFO("[Vulkan Terrain Compute] Generators agree: max difference %g, tolerance %g", result.max_error, m_config.tolerance);
+	else
+		AURION_ERROR("[Vulkan Terrain Compute] Generators disagree: max difference %g, tolerance %g", result.max_error, m_config.tolerance);
+}
+
+size_t VulkanTerrainCompute::GetPendingCount()
+{
+	return m_in_flight.size();
+}
+
+const VulkanTerrainComputeConfig& VulkanTerrainCompute::GetConfig()
+{
+	return m_config;
+}
+
+void VulkanTerrainCompute::GenerateOnCPU(const VulkanTerrainTile& tile, TerrainHeightmap& heightmap)
+{
+	const int32_t tile_span = static_cast<int32_t>(m_config.tile_texels - 1);
+	heightmap.Generate(m_config.noise, m_config.tile_texels, tile.x * tile_span, tile.y * tile_span);
+}
+
+bool VulkanTerrainCompute::CreateSlot(VulkanTerrainTileSlot& slot)
+{
+	VulkanImageCreateInfo create_info{};
+	create_info.format = VK_FORMAT_R32_SFLOAT;
+	create_info.extent = VkExtent3D{ m_config.tile_texels, m_config.tile_texels, 1 };
+	create_info.usage_flags = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	create_info.aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+
+	slot.image = VulkanImage::Create(m_logical_device->handle, m_logical_device->allocator, create_info);
+	if (slot.image.image == VK_NULL_HANDLE)
+		return false;
+
+	VkBufferCreateInfo buffer_info{};
+	buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_info.size = static_cast<VkDeviceSize>(m_config.tile_texels) * m_config.tile_texels * sizeof(float);
+	buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	// Read on the host, so cached memory is preferred
+	VmaAllocationCreateInfo alloc_info{};
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+	alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VmaAllocationInfo allocation_info{};
+	if (vmaCreateBuffer(m_logical_device->allocator, &buffer_info, &alloc_info, &slot.readback_buffer, &slot.readback_allocation, &allocation_info) != VK_SUCCESS)
+		return false;
+
+	slot.readback = static_cast<const float*>(allocation_info.pMappedData);
+
+	VkDescriptorSetAllocateInfo set_info{};
+	set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	set_info.descriptorPool = m_descriptor_pool;
+	set_info.descriptorSetCount = 1;
+	set_info.pSetLayouts = &m_pipeline->ds_layouts[0];
+
+	if (vkAllocateDescriptorSets(m_logical_device->handle, &set_info, &slot.descriptor_set) != VK_SUCCESS)
+		return false;
+
+	VkDescriptorImageInfo image_info{};
+	image_info.imageView = slot.image.view;
+	image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+	VkWriteDescriptorSet write{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = slot.descriptor_set;
+	write.dstBinding = 0;
+	write.descriptorCount = 1;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	write.pImageInfo = &image_info;
+
+	vkUpdateDescriptorSets(m_logical_device->handle, 1, &write, 0, nullptr);
+
+	return true;
+}
+
+void VulkanTerrainCompute::DestroySlot(VulkanTerrainTileSlot& slot)
+{
+	if (slot.readback_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, slot.readback_buffer, slot.readback_allocation);
+
+	if (slot.image.image != VK_NULL_HANDLE)
+	{
+		vkDestroySampler(m_logical_device->handle, slot.image.sampler, nullptr);
+		vkDestroyImageView(m_logical_device->handle, slot.image.view, nullptr);
+		vmaDestroyImage(m_logical_device->allocator, slot.image.image, slot.image.allocation);
+	}
+
+	// Sets are freed with the pool
+	slot = {};
+}
\ No newline at end of file
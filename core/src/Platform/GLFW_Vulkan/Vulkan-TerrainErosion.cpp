@@ -0,0 +1,635 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+import Vulkan;
+import Terrain;
+
+constexpr uint32_t c_erosion_group_size = 8;
+
+// In dispatch order. Each shader fixes which state image it reads and writes.
+constexpr const char* c_erosion_shaders[VulkanTerrainErosion::c_pass_count] = {
+	"assets/shaders/terrain-erosion-water.comp", // Rain, A to B
+	"assets/shaders/terrain-erosion-flux.comp", // Outflow through each pipe
+	"assets/shaders/terrain-erosion-velocity.comp", // Water movement, B to A
+	"assets/shaders/terrain-erosion-erode.comp", // Erosion and deposition, A to B
+	"assets/shaders/terrain-erosion-transport.comp" // Sediment transport and evaporation, B to A
+};
+
+// Every pass reads what the one before wrote
+static void RecordPassBarrier(const VkCommandBuffer& cmd_buffer)
+{
+	VkMemoryBarrier2 barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+	barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+	barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+	barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+	barrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+	VkDependencyInfo dep_info{};
+	dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dep_info.memoryBarrierCount = 1;
+	dep_info.pMemoryBarriers = &barrier;
+
+	vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+}
+
+VulkanTerrainErosion::VulkanTerrainErosion()
+	: m_logical_device(nullptr), m_scheduler(nullptr), m_pipelines({}), m_config({}), m_size(0), m_states({}), m_flux({}), m_velocity({}),
+		m_descriptor_pool(VK_NULL_HANDLE), m_descriptor_sets({}), m_staging_buffer(VK_NULL_HANDLE), m_staging_allocation(VK_NULL_HANDLE),
+		m_upload_ticket({}), m_readback_buffer(VK_NULL_HANDLE), m_readback_allocation(VK_NULL_HANDLE), m_readback(nullptr), m_readback_heights(),
+		m_readback_ticket({}), m_ticket({}), m_running(true), m_stats({}), m_window_start(), m_window_iterations(0)
+{
+
+}
+
+VulkanTerrainErosion::~VulkanTerrainErosion()
+{
+	this->Destroy();
+}
+
+bool VulkanTerrainErosion::Initialize(VulkanDevice* logical_device, VulkanComputeScheduler* scheduler, VulkanPipelineBuilder& builder, const TerrainHeightmap& heightmap,
+	const VulkanTerrainErosionConfig& config)
+{
+	if (m_logical_device)
+	{
+		AURION_WARN("[Vulkan Terrain Erosion] Attempt to initialize after initialization!");
+		return false;
+	}
+
+	if (!logical_device || !scheduler || heightmap.GetSize() < 2)
+	{
+		AURION_ERROR("[Vulkan Terrain Erosion] Initialization requires a device, a compute scheduler and a heightmap of at least 2 texels.");
+		return false;
+	}
+
+	m_logical_device = logical_device;
+	m_scheduler = scheduler;
+	m_config = config;
+	m_size = heightmap.GetSize();
+
+	// The passes share one set layout, so their descriptor sets are interchangeable
+	for (const char* shader : c_erosion_shaders)
+	{
+		builder.Configure(VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO)
+		.BindShader(VK_SHADER_STAGE_COMPUTE_BIT, 0, shader, false)
+		.ConfigurePipelineLayout() // Pipeline Layout
+			.ConfigureDescSetLayout()
+				.AddDescSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT) // State A
+				.AddDescSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT) // State B
+				.AddDescSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Previous iteration's flux
+				.AddDescSetLayoutBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT) // This iteration's flux
+				.AddDescSetLayoutBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT) // Velocity
+			.BuildDescSetLayout()
+			.AddPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VulkanTerrainErosionConstants))
+		.BuildPipelineLayout();
+	}
+
+	VulkanPipelineBuilder::Result result = builder.Build();
+
+	// Results accumulate across builds, so this build's pipelines are the last ones
+	if (result.compute_pipelines.size() < c_pass_count)
+	{
+		AURION_ERROR("[Vulkan Terrain Erosion] Failed to build the erosion pipelines!");
+		this->Destroy();
+		return false;
+	}
+
+	const size_t first_pipeline = result.compute_pipelines.size() - c_pass_count;
+	for (uint32_t i = 0; i < c_pass_count; i++)
+	{
+		m_pipelines[i] = result.compute_pipelines[first_pipeline + i];
+		if (!m_pipelines[i] || m_pipelines[i]->handle == VK_NULL_HANDLE || m_pipelines[i]->ds_layouts.empty())
+		{
+			AURION_ERROR("[Vulkan Terrain Erosion] Failed to build the pipeline for %s!", c_erosion_shaders[i]);
+			this->Destroy();
+			return false;
+		}
+	}
+
+	// Graphics samples the state once a batch is consumed, so it is shared with every queue family. Readbacks copy from it.
+	const VkImageUsageFlags state_usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	const VkImageUsageFlags work_usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+	if (!this->CreateImage(m_states[0], VK_FORMAT_R32G32B32A32_SFLOAT, state_usage) ||
+		!this->CreateImage(m_states[1], VK_FORMAT_R32G32B32A32_SFLOAT, work_usage) ||
+		!this->CreateImage(m_flux[0], VK_FORMAT_R32G32B32A32_SFLOAT, work_usage) ||
+		!this->CreateImage(m_flux[1], VK_FORMAT_R32G32B32A32_SFLOAT, work_usage) ||
+		!this->CreateImage(m_velocity, VK_FORMAT_R32G32_SFLOAT, work_usage))
+	{
+		AURION_ERROR("[Vulkan Terrain Erosion] Failed to create the simulation state for a %dx%d heightmap!", m_size, m_size);
+		this->Destroy();
+		return false;
+	}
+
+	VkDescriptorPoolSize pool_size{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 5 * 2 };
+
+	VkDescriptorPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	pool_info.maxSets = 2;
+	pool_info.poolSizeCount = 1;
+	pool_info.pPoolSizes = &pool_size;
+
+	if (vkCreateDescriptorPool(m_logical_device->handle, &pool_info, nullptr, &m_descriptor_pool) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Terrain Erosion] Failed to create the descriptor pool!");
+		this->Destroy();
+		return false;
+	}
+
+	const VkDescriptorSetLayout set_layouts[2] = { m_pipelines[0]->ds_layouts[0], m_pipelines[0]->ds_layouts[0] };
+
+	VkDescriptorSetAllocateInfo set_info{};
+	set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	set_info.descriptorPool = m_descriptor_pool;
+	set_info.descriptorSetCount = 2;
+	set_info.pSetLayouts = set_layouts;
+
+	if (vkAllocateDescriptorSets(m_logical_device->handle, &set_info, m_descriptor_sets.data()) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Terrain Erosion] Failed to allocate descriptor sets!");
+		this->Destroy();
+		return false;
+	}
+
+	// Set i reads flux i and writes the other
+	for (uint32_t i = 0; i < 2; i++)
+	{
+		const VkImageView views[5] = { m_states[0].view, m_states[1].view, m_flux[i].view, m_flux[1 - i].view, m_velocity.view };
+
+		VkDescriptorImageInfo image_infos[5]{};
+		VkWriteDescriptorSet writes[5]{};
+		for (uint32_t binding = 0; binding < 5; binding++)
+		{
+			image_infos[binding].imageView = views[binding];
+			image_infos[binding].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = m_descriptor_sets[i];
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+			writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[binding].pImageInfo = &image_infos[binding];
+		}
+
+		vkUpdateDescriptorSets(m_logical_device->handle, 5, writes, 0, nullptr);
+	}
+
+	if (!this->Upload(heightmap))
+	{
+		this->Destroy();
+		return false;
+	}
+
+	m_window_start = std::chrono::high_resolution_clock::now();
+
+	return true;
+}
+
+void VulkanTerrainErosion::Destroy()
+{
+	if (!m_logical_device)
+		return;
+
+	this->WaitIdle();
+	this->ReleaseStaging();
+
+	if (m_readback_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, m_readback_buffer, m_readback_allocation);
+
+	m_readback_buffer = VK_NULL_HANDLE;
+	m_readback_allocation = VK_NULL_HANDLE;
+	m_readback = nullptr;
+	m_readback_heights.clear();
+	m_readback_ticket = {};
+
+	for (VulkanImage& image : m_states)
+		this->DestroyImage(image);
+	for (VulkanImage& image : m_flux)
+		this->DestroyImage(image);
+	this->DestroyImage(m_velocity);
+
+	// Sets are freed with the pool
+	if (m_descriptor_pool != VK_NULL_HANDLE)
+		vkDestroyDescriptorPool(m_logical_device->handle, m_descriptor_pool, nullptr);
+
+	m_descriptor_pool = VK_NULL_HANDLE;
+	m_descriptor_sets = {};
+	m_pipelines = {};
+	m_batches.clear();
+	m_ticket = {};
+	m_upload_ticket = {};
+	m_stats = {};
+	m_window_iterations = 0;
+	m_size = 0;
+	m_scheduler = nullptr;
+	m_logical_device = nullptr;
+}
+
+bool VulkanTerrainErosion::Reset(const TerrainHeightmap& heightmap)
+{
+	if (!m_logical_device)
+		return false;
+
+	if (heightmap.GetSize() != m_size)
+	{
+		AURION_ERROR("[Vulkan Terrain Erosion] Can't reset a %dx%d simulation with a %dx%d heightmap!", m_size, m_size, heightmap.GetSize(), heightmap.GetSize());
+		return false;
+	}
+
+	this->WaitIdle();
+	this->CollectBatches();
+
+	// Heights of the old simulation would undo the reset
+	m_readback_ticket = {};
+
+	return this->Upload(heightmap);
+}
+
+void VulkanTerrainErosion::Update()
+{
+	if (!m_logical_device)
+		return;
+
+	this->CollectBatches();
+
+	if (m_staging_buffer != VK_NULL_HANDLE && m_scheduler->IsComplete(m_upload_ticket))
+		this->ReleaseStaging();
+
+	const auto now = std::chrono::high_resolution_clock::now();
+	const double window_seconds = std::chrono::duration<double>(now - m_window_start).count();
+	if (window_seconds >= 1.0)
+	{
+		m_stats.iterations_per_second = m_window_iterations / window_seconds;
+		m_stats.cell_updates_per_second = m_stats.iterations_per_second * m_size * m_size;
+		m_window_iterations = 0;
+		m_window_start = now;
+	}
+
+	if (m_running)
+	{
+		while (m_batches.size() < std::max(m_config.batches_in_flight, 1u))
+		{
+			if (!this->SubmitBatch())
+				break;
+		}
+	}
+
+	m_stats.batches_in_flight = static_cast<uint32_t>(m_batches.size());
+}
+
+void VulkanTerrainErosion::SetRunning(const bool& running)
+{
+	m_running = running;
+}
+
+bool VulkanTerrainErosion::IsRunning()
+{
+	return m_running;
+}
+
+void VulkanTerrainErosion::SetConfig(const VulkanTerrainErosionConfig& config)
+{
+	m_config = config;
+}
+
+const VulkanTerrainErosionConfig& VulkanTerrainErosion::GetConfig()
+{
+	return m_config;
+}
+
+void VulkanTerrainErosion::WaitIdle()
+{
+	if (m_scheduler && m_ticket.value != 0)
+		m_scheduler->Wait(m_ticket);
+}
+
+bool VulkanTerrainErosion::RequestReadback()
+{
+	if (!m_logical_device || m_readback_ticket.value != 0)
+		return false;
+
+	if (m_readback_buffer == VK_NULL_HANDLE && !this->CreateReadback())
+	{
+		AURION_ERROR("[Vulkan Terrain Erosion] Failed to create the readback buffer!");
+		return false;
+	}
+
+	const VkImage state = m_states[0].image;
+	const VkBuffer readback_buffer = m_readback_buffer;
+	const uint32_t size = m_size;
+
+	// Queued behind the last batch, and ahead of the next, which mustn't overwrite the state mid-copy
+	VulkanComputeTicket ticket = m_scheduler->Submit([state, readback_buffer, size](const VkCommandBuffer& cmd_buffer)
+	{
+		VulkanImage::TransitionLayout(cmd_buffer, state, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
+
+		VkBufferImageCopy copy{};
+		copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy.imageSubresource.layerCount = 1;
+		copy.imageExtent = VkExtent3D{ size, size, 1 };
+
+		vkCmdCopyImageToBuffer(cmd_buffer, state, VK_IMAGE_LAYOUT_GENERAL, readback_buffer, 1, &copy);
+
+		VulkanImage::TransitionLayout(cmd_buffer, state, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_NONE);
+
+		// Make the copy visible to the host once the job's timeline value is reached
+		VkBufferMemoryBarrier2 buffer_barrier{};
+		buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+		buffer_barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		buffer_barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		buffer_barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+		buffer_barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+		buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_barrier.buffer = readback_buffer;
+		buffer_barrier.offset = 0;
+		buffer_barrier.size = VK_WHOLE_SIZE;
+
+		VkDependencyInfo dep_info{};
+		dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		dep_info.bufferMemoryBarrierCount = 1;
+		dep_info.pBufferMemoryBarriers = &buffer_barrier;
+
+		vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+	}, "Terrain Erosion Readback", m_ticket);
+
+	if (ticket.value == 0)
+		return false;
+
+	m_readback_ticket = ticket;
+	m_ticket = ticket;
+
+	return true;
+}
+
+bool VulkanTerrainErosion::CollectReadback(const VulkanTerrainErosionConsumer& consumer)
+{
+	if (m_readback_ticket.value == 0 || !m_scheduler->IsComplete(m_readback_ticket))
+		return false;
+
+	m_readback_ticket = {};
+	vmaInvalidateAllocation(m_logical_device->allocator, m_readback_allocation, 0, VK_WHOLE_SIZE);
+
+	// Only the terrain height is handed out, in the heightmap's units
+	const size_t cell_count = static_cast<size_t>(m_size) * m_size;
+	const float inverse_scale = m_config.height_scale > 0.0f ? 1.0f / m_config.height_scale : 0.0f;
+	for (size_t i = 0; i < cell_count; i++)
+		m_readback_heights[i] = m_readback[i * 4] * inverse_scale;
+
+	if (consumer)
+		consumer(m_readback_heights.data(), m_size);
+
+	return true;
+}
+
+const VulkanImage& VulkanTerrainErosion::GetState()
+{
+	return m_states[0];
+}
+
+const VulkanComputeTicket& VulkanTerrainErosion::GetTicket()
+{
+	return m_ticket;
+}
+
+uint32_t VulkanTerrainErosion::GetSize()
+{
+	return m_size;
+}
+
+const VulkanTerrainErosionStats& VulkanTerrainErosion::GetStats()
+{
+	return m_stats;
+}
+
+void VulkanTerrainErosion::CollectBatches()
+{
+	const auto now = std::chrono::high_resolution_clock::now();
+
+	// The compute queue finishes jobs in submission order
+	while (!m_batches.empty() && m_scheduler->IsComplete(m_batches.front().ticket))
+	{
+		const VulkanTerrainErosionBatch& batch = m_batches.front();
+
+		m_stats.iterations_completed += batch.iterations;
+		m_stats.batch_milliseconds = std::chrono::duration<double, std::milli>(now - batch.submitted).count();
+		m_window_iterations += batch.iterations;
+
+		m_batches.pop_front();
+	}
+}
+
+bool VulkanTerrainErosion::Upload(const TerrainHeightmap& heightmap)
+{
+	this->ReleaseStaging();
+
+	const VkDeviceSize cell_count = static_cast<VkDeviceSize>(m_size) * m_size;
+
+	VkBufferCreateInfo buffer_info{};
+	buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_info.size = cell_count * sizeof(float) * 4;
+	buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	VmaAllocationCreateInfo alloc_info{};
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+	alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VmaAllocationInfo allocation_info{};
+	if (vmaCreateBuffer(m_logical_device->allocator, &buffer_info, &alloc_info, &m_staging_buffer, &m_staging_allocation, &allocation_info) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Terrain Erosion] Failed to create the staging buffer!");
+		return false;
+	}
+
+	// Terrain in meters, with no water or sediment
+	float* mapped = static_cast<float*>(allocation_info.pMappedData);
+	const std::vector<float>& heights = heightmap.GetHeights();
+	for (VkDeviceSize i = 0; i < cell_count; i++)
+	{
+		mapped[i * 4 + 0] = heights[i] * m_config.height_scale;
+		mapped[i * 4 + 1] = 0.0f;
+		mapped[i * 4 + 2] = 0.0f;
+		mapped[i * 4 + 3] = 0.0f;
+	}
+	vmaFlushAllocation(m_logical_device->allocator, m_staging_allocation, 0, VK_WHOLE_SIZE);
+
+	VulkanImage* states = m_states.data();
+	VulkanImage* flux = m_flux.data();
+	VulkanImage* velocity = &m_velocity;
+	VkBuffer staging_buffer = m_staging_buffer;
+	const uint32_t size = m_size;
+
+	m_upload_ticket = m_scheduler->Submit([states, flux, velocity, staging_buffer, size](const VkCommandBuffer& cmd_buffer)
+	{
+		VulkanImage* images[5] = { &states[0], &states[1], &flux[0], &flux[1], velocity };
+
+		// Whatever the last simulation left behind is discarded
+		for (VulkanImage* image : images)
+			VulkanImage::TransitionLayout(cmd_buffer, image->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+		VkBufferImageCopy copy{};
+		copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy.imageSubresource.layerCount = 1;
+		copy.imageExtent = VkExtent3D{ size, size, 1 };
+
+		vkCmdCopyBufferToImage(cmd_buffer, staging_buffer, states[0].image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+
+		// No water is flowing yet
+		VkClearColorValue clear{};
+		VkImageSubresourceRange range{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		for (uint32_t i = 1; i < 5; i++)
+			vkCmdClearColorImage(cmd_buffer, images[i]->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clear, 1, &range);
+
+		for (VulkanImage* image : images)
+			VulkanImage::TransitionLayout(cmd_buffer, image->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+				VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+	}, "Terrain Erosion Upload", m_ticket);
+
+	if (m_upload_ticket.value == 0)
+	{
+		AURION_ERROR("[Vulkan Terrain Erosion] Failed to submit the initial state!");
+		this->ReleaseStaging();
+		return false;
+	}
+
+	m_ticket = m_upload_ticket;
+
+	return true;
+}
+
+bool VulkanTerrainErosion::SubmitBatch()
+{
+	const uint32_t iterations = std::max(m_config.iterations_per_frame, 1u);
+
+	VulkanTerrainErosionConstants constants{};
+	constants.time_step = m_config.time_step;
+	constants.cell_size = m_config.cell_size;
+	constants.gravity = m_config.gravity;
+	constants.pipe_area = m_config.pipe_area;
+	constants.rain_rate = m_config.rain_rate;
+	constants.sediment_capacity = m_config.sediment_capacity;
+	constants.dissolving = m_config.dissolving;
+	constants.deposition = m_config.deposition;
+	constants.evaporation = m_config.evaporation;
+	constants.min_tilt = m_config.min_tilt;
+	constants.size = m_size;
+	constants.iteration = static_cast<uint32_t>(m_stats.iterations_submitted);
+
+	const std::array<VulkanPipeline*, c_pass_count>& pipelines = m_pipelines;
+	const std::array<VkDescriptorSet, 2>& descriptor_sets = m_descriptor_sets;
+
+	// Queued behind the last submission, whose writes it reads
+	VulkanComputeTicket ticket = m_scheduler->Submit([&pipelines, &descriptor_sets, &constants, iterations](const VkCommandBuffer& cmd_buffer)
+	{
+		const uint32_t groups = (constants.size + c_erosion_group_size - 1) / c_erosion_group_size;
+		VulkanTerrainErosionConstants iteration_constants = constants;
+
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			// Flux written by the last iteration is read by this one
+			const VkDescriptorSet descriptor_set = descriptor_sets[iteration_constants.iteration & 1];
+
+			for (VulkanPipeline* pipeline : pipelines)
+			{
+				vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->handle);
+				vkCmdBindDescriptorSets(cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->layout, 0, 1, &descriptor_set, 0, nullptr);
+				vkCmdPushConstants(cmd_buffer, pipeline->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VulkanTerrainErosionConstants), &iteration_constants);
+				vkCmdDispatch(cmd_buffer, groups, groups, 1);
+
+				RecordPassBarrier(cmd_buffer);
+			}
+
+			iteration_constants.iteration++;
+		}
+	}, "Terrain Erosion", m_ticket);
+
+	if (ticket.value == 0)
+		return false;
+
+	VulkanTerrainErosionBatch batch{};
+	batch.ticket = ticket;
+	batch.iterations = iterations;
+	batch.submitted = std::chrono::high_resolution_clock::now();
+
+	m_batches.push_back(batch);
+	m_ticket = ticket;
+	m_stats.iterations_submitted += iterations;
+
+	return true;
+}
+
+void VulkanTerrainErosion::ReleaseStaging()
+{
+	if (m_staging_buffer == VK_NULL_HANDLE)
+		return;
+
+	vmaDestroyBuffer(m_logical_device->allocator, m_staging_buffer, m_staging_allocation);
+	m_staging_buffer = VK_NULL_HANDLE;
+	m_staging_allocation = VK_NULL_HANDLE;
+}
+
+bool VulkanTerrainErosion::CreateReadback()
+{
+	const VkDeviceSize cell_count = static_cast<VkDeviceSize>(m_size) * m_size;
+
+	VkBufferCreateInfo buffer_info{};
+	buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_info.size = cell_count * sizeof(float) * 4;
+	buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	// Read on the host, so cached memory is preferred
+	VmaAllocationCreateInfo alloc_info{};
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+	alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VmaAllocationInfo allocation_info{};
+	if (vmaCreateBuffer(m_logical_device->allocator, &buffer_info, &alloc_info, &m_readback_buffer, &m_readback_allocation, &allocation_info) != VK_SUCCESS)
+		return false;
+
+	m_readback = static_cast<const float*>(allocation_info.pMappedData);
+	m_readback_heights.resize(cell_count);
+
+	return true;
+}
+
+bool VulkanTerrainErosion::CreateImage(VulkanImage& image, const VkFormat& format, const VkImageUsageFlags& usage)
+{
+	VulkanImageCreateInfo create_info{};
+	create_info.format = format;
+	create_info.extent = VkExtent3D{ m_size, m_size, 1 };
+	create_info.usage_flags = usage;
+	create_info.aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+	create_info.queue_family_indices = m_logical_device->queue_families.data();
+	create_info.queue_family_count = static_cast<uint32_t>(m_logical_device->queue_families.size());
+
+	image = VulkanImage::Create(m_logical_device->handle, m_logical_device->allocator, create_info);
+
+	return image.image != VK_NULL_HANDLE;
+}
+
+void VulkanTerrainErosion::DestroyImage(VulkanImage& image)
+{
+	if (image.image == VK_NULL_HANDLE)
+		return;
+
+	vkDestroySampler(m_logical_device->handle, image.sampler, nullptr);
+	vkDestroyImageView(m_logical_device->handle, image.view, nullptr);
+	vmaDestroyImage(m_logical_device->allocator, image.image, image.allocation);
+	image = {};
+}
\ No newline at end of file
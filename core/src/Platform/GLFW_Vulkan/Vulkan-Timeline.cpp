@@ -0,0 +1,70 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+import Vulkan;
+
+VulkanTimeline VulkanTimeline::Create(const VkDevice& logical_device, const uint64_t& initial_value)
+{
+	VulkanTimeline timeline;
+	timeline.value = initial_value;
+
+	VkSemaphoreTypeCreateInfo type_info{};
+	type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	type_info.initialValue = initial_value;
+
+	VkSemaphoreCreateInfo sem_info{};
+	sem_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	sem_info.pNext = &type_info;
+	sem_info.flags = 0;
+
+	if (vkCreateSemaphore(logical_device, &sem_info, nullptr, &timeline.handle) != VK_SUCCESS)
+		AURION_ERROR("[Vulkan Timeline] Failed to create timeline semaphore!");
+
+	return timeline;
+}
+
+void VulkanTimeline::Destroy(const VkDevice& logical_device, VulkanTimeline& timeline)
+{
+	vkDestroySemaphore(logical_device, timeline.handle, nullptr);
+	timeline.handle = VK_NULL_HANDLE;
+	timeline.value = 0;
+}
+
+uint64_t VulkanTimeline::Next()
+{
+	return ++value;
+}
+
+bool VulkanTimeline::Wait(const VkDevice& logical_device, const uint64_t& wait_value, const uint64_t& timeout) const
+{
+	VkSemaphoreWaitInfo wait_info{};
+	wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	wait_info.semaphoreCount = 1;
+	wait_info.pSemaphores = &handle;
+	wait_info.pValues = &wait_value;
+
+	return vkWaitSemaphores(logical_device, &wait_info, timeout) == VK_SUCCESS;
+}
+
+bool VulkanTimeline::Reached(const VkDevice& logical_device, const uint64_t& check_value) const
+{
+	uint64_t current_value = 0;
+	vkGetSemaphoreCounterValue(logical_device, handle, &current_value);
+
+	return current_value >= check_value;
+}
+
+VkSemaphoreSubmitInfo VulkanTimeline::SubmitInfo(const uint64_t& submit_value, const VkPipelineStageFlags2& stage_mask) const
+{
+	VkSemaphoreSubmitInfo submit_info{};
+	submit_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+	submit_info.semaphore = handle;
+	submit_info.value = submit_value;
+	submit_info.stageMask = stage_mask;
+
+	return submit_info;
+}
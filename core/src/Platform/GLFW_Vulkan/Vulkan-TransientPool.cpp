@@ -0,0 +1,360 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+import Vulkan;
+
+VkImageCreateInfo VulkanTransientPool::MakeImageCreateInfo(const VulkanTransientImageInfo& info)
+{
+	VkImageCreateInfo create_info{};
+	create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	create_info.imageType = VK_IMAGE_TYPE_2D;
+	create_info.format = info.format;
+	create_info.extent = info.extent;
+	create_info.mipLevels = 1;
+	create_info.arrayLayers = 1;
+	create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+	create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+	create_info.usage = info.usage_flags;
+	create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	// Lazily allocated memory requires transient attachment usage
+	if (info.lazily_allocated)
+		create_info.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+	return create_info;
+}
+
+VkBufferCreateInfo VulkanTransientPool::MakeBufferCreateInfo(const VulkanTransientBufferInfo& info)
+{
+	VkBufferCreateInfo create_info{};
+	create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	create_info.size = info.size;
+	create_info.usage = info.usage_flags;
+	create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	return create_info;
+}
+
+bool VulkanTransientPool::RequestsMatch(const VulkanTransientRequest& a, const VulkanTransientRequest& b)
+{
+	if (a.is_image != b.is_image || a.first_pass != b.first_pass || a.last_pass != b.last_pass)
+		return false;
+
+	if (!a.is_image)
+		return a.buffer_info.size == b.buffer_info.size && a.buffer_info.usage_flags == b.buffer_info.usage_flags;
+
+	return a.image_info.format == b.image_info.format
+		&& a.image_info.extent.width == b.image_info.extent.width
+		&& a.image_info.extent.height == b.image_info.extent.height
+		&& a.image_info.extent.depth == b.image_info.extent.depth
+		&& a.image_info.usage_flags == b.image_info.usage_flags
+		&& a.image_info.aspect_flags == b.image_info.aspect_flags
+		&& a.image_info.lazily_allocated == b.image_info.lazily_allocated;
+}
+
+void VulkanTransientPool::Initialize(const VkDevice& device, const VmaAllocator& vma_allocator)
+{
+	logical_device = device;
+	allocator = vma_allocator;
+}
+
+void VulkanTransientPool::Destroy()
+{
+	for (VulkanTransientResource& resource : resources)
+	{
+		vkDestroyImageView(logical_device, resource.view, nullptr);
+
+		if (resource.lazy_allocation)
+			vmaDestroyImage(allocator, resource.image, resource.lazy_allocation);
+		else
+			vkDestroyImage(logical_device, resource.image, nullptr);
+
+		vkDestroyBuffer(logical_device, resource.buffer, nullptr);
+	}
+
+	resources.clear();
+	requests.clear();
+
+	if (image_memory)
+		vmaFreeMemory(allocator, image_memory);
+	if (buffer_memory)
+		vmaFreeMemory(allocator, buffer_memory);
+
+	image_memory = VK_NULL_HANDLE;
+	image_memory_size = 0;
+	buffer_memory = VK_NULL_HANDLE;
+	buffer_memory_size = 0;
+	stats = {};
+}
+
+bool VulkanTransientPool::Realize(const std::vector<VulkanTransientRequest>& new_requests)
+{
+	// Re-use last frame's placements if nothing changed
+	if (new_requests.size() == requests.size())
+	{
+		bool matches = true;
+		for (size_t i = 0; i < requests.size() && matches; i++)
+			matches = RequestsMatch(requests[i], new_requests[i]);
+
+		if (matches)
+			return true;
+	}
+
+	// Destroy old resources, but hold on to their memory
+	VmaAllocation old_image_memory = image_memory;
+	VkDeviceSize old_image_memory_size = image_memory_size;
+	VmaAllocation old_buffer_memory = buffer_memory;
+	VkDeviceSize old_buffer_memory_size = buffer_memory_size;
+
+	image_memory = VK_NULL_HANDLE;
+	buffer_memory = VK_NULL_HANDLE;
+	this->Destroy();
+
+	image_memory = old_image_memory;
+	image_memory_size = old_image_memory_size;
+	buffer_memory = old_buffer_memory;
+	buffer_memory_size = old_buffer_memory_size;
+
+	requests = new_requests;
+	resources.resize(requests.size());
+
+	struct TransientPlacement
+	{
+		size_t index;
+		VkMemoryRequirements requirements;
+	};
+
+	// Gather memory requirements without creating any resources
+	std::vector<TransientPlacement> image_placements;
+	std::vector<TransientPlacement> buffer_placements;
+
+	for (size_t i = 0; i < requests.size(); i++)
+	{
+		const VulkanTransientRequest& request = requests[i];
+		VulkanTransientResource& resource = resources[i];
+
+		VkMemoryRequirements2 requirements{};
+		requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+
+		if (!request.is_image)
+		{
+			VkBufferCreateInfo create_info = MakeBufferCreateInfo(request.buffer_info);
+
+			VkDeviceBufferMemoryRequirements buffer_requirements{};
+			buffer_requirements.sType = VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS;
+			buffer_requirements.pCreateInfo = &create_info;
+
+			vkGetDeviceBufferMemoryRequirements(logical_device, &buffer_requirements, &requirements);
+			buffer_placements.emplace_back(TransientPlacement{ i, requirements.memoryRequirements });
+			continue;
+		}
+
+		VkImageCreateInfo create_info = MakeImageCreateInfo(request.image_info);
+
+		// Lazily allocated attachments get their own memory, which is usually never committed
+		if (request.image_info.lazily_allocated)
+		{
+			VmaAllocationCreateInfo lazy_alloc_info{};
+			lazy_alloc_info.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+
+			VmaAllocationInfo allocation_info{};
+			if (vmaCreateImage(allocator, &create_info, &lazy_alloc_info, &resource.image, &resource.lazy_allocation, &allocation_info) == VK_SUCCESS)
+			{
+				resource.size = allocation_info.size;
+				stats.lazy_bytes += allocation_info.size;
+				continue;
+			}
+
+			// No lazily allocated memory type (common on desktop GPUs); alias it instead
+			resource.image = VK_NULL_HANDLE;
+			resource.lazy_allocation = VK_NULL_HANDLE;
+		}
+
+		VkDeviceImageMemoryRequirements image_requirements{};
+		image_requirements.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS;
+		image_requirements.pCreateInfo = &create_info;
+
+		vkGetDeviceImageMemoryRequirements(logical_device, &image_requirements, &requirements);
+		image_placements.emplace_back(TransientPlacement{ i, requirements.memoryRequirements });
+	}
+
+	// Place each group in a single allocation, aliasing resources with disjoint lifetimes
+	auto place_group = [&](std::vector<TransientPlacement>& placements, VmaAllocation& memory, VkDeviceSize& memory_size) -> bool {
+		if (placements.empty())
+			return true;
+
+		// Largest first gives tighter packing
+		std::sort(placements.begin(), placements.end(), [](const TransientPlacement& a, const TransientPlacement& b) {
+			return a.requirements.size > b.requirements.size;
+		});
+
+		VkDeviceSize total_size = 0;
+		VkDeviceSize alignment = 1;
+		uint32_t memory_type_bits = ~0u;
+
+		for (size_t i = 0; i < placements.size(); i++)
+		{
+			const TransientPlacement& placement = placements[i];
+			const VulkanTransientRequest& request = requests[placement.index];
+			VulkanTransientResource& resource = resources[placement.index];
+
+			auto lifetimes_overlap = [&](const TransientPlacement& other) {
+				const VulkanTransientRequest& other_request = requests[other.index];
+				return request.first_pass <= other_request.last_pass && other_request.first_pass <= request.last_pass;
+			};
+
+			// Find the lowest offset that doesn't collide with a placed resource that's alive at the same time
+			VkDeviceSize offset = 0;
+			bool collides = true;
+			while (collides)
+			{
+				collides = false;
+				const VkDeviceSize align = std::max<VkDeviceSize>(placement.requirements.alignment, 1);
+				offset = (offset + align - 1) / align * align;
+
+				for (size_t j = 0; j < i; j++)
+				{
+					const VulkanTransientResource& other = resources[placements[j].index];
+					if (!lifetimes_overlap(placements[j]))
+						continue;
+
+					if (offset < other.offset + other.size && other.offset < offset + placement.requirements.size)
+					{
+						offset = other.offset + other.size;
+						collides = true;
+					}
+				}
+			}
+
+			resource.offset = offset;
+			resource.size = placement.requirements.size;
+
+			total_size = std::max(total_size, offset + placement.requirements.size);
+			alignment = std::max(alignment, placement.requirements.alignment);
+			memory_type_bits &= placement.requirements.memoryTypeBits;
+
+			stats.requested_bytes += placement.requirements.size;
+		}
+
+		// Record which earlier resources a resource's memory was handed down from
+		for (size_t i = 0; i < placements.size(); i++)
+		{
+			const VulkanTransientRequest& request = requests[placements[i].index];
+			VulkanTransientResource& resource = resources[placements[i].index];
+
+			for (size_t j = 0; j < placements.size(); j++)
+			{
+				const VulkanTransientRequest& other_request = requests[placements[j].index];
+				const VulkanTransientResource& other = resources[placements[j].index];
+
+				bool memory_overlaps = resource.offset < other.offset + other.size && other.offset < resource.offset + resource.size;
+				if (i != j && memory_overlaps && other_request.last_pass < request.first_pass)
+					resource.alias_predecessors.emplace_back((uint32_t)placements[j].index);
+			}
+		}
+
+		if (memory_type_bits == 0)
+		{
+			AURION_ERROR("[Vulkan Transient Pool] Transient resources have no memory type in common!");
+			return false;
+		}
+
+		// Re-use the existing allocation if it's large enough and of a compatible type
+		if (memory)
+		{
+			VmaAllocationInfo allocation_info{};
+			vmaGetAllocationInfo(allocator, memory, &allocation_info);
+
+			if (memory_size < total_size || (memory_type_bits & (1u << allocation_info.memoryType)) == 0)
+			{
+				vmaFreeMemory(allocator, memory);
+				memory = VK_NULL_HANDLE;
+				memory_size = 0;
+			}
+		}
+
+		if (!memory)
+		{
+			VkMemoryRequirements requirements{};
+			requirements.size = total_size;
+			requirements.alignment = alignment;
+			requirements.memoryTypeBits = memory_type_bits;
+
+			VmaAllocationCreateInfo alloc_info{};
+			alloc_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+			alloc_info.requiredFlags = VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+			if (vmaAllocateMemory(allocator, &requirements, &alloc_info, &memory, nullptr) != VK_SUCCESS)
+			{
+				AURION_ERROR("[Vulkan Transient Pool] Failed to allocate %llu bytes of transient memory!", total_size);
+				return false;
+			}
+
+			memory_size = total_size;
+		}
+
+		stats.aliased_bytes += total_size;
+		return true;
+	};
+
+	if (!place_group(image_placements, image_memory, image_memory_size) || !place_group(buffer_placements, buffer_memory, buffer_memory_size))
+	{
+		this->Destroy();
+		return false;
+	}
+
+	// Create and bind every aliased resource
+	for (const TransientPlacement& placement : image_placements)
+	{
+		VulkanTransientResource& resource = resources[placement.index];
+		VkImageCreateInfo create_info = MakeImageCreateInfo(requests[placement.index].image_info);
+
+		vkCreateImage(logical_device, &create_info, nullptr, &resource.image);
+		vmaBindImageMemory2(allocator, image_memory, resource.offset, resource.image, nullptr);
+	}
+
+	for (const TransientPlacement& placement : buffer_placements)
+	{
+		VulkanTransientResource& resource = resources[placement.index];
+		VkBufferCreateInfo create_info = MakeBufferCreateInfo(requests[placement.index].buffer_info);
+
+		vkCreateBuffer(logical_device, &create_info, nullptr, &resource.buffer);
+		vmaBindBufferMemory2(allocator, buffer_memory, resource.offset, resource.buffer, nullptr);
+	}
+
+	// Image views, for aliased and lazily allocated images alike
+	for (size_t i = 0; i < requests.size(); i++)
+	{
+		if (!requests[i].is_image)
+			continue;
+
+		VkImageViewCreateInfo view_info{};
+		view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		view_info.image = resources[i].image;
+		view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		view_info.format = requests[i].image_info.format;
+		view_info.subresourceRange.aspectMask = requests[i].image_info.aspect_flags;
+		view_info.subresourceRange.baseMipLevel = 0;
+		view_info.subresourceRange.levelCount = 1;
+		view_info.subresourceRange.baseArrayLayer = 0;
+		view_info.subresourceRange.layerCount = 1;
+
+		vkCreateImageView(logical_device, &view_info, nullptr, &resources[i].view);
+	}
+
+	AURION_TRACE("[Vulkan Transient Pool] Placed %d transient resources: %llu bytes requested, %llu bytes aliased, %llu bytes lazy",
+		(int)requests.size(), stats.requested_bytes, stats.aliased_bytes, stats.lazy_bytes);
+
+	return true;
+}
+
+const VulkanTransientResource& VulkanTransientPool::GetResource(const size_t& request_index) const
+{
+	return resources[request_index];
+}
\ No newline at end of file
@@ -0,0 +1,836 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <memory>
+#include <future>
+#include <chrono>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+
+import Vulkan;
+import Jobs;
+import Texture;
+
+// Staging allocations are aligned for any texel size the cache supports
+constexpr VkDeviceSize c_staging_alignment = 16;
+
+// Largest region supported by the page id packing
+constexpr uint32_t c_max_pages_per_side = 1024;
+
+// Cache formats that pages are block compressed into before upload
+static bool GetBlockFormat(const VkFormat& format, BCFormat& block_format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		block_format = BCFormat::BC1;
+		return true;
+	case VK_FORMAT_BC4_UNORM_BLOCK:
+		block_format = BCFormat::BC4;
+		return true;
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+		block_format = BCFormat::BC5;
+		return true;
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		block_format = BCFormat::BC7;
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Stages that may sample the texture or write feedback
+constexpr VkPipelineStageFlags2 c_virtual_texture_stages = VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+
+uint32_t VulkanVirtualTexture::PackPage(const VulkanVirtualPage& page)
+{
+	return (page.region << 24) | ((page.mip & 0xF) << 20) | ((page.x & 0x3FF) << 10) | (page.y & 0x3FF);
+}
+
+VulkanVirtualPage VulkanVirtualTexture::UnpackPage(const uint32_t& page_id)
+{
+	return VulkanVirtualPage{
+		.region = page_id >> 24,
+		.mip = (page_id >> 20) & 0xF,
+		.x = (page_id >> 10) & 0x3FF,
+		.y = page_id & 0x3FF
+	};
+}
+
+VulkanVirtualTexture::VulkanVirtualTexture()
+	: m_logical_device(nullptr), m_config({}), m_texel_size(0), m_page_bytes(0), m_compressed(false), m_block_format(BCFormat::BC1), m_cache({}), m_cache_initialized(false), m_frame(0),
+		m_staging_buffer(VK_NULL_HANDLE), m_staging_allocation(VK_NULL_HANDLE), m_staging_mapped(nullptr), m_staging_head(0), m_staging_used(0),
+		m_stats({})
+{
+
+}
+
+VulkanVirtualTexture::~VulkanVirtualTexture()
+{
+	this->Destroy();
+}
+
+bool VulkanVirtualTexture::Initialize(VulkanDevice* logical_device, const VulkanVirtualTextureConfig& config)
+{
+	if (m_logical_device)
+	{
+		AURION_WARN("[Vulkan Virtual Texture] Attempt to initialize after initialization!");
+		return false;
+	}
+
+	m_config = config;
+	m_compressed = GetBlockFormat(m_config.format, m_block_format);
+
+	// Compressed pages are produced as RGBA8
+	m_texel_size = m_compressed ? 4 : VulkanImage::GetTexelSize(m_config.format);
+
+	if (m_texel_size == 0 || (m_compressed && m_config.page_size % 4 != 0))
+	{
+		AURION_ERROR("[Vulkan Virtual Texture] Unsupported cache format %d for %d texel pages.", m_config.format, m_config.page_size);
+		return false;
+	}
+
+	m_page_bytes = m_compressed
+		? static_cast<uint32_t>(BlockCompressor::GetEncodedSize(m_block_format, m_config.page_size, m_config.page_size))
+		: m_config.page_size * m_config.page_size * m_texel_size;
+
+	// Cache coordinates are stored in 8-bit indirection channels
+	if (m_config.cache_pages_per_side == 0 || m_config.cache_pages_per_side > 256 || m_config.page_size <= m_config.page_border * 2)
+	{
+		AURION_ERROR("[Vulkan Virtual Texture] Invalid cache layout: %d pages of %d texels, with a %d texel border.",
+			m_config.cache_pages_per_side, m_config.page_size, m_config.page_border);
+		return false;
+	}
+
+	m_logical_device = logical_device;
+	m_config.frames_in_flight = std::max(m_config.frames_in_flight, 1u);
+
+	// Physical page cache
+	{
+		VulkanImageCreateInfo create_info{};
+		create_info.format = m_config.format;
+		create_info.extent = VkExtent3D{
+			.width = m_config.page_size * m_config.cache_pages_per_side,
+			.height = m_config.page_size * m_config.cache_pages_per_side,
+			.depth = 1
+		};
+		create_info.usage_flags = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		create_info.aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+
+		// Compute passes may sample the cache as well
+		create_info.queue_family_indices = m_logical_device->queue_families.data();
+		create_info.queue_family_count = static_cast<uint32_t>(m_logical_device->queue_families.size());
+
+		m_cache = VulkanImage::Create(m_logical_device->handle, m_logical_device->allocator, create_info);
+		if (m_cache.image == VK_NULL_HANDLE)
+		{
+			AURION_ERROR("[Vulkan Virtual Texture] Failed to create the page cache!");
+			this->Destroy();
+			return false;
+		}
+
+		m_slots.assign(m_config.cache_pages_per_side * m_config.cache_pages_per_side, {});
+	}
+
+	// Upload ring
+	{
+		VkBufferCreateInfo buffer_info{};
+		buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		buffer_info.size = m_config.staging_size;
+		buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VmaAllocationCreateInfo alloc_info{};
+		alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+		alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		VmaAllocationInfo allocation_info{};
+		if (vmaCreateBuffer(m_logical_device->allocator, &buffer_info, &alloc_info, &m_staging_buffer, &m_staging_allocation, &allocation_info) != VK_SUCCESS)
+		{
+			AURION_ERROR("[Vulkan Virtual Texture] Failed to create the staging ring!");
+			this->Destroy();
+			return false;
+		}
+
+		m_staging_mapped = static_cast<uint8_t*>(allocation_info.pMappedData);
+	}
+
+	// Feedback buffers, one per frame in flight
+	m_frames.resize(m_config.frames_in_flight);
+	for (VulkanVirtualTextureFrame& frame : m_frames)
+	{
+		if (!this->CreateFrame(frame))
+		{
+			AURION_ERROR("[Vulkan Virtual Texture] Failed to create feedback buffers!");
+			this->Destroy();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void VulkanVirtualTexture::Destroy()
+{
+	if (!m_logical_device)
+		return;
+
+	// Producers write into job owned memory, so they must finish first
+	for (VulkanVirtualPageJob& job : m_jobs)
+		if (job.done.valid())
+			JobSystem::Get()->Wait(job.done);
+
+	m_jobs.clear();
+	m_ready.clear();
+	m_in_production.clear();
+	m_requests.clear();
+
+	// Wait for any frame still using the cache, indirection or staging memory
+	m_logical_device->graphics_timeline.Wait(m_logical_device->handle, m_logical_device->graphics_timeline.value);
+
+	for (VulkanVirtualTextureFrame& frame : m_frames)
+		this->DestroyFrame(frame);
+	m_frames.clear();
+
+	for (VulkanVirtualTextureRegion& region : m_regions)
+		this->DestroyImage(region.indirection);
+	m_regions.clear();
+
+	this->DestroyImage(m_cache);
+	m_cache_initialized = false;
+	m_slots.clear();
+	m_resident.clear();
+
+	if (m_staging_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, m_staging_buffer, m_staging_allocation);
+
+	m_staging_buffer = VK_NULL_HANDLE;
+	m_staging_allocation = VK_NULL_HANDLE;
+	m_staging_mapped = nullptr;
+	m_staging_head = 0;
+	m_staging_used = 0;
+	m_staging_in_flight.clear();
+
+	m_stats = {};
+	m_logical_device = nullptr;
+}
+
+uint32_t VulkanVirtualTexture::AddRegion(const VulkanVirtualTextureRegionInfo& info)
+{
+	if (!m_logical_device)
+		return c_max_regions;
+
+	const bool power_of_two = info.pages_per_side != 0 && (info.pages_per_side & (info.pages_per_side - 1)) == 0;
+	if (!power_of_two || info.pages_per_side > c_max_pages_per_side || !info.producer)
+	{
+		AURION_ERROR("[Vulkan Virtual Texture] Regions need a producer, and a power of two page count of at most %d per side.", c_max_pages_per_side);
+		return c_max_regions;
+	}
+
+	// Re-use the slot of a removed region, once nothing references it anymore
+	uint32_t index = static_cast<uint32_t>(m_regions.size());
+	for (uint32_t i = 0; i < m_regions.size(); i++)
+	{
+		if (!m_regions[i].active && m_regions[i].indirection.image == VK_NULL_HANDLE)
+		{
+			index = i;
+			break;
+		}
+	}
+
+	if (index >= c_max_regions)
+	{
+		AURION_ERROR("[Vulkan Virtual Texture] Region limit of %d reached.", c_max_regions);
+		return c_max_regions;
+	}
+
+	VulkanVirtualTextureRegion region{};
+	region.pages_per_side = info.pages_per_side;
+	region.producer = info.producer;
+
+	VulkanImageCreateInfo create_info{};
+	create_info.format = VK_FORMAT_R8G8B8A8_UINT;
+	create_info.extent = VkExtent3D{ info.pages_per_side, info.pages_per_side, 1 };
+	create_info.mip_levels = VulkanImage::c_full_mip_chain;
+	create_info.usage_flags = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	create_info.aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
+	create_info.queue_family_indices = m_logical_device->queue_families.data();
+	create_info.queue_family_count = static_cast<uint32_t>(m_logical_device->queue_families.size());
+
+	region.indirection = VulkanImage::Create(m_logical_device->handle, m_logical_device->allocator, create_info);
+	if (region.indirection.image == VK_NULL_HANDLE)
+	{
+		AURION_ERROR("[Vulkan Virtual Texture] Failed to create an indirection texture!");
+		return c_max_regions;
+	}
+
+	region.mip_levels = region.indirection.mip_levels;
+	region.active = true;
+
+	if (index == m_regions.size())
+		m_regions.emplace_back(std::move(region));
+	else
+		m_regions[index] = std::move(region);
+
+	// The coarsest page backs every lookup in the region
+	this->RequestPage(PackPage(VulkanVirtualPage{ .region = index, .mip = m_regions[index].mip_levels - 1, .x = 0, .y = 0 }));
+
+	return index;
+}
+
+void VulkanVirtualTexture::RemoveRegion(const uint32_t& region)
+{
+	if (region >= m_regions.size() || !m_regions[region].active)
+		return;
+
+	// Its page ids may be reused by the next region added, so nothing produced for it may outlive it
+	for (auto it = m_jobs.begin(); it != m_jobs.end();)
+	{
+		if (UnpackPage(it->page_id).region != region)
+		{
+			it++;
+			continue;
+		}
+
+		JobSystem::Get()->Wait(it->done);
+		m_in_production.erase(it->page_id);
+		it = m_jobs.erase(it);
+	}
+
+	for (auto it = m_ready.begin(); it != m_ready.end();)
+	{
+		if (UnpackPage(it->page_id).region != region)
+		{
+			it++;
+			continue;
+		}
+
+		m_in_production.erase(it->page_id);
+		it = m_ready.erase(it);
+	}
+
+	// Free its cache pages
+	for (auto it = m_resident.begin(); it != m_resident.end();)
+	{
+		if (UnpackPage(it->first).region == region)
+		{
+			m_slots[it->second] = {};
+			it = m_resident.erase(it);
+		}
+		else
+			it++;
+	}
+
+	// Frames in flight may still sample the indirection texture
+	m_logical_device->graphics_timeline.Wait(m_logical_device->handle, m_logical_device->graphics_timeline.value);
+
+	VulkanVirtualTextureRegion& removed = m_regions[region];
+	this->DestroyImage(removed.indirection);
+	removed = {};
+}
+
+void VulkanVirtualTexture::BeginFrame()
+{
+	if (!m_logical_device)
+		return;
+
+	const VkDevice& device = m_logical_device->handle;
+	VulkanTimeline& graphics_timeline = m_logical_device->graphics_timeline;
+
+	// Last frame's work went out with, at most, the latest reserved graphics value
+	const uint64_t submitted_value = graphics_timeline.value;
+	m_frames[m_frame % m_frames.size()].graphics_timeline_value = submitted_value;
+	for (auto& [bytes, value] : m_staging_in_flight)
+		if (value == 0)
+			value = submitted_value;
+
+	m_frame++;
+
+	this->ReleaseStaging();
+
+	// Read every completed frame's feedback, without waiting on any
+	for (VulkanVirtualTextureFrame& frame : m_frames)
+		if (frame.feedback_recorded && graphics_timeline.Reached(device, frame.graphics_timeline_value))
+			this->ReadFeedback(frame);
+
+	// This frame's buffers are about to be re-used. Frames in flight are bounded, so this rarely waits.
+	VulkanVirtualTextureFrame& current = m_frames[m_frame % m_frames.size()];
+	if (current.feedback_recorded)
+	{
+		graphics_timeline.Wait(device, current.graphics_timeline_value);
+		this->ReadFeedback(current);
+	}
+
+	// Resident pages stay in use; the rest are produced, coarsest level and most requested first
+	std::vector<std::pair<uint32_t, uint32_t>> missing;
+	for (const auto& [page_id, count] : m_requests)
+	{
+		auto resident = m_resident.find(page_id);
+		if (resident != m_resident.end())
+			m_slots[resident->second].last_used = m_frame;
+		else if (!m_in_production.contains(page_id))
+			missing.emplace_back(page_id, count);
+	}
+
+	m_stats.requested_pages = static_cast<uint32_t>(m_requests.size());
+	m_requests.clear();
+
+	std::sort(missing.begin(), missing.end(), [](const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) {
+		uint32_t a_mip = UnpackPage(a.first).mip;
+		uint32_t b_mip = UnpackPage(b.first).mip;
+		return a_mip != b_mip ? a_mip > b_mip : a.second > b.second;
+	});
+
+	for (const auto& [page_id, count] : missing)
+	{
+		if (m_jobs.size() >= m_config.max_pending_pages)
+			break;
+
+		this->RequestPage(page_id);
+	}
+
+	this->CollectJobs();
+}
+
+void VulkanVirtualTexture::RecordUploads(const VkCommandBuffer& cmd_buffer)
+{
+	if (!m_logical_device)
+		return;
+
+	const uint32_t page_bytes = m_page_bytes;
+
+	// Pages to copy into the cache, and indirection texels to rewrite
+	std::vector<VkBufferImageCopy> cache_copies;
+	std::vector<std::pair<VulkanVirtualPage, uint32_t>> indirection_updates;
+
+	m_stats.uploads = 0;
+	m_stats.evictions = 0;
+
+	// Each upload writes at most two indirection texels (the new page, and an evicted one), which share one allocation
+	VkDeviceSize indirection_offset = 0;
+	const bool can_upload = !m_ready.empty() &&
+		this->AllocateStaging(m_config.max_uploads_per_frame * 2 * sizeof(uint32_t), indirection_offset);
+
+	while (can_upload && !m_ready.empty() && cache_copies.size() < m_config.max_uploads_per_frame)
+	{
+		VulkanVirtualPageJob& job = m_ready.front();
+		const VulkanVirtualPage page = UnpackPage(job.page_id);
+
+		// Drop pages of removed regions
+		if (page.region >= m_regions.size() || !m_regions[page.region].active)
+		{
+			m_in_production.erase(job.page_id);
+			m_ready.pop_front();
+			continue;
+		}
+
+		// Try again next frame if the ring or the cache is full
+		VkDeviceSize offset = 0;
+		uint32_t slot_index = this->AcquireSlot();
+		if (slot_index == UINT32_MAX || !this->AllocateStaging(page_bytes, offset))
+			break;
+
+		VulkanVirtualCacheSlot& slot = m_slots[slot_index];
+		const uint32_t slot_x = slot_index % m_config.cache_pages_per_side;
+		const uint32_t slot_y = slot_index / m_config.cache_pages_per_side;
+
+		// Evict the slot's previous page
+		if (slot.page_id != UINT32_MAX)
+		{
+			m_resident.erase(slot.page_id);
+			indirection_updates.emplace_back(UnpackPage(slot.page_id), 0);
+			m_stats.evictions++;
+		}
+
+		slot.page_id = job.page_id;
+		slot.last_used = m_frame;
+		slot.pinned = page.mip == m_regions[page.region].mip_levels - 1;
+		m_resident[job.page_id] = slot_index;
+
+		std::memcpy(m_staging_mapped + offset, job.texels.get(), page_bytes);
+
+		VkBufferImageCopy& copy = cache_copies.emplace_back();
+		copy.bufferOffset = offset;
+		copy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		copy.imageOffset = { static_cast<int32_t>(slot_x * m_config.page_size), static_cast<int32_t>(slot_y * m_config.page_size), 0 };
+		copy.imageExtent = { m_config.page_size, m_config.page_size, 1 };
+
+		// Cache page x, cache page y, mip, resident
+		indirection_updates.emplace_back(page, slot_x | (slot_y << 8) | (page.mip << 16) | (1u << 24));
+
+		m_in_production.erase(job.page_id);
+		m_ready.pop_front();
+	}
+
+	m_stats.uploads = static_cast<uint32_t>(cache_copies.size());
+
+	std::vector<std::vector<VkBufferImageCopy>> indirection_copies(m_regions.size());
+	for (size_t i = 0; i < indirection_updates.size(); i++)
+	{
+		const auto& [page, value] = indirection_updates[i];
+		const VkDeviceSize offset = indirection_offset + i * sizeof(uint32_t);
+		std::memcpy(m_staging_mapped + offset, &value, sizeof(uint32_t));
+
+		VkBufferImageCopy& copy = indirection_copies[page.region].emplace_back();
+		copy.bufferOffset = offset;
+		copy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, page.mip, 0, 1 };
+		copy.imageOffset = { static_cast<int32_t>(page.x), static_cast<int32_t>(page.y), 0 };
+		copy.imageExtent = { 1, 1, 1 };
+	}
+
+	vmaFlushAllocation(m_logical_device->allocator, m_staging_allocation, 0, VK_WHOLE_SIZE);
+
+	// Page cache
+	if (!cache_copies.empty())
+	{
+		VulkanImage::TransitionLayout(cmd_buffer, m_cache.image,
+			m_cache_initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			c_virtual_texture_stages, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+		vkCmdCopyBufferToImage(cmd_buffer, m_staging_buffer, m_cache.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			static_cast<uint32_t>(cache_copies.size()), cache_copies.data());
+
+		VulkanImage::TransitionLayout(cmd_buffer, m_cache.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, c_virtual_texture_stages, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+
+		m_cache_initialized = true;
+	}
+	else if (!m_cache_initialized)
+	{
+		// Shaders may bind the cache before its first page arrives. Lookups find nothing resident and use their fallback.
+		VulkanImage::TransitionLayout(cmd_buffer, m_cache.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, c_virtual_texture_stages, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+
+		m_cache_initialized = true;
+	}
+
+	// Indirection textures start out with no resident pages
+	for (size_t i = 0; i < m_regions.size(); i++)
+	{
+		VulkanVirtualTextureRegion& region = m_regions[i];
+		if (!region.active || (region.initialized && indirection_copies[i].empty()))
+			continue;
+
+		VulkanImage::TransitionLayout(cmd_buffer, region.indirection.image,
+			region.initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			c_virtual_texture_stages, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+		if (!region.initialized)
+		{
+			VkClearColorValue clear_value{};
+			VkImageSubresourceRange clear_range{ VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+			vkCmdClearColorImage(cmd_buffer, region.indirection.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clear_value, 1, &clear_range);
+
+			// Updates land after the clear
+			VulkanImage::TransitionLayout(cmd_buffer, region.indirection.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+			region.initialized = true;
+		}
+
+		if (!indirection_copies[i].empty())
+		{
+			vkCmdCopyBufferToImage(cmd_buffer, m_staging_buffer, region.indirection.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(indirection_copies[i].size()), indirection_copies[i].data());
+		}
+
+		VulkanImage::TransitionLayout(cmd_buffer, region.indirection.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, c_virtual_texture_stages, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+	}
+
+	// Clear this frame's feedback, so texels the feedback pass doesn't cover request nothing
+	VulkanVirtualTextureFrame& frame = m_frames[m_frame % m_frames.size()];
+	vkCmdFillBuffer(cmd_buffer, frame.feedback_buffer, 0, VK_WHOLE_SIZE, c_empty_feedback);
+
+	VkMemoryBarrier2 barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+	barrier.srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+	barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	barrier.dstStageMask = c_virtual_texture_stages;
+	barrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+	VkDependencyInfo dep_info{};
+	dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dep_info.memoryBarrierCount = 1;
+	dep_info.pMemoryBarriers = &barrier;
+
+	vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+}
+
+void VulkanVirtualTexture::RecordFeedbackReadback(const VkCommandBuffer& cmd_buffer)
+{
+	if (!m_logical_device)
+		return;
+
+	VulkanVirtualTextureFrame& frame = m_frames[m_frame % m_frames.size()];
+
+	VkMemoryBarrier2 barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+	barrier.srcStageMask = c_virtual_texture_stages;
+	barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+	barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+	barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+
+	VkDependencyInfo dep_info{};
+	dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dep_info.memoryBarrierCount = 1;
+	dep_info.pMemoryBarriers = &barrier;
+
+	vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+
+	VkBufferCopy copy{};
+	copy.size = (VkDeviceSize)m_config.feedback_extent.width * m_config.feedback_extent.height * sizeof(uint32_t);
+	vkCmdCopyBuffer(cmd_buffer, frame.feedback_buffer, frame.readback_buffer, 1, &copy);
+
+	// Make the copy visible to the host once the frame's timeline value is reached
+	barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+	barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+	barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+
+	vkCmdPipelineBarrier2(cmd_buffer, &dep_info);
+
+	frame.feedback_recorded = true;
+}
+
+VkBuffer VulkanVirtualTexture::GetFeedbackBuffer()
+{
+	if (m_frames.empty())
+		return VK_NULL_HANDLE;
+
+	return m_frames[m_frame % m_frames.size()].feedback_buffer;
+}
+
+const VkExtent2D& VulkanVirtualTexture::GetFeedbackExtent()
+{
+	return m_config.feedback_extent;
+}
+
+size_t VulkanVirtualTexture::GetFrameIndex()
+{
+	if (m_frames.empty())
+		return 0;
+
+	return static_cast<size_t>(m_frame % m_frames.size());
+}
+
+const VulkanImage& VulkanVirtualTexture::GetCache()
+{
+	return m_cache;
+}
+
+const VulkanImage* VulkanVirtualTexture::GetIndirection(const uint32_t& region)
+{
+	if (region >= m_regions.size() || !m_regions[region].active)
+		return nullptr;
+
+	return &m_regions[region].indirection;
+}
+
+const VulkanVirtualTextureConfig& VulkanVirtualTexture::GetConfig()
+{
+	return m_config;
+}
+
+const VulkanVirtualTextureStats& VulkanVirtualTexture::GetStats()
+{
+	m_stats.resident_pages = static_cast<uint32_t>(m_resident.size());
+	m_stats.pending_pages = static_cast<uint32_t>(m_jobs.size());
+	m_stats.ready_pages = static_cast<uint32_t>(m_ready.size());
+
+	return m_stats;
+}
+
+void VulkanVirtualTexture::ReadFeedback(VulkanVirtualTextureFrame& frame)
+{
+	frame.feedback_recorded = false;
+
+	vmaInvalidateAllocation(m_logical_device->allocator, frame.readback_allocation, 0, VK_WHOLE_SIZE);
+
+	const size_t entry_count = (size_t)m_config.feedback_extent.width * m_config.feedback_extent.height;
+	for (size_t i = 0; i < entry_count; i++)
+	{
+		const uint32_t page_id = frame.readback[i];
+		if (page_id == c_empty_feedback)
+			continue;
+
+		// Ignore anything a shader got wrong
+		const VulkanVirtualPage page = UnpackPage(page_id);
+		if (page.region >= m_regions.size() || !m_regions[page.region].active)
+			continue;
+
+		const VulkanVirtualTextureRegion& region = m_regions[page.region];
+		const uint32_t level_pages = std::max(region.pages_per_side >> page.mip, 1u);
+		if (page.mip >= region.mip_levels || page.x >= level_pages || page.y >= level_pages)
+			continue;
+
+		m_requests[page_id]++;
+	}
+}
+
+void VulkanVirtualTexture::RequestPage(const uint32_t& page_id)
+{
+	const VulkanVirtualPage page = UnpackPage(page_id);
+	const VulkanVirtualPageProducer producer = m_regions[page.region].producer;
+	const uint32_t page_size = m_config.page_size;
+
+	VulkanVirtualPageJob& job = m_jobs.emplace_back();
+	job.page_id = page_id;
+	job.texels = std::make_unique<uint8_t[]>(m_page_bytes);
+
+	uint8_t* texels = job.texels.get();
+	if (!m_compressed)
+	{
+		job.done = JobSystem::Get()->Submit([producer, page, texels, page_size]() { producer(page, texels, page_size); });
+	}
+	else
+	{
+		// Compress on the same worker, so only compressed pages are staged and uploaded
+		BCEncodeInfo encode_info{};
+		encode_info.format = m_block_format;
+		encode_info.quality = m_config.compression_quality;
+		encode_info.width = page_size;
+		encode_info.height = page_size;
+		encode_info.components = 4;
+
+		job.done = JobSystem::Get()->Submit([producer, page, texels, page_size, encode_info]() mutable {
+			std::vector<uint8_t> source((size_t)page_size * page_size * 4);
+			producer(page, source.data(), page_size);
+
+			encode_info.texels = source.data();
+			BlockCompressor::Encode(encode_info, texels);
+		});
+	}
+
+	m_in_production.insert(page_id);
+}
+
+void VulkanVirtualTexture::CollectJobs()
+{
+	for (auto it = m_jobs.begin(); it != m_jobs.end();)
+	{
+		if (it->done.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			it++;
+			continue;
+		}
+
+		it->done.get();
+		m_ready.emplace_back(std::move(*it));
+		it = m_jobs.erase(it);
+	}
+}
+
+uint32_t VulkanVirtualTexture::AcquireSlot()
+{
+	// Prefer an empty slot, otherwise evict the least recently used page not needed this frame
+	uint32_t victim = UINT32_MAX;
+	for (uint32_t i = 0; i < m_slots.size(); i++)
+	{
+		const VulkanVirtualCacheSlot& slot = m_slots[i];
+		if (slot.page_id == UINT32_MAX)
+			return i;
+
+		if (slot.pinned || slot.last_used >= m_frame)
+			continue;
+
+		if (victim == UINT32_MAX || slot.last_used < m_slots[victim].last_used)
+			victim = i;
+	}
+
+	return victim;
+}
+
+bool VulkanVirtualTexture::AllocateStaging(const VkDeviceSize& size, VkDeviceSize& offset)
+{
+	const VkDeviceSize aligned_size = (size + c_staging_alignment - 1) & ~(c_staging_alignment - 1);
+
+	// Allocations never wrap; the skipped tail of the ring is charged to this allocation
+	VkDeviceSize padding = m_staging_head + aligned_size > m_config.staging_size ? m_config.staging_size - m_staging_head : 0;
+	if (m_staging_used + padding + aligned_size > m_config.staging_size)
+		return false;
+
+	offset = padding > 0 ? 0 : m_staging_head;
+	m_staging_head = offset + aligned_size;
+	m_staging_used += padding + aligned_size;
+	m_staging_in_flight.emplace_back(padding + aligned_size, 0);
+
+	return true;
+}
+
+void VulkanVirtualTexture::ReleaseStaging()
+{
+	while (!m_staging_in_flight.empty())
+	{
+		const auto& [bytes, value] = m_staging_in_flight.front();
+		if (value == 0 || !m_logical_device->graphics_timeline.Reached(m_logical_device->handle, value))
+			break;
+
+		m_staging_used -= bytes;
+		m_staging_in_flight.pop_front();
+	}
+
+	if (m_staging_used == 0)
+		m_staging_head = 0;
+}
+
+bool VulkanVirtualTexture::CreateFrame(VulkanVirtualTextureFrame& frame)
+{
+	const VkDeviceSize size = (VkDeviceSize)m_config.feedback_extent.width * m_config.feedback_extent.height * sizeof(uint32_t);
+
+	// Written by the feedback pass
+	VkBufferCreateInfo buffer_info{};
+	buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_info.size = size;
+	buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	VmaAllocationCreateInfo alloc_info{};
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+	if (vmaCreateBuffer(m_logical_device->allocator, &buffer_info, &alloc_info, &frame.feedback_buffer, &frame.feedback_allocation, nullptr) != VK_SUCCESS)
+		return false;
+
+	// Read back through cached host memory where available
+	buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+	alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VmaAllocationInfo allocation_info{};
+	if (vmaCreateBuffer(m_logical_device->allocator, &buffer_info, &alloc_info, &frame.readback_buffer, &frame.readback_allocation, &allocation_info) != VK_SUCCESS)
+		return false;
+
+	frame.readback = static_cast<const uint32_t*>(allocation_info.pMappedData);
+	return true;
+}
+
+void VulkanVirtualTexture::DestroyFrame(VulkanVirtualTextureFrame& frame)
+{
+	if (frame.feedback_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, frame.feedback_buffer, frame.feedback_allocation);
+
+	if (frame.readback_buffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(m_logical_device->allocator, frame.readback_buffer, frame.readback_allocation);
+
+	frame = {};
+}
+
+void VulkanVirtualTexture::DestroyImage(VulkanImage& image)
+{
+	if (image.image == VK_NULL_HANDLE)
+		return;
+
+	vkDestroySampler(m_logical_device->handle, image.sampler, nullptr);
+	vkDestroyImageView(m_logical_device->handle, image.view, nullptr);
+	vmaDestroyImage(m_logical_device->allocator, image.image, image.allocation);
+	image = {};
+}
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <functional>
 #include <algorithm>
 #include <chrono>
+#include <mutex>
+#include <array>
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
@@ -17,11 +19,18 @@
 
 import Vulkan;
 import Aurion.Window;
+import Jobs;
+
+// Descriptor sets available to UI fonts and textures
+constexpr uint32_t c_ui_max_textures = 64;
 
 VulkanWindow::VulkanWindow()
-	: m_handle({}), m_logical_device(nullptr), m_surface({}), m_imgui_context(nullptr), 
+	: m_handle({}), m_logical_device(nullptr), m_surface({}), m_imgui_context(nullptr), m_imgui_descriptor_pool(VK_NULL_HANDLE), m_swapchain_resource(0), m_frame_resource(0), m_viewport_extent({}), m_submitted_frames(0),
+		m_last_graphics_timeline_value(0), m_present_id(0), m_swapchain_first_present_id(1), m_present_slot(0),
+		m_compute_wait_value(0), m_compute_wait_stages(VK_PIPELINE_STAGE_2_NONE), m_compute_recorded(false),
+		m_compute_consumer_stages(VK_PIPELINE_STAGE_2_NONE),
 		m_current_frame(0), m_ui_render_fun(nullptr), m_render_as_ui(false),
-		m_attached(false), m_enabled(true), m_vsync_enabled(true)
+		m_attached(false), m_enabled(true), m_vsync_enabled(true), m_swapchain_dirty(false), m_frame_skipped(false), m_parallel_recording(false)
 {
 
 }
@@ -35,19 +44,21 @@ VulkanWindow::~VulkanWindow()
 	// Wait for logical device
 	vkDeviceWaitIdle(m_logical_device->handle);
 
+	this->ShutdownUI();
+	m_profiler.Destroy();
+
 	// Clean up Frame resources
 	for (auto& frame : m_frames)
 	{
 		// Cleanup Command Pools
 		vkDestroyCommandPool(m_logical_device->handle, frame.graphics_cmd_pool, nullptr);
 		vkDestroyCommandPool(m_logical_device->handle, frame.compute_cmd_pool, nullptr);
+		this->DestroyRecordSlots(frame);
+		frame.transient_pool.Destroy();
 
 		// Cleanup frame sync
-		vkDestroySemaphore(m_logical_device->handle, frame.compute_semaphore, nullptr);
-		vkDestroySemaphore(m_logical_device->handle, frame.graphics_semaphore, nullptr);
 		vkDestroySemaphore(m_logical_device->handle, frame.swapchain_semaphore, nullptr);
-		vkDestroyFence(m_logical_device->handle, frame.compute_fence, nullptr);
-		vkDestroyFence(m_logical_device->handle, frame.graphics_fence, nullptr);
+		vkDestroySemaphore(m_logical_device->handle, frame.present_semaphore, nullptr);
 
 		// Cleanup frame image
 		vkDestroySampler(m_logical_device->handle, frame.image.sampler, nullptr);
@@ -55,6 +66,9 @@ VulkanWindow::~VulkanWindow()
 		vmaDestroyImage(m_logical_device->allocator, frame.image.image, frame.image.allocation);
 	}
 
+	// The device is idle, so every retired swapchain can go
+	this->ReleaseRetiredSwapchains(true);
+
 	// Clean up VkSwapchainKHR image views
 	for (auto& view : m_surface.swapchain.image_views)
 		vkDestroyImageView(m_logical_device->handle, view, nullptr);
@@ -93,12 +107,12 @@ void VulkanWindow::Attach(const Aurion::WindowHandle& handle)
 		_this->m_handle.window->Close();
 	});
 
-	// This will ALWAYS occur outside of normal rendering
+	// This will ALWAYS occur outside of normal rendering. Recreation is deferred to the next frame,
+	//	so a drag-resize only recreates once per frame instead of once per event.
 	glfwSetFramebufferSizeCallback(win, [](GLFWwindow* window, int width, int height) {
 		VulkanWindow* _this = (VulkanWindow*)glfwGetWindowUserPointer(window);
 
-		_this->RecreateSwapchain();
-
+		_this->m_swapchain_dirty = true;
 	});
 
 	m_attached = true;
@@ -185,8 +199,10 @@ void VulkanWindow::Attach(const Aurion::WindowHandle& handle, VulkanDevice* logi
 	RecreateSwapchain();
 
 	// Setup ImGui for this window
-	m_imgui_context = ImGui::CreateContext();
-	ImGui::SetCurrentContext(m_imgui_context);
+	this->InitializeUI();
+
+	// Query pools are created per frame in SetMaxFramesInFlight
+	m_profiler.Initialize(m_logical_device);
 
 	m_attached = true;
 }
@@ -205,88 +221,192 @@ bool VulkanWindow::OnRender()
 		return false;
 
 	// Setup the current frame
-	const VulkanFrame& frame = m_frames[m_current_frame];
+	VulkanFrame& frame = m_frames[m_current_frame];
 
 	// Reset the current frame
 	this->Reset(frame);
 
+	// The frame's previous work is complete, so its timings can be read without waiting
+	m_profiler.BeginFrame(m_current_frame);
+
+	// This frame's wait also retired older frames, along with any swapchains they used
+	this->ReleaseRetiredSwapchains();
+
+	if (m_swapchain_dirty || m_surface.swapchain.handle == VK_NULL_HANDLE)
+		this->RecreateSwapchain();
+
 	// Swap buffers; Bail if this fails
+	m_frame_skipped = false;
 	if (!this->SwapBuffers(frame))
+	{
+		m_frame_skipped = true;
 		return false;
+	}
+
+	// Nothing to render into, e.g. while minimized
+	if (m_frame_skipped)
+		return true;
+
+	// Pick this frame's resolution from the timings of this frame slot's previous use, at the scale it rendered with
+	const float render_scale = m_dynamic_resolution.Update(m_profiler.GetFrameMilliseconds(), frame.render_scale);
+	frame.render_scale = render_scale;
+	frame.render_extent = m_dynamic_resolution.GetRenderExtent(this->GetFullRenderExtent(frame));
+
+	// The UI samples this frame's image directly
+	if (m_render_as_ui)
+		this->UpdateUITexture(frame);
 
 	// Begin command buffer recording
 	this->Begin(frame);
 
-	VulkanImage::TransitionLayout(
-		frame.graphics_cmd_buffer,
-		frame.image.image,
+	// Describe this frame's work. Barriers between passes are inferred when the graph executes in OnUIRender.
+	m_render_graph.Reset();
+	m_render_graph.SetTransientPool(&frame.transient_pool);
+
+	uint32_t frame_image = m_render_graph.ImportImage("Frame Image", frame.image.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+
+	// The swapchain image must wait on the acquire semaphore's stage
+	uint32_t swapchain_image = m_render_graph.ImportImage(
+		"Swapchain Image",
+		m_surface.swapchain.images[m_surface.swapchain.current_image_index],
+		VK_IMAGE_ASPECT_COLOR_BIT,
 		VK_IMAGE_LAYOUT_UNDEFINED,
-		VK_IMAGE_LAYOUT_GENERAL
+		VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
 	);
 
-	// Record all commands
-	this->Record(frame);
+	m_render_graph.MarkOutput(swapchain_image, VulkanResourceUsage::Present);
+	m_swapchain_resource = swapchain_image;
+	m_frame_resource = frame_image;
+
+	// Render commands draw into the frame image as a color attachment, loading what earlier commands drew
+	VulkanRenderGraphPass& command_pass = m_render_graph.AddPass("Render Commands")
+		.Write(frame_image, VulkanResourceUsage::ColorAttachmentReadWrite)
+		.Execute([this, &frame](const VkCommandBuffer&) { this->Record(frame); });
+
+	// Images commands share only live within the pass, so they're transients sized with the frame image
+	m_command_image_resources.clear();
+	for (const VulkanCommandImageInfo& command_image : m_command_image_infos)
+	{
+		VulkanTransientImageInfo image_info = command_image.image_info;
+		if (image_info.extent.width == 0 || image_info.extent.height == 0)
+			image_info.extent = frame.image.extent;
+
+		const uint32_t resource = m_render_graph.CreateImage(command_image.name, image_info);
+		command_pass.Write(resource, command_image.usage);
+		m_command_image_resources.emplace_back(resource);
+	}
 
-	// If we want to render the image as a UI texture, do so in OnUIRender
+	// The UI pass samples the image in OnUIRender, with no copy to the swapchain
 	if (m_render_as_ui)
+	{
+		m_render_graph.MarkOutput(frame_image, VulkanResourceUsage::FragmentSampled);
 		return true;
+	}
 
-	this->CopyImageToSwapchain(frame.graphics_cmd_buffer, frame.image.image, frame.image.extent);
+	m_render_graph.AddPass("Copy To Swapchain")
+		.Read(frame_image, VulkanResourceUsage::TransferSrc)
+		.Write(swapchain_image, VulkanResourceUsage::TransferDst)
+		.Execute([this, &frame](const VkCommandBuffer& cmd_buffer) { this->CopyImageToSwapchain(cmd_buffer, frame.image.image, frame.render_extent); });
 
 	return true;
 }
 
 bool VulkanWindow::OnUIRender()
+{
+	if (!this->BuildUI())
+		return false;
+
+	this->RecordFrame();
+
+	// A batch of one, through the same path the renderer batches several windows with
+	m_submit_batch.Clear();
+	if (this->AppendSubmit(m_submit_batch))
+	{
+		m_submit_batch.Submit(*m_logical_device);
+		this->OnPresented(m_submit_batch);
+	}
+
+	return true;
+}
+
+bool VulkanWindow::BuildUI()
 {
 	// Don't attempt to render if not enabled, or the window is no longer open
 	if (!m_enabled || !m_handle.window->IsOpen())
 		return false;
 
-	const VulkanFrame& frame = m_frames[m_current_frame];
+	// Try again next frame, without advancing
+	if (m_frame_skipped)
+		return true;
+
+	// Set ImGui context and build this frame's UI
+	ImGui::SetCurrentContext(m_imgui_context);
+	ImGui_ImplVulkan_NewFrame();
+	ImGui_ImplGlfw_NewFrame();
+	ImGui::NewFrame();
+
+	// Editor windows, including the viewport, dock around the main window
+	if (m_render_as_ui)
+		ImGui::DockSpaceOverViewport();
 
 	if (m_ui_render_fun)
-	{
-		// Set ImGui context and render UI
-		ImGui::SetCurrentContext(m_imgui_context);
+		m_ui_render_fun();
 
-		// Transition render image into a valid format for UI rendering
+	ImGui::Render();
 
-		if (m_render_as_ui) 
-		{
-			//	- Add ui render image to ui context
-		}
+	// Draw the UI over the swapchain image
+	ImDrawData* draw_data = ImGui::GetDrawData();
+	if (draw_data && draw_data->CmdListsCount > 0)
+	{
+		VulkanRenderGraphPass& ui_pass = m_render_graph.AddPass("UI")
+			.Write(m_swapchain_resource, m_render_as_ui ? VulkanResourceUsage::ColorAttachmentWrite : VulkanResourceUsage::ColorAttachmentReadWrite)
+			.Execute([this, draw_data](const VkCommandBuffer& cmd_buffer) { this->RenderUI(cmd_buffer, draw_data); });
 
-		m_ui_render_fun();
+		// The viewport samples the frame image, so it must be finished and readable first
+		if (m_render_as_ui)
+			ui_pass.Read(m_frame_resource, VulkanResourceUsage::FragmentSampled);
 	}
 
-	VulkanImage::TransitionLayout(
-		frame.graphics_cmd_buffer,
-		m_surface.swapchain.images[m_surface.swapchain.current_image_index],
-		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-		VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
-	);
+	return true;
+}
 
-	this->End(frame);
+void VulkanWindow::RecordFrame()
+{
+	if (m_frame_skipped)
+		return;
 
-	this->SubmitAndPresent(frame);
+	VulkanFrame& frame = m_frames[m_current_frame];
 
-	// Increase the current frame
-	m_current_frame = (m_current_frame + 1) % m_frames.size();
+	// Record all passes, leaving the swapchain image ready for presentation
+	m_render_graph.Execute(frame.graphics_cmd_buffer, &m_profiler);
 
-	return true;
+	this->End(frame);
 }
 
 void VulkanWindow::Reset(const VulkanFrame& frame)
 {
-	// Reset Fences
-	vkWaitForFences(m_logical_device->handle, 1, &frame.graphics_fence, VK_TRUE, UINT64_MAX);
-	vkWaitForFences(m_logical_device->handle, 1, &frame.compute_fence, VK_TRUE, UINT64_MAX);
-	vkResetFences(m_logical_device->handle, 1, &frame.graphics_fence);
-	vkResetFences(m_logical_device->handle, 1, &frame.compute_fence);
+	// Wait for this frame's previous graphics and compute work in a single call
+	VkSemaphore timelines[] = { m_logical_device->graphics_timeline.handle, m_logical_device->compute_timeline.handle };
+	uint64_t values[] = { frame.graphics_timeline_value, frame.compute_timeline_value };
+
+	VkSemaphoreWaitInfo wait_info{};
+	wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	wait_info.semaphoreCount = 2;
+	wait_info.pSemaphores = timelines;
+	wait_info.pValues = values;
+
+	vkWaitSemaphores(m_logical_device->handle, &wait_info, UINT64_MAX);
 
 	// Opt for command buffer re-use
 	vkResetCommandPool(m_logical_device->handle, frame.graphics_cmd_pool, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
 	vkResetCommandPool(m_logical_device->handle, frame.compute_cmd_pool, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+
+	// Secondary buffers keep their memory, since they're re-recorded every frame
+	for (const VulkanRecordSlot& slot : frame.record_slots)
+	{
+		vkResetCommandPool(m_logical_device->handle, slot.graphics_cmd_pool, 0);
+		vkResetCommandPool(m_logical_device->handle, slot.compute_cmd_pool, 0);
+	}
 }
 
 void VulkanWindow::Begin(const VulkanFrame& frame)
@@ -301,32 +421,241 @@ void VulkanWindow::Begin(const VulkanFrame& frame)
 	vkBeginCommandBuffer(frame.compute_cmd_buffer, &frame_begin_info);
 }
 
-void VulkanWindow::Record(const VulkanFrame& frame)
-{
-	// Setup command data
-	VulkanCommand command_data{
-		.window_handle = m_handle,
-		.graphics_buffer = frame.graphics_cmd_buffer,
-		.compute_buffer = frame.compute_cmd_buffer,
-		.render_image = frame.image.image,
-		.render_view = frame.image.view,
-		.render_sampler = frame.image.sampler,
-		.render_extent = frame.image.extent,
-		.render_format = frame.image.format,
-		.swapchain_extent = m_surface.swapchain.extent,
-		.current_frame = m_current_frame
-	};
+void VulkanWindow::Record(VulkanFrame& frame)
+{
+	// The graph has compiled by now, so command images have handles
+	m_command_images.resize(m_command_image_resources.size());
+	for (size_t i = 0; i < m_command_image_resources.size(); i++)
+	{
+		const VulkanRenderGraphResource* resource = m_render_graph.GetResource(m_command_image_resources[i]);
+		const VulkanTransientImageInfo& image_info = m_command_image_infos[i].image_info;
+
+		VulkanImage& image = m_command_images[i];
+		image = {};
+		image.image = resource->image;
+		image.view = resource->view;
+		image.format = image_info.format;
+		image.extent = image_info.extent.width == 0 || image_info.extent.height == 0 ? frame.image.extent : image_info.extent;
+		image.aspect_flags = image_info.aspect_flags;
+	}
+
+	// Gather all commands in execution order: temporary commands first, then bound commands
+	m_record_commands.clear();
+	m_record_names.clear();
+	for (size_t i = 0; i < m_submit_commands.size(); i++)
+	{
+		m_record_commands.emplace_back(&m_submit_commands[i]);
+		m_record_names.emplace_back(&m_submit_command_names[i]);
+	}
+	for (size_t i = 0; i < m_bound_commands.size(); i++)
+	{
+		m_record_commands.emplace_back(&m_bound_commands[i]);
+		m_record_names.emplace_back(&m_bound_command_names[i]);
+	}
+
+	// Time and count the work of every command on both queues. Scopes are allocated up front, so recording threads only write timestamps.
+	m_record_scopes.assign(m_record_commands.size(), { VulkanProfiler::c_invalid_scope, VulkanProfiler::c_invalid_scope });
+	if (m_profiler.Enabled())
+	{
+		for (size_t i = 0; i < m_record_commands.size(); i++)
+		{
+			std::string name = m_record_names[i]->empty() ? "Command " + std::to_string(i) : *m_record_names[i];
+			m_record_scopes[i] = { m_profiler.AddScope(name, false, true), m_profiler.AddScope(name, true, true) };
+		}
+	}
+
+	// Fall back to serial recording if parallel recording is disabled or fails
+	if (!m_parallel_recording || m_record_commands.size() < 2 || !this->RecordParallel(frame))
+	{
+		// Setup command data
+		VulkanCommand command_data{
+			.window_handle = m_handle,
+			.graphics_buffer = frame.graphics_cmd_buffer,
+			.compute_buffer = frame.compute_cmd_buffer,
+			.render_image = frame.image.image,
+			.render_view = frame.image.view,
+			.render_sampler = frame.image.sampler,
+			.render_extent = frame.render_extent,
+			.render_format = frame.image.format,
+			.swapchain_extent = m_surface.swapchain.extent,
+			.command_images = m_command_images,
+			.current_frame = m_current_frame,
+			.compute_recorded = m_compute_recorded,
+			.compute_consumer_stages = m_compute_consumer_stages
+		};
+
+		// Execute all commands directly into the primary buffers
+		for (size_t i = 0; i < m_record_commands.size(); i++)
+		{
+			m_profiler.WriteBegin(frame.graphics_cmd_buffer, m_record_scopes[i].first);
+			m_profiler.WriteBegin(frame.compute_cmd_buffer, m_record_scopes[i].second);
+
+			(*m_record_commands[i])(command_data);
 
-	// Execute all temporary commands
-	for (const auto& command : m_submit_commands)
-		command(command_data);
+			m_profiler.WriteEnd(frame.graphics_cmd_buffer, m_record_scopes[i].first);
+			m_profiler.WriteEnd(frame.compute_cmd_buffer, m_record_scopes[i].second);
+		}
+	}
 
 	// Clear all temporary commands
 	m_submit_commands.clear();
+	m_submit_command_names.clear();
+	m_record_commands.clear();
+	m_record_names.clear();
+}
+
+bool VulkanWindow::RecordParallel(VulkanFrame& frame)
+{
+	JobSystem* jobs = JobSystem::Get();
+
+	// Split commands into one contiguous chunk per thread, including the calling thread
+	const size_t command_count = m_record_commands.size();
+	const size_t chunk_count = std::min(command_count, (size_t)jobs->GetThreadCount() + 1);
+
+	if (!this->CreateRecordSlots(frame, chunk_count))
+	{
+		AURION_ERROR("[VulkanWindow] Failed to create parallel recording resources!");
+		return false;
+	}
+
+	// One flag and stage mask per chunk, so recording threads never share one
+	std::vector<uint8_t> chunk_compute_recorded(chunk_count, 0);
+	std::vector<VkPipelineStageFlags2> chunk_consumer_stages(chunk_count, VK_PIPELINE_STAGE_2_NONE);
+
+	// Secondary buffers don't continue a render pass; commands begin their own rendering
+	VkCommandBufferInheritanceInfo inheritance_info{};
+	inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
+	VkCommandBufferBeginInfo begin_info{
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		.pInheritanceInfo = &inheritance_info
+	};
+
+	jobs->ParallelFor(chunk_count, [&](size_t chunk) {
+		const VulkanRecordSlot& slot = frame.record_slots[chunk];
+
+		vkBeginCommandBuffer(slot.graphics_cmd_buffer, &begin_info);
+		vkBeginCommandBuffer(slot.compute_cmd_buffer, &begin_info);
+
+		bool compute_recorded = false;
+		VkPipelineStageFlags2 consumer_stages = VK_PIPELINE_STAGE_2_NONE;
+
+		VulkanCommand command_data{
+			.window_handle = m_handle,
+			.graphics_buffer = slot.graphics_cmd_buffer,
+			.compute_buffer = slot.compute_cmd_buffer,
+			.render_image = frame.image.image,
+			.render_view = frame.image.view,
+			.render_sampler = frame.image.sampler,
+			.render_extent = frame.render_extent,
+			.render_format = frame.image.format,
+			.swapchain_extent = m_surface.swapchain.extent,
+			.command_images = m_command_images,
+			.current_frame = m_current_frame,
+			.compute_recorded = compute_recorded,
+			.compute_consumer_stages = consumer_stages
+		};
+
+		const size_t first = (chunk * command_count) / chunk_count;
+		const size_t last = ((chunk + 1) * command_count) / chunk_count;
+		for (size_t i = first; i < last; i++)
+		{
+			m_profiler.WriteBegin(slot.graphics_cmd_buffer, m_record_scopes[i].first);
+			m_profiler.WriteBegin(slot.compute_cmd_buffer, m_record_scopes[i].second);
 
-	// Execute all bound commands
-	for (const auto& command : m_bound_commands)
-		command(command_data);
+			(*m_record_commands[i])(command_data);
+
+			m_profiler.WriteEnd(slot.graphics_cmd_buffer, m_record_scopes[i].first);
+			m_profiler.WriteEnd(slot.compute_cmd_buffer, m_record_scopes[i].second);
+		}
+
+		vkEndCommandBuffer(slot.graphics_cmd_buffer);
+		vkEndCommandBuffer(slot.compute_cmd_buffer);
+
+		chunk_compute_recorded[chunk] = compute_recorded ? 1 : 0;
+		chunk_consumer_stages[chunk] = consumer_stages;
+	});
+
+	for (size_t i = 0; i < chunk_count; i++)
+	{
+		m_compute_recorded = m_compute_recorded || chunk_compute_recorded[i] != 0;
+		m_compute_consumer_stages |= chunk_consumer_stages[i];
+	}
+
+	// Execute chunks in order, so results match serial recording
+	std::vector<VkCommandBuffer> graphics_buffers(chunk_count);
+	std::vector<VkCommandBuffer> compute_buffers(chunk_count);
+	for (size_t i = 0; i < chunk_count; i++)
+	{
+		graphics_buffers[i] = frame.record_slots[i].graphics_cmd_buffer;
+		compute_buffers[i] = frame.record_slots[i].compute_cmd_buffer;
+	}
+
+	vkCmdExecuteCommands(frame.graphics_cmd_buffer, (uint32_t)chunk_count, graphics_buffers.data());
+	vkCmdExecuteCommands(frame.compute_cmd_buffer, (uint32_t)chunk_count, compute_buffers.data());
+
+	return true;
+}
+
+bool VulkanWindow::CreateRecordSlots(VulkanFrame& frame, const size_t& slot_count)
+{
+	if (frame.record_slots.size() >= slot_count)
+		return true;
+
+	size_t create_index = frame.record_slots.size();
+	frame.record_slots.resize(slot_count);
+
+	for (; create_index < slot_count; create_index++)
+	{
+		VulkanRecordSlot& slot = frame.record_slots[create_index];
+
+		VkCommandPoolCreateInfo pool_info{};
+		pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+		VkCommandBufferAllocateInfo buffer_info{};
+		buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		buffer_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		buffer_info.commandBufferCount = 1;
+
+		// Graphics
+		pool_info.queueFamilyIndex = m_logical_device->graphics_queue_index.value();
+		if (vkCreateCommandPool(m_logical_device->handle, &pool_info, nullptr, &slot.graphics_cmd_pool) != VK_SUCCESS)
+		{
+			frame.record_slots.resize(create_index);
+			return false;
+		}
+
+		buffer_info.commandPool = slot.graphics_cmd_pool;
+		vkAllocateCommandBuffers(m_logical_device->handle, &buffer_info, &slot.graphics_cmd_buffer);
+
+		// Compute
+		pool_info.queueFamilyIndex = m_logical_device->compute_queue_index.value();
+		if (vkCreateCommandPool(m_logical_device->handle, &pool_info, nullptr, &slot.compute_cmd_pool) != VK_SUCCESS)
+		{
+			vkDestroyCommandPool(m_logical_device->handle, slot.graphics_cmd_pool, nullptr);
+			frame.record_slots.resize(create_index);
+			return false;
+		}
+
+		buffer_info.commandPool = slot.compute_cmd_pool;
+		vkAllocateCommandBuffers(m_logical_device->handle, &buffer_info, &slot.compute_cmd_buffer);
+	}
+
+	return true;
+}
+
+void VulkanWindow::DestroyRecordSlots(VulkanFrame& frame)
+{
+	// Destroying the pools frees their command buffers
+	for (const VulkanRecordSlot& slot : frame.record_slots)
+	{
+		vkDestroyCommandPool(m_logical_device->handle, slot.graphics_cmd_pool, nullptr);
+		vkDestroyCommandPool(m_logical_device->handle, slot.compute_cmd_pool, nullptr);
+	}
+
+	frame.record_slots.clear();
 }
 
 void VulkanWindow::End(const VulkanFrame& frame)
@@ -337,6 +666,12 @@ void VulkanWindow::End(const VulkanFrame& frame)
 
 bool VulkanWindow::SwapBuffers(const VulkanFrame& frame)
 {
+	if (m_surface.swapchain.handle == VK_NULL_HANDLE)
+	{
+		m_frame_skipped = true;
+		return true;
+	}
+
 	// Grab swapchain image
 	VkResult acquire_result = vkAcquireNextImageKHR(
 		m_logical_device->handle,
@@ -347,13 +682,40 @@ bool VulkanWindow::SwapBuffers(const VulkanFrame& frame)
 		&m_surface.swapchain.current_image_index
 	);
 
-	// Recreate swapchain if needed
+	// Recreate the swapchain and try once more. A failed acquire doesn't signal the semaphore, so it can be re-used.
 	if (acquire_result == VK_ERROR_OUT_OF_DATE_KHR)
 	{
-		AURION_ERROR("SWAPCHAIN IS OUT OF DATE");
-		this->RecreateSwapchain();
+		if (!this->RecreateSwapchain())
+		{
+			m_frame_skipped = true;
+			return true;
+		}
+
+		acquire_result = vkAcquireNextImageKHR(
+			m_logical_device->handle,
+			m_surface.swapchain.handle,
+			UINT64_MAX,
+			frame.swapchain_semaphore,
+			nullptr,
+			&m_surface.swapchain.current_image_index
+		);
+	}
+
+	// The image is still presentable; recreate once this frame is done with it
+	if (acquire_result == VK_SUBOPTIMAL_KHR)
+	{
+		m_swapchain_dirty = true;
+		return true;
+	}
+
+	if (acquire_result == VK_ERROR_OUT_OF_DATE_KHR)
+	{
+		m_swapchain_dirty = true;
+		m_frame_skipped = true;
+		return true;
 	}
-	else if (acquire_result != VK_SUCCESS && acquire_result == VK_SUBOPTIMAL_KHR)
+
+	if (acquire_result != VK_SUCCESS)
 	{
 		AURION_CRITICAL("[Vulkan Window] Failed to acquire swapchain image!");
 		return false;
@@ -362,88 +724,308 @@ bool VulkanWindow::SwapBuffers(const VulkanFrame& frame)
 	return true;
 }
 
-void VulkanWindow::SubmitAndPresent(const VulkanFrame& frame)
+void VulkanWindow::ReleaseRetiredSwapchains(const bool& force)
 {
-	// Submit all commands
+	// Retired in order, so stop at the first that may still be in use. Presentation has no completion
+	//	signal, so a swapchain is also kept until every frame slot has been re-used since.
+	while (!m_retired_swapchains.empty())
 	{
-		VkCommandBufferSubmitInfo graphics_cmd_buffer_info{};
-		graphics_cmd_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
-		graphics_cmd_buffer_info.commandBuffer = frame.graphics_cmd_buffer;
+		VulkanRetiredSwapchain& retired = m_retired_swapchains.front();
+
+		if (!force)
+		{
+			if (m_submitted_frames < retired.submitted_frames + m_frames.size())
+				break;
+
+			if (!m_logical_device->graphics_timeline.Reached(m_logical_device->handle, retired.graphics_timeline_value))
+				break;
+		}
+
+		for (const VkImageView& view : retired.image_views)
+			vkDestroyImageView(m_logical_device->handle, view, nullptr);
+
+		vkDestroySwapchainKHR(m_logical_device->handle, retired.handle, nullptr);
+
+		for (const VulkanImage& image : retired.frame_images)
+		{
+			vkDestroySampler(m_logical_device->handle, image.sampler, nullptr);
+			vkDestroyImageView(m_logical_device->handle, image.view, nullptr);
+			vmaDestroyImage(m_logical_device->allocator, image.image, image.allocation);
+		}
+
+		m_retired_swapchains.pop_front();
+	}
+}
+
+bool VulkanWindow::AppendSubmit(VulkanSubmitBatch& batch)
+{
+	if (m_frame_skipped)
+		return false;
+
+	VulkanFrame& frame = m_frames[m_current_frame];
+
+	VulkanTimeline& graphics_timeline = m_logical_device->graphics_timeline;
+	VulkanTimeline& compute_timeline = m_logical_device->compute_timeline;
+
+	m_profiler.EndFrame();
+
+	// Skip compute entirely if no command recorded into it. Its buffer may only hold profiler timestamps.
+	const bool submit_compute = m_compute_recorded;
+
+	// Reserve the values this frame's submissions will signal. Batches are submitted in append order, so values stay increasing.
+	frame.compute_timeline_value = submit_compute ? compute_timeline.Next() : 0;
+	frame.graphics_timeline_value = graphics_timeline.Next();
 
-		VkCommandBufferSubmitInfo compute_cmd_buffer_info{};
+	// Graphics waits on this frame's compute work from the stages that read it, and on any scheduled jobs it consumes
+	uint64_t compute_wait_value = m_compute_wait_value;
+	VkPipelineStageFlags2 compute_wait_stages = m_compute_wait_stages;
+	if (submit_compute)
+	{
+		compute_wait_value = std::max(compute_wait_value, frame.compute_timeline_value);
+		compute_wait_stages |= m_compute_consumer_stages != VK_PIPELINE_STAGE_2_NONE ? m_compute_consumer_stages : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+	}
+
+	m_compute_wait_value = 0;
+	m_compute_wait_stages = VK_PIPELINE_STAGE_2_NONE;
+	m_compute_recorded = false;
+	m_compute_consumer_stages = VK_PIPELINE_STAGE_2_NONE;
+
+	// Compute signals its timeline once all of its work completes
+	if (submit_compute)
+	{
+		VkCommandBufferSubmitInfo& compute_cmd_buffer_info = batch.cmd_buffer_infos.emplace_back();
 		compute_cmd_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
 		compute_cmd_buffer_info.commandBuffer = frame.compute_cmd_buffer;
 
-		VkSemaphoreSubmitInfo graphics_signal_semaphore_info{};
-		graphics_signal_semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-		graphics_signal_semaphore_info.stageMask = VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT;
-		graphics_signal_semaphore_info.semaphore = frame.graphics_semaphore;
+		std::array<VkSemaphoreSubmitInfo, 2>& compute_signal_infos = batch.semaphore_infos.emplace_back();
+		compute_signal_infos[0] = compute_timeline.SubmitInfo(frame.compute_timeline_value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+		VkSubmitInfo2& compute_submit_info = batch.compute_submits.emplace_back();
+		compute_submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+		compute_submit_info.commandBufferInfoCount = 1;
+		compute_submit_info.pCommandBufferInfos = &compute_cmd_buffer_info;
+		compute_submit_info.signalSemaphoreInfoCount = 1;
+		compute_submit_info.pSignalSemaphoreInfos = compute_signal_infos.data();
+	}
 
-		VkSemaphoreSubmitInfo compute_signal_semaphore_info{};
-		compute_signal_semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-		compute_signal_semaphore_info.stageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-		compute_signal_semaphore_info.semaphore = frame.compute_semaphore;
+	// Graphics waits on the swapchain image, and on compute only if it consumes compute results
+	{
+		VkCommandBufferSubmitInfo& graphics_cmd_buffer_info = batch.cmd_buffer_infos.emplace_back();
+		graphics_cmd_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+		graphics_cmd_buffer_info.commandBuffer = frame.graphics_cmd_buffer;
 
-		VkSemaphoreSubmitInfo wait_semaphore_info{};
-		wait_semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-		wait_semaphore_info.stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
-		wait_semaphore_info.semaphore = frame.swapchain_semaphore;
+		std::array<VkSemaphoreSubmitInfo, 2>& graphics_wait_infos = batch.semaphore_infos.emplace_back();
+		graphics_wait_infos[0].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+		graphics_wait_infos[0].stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+		graphics_wait_infos[0].semaphore = frame.swapchain_semaphore;
+		graphics_wait_infos[1] = compute_timeline.SubmitInfo(compute_wait_value, compute_wait_stages);
 
-		VkSubmitInfo2 graphics_submit_info{};
+		// Graphics signals its timeline and the binary semaphore presentation waits on
+		std::array<VkSemaphoreSubmitInfo, 2>& graphics_signal_infos = batch.semaphore_infos.emplace_back();
+		graphics_signal_infos[0] = graphics_timeline.SubmitInfo(frame.graphics_timeline_value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+		graphics_signal_infos[1].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+		graphics_signal_infos[1].stageMask = VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT;
+		graphics_signal_infos[1].semaphore = frame.present_semaphore;
+
+		VkSubmitInfo2& graphics_submit_info = batch.graphics_submits.emplace_back();
 		graphics_submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
 		graphics_submit_info.commandBufferInfoCount = 1;
 		graphics_submit_info.pCommandBufferInfos = &graphics_cmd_buffer_info;
-		graphics_submit_info.signalSemaphoreInfoCount = 1;
-		graphics_submit_info.pSignalSemaphoreInfos = &graphics_signal_semaphore_info;
-		graphics_submit_info.waitSemaphoreInfoCount = 1;
-		graphics_submit_info.pWaitSemaphoreInfos = &wait_semaphore_info;
+		graphics_submit_info.waitSemaphoreInfoCount = compute_wait_value > 0 ? 2 : 1;
+		graphics_submit_info.pWaitSemaphoreInfos = graphics_wait_infos.data();
+		graphics_submit_info.signalSemaphoreInfoCount = 2;
+		graphics_submit_info.pSignalSemaphoreInfos = graphics_signal_infos.data();
+	}
 
-		VkSubmitInfo2 compute_submit_info{};
-		compute_submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-		compute_submit_info.commandBufferInfoCount = 1;
-		compute_submit_info.pCommandBufferInfos = &compute_cmd_buffer_info;
-		compute_submit_info.signalSemaphoreInfoCount = 1;
-		compute_submit_info.pSignalSemaphoreInfos = &compute_signal_semaphore_info;
+	// Present the image once graphics work completes. Present ids tag each present, so the frame pacer can wait for it to reach the display.
+	if (m_logical_device->present_wait_supported)
+		m_present_id++;
 
-		// Submit Graphics Queue
-		vkQueueSubmit2(m_logical_device->graphics_queue, 1, &graphics_submit_info, frame.graphics_fence);
+	m_present_slot = batch.swapchains.size();
+	batch.present_queues.push_back(m_surface.present_queue);
+	batch.swapchains.push_back(m_surface.swapchain.handle);
+	batch.image_indices.push_back(m_surface.swapchain.current_image_index);
+	batch.present_semaphores.push_back(frame.present_semaphore);
+	batch.present_ids.push_back(m_logical_device->present_wait_supported ? m_present_id : 0);
+	batch.present_results.push_back(VK_SUCCESS);
 
-		// Submit Compute Queue
-		vkQueueSubmit2(m_logical_device->compute_queue, 1, &compute_submit_info, frame.compute_fence);
+	return true;
+}
+
+void VulkanWindow::OnPresented(const VulkanSubmitBatch& batch)
+{
+	if (m_frame_skipped)
+		return;
+
+	if (!batch.submitted)
+	{
+		this->DiscardFrame(m_frames[m_current_frame]);
+		return;
+	}
+
+	m_submitted_frames++;
+	m_last_graphics_timeline_value = m_frames[m_current_frame].graphics_timeline_value;
+
+	// Recreate before the next acquire
+	VkResult present_result = batch.present_results[m_present_slot];
+	if (present_result == VK_ERROR_OUT_OF_DATE_KHR || present_result == VK_SUBOPTIMAL_KHR)
+		m_swapchain_dirty = true;
+
+	// Increase the current frame
+	m_current_frame = (m_current_frame + 1) % m_frames.size();
+}
+
+void VulkanWindow::DiscardFrame(VulkanFrame& frame)
+{
+	AURION_WARN("[Vulkan Window] Frame %d was never submitted. Recreating its swapchain.", m_current_frame);
+
+	// Nothing will signal the reserved values, so waiting on them before the slot's next use would never return.
+	//	Later frames signal higher values, which anything else stamped with them waits on instead.
+	frame.graphics_timeline_value = 0;
+	frame.compute_timeline_value = 0;
+
+	// The acquire's signal was never waited on, so the semaphore can't be acquired with again. It may still be
+	//	pending, and only an idle device guarantees it isn't.
+	vkDeviceWaitIdle(m_logical_device->handle);
+	vkDestroySemaphore(m_logical_device->handle, frame.swapchain_semaphore, nullptr);
+
+	VkSemaphoreCreateInfo sem_info{};
+	sem_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	if (vkCreateSemaphore(m_logical_device->handle, &sem_info, nullptr, &frame.swapchain_semaphore) != VK_SUCCESS)
+		AURION_ERROR("[Vulkan Window] Frame %d: Failed to create swapchain semaphore!", m_current_frame);
+
+	// The acquired image is never presented, so it's only returned with its swapchain
+	m_swapchain_dirty = true;
+}
+
+void VulkanSubmitBatch::Clear()
+{
+	submitted = false;
+
+	cmd_buffer_infos.clear();
+	semaphore_infos.clear();
+	compute_submits.clear();
+	graphics_submits.clear();
+
+	present_queues.clear();
+	swapchains.clear();
+	image_indices.clear();
+	present_semaphores.clear();
+	present_ids.clear();
+	present_results.clear();
+}
+
+bool VulkanSubmitBatch::Submit(const VulkanDevice& logical_device)
+{
+	submitted = false;
+
+	// Compute first, so graphics waits never precede the signals they depend on. Graphics would wait forever on
+	//	compute values that were never submitted.
+	if (!compute_submits.empty() && vkQueueSubmit2(logical_device.compute_queue, static_cast<uint32_t>(compute_submits.size()), compute_submits.data(), VK_NULL_HANDLE) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Submit Batch] Failed to submit compute work!");
+		return false;
+	}
+
+	// Presents wait on binary semaphores only graphics signals
+	if (!graphics_submits.empty() && vkQueueSubmit2(logical_device.graphics_queue, static_cast<uint32_t>(graphics_submits.size()), graphics_submits.data(), VK_NULL_HANDLE) != VK_SUCCESS)
+	{
+		AURION_ERROR("[Vulkan Submit Batch] Failed to submit graphics work!");
+		return false;
 	}
 
-	// Wait on graphics and comput queues to finish before presenting
-	std::vector<VkSemaphore> wait_semaphores = { frame.graphics_semaphore, frame.compute_semaphore };
+	submitted = true;
+
+	// One present per present queue, covering every swapchain presented from it
+	std::vector<VkSwapchainKHR> queue_swapchains;
+	std::vector<uint32_t> queue_image_indices;
+	std::vector<VkSemaphore> queue_semaphores;
+	std::vector<uint64_t> queue_present_ids;
+	std::vector<VkResult> queue_results;
+	std::vector<size_t> queue_slots;
+	std::vector<bool> presented(swapchains.size(), false);
+
+	for (size_t i = 0; i < swapchains.size(); i++)
+	{
+		if (presented[i])
+			continue;
+
+		queue_swapchains.clear();
+		queue_image_indices.clear();
+		queue_semaphores.clear();
+		queue_present_ids.clear();
+		queue_slots.clear();
+
+		for (size_t j = i; j < swapchains.size(); j++)
+		{
+			if (presented[j] || present_queues[j] != present_queues[i])
+				continue;
+
+			queue_swapchains.push_back(swapchains[j]);
+			queue_image_indices.push_back(image_indices[j]);
+			queue_semaphores.push_back(present_semaphores[j]);
+			queue_present_ids.push_back(present_ids[j]);
+			queue_slots.push_back(j);
+			presented[j] = true;
+		}
+
+		queue_results.assign(queue_slots.size(), VK_SUCCESS);
+
+		VkPresentIdKHR present_id{};
+		present_id.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+		present_id.swapchainCount = static_cast<uint32_t>(queue_present_ids.size());
+		present_id.pPresentIds = queue_present_ids.data();
+
+		VkPresentInfoKHR present_info{};
+		present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+		present_info.pNext = logical_device.present_wait_supported ? &present_id : nullptr;
+		present_info.waitSemaphoreCount = static_cast<uint32_t>(queue_semaphores.size());
+		present_info.pWaitSemaphores = queue_semaphores.data();
+		present_info.swapchainCount = static_cast<uint32_t>(queue_swapchains.size());
+		present_info.pSwapchains = queue_swapchains.data();
+		present_info.pImageIndices = queue_image_indices.data();
+		present_info.pResults = queue_results.data();
 
-	// Present the image
-	VkPresentInfoKHR present_info{};
-	present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-	present_info.waitSemaphoreCount = (uint32_t)wait_semaphores.size();
-	present_info.pWaitSemaphores = wait_semaphores.data();
-	present_info.swapchainCount = 1;
-	present_info.pSwapchains = &m_surface.swapchain.handle;
-	present_info.pImageIndices = &m_surface.swapchain.current_image_index;
+		vkQueuePresentKHR(present_queues[i], &present_info);
 
-	vkQueuePresentKHR(m_surface.present_queue, &present_info);
+		for (size_t k = 0; k < queue_slots.size(); k++)
+			present_results[queue_slots[k]] = queue_results[k];
+	}
+
+	return true;
 }
 
 void VulkanWindow::CopyImageToSwapchain(const VkCommandBuffer& cmd_buffer, const VkImage& image, const VkExtent3D& extent)
 {
-	// Image Layout
-	VulkanImage::TransitionLayout(
-		cmd_buffer,
-		image,
-		VK_IMAGE_LAYOUT_GENERAL,
-		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-	);
+	// Both images are expected in their transfer layouts; the render graph transitions them
+	const VkExtent2D& swapchain_extent = m_surface.swapchain.extent;
 
-	// Swapchain Image Layout
-	VulkanImage::TransitionLayout(
-		cmd_buffer,
-		m_surface.swapchain.images[m_surface.swapchain.current_image_index],
-		VK_IMAGE_LAYOUT_UNDEFINED,
-		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-	);
+	// Scale a dynamic resolution frame up to the swapchain, filtering in the same pass as the copy
+	if (extent.width != swapchain_extent.width || extent.height != swapchain_extent.height)
+	{
+		VkImageBlit2 blit{
+			.sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2,
+			.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+			.srcOffsets = { { 0, 0, 0 }, { (int32_t)extent.width, (int32_t)extent.height, 1 } },
+			.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+			.dstOffsets = { { 0, 0, 0 }, { (int32_t)swapchain_extent.width, (int32_t)swapchain_extent.height, 1 } }
+		};
+
+		VkBlitImageInfo2 blit_info{
+			.sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2,
+			.srcImage = image,
+			.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			.dstImage = m_surface.swapchain.images[m_surface.swapchain.current_image_index],
+			.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			.regionCount = 1,
+			.pRegions = &blit,
+			.filter = VK_FILTER_LINEAR
+		};
+
+		vkCmdBlitImage2(cmd_buffer, &blit_info);
+		return;
+	}
 
 	// Copy frame image to swapchain image
 	VkImageCopy2 region{
@@ -499,10 +1081,111 @@ bool VulkanWindow::Enabled()
 
 void VulkanWindow::SetVSyncEnabled(const bool& enabled)
 {
-	// Set V-Sync
+	if (m_vsync_enabled == enabled)
+		return;
+
+	// Set V-Sync. The present mode changes with the next frame's swapchain.
 	m_vsync_enabled = enabled;
+	m_swapchain_dirty = true;
+}
 
-	RecreateSwapchain();
+void VulkanWindow::SetRenderAsUI(const bool& enabled)
+{
+	m_render_as_ui = enabled;
+}
+
+bool VulkanWindow::RenderAsUI()
+{
+	return m_render_as_ui;
+}
+
+void VulkanWindow::DrawViewport(const char* title)
+{
+	if (!m_render_as_ui || m_frames.empty())
+		return;
+
+	const VulkanFrame& frame = m_frames[m_current_frame];
+
+	ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
+	if (ImGui::Begin(title))
+	{
+		const ImVec2 available = ImGui::GetContentRegionAvail();
+		m_viewport_extent = VkExtent2D{
+			static_cast<uint32_t>(std::max(available.x, 1.0f)),
+			static_cast<uint32_t>(std::max(available.y, 1.0f))
+		};
+
+		// The rendered region takes the viewport's aspect ratio, a frame behind any resize. Fit it, centered in the
+		//	window; sampling scales it up to the window's size.
+		const VkExtent3D& image_extent = frame.image.extent;
+		const VkExtent3D& render_extent = frame.render_extent;
+		if (frame.ui_texture != VK_NULL_HANDLE && render_extent.width > 0 && render_extent.height > 0)
+		{
+			const float scale = std::min(available.x / render_extent.width, available.y / render_extent.height);
+			const ImVec2 size(render_extent.width * scale, render_extent.height * scale);
+			const ImVec2 uv_max((float)render_extent.width / image_extent.width, (float)render_extent.height / image_extent.height);
+
+			const ImVec2 cursor = ImGui::GetCursorPos();
+			ImGui::SetCursorPos(ImVec2(cursor.x + (available.x - size.x) * 0.5f, cursor.y + (available.y - size.y) * 0.5f));
+			ImGui::Image((ImTextureID)frame.ui_texture, size, ImVec2(0.0f, 0.0f), uv_max);
+		}
+	}
+	ImGui::End();
+	ImGui::PopStyleVar();
+}
+
+const VkExtent2D& VulkanWindow::GetViewportExtent()
+{
+	return m_viewport_extent;
+}
+
+VkExtent3D VulkanWindow::GetFullRenderExtent(const VulkanFrame& frame)
+{
+	const VkExtent3D& image_extent = frame.image.extent;
+	const VkExtent2D& viewport = this->GetViewportExtent();
+	if (!m_render_as_ui || viewport.width == 0 || viewport.height == 0)
+		return image_extent;
+
+	// Shrunk to fit within the frame image, keeping the viewport's aspect ratio
+	const float scale = std::min({ 1.0f,
+		static_cast<float>(image_extent.width) / viewport.width,
+		static_cast<float>(image_extent.height) / viewport.height });
+
+	return VkExtent3D{
+		std::clamp(static_cast<uint32_t>(viewport.width * scale), 1u, image_extent.width),
+		std::clamp(static_cast<uint32_t>(viewport.height * scale), 1u, image_extent.height),
+		1
+	};
+}
+
+void VulkanWindow::SetDynamicResolution(const VulkanDynamicResolutionConfig& config)
+{
+	m_dynamic_resolution.Configure(config);
+}
+
+VulkanDynamicResolution* VulkanWindow::GetDynamicResolution()
+{
+	return &m_dynamic_resolution;
+}
+
+void VulkanWindow::WaitForPresent(const uint64_t& timeout)
+{
+	if (!m_attached || m_submitted_frames == 0)
+		return;
+
+	// Wait for the display, when the last present went to the current swapchain
+	if (m_logical_device->present_wait_supported && m_surface.swapchain.handle != VK_NULL_HANDLE && m_present_id >= m_swapchain_first_present_id)
+	{
+		VkResult result = m_logical_device->wait_for_present(m_logical_device->handle, m_surface.swapchain.handle, m_present_id, timeout);
+
+		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+			m_swapchain_dirty = true;
+
+		return;
+	}
+
+	// Otherwise the frame's GPU work finishing is the closest available signal
+	m_logical_device->graphics_timeline.Wait(m_logical_device->handle, m_last_graphics_timeline_value, timeout);
 }
 
 void VulkanWindow::SetMaxFramesInFlight(const uint32_t& max_in_flight_frames)
@@ -516,24 +1199,34 @@ void VulkanWindow::SetMaxFramesInFlight(const uint32_t& max_in_flight_frames)
 		{
 			VulkanFrame& frame = m_frames[m_frames.size() - 1 - i];
 
+			// Ensure the frame's work has completed before destroying its resources
+			m_logical_device->graphics_timeline.Wait(m_logical_device->handle, frame.graphics_timeline_value);
+			m_logical_device->compute_timeline.Wait(m_logical_device->handle, frame.compute_timeline_value);
+
 			// Cleanup Command Pools
 			vkDestroyCommandPool(m_logical_device->handle, frame.graphics_cmd_pool, nullptr);
 			vkDestroyCommandPool(m_logical_device->handle, frame.compute_cmd_pool, nullptr);
+			this->DestroyRecordSlots(frame);
+			frame.transient_pool.Destroy();
 
 			// Cleanup sync objects
-			vkDestroySemaphore(m_logical_device->handle, frame.compute_semaphore, nullptr);
-			vkDestroySemaphore(m_logical_device->handle, frame.graphics_semaphore, nullptr);
 			vkDestroySemaphore(m_logical_device->handle, frame.swapchain_semaphore, nullptr);
-			vkDestroyFence(m_logical_device->handle, frame.compute_fence, nullptr);
-			vkDestroyFence(m_logical_device->handle, frame.graphics_fence, nullptr);
+			vkDestroySemaphore(m_logical_device->handle, frame.present_semaphore, nullptr);
 		
-			// Cleanup render image
+			// Cleanup render image, and its UI registration
+			if (frame.ui_texture != VK_NULL_HANDLE)
+			{
+				ImGui::SetCurrentContext(m_imgui_context);
+				ImGui_ImplVulkan_RemoveTexture(frame.ui_texture);
+			}
+
 			vkDestroySampler(m_logical_device->handle, frame.image.sampler, nullptr);
 			vkDestroyImageView(m_logical_device->handle, frame.image.view, nullptr);
 			vmaDestroyImage(m_logical_device->allocator, frame.image.image, frame.image.allocation);
 		}
 
 		m_frames.resize(max_in_flight_frames);
+		m_profiler.Resize(max_in_flight_frames);
 		return;
 	}
 
@@ -542,6 +1235,7 @@ void VulkanWindow::SetMaxFramesInFlight(const uint32_t& max_in_flight_frames)
 
 	// Resize
 	m_frames.resize(max_in_flight_frames);
+	m_profiler.Resize(max_in_flight_frames);
 	
 	// Determine the starting index for resource creation
 	size_t create_index = m_frames.size() - create_count;
@@ -571,9 +1265,16 @@ void VulkanWindow::SetMaxFramesInFlight(const uint32_t& max_in_flight_frames)
 
 			create_info.aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
 
+			// Frame images are written by both the graphics and compute queues
+			create_info.queue_family_indices = m_logical_device->queue_families.data();
+			create_info.queue_family_count = static_cast<uint32_t>(m_logical_device->queue_families.size());
+
 			frame.image = VulkanImage::Create(m_logical_device->handle, m_logical_device->allocator, create_info);
 		}
 
+		// Transient resources are only allocated once a render graph requests them
+		frame.transient_pool.Initialize(m_logical_device->handle, m_logical_device->allocator);
+
 		// Graphics/Compute Command Pool Creation
 		{
 			VkCommandPoolCreateInfo pool_info{};
@@ -623,74 +1324,37 @@ void VulkanWindow::SetMaxFramesInFlight(const uint32_t& max_in_flight_frames)
 			}
 		}
 
-		// Graphics/Compute Fences
-		{
-			VkFenceCreateInfo fence_info{};
-			fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-			fence_info.pNext = nullptr;
-			fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-			// Graphics Fence
-			if (vkCreateFence(m_logical_device->handle, &fence_info, nullptr, &frame.graphics_fence) != VK_SUCCESS)
-			{
-				AURION_ERROR("[VulkanWindow] Frame %d: Failed to create graphics fence!", create_index);
-				return;
-			}
-
-			// Compute Fence
-			if (vkCreateFence(m_logical_device->handle, &fence_info, nullptr, &frame.compute_fence) != VK_SUCCESS)
-			{
-				AURION_ERROR("[VulkanWindow] Frame %d: Failed to create compute fence!", create_index);
-				return;
-			}
-		}
-
-		// Graphics/Compute Semaphores
+		// Swapchain/Present Semaphores. Queue work is tracked by the device's timelines.
 		{
 			VkSemaphoreCreateInfo sem_info{};
 			sem_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 			sem_info.pNext = nullptr;
 			sem_info.flags = 0;
 
-			// Graphics Semaphore
-			if (vkCreateSemaphore(m_logical_device->handle, &sem_info, nullptr, &frame.graphics_semaphore) != VK_SUCCESS)
-			{
-				AURION_ERROR("[VulkanWindow] Frame %d: Failed to create graphics semaphore!", create_index);
-				return;
-			}
-
-			// Compute Semaphore
-			if (vkCreateSemaphore(m_logical_device->handle, &sem_info, nullptr, &frame.compute_semaphore) != VK_SUCCESS)
+			// Swapchain Semaphore
+			if (vkCreateSemaphore(m_logical_device->handle, &sem_info, nullptr, &frame.swapchain_semaphore) != VK_SUCCESS)
 			{
-				AURION_ERROR("[VulkanWindow] Frame %d: Failed to create compute semaphore!", create_index);
+				AURION_ERROR("[VulkanWindow] Frame %d: Failed to create swapchain semaphore!", create_index);
 				return;
 			}
 
-			// Swapchain Semaphore
-			if (vkCreateSemaphore(m_logical_device->handle, &sem_info, nullptr, &frame.swapchain_semaphore) != VK_SUCCESS)
+			// Present Semaphore
+			if (vkCreateSemaphore(m_logical_device->handle, &sem_info, nullptr, &frame.present_semaphore) != VK_SUCCESS)
 			{
-				AURION_ERROR("[VulkanWindow] Frame %d: Failed to create swapchain semaphore!", create_index);
+				AURION_ERROR("[VulkanWindow] Frame %d: Failed to create present semaphore!", create_index);
 				return;
 			}
 		}
 	}
 }
 
-void VulkanWindow::RecreateSwapchain()
+bool VulkanWindow::RecreateSwapchain()
 {
-	// Wait for GPU to finish work
-	vkDeviceWaitIdle(m_logical_device->handle);
-
-	// Cleanup old swapchain resources
-	if (m_surface.swapchain.handle != VK_NULL_HANDLE)
-	{
-		// Image views
-		for (size_t i = 0; i < m_surface.swapchain.image_views.size(); i++)
-			vkDestroyImageView(m_logical_device->handle, m_surface.swapchain.image_views[i], nullptr);
-
-		// Swapchain
-		vkDestroySwapchainKHR(m_logical_device->handle, m_surface.swapchain.handle, nullptr);
-	}
+	// In-flight frames may still use the current swapchain and frame images, so they're retired
+	//	instead of destroyed, and nothing here waits on the device.
+	const VkExtent2D old_extent = m_surface.swapchain.extent;
+	const VkSurfaceFormatKHR old_format = m_surface.swapchain.format;
+	const uint32_t old_min_image_count = m_surface.swapchain.support.capabilities.minImageCount;
 
 	// Query Swapchain support and create swapchain
 	{
@@ -710,7 +1374,7 @@ void VulkanWindow::RecreateSwapchain()
 				"[VulkanWindow] VkSurface %s count(s) are 0. Surface presentation is likely not supported.",
 				format_count == 0 ? (present_mode_count == 0 ? "Format and PresentMode" : "Format") : "PresentMode"
 			);
-			return;
+			return false;
 		}
 
 		// Get surface formats
@@ -740,7 +1404,7 @@ void VulkanWindow::RecreateSwapchain()
 				(m_surface.swapchain.support.present_modes.empty() == 0 ? "Format and PresentMode" : "Format") :
 				"PresentMode"
 			);
-			return;
+			return false;
 		}
 	}
 
@@ -759,14 +1423,17 @@ void VulkanWindow::RecreateSwapchain()
 
 	// Choose Swapchain Present Mode
 	{
-		// Default to the first available present mode
-		m_surface.swapchain.present_mode = m_surface.swapchain.support.present_modes[0];
-		
-		// Prefer v-sync present mode for stability if enabled, 'unlimited' otherwise
-		for (const auto& mode : m_surface.swapchain.support.present_modes)
+		// FIFO is always supported, and is the only mode that never tears or drops frames
+		m_surface.swapchain.present_mode = VK_PRESENT_MODE_FIFO_KHR;
+
+		// Without v-sync, prefer mailbox (no tearing, lowest latency), then immediate
+		if (!m_vsync_enabled)
 		{
-			if ((m_vsync_enabled && mode == VK_PRESENT_MODE_FIFO_KHR) || mode == VK_PRESENT_MODE_MAILBOX_KHR)
-				m_surface.swapchain.present_mode = mode;
+			const std::vector<VkPresentModeKHR>& modes = m_surface.swapchain.support.present_modes;
+			if (std::find(modes.begin(), modes.end(), VK_PRESENT_MODE_MAILBOX_KHR) != modes.end())
+				m_surface.swapchain.present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+			else if (std::find(modes.begin(), modes.end(), VK_PRESENT_MODE_IMMEDIATE_KHR) != modes.end())
+				m_surface.swapchain.present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
 		}
 	}
 
@@ -794,6 +1461,17 @@ void VulkanWindow::RecreateSwapchain()
 		}
 	}
 
+	// A minimized window has no extent. Keep the current swapchain until it's restored.
+	if (m_surface.swapchain.extent.width == 0 || m_surface.swapchain.extent.height == 0)
+	{
+		m_surface.swapchain.extent = old_extent;
+		m_surface.swapchain.format = old_format;
+		return false;
+	}
+
+	// Whether the retired entry for this recreation still has to be added, if frame images need it
+	bool retired_frames_only = false;
+
 	// Create Swapchain
 	{
 		// Assign the number of images we'd like to have in the swap chain, always 1 more than the minimum to avoid waiting for driver operations,
@@ -838,13 +1516,34 @@ void VulkanWindow::RecreateSwapchain()
 		createInfo.presentMode = m_surface.swapchain.present_mode;
 		createInfo.clipped = VK_TRUE; // clips pixels covered by another window
 
-		createInfo.oldSwapchain = VK_NULL_HANDLE;
+		// Lets the presentation engine hand resources over, and keeps presenting already queued images
+		createInfo.oldSwapchain = m_surface.swapchain.handle;
+
+		// The old swapchain is retired by this call even if creation fails
+		VulkanRetiredSwapchain retired{};
+		retired.handle = m_surface.swapchain.handle;
+		retired.image_views = std::move(m_surface.swapchain.image_views);
+		retired.graphics_timeline_value = m_logical_device->graphics_timeline.value;
+		retired.submitted_frames = m_submitted_frames;
+
+		if (retired.handle != VK_NULL_HANDLE)
+			m_retired_swapchains.emplace_back(std::move(retired));
+		else
+			retired_frames_only = true;
+
+		m_surface.swapchain.image_views.clear();
+		m_surface.swapchain.images.clear();
 
 		if (vkCreateSwapchainKHR(m_logical_device->handle, &createInfo, nullptr, &m_surface.swapchain.handle) != VK_SUCCESS)
 		{
 			AURION_ERROR("[VulkanWindow] Failed to create swap chain!");
-			return;
+			m_surface.swapchain.handle = VK_NULL_HANDLE;
+			m_swapchain_dirty = true;
+			return false;
 		}
+
+		// Present ids are per swapchain; earlier ones can't be waited on through this one
+		m_swapchain_first_present_id = m_present_id + 1;
 	}
 
 	// Create Images and Image Views
@@ -885,20 +1584,33 @@ void VulkanWindow::RecreateSwapchain()
 			if (vkCreateImageView(m_logical_device->handle, &createInfo, nullptr, &m_surface.swapchain.image_views[i]) != VK_SUCCESS)
 			{
 				AURION_ERROR("[VulkanWindow] Failed to create image view!");
-				return ;
+				return false;
 			}
 		}
 	}
 
-	// Revalidate Frame ImageData
-	for (size_t i = 0; i < m_frames.size(); i++)
+	// Frame images only need replacing if their extent or format changed, e.g. not for V-Sync toggles
+	const bool frames_changed = old_extent.width != m_surface.swapchain.extent.width ||
+		old_extent.height != m_surface.swapchain.extent.height || old_format.format != m_surface.swapchain.format.format;
+
+	for (size_t i = 0; i < m_frames.size() && frames_changed; i++)
 	{
 		VulkanFrame& frame = m_frames[i];
 
-		// Destroy old frame resources
-		vkDestroySampler(m_logical_device->handle, frame.image.sampler, nullptr);
-		vkDestroyImageView(m_logical_device->handle, frame.image.view, nullptr);
-		vmaDestroyImage(m_logical_device->allocator, frame.image.image, frame.image.allocation);
+		// Retire the old image along with the swapchain it was sized for
+		if (frame.image.image != VK_NULL_HANDLE)
+		{
+			if (retired_frames_only)
+			{
+				m_retired_swapchains.emplace_back(VulkanRetiredSwapchain{
+					.graphics_timeline_value = m_logical_device->graphics_timeline.value,
+					.submitted_frames = m_submitted_frames
+				});
+				retired_frames_only = false;
+			}
+
+			m_retired_swapchains.back().frame_images.emplace_back(frame.image);
+		}
 
 		VulkanImageCreateInfo img_create_info{};
 		img_create_info.extent = VkExtent3D{
@@ -918,19 +1630,170 @@ void VulkanWindow::RecreateSwapchain()
 
 		img_create_info.aspect_flags = VK_IMAGE_ASPECT_COLOR_BIT;
 
+		// Frame images are written by both the graphics and compute queues
+		img_create_info.queue_family_indices = m_logical_device->queue_families.data();
+		img_create_info.queue_family_count = static_cast<uint32_t>(m_logical_device->queue_families.size());
+
 		frame.image = VulkanImage::Create(m_logical_device->handle, m_logical_device->allocator, img_create_info);
 	}
 
+	// UI buffers are sized by the minimum image count
+	if (m_imgui_context && m_surface.swapchain.support.capabilities.minImageCount != old_min_image_count)
+	{
+		ImGui::SetCurrentContext(m_imgui_context);
+		ImGui_ImplVulkan_SetMinImageCount(std::max(2u, m_surface.swapchain.support.capabilities.minImageCount));
+	}
+
 	// Re-enable for rendering
 	m_surface.swapchain.current_image_index = 0;
+	m_swapchain_dirty = false;
+
+	return true;
 }
 
-void VulkanWindow::BindRenderCommand(const std::function<void(const VulkanCommand&)>& command)
+void VulkanWindow::BindRenderCommand(const std::function<void(const VulkanCommand&)>& command, const std::string& name)
 {
 	m_bound_commands.emplace_back(command);
+	m_bound_command_names.emplace_back(name);
 }
 
-void VulkanWindow::SubmitRenderCommand(const std::function<void(const VulkanCommand&)>& command)
+void VulkanWindow::SubmitRenderCommand(const std::function<void(const VulkanCommand&)>& command, const std::string& name)
 {
 	m_submit_commands.emplace_back(command);
+	m_submit_command_names.emplace_back(name);
+}
+
+uint32_t VulkanWindow::DeclareCommandImage(const VulkanCommandImageInfo& image_info)
+{
+	m_command_image_infos.emplace_back(image_info);
+	return static_cast<uint32_t>(m_command_image_infos.size() - 1);
+}
+
+void VulkanWindow::SetParallelRecordingEnabled(const bool& enabled)
+{
+	m_parallel_recording = enabled;
+}
+
+VulkanProfiler* VulkanWindow::GetProfiler()
+{
+	return &m_profiler;
 }
+
+void VulkanWindow::ConsumeCompute(const VulkanComputeTicket& ticket, const VkPipelineStageFlags2& stages)
+{
+	if (ticket.value == 0)
+		return;
+
+	m_compute_wait_value = std::max(m_compute_wait_value, ticket.value);
+	m_compute_wait_stages |= stages;
+}
+
+void VulkanWindow::InitializeUI()
+{
+	m_imgui_context = ImGui::CreateContext();
+	ImGui::SetCurrentContext(m_imgui_context);
+
+	// Lets the viewport and tool windows dock into an editor layout
+	ImGui::GetIO().ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+
+	// Descriptor pool for the font atlas and UI textures
+	VkDescriptorPoolSize pool_size{};
+	pool_size.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	pool_size.descriptorCount = c_ui_max_textures;
+
+	VkDescriptorPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+	pool_info.maxSets = c_ui_max_textures;
+	pool_info.poolSizeCount = 1;
+	pool_info.pPoolSizes = &pool_size;
+
+	if (vkCreateDescriptorPool(m_logical_device->handle, &pool_info, nullptr, &m_imgui_descriptor_pool) != VK_SUCCESS)
+	{
+		AURION_ERROR("[VulkanWindow] Failed to create UI descriptor pool!");
+		return;
+	}
+
+	ImGui_ImplGlfw_InitForVulkan((GLFWwindow*)m_handle.window->GetNativeHandle(), true);
+
+	// UI renders straight into the swapchain image with dynamic rendering
+	ImGui_ImplVulkan_InitInfo init_info{};
+	init_info.Instance = m_logical_device->vk_instance;
+	init_info.PhysicalDevice = m_logical_device->physical_device;
+	init_info.Device = m_logical_device->handle;
+	init_info.QueueFamily = m_logical_device->graphics_queue_index.value();
+	init_info.Queue = m_logical_device->graphics_queue;
+	init_info.DescriptorPool = m_imgui_descriptor_pool;
+	init_info.MinImageCount = std::max(2u, m_surface.swapchain.support.capabilities.minImageCount);
+	init_info.ImageCount = std::max(init_info.MinImageCount, (uint32_t)m_surface.swapchain.images.size());
+	init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+	init_info.UseDynamicRendering = true;
+	init_info.PipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+	init_info.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
+	init_info.PipelineRenderingCreateInfo.pColorAttachmentFormats = &m_surface.swapchain.format.format;
+
+	if (!ImGui_ImplVulkan_Init(&init_info))
+		AURION_ERROR("[VulkanWindow] Failed to initialize the ImGui Vulkan backend!");
+}
+
+void VulkanWindow::ShutdownUI()
+{
+	if (!m_imgui_context)
+		return;
+
+	ImGui::SetCurrentContext(m_imgui_context);
+	ImGui_ImplVulkan_Shutdown();
+	ImGui_ImplGlfw_Shutdown();
+	ImGui::DestroyContext(m_imgui_context);
+	m_imgui_context = nullptr;
+
+	vkDestroyDescriptorPool(m_logical_device->handle, m_imgui_descriptor_pool, nullptr);
+	m_imgui_descriptor_pool = VK_NULL_HANDLE;
+}
+
+void VulkanWindow::RenderUI(const VkCommandBuffer& cmd_buffer, ImDrawData* draw_data)
+{
+	VkRenderingAttachmentInfo color_attachment{
+		.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+		.imageView = m_surface.swapchain.image_views[m_surface.swapchain.current_image_index],
+		.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+		.loadOp = m_render_as_ui ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD,
+		.storeOp = VK_ATTACHMENT_STORE_OP_STORE
+	};
+
+	VkRenderingInfo render_info{
+		.sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+		.renderArea = VkRect2D{
+			.extent = m_surface.swapchain.extent
+		},
+		.layerCount = 1,
+		.colorAttachmentCount = 1,
+		.pColorAttachments = &color_attachment
+	};
+
+	// The ImGui backend reads the current context, which is global. Windows recording in parallel take turns here.
+	static std::mutex ui_record_mutex;
+	std::lock_guard<std::mutex> lock(ui_record_mutex);
+	ImGui::SetCurrentContext(m_imgui_context);
+
+	vkCmdBeginRendering(cmd_buffer, &render_info);
+	ImGui_ImplVulkan_RenderDrawData(draw_data, cmd_buffer);
+	vkCmdEndRendering(cmd_buffer);
+}
+
+void VulkanWindow::UpdateUITexture(VulkanFrame& frame)
+{
+	if (!m_imgui_context || frame.image.view == VK_NULL_HANDLE)
+		return;
+
+	if (frame.ui_texture != VK_NULL_HANDLE && frame.ui_texture_view == frame.image.view)
+		return;
+
+	// Only this frame's command buffers use its descriptor set, and their previous work has completed
+	ImGui::SetCurrentContext(m_imgui_context);
+	if (frame.ui_texture != VK_NULL_HANDLE)
+		ImGui_ImplVulkan_RemoveTexture(frame.ui_texture);
+
+	frame.ui_texture = ImGui_ImplVulkan_AddTexture(frame.image.sampler, frame.image.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	frame.ui_texture_view = frame.image.view;
+}
\ No newline at end of file
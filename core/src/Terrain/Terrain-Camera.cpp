@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <cmath>
+
+import Terrain;
+
+static void Normalize(float v[3])
+{
+	const float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+	if (length <= 0.0f)
+		return;
+
+	v[0] /= length;
+	v[1] /= length;
+	v[2] /= length;
+}
+
+static void Cross(const float a[3], const float b[3], float out[3])
+{
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static float Dot(const float a[3], const float b[3])
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+void TerrainCamera::LookAt(const float target[3])
+{
+	float direction[3] = { target[0] - position[0], target[1] - position[1], target[2] - position[2] };
+	Normalize(direction);
+
+	yaw = std::atan2(direction[0], direction[2]);
+	pitch = std::asin(direction[1]);
+}
+
+void TerrainCamera::GetForward(float out[3]) const
+{
+	out[0] = std::cos(pitch) * std::sin(yaw);
+	out[1] = std::sin(pitch);
+	out[2] = std::cos(pitch) * std::cos(yaw);
+}
+
+void TerrainCamera::ComputeViewProjection(const float& aspect, float out[16]) const
+{
+	// View basis: screen right, screen up and forward
+	const float world_up[3] = { 0.0f, 1.0f, 0.0f };
+	float forward[3];
+	this->GetForward(forward);
+
+	float right[3];
+	Cross(forward, world_up, right);
+	Normalize(right);
+
+	float up[3];
+	Cross(right, forward, up);
+
+	const float scale = this->GetProjectionScale();
+	const float depth_scale = far_plane / (far_plane - near_plane);
+	const float depth_offset = -far_plane * near_plane / (far_plane - near_plane);
+
+	const float rows[4][4] = {
+		{ right[0] * scale / aspect, right[1] * scale / aspect, right[2] * scale / aspect, -Dot(right, position) * scale / aspect },
+		{ -up[0] * scale, -up[1] * scale, -up[2] * scale, Dot(up, position) * scale }, // Vulkan's y points down
+		{ forward[0] * depth_scale, forward[1] * depth_scale, forward[2] * depth_scale, -Dot(forward, position) * depth_scale + depth_offset },
+		{ forward[0], forward[1], forward[2], -Dot(forward, position) }
+	};
+
+	for (uint32_t column = 0; column < 4; column++)
+		for (uint32_t row = 0; row < 4; row++)
+			out[column * 4 + row] = rows[row][column];
+}
+
+float TerrainCamera::GetProjectionScale() const
+{
+	return 1.0f / std::tan(fov_y * 0.5f);
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+import Terrain;
+import Jobs;
+
+TerrainHeightmap::TerrainHeightmap()
+	: m_size(0)
+{
+
+}
+
+TerrainHeightmap::~TerrainHeightmap()
+{
+
+}
+
+void TerrainHeightmap::Generate(const TerrainNoiseConfig& config, const uint32_t& size, const int32_t& origin_x, const int32_t& origin_y)
+{
+	m_size = size;
+	m_heights.assign(static_cast<size_t>(size) * size, 0.0f);
+
+	JobSystem::Get()->ParallelFor(size, [this, &config, origin_x, origin_y](size_t y)
+	{
+		float* row = m_heights.data() + y * m_size;
+		const float sample_y = static_cast<float>(origin_y + static_cast<int32_t>(y));
+		for (uint32_t x = 0; x < m_size; x++)
+			row[x] = TerrainNoise::Sample(config, static_cast<float>(origin_x + static_cast<int32_t>(x)), sample_y);
+	});
+}
+
+void TerrainHeightmap::Resize(const uint32_t& size)
+{
+	m_size = size;
+	m_heights.assign(static_cast<size_t>(size) * size, 0.0f);
+}
+
+void TerrainHeightmap::Write(const uint32_t& x, const uint32_t& y, const uint32_t& width, const uint32_t& height, const float* heights)
+{
+	if (x >= m_size || y >= m_size)
+		return;
+
+	// Clipped to the heightmap, keeping the source's row pitch
+	const uint32_t columns = std::min(width, m_size - x);
+	const uint32_t rows = std::min(height, m_size - y);
+	for (uint32_t row = 0; row < rows; row++)
+		std::copy_n(heights + static_cast<size_t>(row) * width, columns, m_heights.data() + static_cast<size_t>(y + row) * m_size + x);
+}
+
+std::vector<TerrainPatchBounds> TerrainHeightmap::ComputePatchBounds(const uint32_t& patch_texels) const
+{
+	if (patch_texels == 0 || m_size <= patch_texels)
+		return {};
+
+	const uint32_t patches_per_side = (m_size - 1) / patch_texels;
+	std::vector<TerrainPatchBounds> bounds(static_cast<size_t>(patches_per_side) * patches_per_side);
+
+	JobSystem::Get()->ParallelFor(bounds.size(), [&](size_t index)
+	{
+		bounds[index] = this->ComputePatchBounds(patch_texels, static_cast<uint32_t>(index % patches_per_side), static_cast<uint32_t>(index / patches_per_side));
+	});
+
+	return bounds;
+}
+
+TerrainPatchBounds TerrainHeightmap::ComputePatchBounds(const uint32_t& patch_texels, const uint32_t& patch_x, const uint32_t& patch_y) const
+{
+	const uint32_t origin_x = patch_x * patch_texels;
+	const uint32_t origin_y = patch_y * patch_texels;
+	const float* origin = m_heights.data() + static_cast<size_t>(origin_y) * m_size + origin_x;
+
+	// An untessellated patch renders as the bilinear surface through its corners
+	const float h00 = origin[0];
+	const float h10 = origin[patch_texels];
+	const float h01 = origin[static_cast<size_t>(patch_texels) * m_size];
+	const float h11 = origin[static_cast<size_t>(patch_texels) * m_size + patch_texels];
+
+	TerrainPatchBounds patch{};
+	patch.min_height = FLT_MAX;
+	patch.max_height = -FLT_MAX;
+
+	double squared_error = 0.0;
+	for (uint32_t y = 0; y <= patch_texels; y++)
+	{
+		const float v = static_cast<float>(y) / patch_texels;
+		const float* row = origin + static_cast<size_t>(y) * m_size;
+
+		for (uint32_t x = 0; x <= patch_texels; x++)
+		{
+			const float u = static_cast<float>(x) / patch_texels;
+			const float h0 = h00 + (h10 - h00) * u;
+			const float h1 = h01 + (h11 - h01) * u;
+			const float error = row[x] - (h0 + (h1 - h0) * v);
+
+			patch.min_height = std::min(patch.min_height, row[x]);
+			patch.max_height = std::max(patch.max_height, row[x]);
+			squared_error += error * error;
+		}
+	}
+
+	patch.variance = static_cast<float>(squared_error / ((patch_texels + 1) * (patch_texels + 1)));
+
+	return patch;
+}
+
+std::vector<TerrainMeshlet> TerrainHeightmap::ComputeMeshlets(const uint32_t& meshlet_quads, const uint32_t& stride, const float& texel_spacing, const float& height_scale) const
+{
+	const uint32_t meshlet_texels = meshlet_quads * stride;
+	if (meshlet_texels == 0 || m_size <= meshlet_texels)
+		return {};
+
+	const uint32_t meshlets_per_side = (m_size - 1) / meshlet_texels;
+	std::vector<TerrainMeshlet> meshlets(static_cast<size_t>(meshlets_per_side) * meshlets_per_side);
+
+	JobSystem::Get()->ParallelFor(meshlets.size(), [&](size_t index)
+	{
+		const uint32_t origin_x = static_cast<uint32_t>(index % meshlets_per_side) * meshlet_texels;
+		const uint32_t origin_y = static_cast<uint32_t>(index / meshlets_per_side) * meshlet_texels;
+
+		auto height = [&](const uint32_t& x, const uint32_t& y) {
+			return m_heights[static_cast<size_t>(origin_y + y * stride) * m_size + origin_x + x * stride];
+		};
+
+		TerrainMeshlet& meshlet = meshlets[index];
+		meshlet.min_height = FLT_MAX;
+		meshlet.max_height = -FLT_MAX;
+
+		for (uint32_t y = 0; y <= meshlet_quads; y++)
+		{
+			for (uint32_t x = 0; x <= meshlet_quads; x++)
+			{
+				meshlet.min_height = std::min(meshlet.min_height, height(x, y));
+				meshlet.max_height = std::max(meshlet.max_height, height(x, y));
+			}
+		}
+
+		// Upward facing triangle normals, from the height steps across each triangle's legs
+		const float spacing = texel_spacing * stride;
+		std::vector<float> normals;
+		normals.reserve(static_cast<size_t>(meshlet_quads) * meshlet_quads * 6);
+
+		float axis[3] = { 0.0f, 0.0f, 0.0f };
+		for (uint32_t y = 0; y < meshlet_quads; y++)
+		{
+			for (uint32_t x = 0; x < meshlet_quads; x++)
+			{
+				const float h00 = height(x, y) * height_scale;
+				const float h10 = height(x + 1, y) * height_scale;
+				const float h01 = height(x, y + 1) * height_scale;
+				const float h11 = height(x + 1, y + 1) * height_scale;
+
+				const float triangles[2][2] = {
+					{ h10 - h00, h01 - h00 }, // (00, 01, 10)
+					{ h11 - h01, h11 - h10 } // (10, 01, 11)
+				};
+
+				for (const auto& [dx, dz] : triangles)
+				{
+					float normal[3] = { -dx * spacing, spacing * spacing, -dz * spacing };
+					const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+					for (uint32_t i = 0; i < 3; i++)
+					{
+						normal[i] /= length;
+						axis[i] += normal[i];
+						normals.push_back(normal[i]);
+					}
+				}
+			}
+		}
+
+		const float axis_length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+		for (uint32_t i = 0; i < 3; i++)
+			meshlet.cone[i] = axis[i] / axis_length;
+
+		// Widest normal from the axis
+		float min_dot = 1.0f;
+		for (size_t i = 0; i < normals.size(); i += 3)
+			min_dot = std::min(min_dot, normals[i] * meshlet.cone[0] + normals[i + 1] * meshlet.cone[1] + normals[i + 2] * meshlet.cone[2]);
+
+		meshlet.cone[3] = min_dot <= 0.0f ? 1.0f : std::sqrt(std::max(1.0f - min_dot * min_dot, 0.0f));
+	});
+
+	return meshlets;
+}
+
+float TerrainHeightmap::Sample(const float& x, const float& y) const
+{
+	if (m_size == 0)
+		return 0.0f;
+
+	const float max_coord = static_cast<float>(m_size - 1);
+	const float cx = std::clamp(x, 0.0f, max_coord);
+	const float cy = std::clamp(y, 0.0f, max_coord);
+
+	const uint32_t x0 = std::min(static_cast<uint32_t>(cx), m_size > 1 ? m_size - 2 : 0);
+	const uint32_t y0 = std::min(static_cast<uint32_t>(cy), m_size > 1 ? m_size - 2 : 0);
+	const uint32_t x1 = std::min(x0 + 1, m_size - 1);
+	const uint32_t y1 = std::min(y0 + 1, m_size - 1);
+	const float fx = cx - x0;
+	const float fy = cy - y0;
+
+	const float h00 = m_heights[static_cast<size_t>(y0) * m_size + x0];
+	const float h10 = m_heights[static_cast<size_t>(y0) * m_size + x1];
+	const float h01 = m_heights[static_cast<size_t>(y1) * m_size + x0];
+	const float h11 = m_heights[static_cast<size_t>(y1) * m_size + x1];
+
+	const float h0 = h00 + (h10 - h00) * fx;
+	const float h1 = h01 + (h11 - h01) * fx;
+	return h0 + (h1 - h0) * fy;
+}
+
+uint32_t TerrainHeightmap::GetSize() const
+{
+	return m_size;
+}
+
+const std::vector<float>& TerrainHeightmap::GetHeights() const
+{
+	return m_heights;
+}
\ No newline at end of file
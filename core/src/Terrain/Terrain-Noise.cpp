@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+import Terrain;
+
+// Unit gradients, picked by the low bits of a lattice point's hash
+constexpr float c_gradients[8][2] = {
+	{ 1.0f, 0.0f }, { -1.0f, 0.0f }, { 0.0f, 1.0f }, { 0.0f, -1.0f },
+	{ 0.70710678f, 0.70710678f }, { -0.70710678f, 0.70710678f }, { 0.70710678f, -0.70710678f }, { -0.70710678f, -0.70710678f }
+};
+
+// Decorrelates the seeds of successive octaves
+constexpr uint32_t c_octave_seed_step = 0x9E3779B9u;
+
+// Quintic fade, so the noise has continuous second derivatives across cells
+static float Fade(const float& t)
+{
+	return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+static float CornerDot(const int32_t& x, const int32_t& y, const uint32_t& seed, const float& dx, const float& dy)
+{
+	const float* gradient = c_gradients[TerrainNoise::Hash(x, y, seed) & 7u];
+	return gradient[0] * dx + gradient[1] * dy;
+}
+
+uint32_t TerrainNoise::Hash(const int32_t& x, const int32_t& y, const uint32_t& seed)
+{
+	uint32_t h = (static_cast<uint32_t>(x) * 0x8DA6B343u) ^ (static_cast<uint32_t>(y) * 0xD8163841u) ^ (seed * 0xCB1AB31Fu);
+	h ^= h >> 16;
+	h *= 0x7FEB352Du;
+	h ^= h >> 15;
+	h *= 0x846CA68Bu;
+	h ^= h >> 16;
+	return h;
+}
+
+float TerrainNoise::Gradient(const float& x, const float& y, const uint32_t& seed)
+{
+	const float floor_x = std::floor(x);
+	const float floor_y = std::floor(y);
+	const int32_t cell_x = static_cast<int32_t>(floor_x);
+	const int32_t cell_y = static_cast<int32_t>(floor_y);
+	const float tx = x - floor_x;
+	const float ty = y - floor_y;
+
+	const float n00 = CornerDot(cell_x, cell_y, seed, tx, ty);
+	const float n10 = CornerDot(cell_x + 1, cell_y, seed, tx - 1.0f, ty);
+	const float n01 = CornerDot(cell_x, cell_y + 1, seed, tx, ty - 1.0f);
+	const float n11 = CornerDot(cell_x + 1, cell_y + 1, seed, tx - 1.0f, ty - 1.0f);
+
+	const float u = Fade(tx);
+	const float v = Fade(ty);
+	const float n0 = n00 + (n10 - n00) * u;
+	const float n1 = n01 + (n11 - n01) * u;
+	return n0 + (n1 - n0) * v;
+}
+
+float TerrainNoise::Sample(const TerrainNoiseConfig& config, const float& x, const float& y)
+{
+	float sum = 0.0f;
+	float total = 0.0f;
+	float amplitude = 1.0f;
+	float frequency = config.frequency;
+
+	for (uint32_t octave = 0; octave < config.octaves; octave++)
+	{
+		sum += TerrainNoise::Gradient(x * frequency, y * frequency, config.seed + octave * c_octave_seed_step) * amplitude;
+		total += amplitude;
+		amplitude *= config.gain;
+		frequency *= config.lacunarity;
+	}
+
+	// Normalize the octave sum, then remap gradient noise's range onto [0, 1]
+	const float noise = total > 0.0f ? sum / total : 0.0f;
+	const float height = std::clamp(noise * 0.70710678f + 0.5f, 0.0f, 1.0f);
+
+	return std::pow(height, config.exponent);
+}
\ No newline at end of file
@@ -1,16 +1,25 @@
 #include <macros/AurionLog.h>
 
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
 #include <functional>
 #include <cmath>
 #include <chrono>
+#include <algorithm>
 
 #include <GLFW/glfw3.h>
+#include <imgui.h>
 
 #include <vulkan/vulkan.h>
 
 import TerrainGenerator;
 import Aurion.GLFW;
 import Vulkan;
+import Terrain;
+
+// Every readback re-uploads the whole heightmap, so they're spaced out while erosion runs
+constexpr std::chrono::milliseconds c_erosion_readback_interval(1000);
 
 TerrainGenerator::TerrainGenerator()
 {
@@ -30,6 +39,150 @@ void TerrainGenerator::StartAndRun()
 	this->Unload();
 }
 
+void TerrainGenerator::RunGenerationBenchmark()
+{
+	// No window is needed, so any device with a compute queue will do
+	VulkanDriverConfiguration driver_config{};
+	driver_config.headless = true;
+
+	VulkanDriver vulkan_driver;
+	vulkan_driver.Initialize(driver_config);
+
+	VulkanRenderer* renderer = (VulkanRenderer*)vulkan_driver.CreateRenderer();
+	if (!renderer)
+		return;
+
+	VulkanTerrainCompute tile_generator;
+	if (!tile_generator.Initialize(renderer->GetLogicalDevice(), renderer->GetComputeScheduler(), *renderer->GetPipelineBuilder()))
+		return;
+
+	tile_generator.RunBenchmark();
+	tile_generator.Destroy();
+}
+
+bool TerrainGenerator::RunHeadlessGoldenTest()
+{
+	VulkanDriverConfiguration driver_config{};
+	driver_config.headless = true;
+
+	VulkanDriver vulkan_driver;
+	vulkan_driver.Initialize(driver_config);
+
+	VulkanRenderer* renderer = (VulkanRenderer*)vulkan_driver.CreateRenderer();
+	if (!renderer)
+		return false;
+
+	VulkanHeadlessTargetConfig target_config{};
+	target_config.extent = { 64, 48 };
+	target_config.format = VK_FORMAT_B8G8R8A8_UNORM;
+	target_config.readback_enabled = true;
+
+	VulkanHeadlessTarget* target = renderer->GetHeadlessTarget(renderer->AddHeadlessTarget(target_config));
+	if (!target)
+		return false;
+
+	// Colors that UNORM stores exactly. Each frame shifts them, so a stale frame in flight can't pass for the latest.
+	const float palette[4][4] = {
+		{ 1.0f, 0.0f, 0.0f, 1.0f },
+		{ 0.0f, 1.0f, 0.0f, 1.0f },
+		{ 0.0f, 0.0f, 1.0f, 1.0f },
+		{ 0.2f, 0.4f, 0.6f, 1.0f }
+	};
+
+	uint32_t frame_index = 0;
+
+	// The whole image is cleared to one color, then the lower right quadrant to the next
+	target->BindRenderCommand([&](const VulkanCommand& command) {
+		const float* background = palette[frame_index % 4];
+		const float* quadrant = palette[(frame_index + 1) % 4];
+
+		VkRenderingAttachmentInfo color_attachment{
+			.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+			.imageView = command.render_view,
+			.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+			.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+			.clearValue = VkClearValue{ .color = { background[0], background[1], background[2], background[3] } }
+		};
+
+		VkRenderingInfo render_info{
+			.sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+			.renderArea = VkRect2D{ .extent = { command.render_extent.width, command.render_extent.height } },
+			.layerCount = 1,
+			.colorAttachmentCount = 1,
+			.pColorAttachments = &color_attachment
+		};
+
+		VkClearAttachment clear{
+			.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+			.colorAttachment = 0,
+			.clearValue = VkClearValue{ .color = { quadrant[0], quadrant[1], quadrant[2], quadrant[3] } }
+		};
+
+		VkClearRect clear_rect{
+			.rect = VkRect2D{
+				.offset = { (int32_t)command.render_extent.width / 2, (int32_t)command.render_extent.height / 2 },
+				.extent = { command.render_extent.width - command.render_extent.width / 2, command.render_extent.height - command.render_extent.height / 2 }
+			},
+			.baseArrayLayer = 0,
+			.layerCount = 1
+		};
+
+		vkCmdBeginRendering(command.graphics_buffer, &render_info);
+		vkCmdClearAttachments(command.graphics_buffer, 1, &clear, 1, &clear_rect);
+		vkCmdEndRendering(command.graphics_buffer);
+	}, "Golden Pattern");
+
+	const uint32_t width = target_config.extent.width;
+	const uint32_t height = target_config.extent.height;
+
+	// More frames than are in flight, so every frame slot's readback is reused at least once
+	bool passed = true;
+	std::vector<uint8_t> pixels;
+	for (frame_index = 0; frame_index < 8 && passed; frame_index++)
+	{
+		if (!target->Render() || !target->ReadPixels(pixels) || pixels.size() != (size_t)width * height * 4)
+		{
+			AURION_ERROR("[Headless Golden Test] Frame %d could not be read back!", frame_index);
+			passed = false;
+			break;
+		}
+
+		for (uint32_t y = 0; y < height && passed; y++)
+		{
+			for (uint32_t x = 0; x < width && passed; x++)
+			{
+				const float* color = x >= width / 2 && y >= height / 2 ? palette[(frame_index + 1) % 4] : palette[frame_index % 4];
+				const uint8_t* texel = &pixels[((size_t)y * width + x) * 4];
+
+				// B8G8R8A8 stores blue first. Rounding may differ by one step between implementations.
+				const int expected[4] = {
+					(int)std::lround(color[2] * 255.0f), (int)std::lround(color[1] * 255.0f),
+					(int)std::lround(color[0] * 255.0f), (int)std::lround(color[3] * 255.0f)
+				};
+
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					if (std::abs((int)texel[channel] - expected[channel]) <= 1)
+						continue;
+
+					AURION_ERROR("[Headless Golden Test] Frame %d texel (%d, %d) channel %d is %d, expected %d!",
+						frame_index, x, y, channel, texel[channel], expected[channel]);
+					passed = false;
+					break;
+				}
+			}
+		}
+	}
+
+	target->WaitIdle();
+
+	if (passed)
+		AURION_INFO("[Headless Golden Test] %d frames of %dx%d matched the expected image.", frame_index, width, height);
+
+	return passed;
+}
+
 void TerrainGenerator::Load()
 {
 	// Potentially load config from file
@@ -43,80 +196,39 @@ void TerrainGenerator::Load()
 
 	m_renderer = (VulkanRenderer*)m_vulkan_driver.CreateRenderer();
 
-	// Setting up Hello Triangle
 	VulkanPipelineBuilder* builder = m_renderer->GetPipelineBuilder();
-	
-	// Configuring the Graphics Pipeline
-	{
-		// Graphics Pipeline Configuration (Based On Vulkan Tutorial: https://vulkan-tutorial.com/ and the Vulkan Guide: https://vkguide.dev/)
-		builder->Configure(VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO)
-		.UseDynamicRendering()
-			.AddDynamicColorAttachmentFormat(VK_FORMAT_B8G8R8A8_UNORM)
-			.SetDynamicDepthAttachmentFormat(VK_FORMAT_D32_SFLOAT)
-			.SetDynamicStencilAttachmentFormat(VK_FORMAT_UNDEFINED)
-		.BindShader(VK_SHADER_STAGE_VERTEX_BIT, 0, "assets/shaders/vert-shader.vert", false)
-		.BindShader(VK_SHADER_STAGE_FRAGMENT_BIT, 0, "assets/shaders/frag-shader.frag", false)
-		.ConfigurePipelineLayout() // Pipeline Layout
-			// Currently Unused
-		.BuildPipelineLayout()
-		.ConfigureVertexInputState() // Vertex Input State
-			// None for now
-		.BuildVertexInputState()
-		.ConfigureInputAssemblyState() // Input Assembly State
-			.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
-			.SetPrimitiveRestartEnable(VK_FALSE)
-		.ConfigureTessellationState() // Tessellation State
-		.ConfigureViewportState()
-			.AddViewport(VkViewport{})
-			.AddScissor(VkRect2D{})
-		.BuildViewportState()
-		.ConfigureRasterizationState() // Rasterization State
-			.SetDepthClampEnabled(VK_FALSE)
-			.SetRasterizerDiscardEnabled(VK_FALSE)
-			.SetPolygonMode(VK_POLYGON_MODE_FILL)
-			.SetLineWidth(1.0f)
-			.SetCullMode(VK_CULL_MODE_BACK_BIT)
-			.SetFrontFace(VK_FRONT_FACE_CLOCKWISE)
-			.SetDepthBiasEnabled(VK_FALSE)
-			.SetDepthBiasConstantFactor(0.0f)
-			.SetDepthBiasClamp(0.0f)
-			.SetDepthBiasSlopeFactor(0.0f)
-		.ConfigureMultisampleState() // MultisampleState
-			.SetSampleShadingEnabled(VK_FALSE)
-			.SetRasterizationSamples(VK_SAMPLE_COUNT_1_BIT)
-			.SetMinSampleShading(1.0f)
-			.SetAlphaToCoverageEnabled(VK_FALSE)
-			.SetAlphaToOneEnabled(VK_FALSE)
-		.BuildMultisampleState()
-		.ConfigureDepthStencilState() // Depth Stencil State
-			// Unused
-		.ConfigureColorBlendState() // Color Blend State
-			.AddColorAttachment()
-				.SetColorWriteMask(VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT)
-				.SetBlendEnabled(VK_FALSE)
-				.SetSrcColorBlendFactor(VK_BLEND_FACTOR_ONE)
-				.SetDstColorBlendFactor(VK_BLEND_FACTOR_ONE)
-				.SetColorBlendOp(VK_BLEND_OP_ADD)
-				.SetSrcAlphaBlendFactor(VK_BLEND_FACTOR_ONE)
-				.SetDstAlphaBlendFactor(VK_BLEND_FACTOR_ONE)
-				.SetAlphaBlendOp(VK_BLEND_OP_ADD)
-			.SetLogicOpEnabled(VK_FALSE)
-			.SetLogicOp(VK_LOGIC_OP_COPY)
-			.SetBlendConstants(0.0f, 0.0f, 0.0f, 0.0f)
-		.BuildColorBlendState()
-		.ConfigureDynamicState() // Dynamic State
-			.AddDynamicState(VK_DYNAMIC_STATE_VIEWPORT)
-			.AddDynamicState(VK_DYNAMIC_STATE_SCISSOR)
-		.BuildDynamicState();
-	}
 
-	// Building all pipelines
-	m_render_pipelines = builder->Build();
+	// Heights come from the compute queue a tile at a time, starting flat. Without a GPU generator that agrees
+	//	with the CPU one, they're generated on the job system instead.
+	VulkanTerrainConfig terrain_config{};
+	terrain_config.generate_heights = !this->InitializeTileGeneration(*builder, terrain_config);
+
+	// Builds the terrain pipelines: mesh shading where supported, tessellation otherwise. Heights are uploaded
+	//	with the first frame.
+	m_terrain.Initialize(m_renderer->GetLogicalDevice(), *builder, terrain_config);
+
+	// Erosion works in the terrain's units, starting paused. Streamed heights replace its flat start once they're in.
+	m_heights_ready = terrain_config.generate_heights;
+	m_generated_heightmap = m_terrain.GetHeightmap();
+	m_erosion_changed = false;
+
+	VulkanTerrainErosionConfig erosion_config{};
+	erosion_config.height_scale = terrain_config.height_scale;
+	erosion_config.cell_size = terrain_config.world_size / (terrain_config.heightmap_size - 1);
+
+	m_erosion.Initialize(m_renderer->GetLogicalDevice(), m_renderer->GetComputeScheduler(), *builder, m_generated_heightmap, erosion_config);
+	m_erosion.SetRunning(false);
+
+#ifdef AURION_CORE_DEBUG
+	// Rebuild pipelines in the background whenever a shader is edited
+	builder->EnableHotReload();
+#endif
 }
 
 void TerrainGenerator::Start()
 {
 	m_should_close = false;
+	m_start_time = std::chrono::steady_clock::now();
 
 	Aurion::WindowConfig window_config;
 	window_config.title = "Terrain Generator";
@@ -127,8 +239,44 @@ void TerrainGenerator::Start()
 	// Create a graphics context for that window
 	m_renderer->AddWindow(main_window);
 
-	// Submit a single command to process the rendering for this window
-	m_renderer->BindCommand(main_window, std::bind(&TerrainGenerator::Render, this, std::placeholders::_1));
+	VulkanWindow* window = m_renderer->GetGraphicsWindow(main_window);
+
+	// Sky and terrain are separate commands that set all of their own state, so they're recorded on separate
+	//	threads. The sky is a single clear, so this mostly keeps the parallel path exercised; it pays off once
+	//	more commands are bound.
+	window->SetParallelRecordingEnabled(true);
+
+	// Flythroughs favor steady pacing and responsive input over peak frame rate
+	VulkanFramePacer* frame_pacer = m_renderer->GetFramePacer();
+	frame_pacer->SetLatencyMode(VulkanLatencyMode::JustInTime);
+
+	// Wide vistas drop resolution rather than frames
+	VulkanDynamicResolutionConfig resolution_config{};
+	resolution_config.enabled = true;
+	window->SetDynamicResolution(resolution_config);
+
+	// The scene shows in a docked viewport, sampled straight from the frame image
+	window->SetRenderAsUI(true);
+
+	// Show GPU timings for every pass and command, how evenly frames are paced, and how far erosion has come
+	window->SetUIRenderCallback([this, window, frame_pacer]()
+	{
+		window->DrawViewport();
+		window->GetProfiler()->DrawOverlay();
+		frame_pacer->DrawOverlay();
+		this->DrawErosionOverlay();
+	});
+
+	// Terrain depth only lives within the frame, so the render graph creates it alongside the frame's other transients
+	VulkanCommandImageInfo depth_info{};
+	depth_info.name = "Terrain Depth";
+	depth_info.image_info = m_terrain.GetDepthImageInfo();
+	depth_info.usage = VulkanResourceUsage::DepthAttachmentWrite;
+	m_depth_image = window->DeclareCommandImage(depth_info);
+
+	// Commands execute in binding order: the sky is cleared before the terrain draws over it
+	m_renderer->BindCommand(main_window, std::bind(&TerrainGenerator::RenderSky, this, std::placeholders::_1), "Sky");
+	m_renderer->BindCommand(main_window, std::bind(&TerrainGenerator::Render, this, std::placeholders::_1), "Terrain");
 }
 
 void TerrainGenerator::Run()
@@ -137,9 +285,15 @@ void TerrainGenerator::Run()
 
 	while (!m_should_close)
 	{
+		// Wait until the frame is due, so input is sampled as late as possible
+		m_renderer->PaceFrame();
+
 		// Input Polling and Window Updates
 		main_window.window->Update();
 
+		this->StreamTiles();
+		this->UpdateErosion();
+
 		// Render Frame
 		m_renderer->BeginFrame();
 		m_renderer->EndFrame();
@@ -151,76 +305,190 @@ void TerrainGenerator::Run()
 
 void TerrainGenerator::Unload()
 {
+	m_erosion.Destroy();
+	m_tile_generator.Destroy();
+	m_terrain.Destroy();
+}
 
+bool TerrainGenerator::InitializeTileGeneration(VulkanPipelineBuilder& builder, const VulkanTerrainConfig& terrain_config)
+{
+	VulkanTerrainComputeConfig config{};
+	config.noise = terrain_config.noise;
+
+	if (!m_tile_generator.Initialize(m_renderer->GetLogicalDevice(), m_renderer->GetComputeScheduler(), builder, config))
+	{
+		AURION_WARN("[Terrain Generator] GPU tile generation is unavailable. Generating heights on the CPU.");
+		return false;
+	}
+
+	// The CPU generator is the reference, so the GPU one is only trusted once a tile matches it
+	const float max_error = m_tile_generator.Validate(VulkanTerrainTile{});
+	if (max_error < 0.0f || max_error > config.tolerance)
+	{
+		AURION_WARN("[Terrain Generator] GPU tiles differ from the CPU generator by %f, past the tolerance of %f. Generating heights on the CPU.",
+			max_error, config.tolerance);
+		m_tile_generator.Destroy();
+		return false;
+	}
+
+	// Enough tiles to cover the heightmap. Tiles past its far edge are clipped when written.
+	const uint32_t tile_span = config.tile_texels - 1;
+	const int32_t tiles_per_side = static_cast<int32_t>((terrain_config.heightmap_size - 1 + tile_span - 1) / tile_span);
+
+	// Requested from the back, so the first row arrives first
+	m_tile_requests.clear();
+	for (int32_t y = tiles_per_side - 1; y >= 0; y--)
+	{
+		for (int32_t x = tiles_per_side - 1; x >= 0; x--)
+			m_tile_requests.push_back(VulkanTerrainTile{ x, y });
+	}
+
+	return true;
 }
 
-void TerrainGenerator::Render(const VulkanCommand& command)
+void TerrainGenerator::StreamTiles()
 {
-	VulkanPipeline* pipeline = m_render_pipelines.graphics_pipelines[0];
+	if (m_heights_ready)
+		return;
 
-	// Draw background
-	float flash = std::abs(std::sin((static_cast<double>(command.current_frame)) / 120.f));
-	VkClearColorValue clear_value{
-		0.0f,
-		0.0f,
-		flash,
-		1.0f
-	};
-	VkImageSubresourceRange clear_range{};
-	clear_range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	clear_range.baseMipLevel = 0;
-	clear_range.levelCount = VK_REMAINING_MIP_LEVELS;
-	clear_range.baseArrayLayer = 0;
-	clear_range.layerCount = VK_REMAINING_ARRAY_LAYERS;
+	// The terrain keeps CPU heights for queries and physics, and uploads the patches each tile touches
+	m_tile_generator.Collect([this](const VulkanTerrainTile& tile, const float* heights, const uint32_t& tile_texels)
+	{
+		const uint32_t tile_span = tile_texels - 1;
+		m_terrain.UpdateHeights(tile.x * tile_span, tile.y * tile_span, tile_texels, tile_texels, heights);
+	});
+
+	while (!m_tile_requests.empty() && m_tile_generator.Request(m_tile_requests.back()))
+		m_tile_requests.pop_back();
+
+	if (!m_tile_requests.empty() || m_tile_generator.GetPendingCount() > 0)
+		return;
+
+	m_heights_ready = true;
+	m_generated_heightmap = m_terrain.GetHeightmap();
+	m_erosion.Reset(m_generated_heightmap);
+}
+
+void TerrainGenerator::UpdateErosion()
+{
+	m_erosion.Update();
+
+	// Eroded heights replace the terrain's, so its bounds, meshlets and CPU queries follow the simulation
+	m_erosion.CollectReadback([this](const float* heights, const uint32_t& size)
+	{
+		m_terrain.UpdateHeights(0, 0, size, size, heights);
+	});
 
-	vkCmdClearColorImage(command.graphics_buffer, command.render_image, VK_IMAGE_LAYOUT_GENERAL, &clear_value, 1, &clear_range);
+	if (m_erosion.IsRunning())
+		m_erosion_changed = true;
 
-	// Draw Triangle
+	// Pausing reads back the final state straight away. It's queued behind the batches still in flight.
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (m_erosion_changed && (!m_erosion.IsRunning() || now - m_erosion_readback_time >= c_erosion_readback_interval) && m_erosion.RequestReadback())
+	{
+		m_erosion_changed = false;
+		m_erosion_readback_time = now;
+	}
+}
+
+void TerrainGenerator::ResetErosion()
+{
+	if (!m_erosion.Reset(m_generated_heightmap))
+		return;
+
+	const uint32_t size = m_generated_heightmap.GetSize();
+	m_terrain.UpdateHeights(0, 0, size, size, m_generated_heightmap.GetHeights().data());
+	m_erosion_changed = false;
+}
+
+void TerrainGenerator::DrawErosionOverlay()
+{
+	ImGui::SetNextWindowBgAlpha(0.8f);
+	if (!ImGui::Begin("Terrain Erosion", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+	{
+		ImGui::End();
+		return;
+	}
 
+	const VulkanTerrainErosionStats& stats = m_erosion.GetStats();
+
+	ImGui::Text("Iterations: %llu", (unsigned long long)stats.iterations_completed);
+	ImGui::Text("Iterations / s: %.1f", stats.iterations_per_second);
+	ImGui::Text("Cells / s: %.2f M", stats.cell_updates_per_second / 1000000.0);
+	ImGui::Text("Batch: %.3f ms, %u in flight", stats.batch_milliseconds, stats.batches_in_flight);
+	ImGui::Separator();
+
+	// Streamed tiles still on their way would be overwritten by the simulation
+	ImGui::BeginDisabled(!m_heights_ready || m_erosion.GetSize() == 0);
+
+	if (ImGui::Button(m_erosion.IsRunning() ? "Pause" : "Run"))
+		m_erosion.SetRunning(!m_erosion.IsRunning());
+
+	ImGui::SameLine();
+	if (ImGui::Button("Reset"))
+		this->ResetErosion();
+
+	ImGui::EndDisabled();
+
+	if (!m_heights_ready)
+		ImGui::TextUnformatted("Waiting for terrain tiles...");
+
+	ImGui::End();
+}
+
+void TerrainGenerator::RenderSky(const VulkanCommand& command)
+{
+	// Clearing on load is the whole pass, so the frame image never leaves the attachment layout
 	VkRenderingAttachmentInfo color_attachment{
 		.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
 		.imageView = command.render_view,
 		.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-		.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD,
-		.storeOp = VK_ATTACHMENT_STORE_OP_STORE
+		.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+		.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+		.clearValue = VkClearValue{ .color = { 0.62f, 0.72f, 0.85f, 1.0f } }
 	};
 
 	VkRenderingInfo render_info{
 		.sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
-		.renderArea = VkRect2D{
-			.extent = VkExtent2D{ command.render_extent.width, command.render_extent.height }
-		},
+		.renderArea = VkRect2D{ .extent = { command.render_extent.width, command.render_extent.height } },
 		.layerCount = 1,
-		.viewMask = 0,
 		.colorAttachmentCount = 1,
 		.pColorAttachments = &color_attachment
 	};
 
 	vkCmdBeginRendering(command.graphics_buffer, &render_info);
+	vkCmdEndRendering(command.graphics_buffer);
 
-	vkCmdBindPipeline(command.graphics_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->handle);
-
-	//set dynamic viewport and scissor
-	VkViewport viewport = {};
-	viewport.x = 0;
-	viewport.y = 0;
-	viewport.width = command.render_extent.width;
-	viewport.height = command.render_extent.height;
-	viewport.minDepth = 0.f;
-	viewport.maxDepth = 1.f;
-
-	vkCmdSetViewport(command.graphics_buffer, 0, 1, &viewport);
-
-	VkRect2D scissor = {};
-	scissor.offset.x = 0;
-	scissor.offset.y = 0;
-	scissor.extent.width = command.render_extent.width;
-	scissor.extent.height = command.render_extent.height;
-
-	vkCmdSetScissor(command.graphics_buffer, 0, 1, &scissor);
-
-	//launch a draw command to draw 3 vertices
-	vkCmdDraw(command.graphics_buffer, 3, 1, 0, 0);
+	// Separate rendering scopes aren't ordered against each other, so the terrain's load must wait on the clear
+	VulkanImage::TransitionLayout(command.graphics_buffer, command.render_image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+		VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+}
 
-	vkCmdEndRendering(command.graphics_buffer);
+void TerrainGenerator::Render(const VulkanCommand& command)
+{
+	m_terrain.Record(command, command.command_images[m_depth_image], this->GetCamera());
 }
+
+TerrainCamera TerrainGenerator::GetCamera()
+{
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+	const VulkanTerrainConfig& config = m_terrain.GetConfig();
+	const TerrainHeightmap& heightmap = m_terrain.GetHeightmap();
+
+	const float angle = static_cast<float>(seconds * 0.05);
+	const float radius = config.world_size * 0.4f;
+	const float center[3] = { config.world_size * 0.5f, config.height_scale * 0.3f, config.world_size * 0.5f };
+
+	TerrainCamera camera{};
+	camera.position[0] = center[0] + std::cos(angle) * radius;
+	camera.position[2] = center[2] + std::sin(angle) * radius;
+
+	// Stay above whatever is underneath
+	const float texels_per_meter = (heightmap.GetSize() - 1) / config.world_size;
+	const float ground = heightmap.Sample(camera.position[0] * texels_per_meter, camera.position[2] * texels_per_meter) * config.height_scale;
+	camera.position[1] = std::max(config.height_scale * 0.8f, ground + 50.0f);
+
+	camera.LookAt(center);
+	return camera;
+}
\ No newline at end of file
@@ -0,0 +1,1260 @@
+#include <macros/AurionLog.h>
+
+#include <cstdint>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+// x64 always provides SSE2
+#include <emmintrin.h>
+
+import Texture;
+import Jobs;
+
+// BC7 4-bit index interpolation weights, in 64ths
+constexpr int32_t c_bc7_weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Power iterations when fitting a block's principal axis
+constexpr uint32_t c_power_iterations = 4;
+
+// A block's 16 texels, one array per channel, for SIMD projection
+struct BCBlockChannels
+{
+	alignas(16) float values[4][16];
+};
+
+// Gathers a 4x4 block as RGBA, clamping at the texture's edges. Missing components are 0, alpha 255.
+static void LoadBlock(const BCEncodeInfo& info, const uint32_t& block_x, const uint32_t& block_y, uint8_t block[64])
+{
+	const uint32_t row_pitch = info.row_pitch != 0 ? info.row_pitch : info.width * info.components;
+
+	for (uint32_t y = 0; y < 4; y++)
+	{
+		const uint32_t src_y = std::min(block_y * 4 + y, info.height - 1);
+		for (uint32_t x = 0; x < 4; x++)
+		{
+			const uint32_t src_x = std::min(block_x * 4 + x, info.width - 1);
+			const uint8_t* src = info.texels + (size_t)src_y * row_pitch + (size_t)src_x * info.components;
+			uint8_t* dst = block + (y * 4 + x) * 4;
+
+			for (uint32_t c = 0; c < 4; c++)
+				dst[c] = c < info.components ? src[c] : (c == 3 ? 255 : 0);
+		}
+	}
+}
+
+static void SplitChannels(const uint8_t block[64], BCBlockChannels& channels)
+{
+	for (uint32_t i = 0; i < 16; i++)
+		for (uint32_t c = 0; c < 4; c++)
+			channels.values[c][i] = static_cast<float>(block[i * 4 + c]);
+}
+
+// Per channel minimum and maximum of a block's 16 RGBA texels
+static void BlockBounds(const uint8_t block[64], uint8_t min[4], uint8_t max[4])
+{
+	const __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+	const __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16));
+	const __m128i row2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32));
+	const __m128i row3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48));
+
+	__m128i lo = _mm_min_epu8(_mm_min_epu8(row0, row1), _mm_min_epu8(row2, row3));
+	__m128i hi = _mm_max_epu8(_mm_max_epu8(row0, row1), _mm_max_epu8(row2, row3));
+
+	// Fold the four texels of each register into one
+	lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 8));
+	lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 4));
+	hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 8));
+	hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 4));
+
+	const uint32_t lo_bits = static_cast<uint32_t>(_mm_cvtsi128_si32(lo));
+	const uint32_t hi_bits = static_cast<uint32_t>(_mm_cvtsi128_si32(hi));
+	std::memcpy(min, &lo_bits, 4);
+	std::memcpy(max, &hi_bits, 4);
+}
+
+// Minimum and maximum of 16 single channel values
+static void ChannelBounds(const uint8_t values[16], uint8_t& min, uint8_t& max)
+{
+	__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+	__m128i hi = lo;
+
+	// Fold all 16 bytes into the lowest
+	lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 8));
+	lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 4));
+	lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 2));
+	lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 1));
+	hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 8));
+	hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 4));
+	hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 2));
+	hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 1));
+
+	min = static_cast<uint8_t>(_mm_cvtsi128_si32(lo) & 0xFF);
+	max = static_cast<uint8_t>(_mm_cvtsi128_si32(hi) & 0xFF);
+}
+
+// Projects each texel onto the segment from e0 to e1, returning the nearest of steps + 1 evenly spaced points (0 at e0)
+static void ProjectToSegment(const BCBlockChannels& block, const uint32_t& channel_count, const float e0[4], const float e1[4], const int32_t& steps, int32_t out[16])
+{
+	float direction[4]{};
+	float length2 = 0.0f;
+	for (uint32_t c = 0; c < channel_count; c++)
+	{
+		direction[c] = e1[c] - e0[c];
+		length2 += direction[c] * direction[c];
+	}
+
+	if (length2 < 1e-6f)
+	{
+		std::fill(out, out + 16, 0);
+		return;
+	}
+
+	const __m128 scale = _mm_set1_ps(static_cast<float>(steps) / length2);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 last = _mm_set1_ps(static_cast<float>(steps));
+
+	for (uint32_t i = 0; i < 16; i += 4)
+	{
+		__m128 dot = _mm_setzero_ps();
+		for (uint32_t c = 0; c < channel_count; c++)
+		{
+			const __m128 offset = _mm_sub_ps(_mm_load_ps(block.values[c] + i), _mm_set1_ps(e0[c]));
+			dot = _mm_add_ps(dot, _mm_mul_ps(offset, _mm_set1_ps(direction[c])));
+		}
+
+		// Round to nearest, clamped to the segment
+		const __m128 t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(dot, scale), zero), last);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvtps_epi32(t));
+	}
+}
+
+// Picks the nearest palette entry for every texel. Returns the block's squared error.
+static float SearchPalette(const BCBlockChannels& block, const uint32_t& channel_count, const float palette[16][4], const uint32_t& palette_size, int32_t out[16])
+{
+	float total = 0.0f;
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		float best = FLT_MAX;
+		for (uint32_t p = 0; p < palette_size; p++)
+		{
+			float error = 0.0f;
+			for (uint32_t c = 0; c < channel_count; c++)
+			{
+				const float d = block.values[c][i] - palette[p][c];
+				error += d * d;
+			}
+
+			if (error < best)
+			{
+				best = error;
+				out[i] = static_cast<int32_t>(p);
+			}
+		}
+
+		total += best;
+	}
+
+	return total;
+}
+
+static float PaletteError(const BCBlockChannels& block, const uint32_t& channel_count, const float palette[16][4], const int32_t indices[16])
+{
+	float total = 0.0f;
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		for (uint32_t c = 0; c < channel_count; c++)
+		{
+			const float d = block.values[c][i] - palette[indices[i]][c];
+			total += d * d;
+		}
+	}
+
+	return total;
+}
+
+// Fits a line through the block's texels, returning its end points at the texels' extreme projections
+static void FitPrincipalAxis(const BCBlockChannels& block, const uint32_t& channel_count, const uint8_t min[4], const uint8_t max[4], float e0[4], float e1[4])
+{
+	float mean[4]{};
+	for (uint32_t c = 0; c < channel_count; c++)
+	{
+		for (uint32_t i = 0; i < 16; i++)
+			mean[c] += block.values[c][i];
+		mean[c] /= 16.0f;
+	}
+
+	float covariance[4][4]{};
+	for (uint32_t i = 0; i < 16; i++)
+		for (uint32_t a = 0; a < channel_count; a++)
+			for (uint32_t b = 0; b < channel_count; b++)
+				covariance[a][b] += (block.values[a][i] - mean[a]) * (block.values[b][i] - mean[b]);
+
+	// The bounding box diagonal is a good first guess for the dominant axis, once channels that fall as the widest one
+	//	rises are flipped. Unflipped, it's orthogonal to the axis of blocks whose channels run in opposite directions.
+	uint32_t widest = 0;
+	for (uint32_t c = 1; c < channel_count; c++)
+		if (covariance[c][c] > covariance[widest][widest])
+			widest = c;
+
+	float axis[4]{};
+	for (uint32_t c = 0; c < channel_count; c++)
+		axis[c] = static_cast<float>(max[c] - min[c]) * (covariance[widest][c] < 0.0f ? -1.0f : 1.0f);
+
+	for (uint32_t iteration = 0; iteration < c_power_iterations; iteration++)
+	{
+		float next[4]{};
+		float largest = 0.0f;
+		for (uint32_t a = 0; a < channel_count; a++)
+		{
+			for (uint32_t b = 0; b < channel_count; b++)
+				next[a] += covariance[a][b] * axis[b];
+			largest = std::max(largest, std::abs(next[a]));
+		}
+
+		if (largest < 1e-6f)
+			break;
+
+		for (uint32_t c = 0; c < channel_count; c++)
+			axis[c] = next[c] / largest;
+	}
+
+	float length2 = 0.0f;
+	for (uint32_t c = 0; c < channel_count; c++)
+		length2 += axis[c] * axis[c];
+
+	// Flat block
+	if (length2 < 1e-6f)
+	{
+		for (uint32_t c = 0; c < channel_count; c++)
+			e0[c] = e1[c] = mean[c];
+		return;
+	}
+
+	float t_min = FLT_MAX;
+	float t_max = -FLT_MAX;
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		float t = 0.0f;
+		for (uint32_t c = 0; c < channel_count; c++)
+			t += (block.values[c][i] - mean[c]) * axis[c];
+
+		t_min = std::min(t_min, t);
+		t_max = std::max(t_max, t);
+	}
+
+	for (uint32_t c = 0; c < channel_count; c++)
+	{
+		e0[c] = std::clamp(mean[c] + axis[c] * t_min / length2, 0.0f, 255.0f);
+		e1[c] = std::clamp(mean[c] + axis[c] * t_max / length2, 0.0f, 255.0f);
+	}
+}
+
+// Least squares end points for fixed indices, weighted 0 at e0 and 1 at e1
+static bool RefineEndPoints(const BCBlockChannels& block, const uint32_t& channel_count, const float weights[16], const int32_t indices[16], float e0[4], float e1[4])
+{
+	float alpha2 = 0.0f, beta2 = 0.0f, alpha_beta = 0.0f;
+	float alpha_x[4]{}, beta_x[4]{};
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		const float beta = weights[indices[i]];
+		const float alpha = 1.0f - beta;
+
+		alpha2 += alpha * alpha;
+		beta2 += beta * beta;
+		alpha_beta += alpha * beta;
+
+		for (uint32_t c = 0; c < channel_count; c++)
+		{
+			alpha_x[c] += alpha * block.values[c][i];
+			beta_x[c] += beta * block.values[c][i];
+		}
+	}
+
+	const float determinant = alpha2 * beta2 - alpha_beta * alpha_beta;
+	if (std::abs(determinant) < 1e-6f)
+		return false;
+
+	for (uint32_t c = 0; c < channel_count; c++)
+	{
+		e0[c] = std::clamp((alpha_x[c] * beta2 - beta_x[c] * alpha_beta) / determinant, 0.0f, 255.0f);
+		e1[c] = std::clamp((beta_x[c] * alpha2 - alpha_x[c] * alpha_beta) / determinant, 0.0f, 255.0f);
+	}
+
+	return true;
+}
+
+static void InsetEndPoints(const uint32_t& channel_count, float e0[4], float e1[4])
+{
+	for (uint32_t c = 0; c < channel_count; c++)
+	{
+		const float inset = (e1[c] - e0[c]) / 16.0f;
+		e0[c] += inset;
+		e1[c] -= inset;
+	}
+}
+
+static void WriteBits(uint8_t* out, uint32_t& offset, const uint32_t& value, const uint32_t& count)
+{
+	for (uint32_t i = 0; i < count; i++, offset++)
+		if ((value >> i) & 1)
+			out[offset >> 3] |= static_cast<uint8_t>(1 << (offset & 7));
+}
+
+static uint32_t ReadBits(const uint8_t* in, uint32_t& offset, const uint32_t& count)
+{
+	uint32_t value = 0;
+	for (uint32_t i = 0; i < count; i++, offset++)
+		value |= ((in[offset >> 3] >> (offset & 7)) & 1u) << i;
+
+	return value;
+}
+
+// BC1 ------------------------------------------------------------------------
+
+static uint16_t PackRGB565(const float color[4])
+{
+	const uint32_t r = static_cast<uint32_t>(std::clamp(std::lround(color[0] * 31.0f / 255.0f), 0l, 31l));
+	const uint32_t g = static_cast<uint32_t>(std::clamp(std::lround(color[1] * 63.0f / 255.0f), 0l, 63l));
+	const uint32_t b = static_cast<uint32_t>(std::clamp(std::lround(color[2] * 31.0f / 255.0f), 0l, 31l));
+
+	return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRGB565(const uint16_t& packed, float color[4])
+{
+	const uint32_t r = (packed >> 11) & 31;
+	const uint32_t g = (packed >> 5) & 63;
+	const uint32_t b = packed & 31;
+
+	color[0] = static_cast<float>((r << 3) | (r >> 2));
+	color[1] = static_cast<float>((g << 2) | (g >> 4));
+	color[2] = static_cast<float>((b << 3) | (b >> 2));
+	color[3] = 255.0f;
+}
+
+// Four colour palette in step order: e0, 2/3 e0 + 1/3 e1, 1/3 e0 + 2/3 e1, e1
+static void BuildBC1Palette(const uint16_t& c0, const uint16_t& c1, float palette[16][4])
+{
+	UnpackRGB565(c0, palette[0]);
+	UnpackRGB565(c1, palette[3]);
+
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		palette[1][c] = std::floor((2.0f * palette[0][c] + palette[3][c]) / 3.0f);
+		palette[2][c] = std::floor((palette[0][c] + 2.0f * palette[3][c]) / 3.0f);
+	}
+}
+
+static float FitBC1(const BCBlockChannels& block, const BCQuality& quality, const float e0[4], const float e1[4], uint16_t& c0, uint16_t& c1, int32_t steps[16])
+{
+	c0 = PackRGB565(e0);
+	c1 = PackRGB565(e1);
+
+	float palette[16][4]{};
+	BuildBC1Palette(c0, c1, palette);
+
+	if (quality == BCQuality::High)
+		return SearchPalette(block, 3, palette, 4, steps);
+
+	ProjectToSegment(block, 3, palette[0], palette[3], 3, steps);
+	return PaletteError(block, 3, palette, steps);
+}
+
+static void EncodeBC1Block(const uint8_t texels[64], const BCQuality& quality, uint8_t* out)
+{
+	BCBlockChannels block;
+	SplitChannels(texels, block);
+
+	uint8_t min[4], max[4];
+	BlockBounds(texels, min, max);
+
+	float e0[4]{}, e1[4]{};
+	if (quality == BCQuality::Fast)
+	{
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			e0[c] = max[c];
+			e1[c] = min[c];
+		}
+	}
+	else
+		FitPrincipalAxis(block, 3, min, max, e0, e1);
+
+	InsetEndPoints(3, e0, e1);
+
+	uint16_t c0 = 0, c1 = 0;
+	int32_t steps[16]{};
+	float error = FitBC1(block, quality, e0, e1, c0, c1, steps);
+
+	if (quality == BCQuality::High)
+	{
+		constexpr float c_bc1_weights[4] = { 0.0f, 1.0f / 3.0f, 2.0f / 3.0f, 1.0f };
+
+		uint16_t refined_c0 = 0, refined_c1 = 0;
+		int32_t refined_steps[16]{};
+		if (RefineEndPoints(block, 3, c_bc1_weights, steps, e0, e1))
+		{
+			const float refined_error = FitBC1(block, quality, e0, e1, refined_c0, refined_c1, refined_steps);
+			if (refined_error < error)
+			{
+				c0 = refined_c0;
+				c1 = refined_c1;
+				std::memcpy(steps, refined_steps, sizeof(steps));
+			}
+		}
+	}
+
+	// Four colour mode needs c0 > c1. Equal end points decode as a flat block.
+	if (c0 < c1)
+	{
+		std::swap(c0, c1);
+		for (int32_t& step : steps)
+			step = 3 - step;
+	}
+	else if (c0 == c1)
+		std::fill(steps, steps + 16, 0);
+
+	// Step order to BC1 index order: e0, e1, 2/3 e0 + 1/3 e1, 1/3 e0 + 2/3 e1
+	constexpr uint32_t c_bc1_index[4] = { 0, 2, 3, 1 };
+
+	uint32_t indices = 0;
+	for (uint32_t i = 0; i < 16; i++)
+		indices |= c_bc1_index[steps[i]] << (i * 2);
+
+	std::memcpy(out, &c0, 2);
+	std::memcpy(out + 2, &c1, 2);
+	std::memcpy(out + 4, &indices, 4);
+}
+
+static void DecodeBC1Block(const uint8_t* in, uint8_t texels[64])
+{
+	uint16_t c0, c1;
+	uint32_t indices;
+	std::memcpy(&c0, in, 2);
+	std::memcpy(&c1, in + 2, 2);
+	std::memcpy(&indices, in + 4, 4);
+
+	float colors[4][4]{};
+	UnpackRGB565(c0, colors[0]);
+	UnpackRGB565(c1, colors[1]);
+
+	for (uint32_t c = 0; c < 3; c++)
+	{
+		if (c0 > c1)
+		{
+			colors[2][c] = std::floor((2.0f * colors[0][c] + colors[1][c]) / 3.0f);
+			colors[3][c] = std::floor((colors[0][c] + 2.0f * colors[1][c]) / 3.0f);
+		}
+		else
+		{
+			colors[2][c] = std::floor((colors[0][c] + colors[1][c]) / 2.0f);
+			colors[3][c] = 0.0f;
+		}
+	}
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		const uint32_t index = (indices >> (i * 2)) & 3;
+		for (uint32_t c = 0; c < 3; c++)
+			texels[i * 4 + c] = static_cast<uint8_t>(colors[index][c]);
+		texels[i * 4 + 3] = 255;
+	}
+}
+
+// BC4 ------------------------------------------------------------------------
+
+// Eight value palette in BC4 index order. a0 > a1 interpolates six values; otherwise four, plus 0 and 255.
+static void BuildBC4Palette(const uint32_t& a0, const uint32_t& a1, float palette[16][4])
+{
+	palette[0][0] = static_cast<float>(a0);
+	palette[1][0] = static_cast<float>(a1);
+
+	if (a0 > a1)
+	{
+		for (uint32_t i = 2; i < 8; i++)
+			palette[i][0] = static_cast<float>(((8 - i) * a0 + (i - 1) * a1 + 3) / 7);
+	}
+	else
+	{
+		for (uint32_t i = 2; i < 6; i++)
+			palette[i][0] = static_cast<float>(((6 - i) * a0 + (i - 1) * a1 + 2) / 5);
+		palette[6][0] = 0.0f;
+		palette[7][0] = 255.0f;
+	}
+}
+
+static void EncodeBC4Block(const uint8_t values[16], const BCQuality& quality, uint8_t* out)
+{
+	BCBlockChannels block;
+	for (uint32_t i = 0; i < 16; i++)
+		block.values[0][i] = static_cast<float>(values[i]);
+
+	uint8_t lo = 0, hi = 0;
+	ChannelBounds(values, lo, hi);
+
+	uint32_t a0 = hi, a1 = lo;
+	int32_t indices[16]{};
+	float palette[16][4]{};
+	BuildBC4Palette(a0, a1, palette);
+
+	if (a0 == a1)
+		std::fill(indices, indices + 16, 0);
+	else if (quality == BCQuality::Fast)
+	{
+		// Projected steps run from a0 to a1; step order to index order
+		constexpr int32_t c_bc4_index[8] = { 0, 2, 3, 4, 5, 6, 7, 1 };
+
+		const float e0[4] = { static_cast<float>(a0) };
+		const float e1[4] = { static_cast<float>(a1) };
+		ProjectToSegment(block, 1, e0, e1, 7, indices);
+
+		for (int32_t& index : indices)
+			index = c_bc4_index[index];
+	}
+	else
+	{
+		float error = SearchPalette(block, 1, palette, 8, indices);
+
+		// Blocks that mix a narrow range with full black or white fit the four value mode better
+		if (quality == BCQuality::High)
+		{
+			uint32_t inner_lo = 255, inner_hi = 0;
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				if (values[i] == 0 || values[i] == 255)
+					continue;
+
+				inner_lo = std::min<uint32_t>(inner_lo, values[i]);
+				inner_hi = std::max<uint32_t>(inner_hi, values[i]);
+			}
+
+			if (inner_lo <= inner_hi)
+			{
+				float inner_palette[16][4]{};
+				int32_t inner_indices[16]{};
+				BuildBC4Palette(inner_lo, inner_hi, inner_palette);
+
+				if (SearchPalette(block, 1, inner_palette, 8, inner_indices) < error)
+				{
+					a0 = inner_lo;
+					a1 = inner_hi;
+					std::memcpy(indices, inner_indices, sizeof(indices));
+				}
+			}
+		}
+	}
+
+	out[0] = static_cast<uint8_t>(a0);
+	out[1] = static_cast<uint8_t>(a1);
+
+	uint64_t bits = 0;
+	for (uint32_t i = 0; i < 16; i++)
+		bits |= static_cast<uint64_t>(indices[i]) << (i * 3);
+
+	for (uint32_t i = 0; i < 6; i++)
+		out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+}
+
+static void DecodeBC4Block(const uint8_t* in, uint8_t* texels, const uint32_t& stride)
+{
+	float palette[16][4]{};
+	BuildBC4Palette(in[0], in[1], palette);
+
+	uint64_t bits = 0;
+	for (uint32_t i = 0; i < 6; i++)
+		bits |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+
+	for (uint32_t i = 0; i < 16; i++)
+		texels[i * stride] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7][0]);
+}
+
+// BC7 (mode 6) ---------------------------------------------------------------
+
+// Quantizes RGBA end points to 7 bits plus a shared low bit
+static void QuantizeBC7(const float e[4], const uint32_t& p_bit, uint32_t quantized[4], float expanded[4])
+{
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		quantized[c] = static_cast<uint32_t>(std::clamp(std::lround((e[c] - p_bit) / 2.0f), 0l, 127l));
+		expanded[c] = static_cast<float>((quantized[c] << 1) | p_bit);
+	}
+}
+
+static void BuildBC7Palette(const float e0[4], const float e1[4], float palette[16][4])
+{
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			const int32_t a = static_cast<int32_t>(e0[c]);
+			const int32_t b = static_cast<int32_t>(e1[c]);
+			palette[i][c] = static_cast<float>((a * (64 - c_bc7_weights[i]) + b * c_bc7_weights[i] + 32) >> 6);
+		}
+	}
+}
+
+struct BCBlock7Fit
+{
+	uint32_t q0[4]{};
+	uint32_t q1[4]{};
+	uint32_t p0 = 0;
+	uint32_t p1 = 0;
+	int32_t steps[16]{};
+	float error = FLT_MAX;
+};
+
+static void FitBC7(const BCBlockChannels& block, const BCQuality& quality, const float e0[4], const float e1[4], BCBlock7Fit& best)
+{
+	// Fast and balanced modes take the low bit closest to each end point's mean; high tries every pair
+	uint32_t p_bits[4][2]{};
+	uint32_t candidates = 4;
+
+	if (quality == BCQuality::High)
+	{
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			p_bits[i][0] = i & 1;
+			p_bits[i][1] = i >> 1;
+		}
+	}
+	else
+	{
+		float sum0 = 0.0f, sum1 = 0.0f;
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			sum0 += e0[c];
+			sum1 += e1[c];
+		}
+
+		p_bits[0][0] = static_cast<uint32_t>(std::lround(sum0 / 4.0f)) & 1;
+		p_bits[0][1] = static_cast<uint32_t>(std::lround(sum1 / 4.0f)) & 1;
+		candidates = 1;
+	}
+
+	for (uint32_t i = 0; i < candidates; i++)
+	{
+		BCBlock7Fit fit{};
+		fit.p0 = p_bits[i][0];
+		fit.p1 = p_bits[i][1];
+
+		float q0[4], q1[4];
+		QuantizeBC7(e0, fit.p0, fit.q0, q0);
+		QuantizeBC7(e1, fit.p1, fit.q1, q1);
+
+		float palette[16][4];
+		BuildBC7Palette(q0, q1, palette);
+
+		if (quality == BCQuality::High)
+			fit.error = SearchPalette(block, 4, palette, 16, fit.steps);
+		else
+		{
+			ProjectToSegment(block, 4, q0, q1, 15, fit.steps);
+			fit.error = PaletteError(block, 4, palette, fit.steps);
+		}
+
+		if (fit.error < best.error)
+			best = fit;
+	}
+}
+
+static void EncodeBC7Block(const uint8_t texels[64], const BCQuality& quality, uint8_t* out)
+{
+	BCBlockChannels block;
+	SplitChannels(texels, block);
+
+	uint8_t min[4], max[4];
+	BlockBounds(texels, min, max);
+
+	float e0[4]{}, e1[4]{};
+	if (quality == BCQuality::Fast)
+	{
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			e0[c] = min[c];
+			e1[c] = max[c];
+		}
+	}
+	else
+		FitPrincipalAxis(block, 4, min, max, e0, e1);
+
+	BCBlock7Fit fit{};
+	FitBC7(block, quality, e0, e1, fit);
+
+	if (quality == BCQuality::High)
+	{
+		float weights[16];
+		for (uint32_t i = 0; i < 16; i++)
+			weights[i] = c_bc7_weights[i] / 64.0f;
+
+		if (RefineEndPoints(block, 4, weights, fit.steps, e0, e1))
+			FitBC7(block, quality, e0, e1, fit);
+	}
+
+	// The anchor index drops its top bit, so texel 0 must use the first half of the palette
+	if (fit.steps[0] >= 8)
+	{
+		std::swap(fit.q0, fit.q1);
+		std::swap(fit.p0, fit.p1);
+		for (int32_t& step : fit.steps)
+			step = 15 - step;
+	}
+
+	std::memset(out, 0, 16);
+	uint32_t offset = 0;
+
+	WriteBits(out, offset, 1 << 6, 7);
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		WriteBits(out, offset, fit.q0[c], 7);
+		WriteBits(out, offset, fit.q1[c], 7);
+	}
+
+	WriteBits(out, offset, fit.p0, 1);
+	WriteBits(out, offset, fit.p1, 1);
+
+	for (uint32_t i = 0; i < 16; i++)
+		WriteBits(out, offset, static_cast<uint32_t>(fit.steps[i]), i == 0 ? 3 : 4);
+}
+
+static bool DecodeBC7Block(const uint8_t* in, uint8_t texels[64])
+{
+	// Only mode 6 is written
+	if ((in[0] & 0x7F) != 0x40)
+		return false;
+
+	uint32_t offset = 7;
+	uint32_t q0[4], q1[4];
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		q0[c] = ReadBits(in, offset, 7);
+		q1[c] = ReadBits(in, offset, 7);
+	}
+
+	const uint32_t p0 = ReadBits(in, offset, 1);
+	const uint32_t p1 = ReadBits(in, offset, 1);
+
+	float e0[4], e1[4];
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		e0[c] = static_cast<float>((q0[c] << 1) | p0);
+		e1[c] = static_cast<float>((q1[c] << 1) | p1);
+	}
+
+	float palette[16][4];
+	BuildBC7Palette(e0, e1, palette);
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		const uint32_t index = ReadBits(in, offset, i == 0 ? 3 : 4);
+		for (uint32_t c = 0; c < 4; c++)
+			texels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+	}
+
+	return true;
+}
+
+// Benchmark source -----------------------------------------------------------
+
+static float LatticeValue(const int32_t& x, const int32_t& y, const uint32_t& seed)
+{
+	uint32_t hash = static_cast<uint32_t>(x) * 0x8DA6B343u ^ static_cast<uint32_t>(y) * 0xD8163841u ^ seed * 0xCB1AB31Fu;
+	hash ^= hash >> 13;
+	hash *= 0x5BD1E995u;
+	hash ^= hash >> 15;
+
+	return static_cast<float>(hash & 0xFFFF) / 65535.0f;
+}
+
+static float ValueNoise(const float& x, const float& y, const uint32_t& seed)
+{
+	const int32_t x0 = static_cast<int32_t>(std::floor(x));
+	const int32_t y0 = static_cast<int32_t>(std::floor(y));
+	const float fx = x - x0;
+	const float fy = y - y0;
+	const float sx = fx * fx * (3.0f - 2.0f * fx);
+	const float sy = fy * fy * (3.0f - 2.0f * fy);
+
+	const float top = LatticeValue(x0, y0, seed) + (LatticeValue(x0 + 1, y0, seed) - LatticeValue(x0, y0, seed)) * sx;
+	const float bottom = LatticeValue(x0, y0 + 1, seed) + (LatticeValue(x0 + 1, y0 + 1, seed) - LatticeValue(x0, y0 + 1, seed)) * sx;
+
+	return top + (bottom - top) * sy;
+}
+
+static float FractalNoise(const float& x, const float& y, const uint32_t& seed)
+{
+	float value = 0.0f, amplitude = 0.5f, frequency = 1.0f;
+	for (uint32_t octave = 0; octave < 5; octave++)
+	{
+		value += ValueNoise(x * frequency, y * frequency, seed + octave) * amplitude;
+		amplitude *= 0.5f;
+		frequency *= 2.0f;
+	}
+
+	return value;
+}
+
+// RGBA8 resembling generated terrain textures: a normal's x and y, height, and a soft edged splat mask
+static std::vector<uint8_t> GenerateBenchmarkTexture(const uint32_t& width, const uint32_t& height)
+{
+	std::vector<float> heights((size_t)width * height);
+	JobSystem::Get()->ParallelFor(height, [&](size_t y) {
+		for (uint32_t x = 0; x < width; x++)
+			heights[y * width + x] = FractalNoise(x / 64.0f, y / 64.0f, 1);
+	});
+
+	std::vector<uint8_t> texels((size_t)width * height * 4);
+	JobSystem::Get()->ParallelFor(height, [&](size_t y) {
+		for (uint32_t x = 0; x < width; x++)
+		{
+			const float dx = heights[y * width + std::min(x + 1, width - 1)] - heights[y * width + (x > 0 ? x - 1 : 0)];
+			const float dy = heights[std::min<size_t>(y + 1, height - 1) * width + x] - heights[(y > 0 ? y - 1 : 0) * width + x];
+
+			const float nx = -dx * 32.0f, ny = -dy * 32.0f;
+			const float length = std::sqrt(nx * nx + ny * ny + 1.0f);
+			const float mask = std::clamp((FractalNoise(x / 32.0f, y / 32.0f, 7) - 0.45f) * 8.0f, 0.0f, 1.0f);
+
+			uint8_t* texel = texels.data() + (y * width + x) * 4;
+			texel[0] = static_cast<uint8_t>(std::lround((nx / length * 0.5f + 0.5f) * 255.0f));
+			texel[1] = static_cast<uint8_t>(std::lround((ny / length * 0.5f + 0.5f) * 255.0f));
+			texel[2] = static_cast<uint8_t>(std::lround(heights[y * width + x] * 255.0f));
+			texel[3] = static_cast<uint8_t>(std::lround(mask * 255.0f));
+		}
+	});
+
+	return texels;
+}
+
+// Self tests -----------------------------------------------------------------
+
+enum class BCTestPattern
+{
+	Flat, // A single colour, reproduced to within end point precision
+	Gradient, // Smooth ramps at a different rate per channel
+	TwoTone, // Alternating dark and bright texels. Principal axis fits start e0 at the dark end, so BC1 has to swap its end points.
+	Crossed, // Red rising as green falls, so the end points' order differs between channels
+};
+
+struct BCTestCase
+{
+	const char* name;
+	BCTestPattern pattern;
+	uint32_t width;
+	uint32_t height;
+	uint32_t max_error[4]; // Largest per channel difference allowed, indexed by BCFormat
+	bool bounding_box_fits; // Whether BCQuality::Fast end points can meet the bounds
+};
+
+// Gradients vary along both axes, which BC1 and BC7 blocks can only fit with a line, hence their wider bounds.
+//	Sizes that aren't multiples of 4 cover the repeated edge texels.
+constexpr BCTestCase c_bc_test_cases[] = {
+	{ "flat", BCTestPattern::Flat, 8, 8, { 3, 0, 0, 1 }, true },
+	{ "gradient", BCTestPattern::Gradient, 16, 16, { 16, 2, 2, 16 }, true },
+	{ "two tone", BCTestPattern::TwoTone, 8, 8, { 16, 1, 1, 1 }, true },
+	{ "crossed", BCTestPattern::Crossed, 6, 5, { 10, 8, 8, 3 }, false },
+};
+
+static std::vector<uint8_t> GenerateTestTexture(const BCTestPattern& pattern, const uint32_t& width, const uint32_t& height)
+{
+	std::vector<uint8_t> texels((size_t)width * height * 4);
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			uint8_t* texel = texels.data() + ((size_t)y * width + x) * 4;
+			uint32_t rgba[4]{};
+
+			switch (pattern)
+			{
+			case BCTestPattern::Flat:
+				rgba[0] = 200; rgba[1] = 120; rgba[2] = 40; rgba[3] = 255;
+				break;
+			case BCTestPattern::Gradient:
+				rgba[0] = 40 + x * 9; rgba[1] = 60 + y * 7; rgba[2] = 100 + (x + y) * 4; rgba[3] = 255 - x * 5;
+				break;
+			case BCTestPattern::TwoTone:
+				if ((x + y) & 1)
+				{
+					rgba[0] = 220; rgba[1] = 200; rgba[2] = 170; rgba[3] = 250;
+				}
+				else
+				{
+					rgba[0] = 30; rgba[1] = 60; rgba[2] = 20; rgba[3] = 40;
+				}
+				break;
+			case BCTestPattern::Crossed:
+				rgba[0] = 20 + x * 40; rgba[1] = 235 - x * 40; rgba[2] = 128; rgba[3] = 200;
+				break;
+			}
+
+			for (uint32_t c = 0; c < 4; c++)
+				texel[c] = static_cast<uint8_t>(rgba[c]);
+		}
+	}
+
+	return texels;
+}
+
+// Four colour mode needs c0 > c1. Equal end points are only written for flat blocks, with every index 0.
+static bool IsFourColorBC1(const uint8_t* blocks, const size_t& block_count, size_t& failed_block)
+{
+	for (size_t i = 0; i < block_count; i++)
+	{
+		const uint8_t* block = blocks + i * 8;
+
+		uint16_t c0, c1;
+		uint32_t indices;
+		std::memcpy(&c0, block, 2);
+		std::memcpy(&c1, block + 2, 2);
+		std::memcpy(&indices, block + 4, 4);
+
+		if (c0 < c1 || (c0 == c1 && indices != 0))
+		{
+			failed_block = i;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// BlockCompressor ------------------------------------------------------------
+
+uint32_t BlockCompressor::GetBlockSize(const BCFormat& format)
+{
+	return format == BCFormat::BC1 || format == BCFormat::BC4 ? 8 : 16;
+}
+
+uint32_t BlockCompressor::GetChannelCount(const BCFormat& format)
+{
+	switch (format)
+	{
+	case BCFormat::BC1: return 3;
+	case BCFormat::BC4: return 1;
+	case BCFormat::BC5: return 2;
+	default: return 4;
+	}
+}
+
+size_t BlockCompressor::GetEncodedSize(const BCFormat& format, const uint32_t& width, const uint32_t& height)
+{
+	return (size_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+}
+
+bool BlockCompressor::Encode(const BCEncodeInfo& info, uint8_t* output)
+{
+	if (!Validate(info) || !output)
+		return false;
+
+	for (uint32_t row = 0; row < (info.height + 3) / 4; row++)
+		EncodeRow(info, row, output);
+
+	return true;
+}
+
+bool BlockCompressor::EncodeParallel(const BCEncodeInfo& info, uint8_t* output)
+{
+	if (!Validate(info) || !output)
+		return false;
+
+	JobSystem::Get()->ParallelFor((info.height + 3) / 4, [&](size_t row) {
+		EncodeRow(info, static_cast<uint32_t>(row), output);
+	});
+
+	return true;
+}
+
+bool BlockCompressor::Decode(const BCFormat& format, const uint32_t& width, const uint32_t& height, const uint8_t* blocks, uint8_t* texels)
+{
+	if (!blocks || !texels || width == 0 || height == 0)
+		return false;
+
+	const uint32_t blocks_x = (width + 3) / 4;
+	const uint32_t blocks_y = (height + 3) / 4;
+	const uint32_t block_size = GetBlockSize(format);
+
+	for (uint32_t by = 0; by < blocks_y; by++)
+	{
+		for (uint32_t bx = 0; bx < blocks_x; bx++)
+		{
+			const uint8_t* in = blocks + ((size_t)by * blocks_x + bx) * block_size;
+
+			// Unused channels are 0 and alpha opaque, as they would sample on the GPU
+			uint8_t block[64]{};
+			for (uint32_t i = 0; i < 16; i++)
+				block[i * 4 + 3] = 255;
+
+			switch (format)
+			{
+			case BCFormat::BC1:
+				DecodeBC1Block(in, block);
+				break;
+			case BCFormat::BC4:
+				DecodeBC4Block(in, block, 4);
+				break;
+			case BCFormat::BC5:
+				DecodeBC4Block(in, block, 4);
+				DecodeBC4Block(in + 8, block + 1, 4);
+				break;
+			case BCFormat::BC7:
+				if (!DecodeBC7Block(in, block))
+					return false;
+				break;
+			}
+
+			for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++)
+				for (uint32_t x = 0; x < 4 && bx * 4 + x < width; x++)
+					std::memcpy(texels + ((size_t)(by * 4 + y) * width + bx * 4 + x) * 4, block + (y * 4 + x) * 4, 4);
+		}
+	}
+
+	return true;
+}
+
+double BlockCompressor::ComputePSNR(const uint8_t* a, const uint8_t* b, const uint32_t& width, const uint32_t& height, const uint32_t& channel_count)
+{
+	double squared_error = 0.0;
+	for (size_t i = 0; i < (size_t)width * height; i++)
+	{
+		for (uint32_t c = 0; c < channel_count; c++)
+		{
+			const double d = static_cast<double>(a[i * 4 + c]) - b[i * 4 + c];
+			squared_error += d * d;
+		}
+	}
+
+	const double mean_squared_error = squared_error / ((double)width * height * channel_count);
+
+	// Identical images
+	if (mean_squared_error <= 0.0)
+		return 99.0;
+
+	return 10.0 * std::log10(255.0 * 255.0 / mean_squared_error);
+}
+
+BCBenchmarkResult BlockCompressor::Benchmark(const BCFormat& format, const BCQuality& quality, const uint32_t& width, const uint32_t& height, const uint32_t& iterations)
+{
+	BCBenchmarkResult result{};
+	result.format = format;
+	result.quality = quality;
+
+	const std::vector<uint8_t> source = GenerateBenchmarkTexture(width, height);
+
+	BCEncodeInfo info{};
+	info.format = format;
+	info.quality = quality;
+	info.width = width;
+	info.height = height;
+	info.texels = source.data();
+	info.components = 4;
+
+	std::vector<uint8_t> encoded(GetEncodedSize(format, width, height));
+
+	// Warm up the workers and caches
+	if (!EncodeParallel(info, encoded.data()))
+		return result;
+
+	const uint32_t runs = std::max(iterations, 1u);
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	for (uint32_t i = 0; i < runs; i++)
+		EncodeParallel(info, encoded.data());
+
+	const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	result.megapixels_per_second = (double)width * height * runs / 1'000'000.0 / std::max(seconds, 1e-9);
+
+	std::vector<uint8_t> decoded((size_t)width * height * 4);
+	if (Decode(format, width, height, encoded.data(), decoded.data()))
+		result.psnr = ComputePSNR(source.data(), decoded.data(), width, height, GetChannelCount(format));
+
+	// BC1 is compared against RGBA8, the format it would otherwise upload as
+	const uint32_t uncompressed_channels = format == BCFormat::BC1 ? 4 : GetChannelCount(format);
+	result.compression_ratio = (double)width * height * uncompressed_channels / encoded.size();
+
+	return result;
+}
+
+void BlockCompressor::RunBenchmarks(const uint32_t& width, const uint32_t& height, const uint32_t& iterations)
+{
+	AURION_INFO("[Block Compression] Benchmarking %dx%d, %d iterations on %d threads", width, height, iterations, JobSystem::Get()->GetThreadCount() + 1);
+
+	for (BCFormat format : { BCFormat::BC1, BCFormat::BC4, BCFormat::BC5, BCFormat::BC7 })
+	{
+		for (BCQuality quality : { BCQuality::Fast, BCQuality::Balanced, BCQuality::High })
+		{
+			const BCBenchmarkResult result = Benchmark(format, quality, width, height, iterations);
+			AURION_INFO("[Block Compression] %s %-8s %8.1f MPix/s  %6.2f dB  %.0f:1",
+				GetFormatName(format), GetQualityName(quality), result.megapixels_per_second, result.psnr, result.compression_ratio);
+		}
+	}
+}
+
+bool BlockCompressor::RunSelfTests()
+{
+	uint32_t failures = 0;
+	uint32_t cases = 0;
+
+	for (const BCTestCase& test : c_bc_test_cases)
+	{
+		const std::vector<uint8_t> source = GenerateTestTexture(test.pattern, test.width, test.height);
+
+		for (BCFormat format : { BCFormat::BC1, BCFormat::BC4, BCFormat::BC5, BCFormat::BC7 })
+		{
+			for (BCQuality quality : { BCQuality::Fast, BCQuality::Balanced, BCQuality::High })
+			{
+				if (quality == BCQuality::Fast && !test.bounding_box_fits)
+					continue;
+
+				cases++;
+
+				BCEncodeInfo info{};
+				info.format = format;
+				info.quality = quality;
+				info.width = test.width;
+				info.height = test.height;
+				info.texels = source.data();
+				info.components = 4;
+
+				const size_t encoded_size = GetEncodedSize(format, test.width, test.height);
+				std::vector<uint8_t> encoded(encoded_size);
+				std::vector<uint8_t> encoded_parallel(encoded_size);
+				std::vector<uint8_t> decoded((size_t)test.width * test.height * 4);
+
+				if (!Encode(info, encoded.data()) || !EncodeParallel(info, encoded_parallel.data()) ||
+					!Decode(format, test.width, test.height, encoded.data(), decoded.data()))
+				{
+					AURION_ERROR("[Block Compression] %s %s %s: encoding or decoding failed.", test.name, GetFormatName(format), GetQualityName(quality));
+					failures++;
+					continue;
+				}
+
+				if (encoded != encoded_parallel)
+				{
+					AURION_ERROR("[Block Compression] %s %s %s: parallel encoding differs from serial.", test.name, GetFormatName(format), GetQualityName(quality));
+					failures++;
+				}
+
+				size_t failed_block = 0;
+				if (format == BCFormat::BC1 && !IsFourColorBC1(encoded.data(), encoded_size / 8, failed_block))
+				{
+					AURION_ERROR("[Block Compression] %s BC1 %s: block %d would decode in three colour mode.", test.name, GetQualityName(quality), static_cast<uint32_t>(failed_block));
+					failures++;
+				}
+
+				// Largest difference over the channels the format stores
+				const uint32_t channel_count = GetChannelCount(format);
+				const uint32_t max_error = test.max_error[static_cast<uint32_t>(format)];
+				uint32_t worst = 0;
+				size_t worst_texel = 0;
+				for (size_t i = 0; i < (size_t)test.width * test.height; i++)
+				{
+					for (uint32_t c = 0; c < channel_count; c++)
+					{
+						const uint32_t error = static_cast<uint32_t>(std::abs(static_cast<int32_t>(source[i * 4 + c]) - decoded[i * 4 + c]));
+						if (error > worst)
+						{
+							worst = error;
+							worst_texel = i;
+						}
+					}
+				}
+
+				if (worst > max_error)
+				{
+					AURION_ERROR("[Block Compression] %s %s %s: error of %d at texel (%d, %d) exceeds %d.", test.name, GetFormatName(format), GetQualityName(quality),
+						worst, static_cast<uint32_t>(worst_texel % test.width), static_cast<uint32_t>(worst_texel / test.width), max_error);
+					failures++;
+				}
+			}
+		}
+	}
+
+	if (failures == 0)
+		AURION_INFO("[Block Compression] All %d round trip cases passed.", cases);
+	else
+		AURION_ERROR("[Block Compression] %d checks failed across %d round trip cases.", failures, cases);
+
+	return failures == 0;
+}
+
+const char* BlockCompressor::GetFormatName(const BCFormat& format)
+{
+	switch (format)
+	{
+	case BCFormat::BC1: return "BC1";
+	case BCFormat::BC4: return "BC4";
+	case BCFormat::BC5: return "BC5";
+	default: return "BC7";
+	}
+}
+
+const char* BlockCompressor::GetQualityName(const BCQuality& quality)
+{
+	switch (quality)
+	{
+	case BCQuality::Fast: return "Fast";
+	case BCQuality::Balanced: return "Balanced";
+	default: return "High";
+	}
+}
+
+bool BlockCompressor::Validate(const BCEncodeInfo& info)
+{
+	if (!info.texels || info.width == 0 || info.height == 0 || info.components == 0 || info.components > 4)
+	{
+		AURION_ERROR("[Block Compression] Invalid source: %dx%d with %d components.", info.width, info.height, info.components);
+		return false;
+	}
+
+	const bool color = info.format == BCFormat::BC1 || info.format == BCFormat::BC7;
+	const uint32_t required = color ? 3 : info.channel + GetChannelCount(info.format);
+	if (info.components < required)
+	{
+		AURION_ERROR("[Block Compression] %s needs %d source components, but only %d are present.", GetFormatName(info.format), required, info.components);
+		return false;
+	}
+
+	return true;
+}
+
+void BlockCompressor::EncodeRow(const BCEncodeInfo& info, const uint32_t& block_row, uint8_t* output)
+{
+	const uint32_t blocks_x = (info.width + 3) / 4;
+	const uint32_t block_size = GetBlockSize(info.format);
+	uint8_t* out = output + (size_t)block_row * blocks_x * block_size;
+
+	uint8_t block[64];
+	uint8_t values[16];
+
+	for (uint32_t bx = 0; bx < blocks_x; bx++, out += block_size)
+	{
+		LoadBlock(info, bx, block_row, block);
+
+		switch (info.format)
+		{
+		case BCFormat::BC1:
+			EncodeBC1Block(block, info.quality, out);
+			break;
+		case BCFormat::BC4:
+			for (uint32_t i = 0; i < 16; i++)
+				values[i] = block[i * 4 + info.channel];
+			EncodeBC4Block(values, info.quality, out);
+			break;
+		case BCFormat::BC5:
+			for (uint32_t c = 0; c < 2; c++)
+			{
+				for (uint32_t i = 0; i < 16; i++)
+					values[i] = block[i * 4 + info.channel + c];
+				EncodeBC4Block(values, info.quality, out + c * 8);
+			}
+			break;
+		case BCFormat::BC7:
+			EncodeBC7Block(block, info.quality, out);
+			break;
+		}
+	}
+}
\ No newline at end of file
@@ -1,7 +1,32 @@
+#include <cstring>
+
 import TerrainGenerator;
+import Texture;
 
-int main()
+int main(int argc, char** argv)
 {
+	// Compares block compression settings instead of running the generator
+	if (argc > 1 && std::strcmp(argv[1], "--bc-benchmark") == 0)
+	{
+		BlockCompressor::RunBenchmarks();
+		return 0;
+	}
+
+	// Checks block compression round trips against their error bounds instead of running the generator
+	if (argc > 1 && std::strcmp(argv[1], "--bc-test") == 0)
+		return BlockCompressor::RunSelfTests() ? 0 : 1;
+
+	// Compares GPU and CPU terrain generation instead of running the generator
+	if (argc > 1 && std::strcmp(argv[1], "--terrain-benchmark") == 0)
+	{
+		TerrainGenerator::RunGenerationBenchmark();
+		return 0;
+	}
+
+	// Checks headless rendering and readback against a known image instead of running the generator
+	if (argc > 1 && std::strcmp(argv[1], "--headless-test") == 0)
+		return TerrainGenerator::RunHeadlessGoldenTest() ? 0 : 1;
+
 	TerrainGenerator terrain_generator;
 	terrain_generator.StartAndRun();
 }
\ No newline at end of file